@@ -26,6 +26,7 @@ CAdaCounter::CAdaCounter()
 	QuoteStart = "\"";
 	QuoteEnd = "\"";
 	QuoteEscapeRear = '\"';
+	customReplaceQuote = true;
 
 	directive.push_back("controlled");
 	directive.push_back("elaborate");
@@ -188,7 +189,7 @@ int CAdaCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd, c
 *
 * \return method status
 */
-int CAdaCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CAdaCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
@@ -196,8 +197,8 @@ int CAdaCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fma
 	string strDirLine = "";
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$:";
 
-	filemap::iterator itfmBak = fmapBak->begin();
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -205,7 +206,7 @@ int CAdaCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fma
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count, false);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count, false);
 		}
 
 		if (!contd)
@@ -251,7 +252,7 @@ int CAdaCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fma
 				if (result->addSLOC(strDirLine, trunc_flag))
 					result->directive_lines[LOG]++;
 			}
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -271,7 +272,7 @@ int CAdaCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fma
 *
 * \return method status
 */
-int CAdaCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CAdaCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool			found_accept	= false;
 	string			strLSLOC		= "";
@@ -279,7 +280,7 @@ int CAdaCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 	unsigned int	cnt				= 0;
 	unsigned int	loopLevel		= 0;
 
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak, tmp;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$:";
 
@@ -301,7 +302,7 @@ int CAdaCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 				found_forifwhile, found_end, found_type, found_is, found_accept, loopLevel);
 
 			cnt = 0;
-			CUtil::CountTally(line, data_name_list, cnt, 1, exclude, "", "", NULL, false);
+			CountTally(line, data_name_list, cnt, 1, exclude, "", "", NULL, false);
 
 			// need to check also if the data line continues
 			if (cnt > 0)
@@ -312,7 +313,7 @@ int CAdaCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
 			}
 		}
 	}
@@ -345,7 +346,7 @@ void CAdaCounter::FoundSLOC(results* result, string &strLSLOC, string &strLSLOCB
 	{
 		// determine logical type, data declaration or executable
 		unsigned int cnt = 0;
-		CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
+		CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
 		if (cnt > 0)
 			result->data_lines[LOG]++;
 		else
@@ -384,7 +385,7 @@ void CAdaCounter::FoundSLOC(results* result, string &strLSLOC, string &strLSLOCB
 * \param found_accept found accept flag
 * \param loopLevel nested loop level
 */
-void CAdaCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+void CAdaCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 						bool &found_block, bool &found_forifwhile, bool &found_end, bool &found_type, bool &found_is, bool &found_accept,
 						unsigned int &loopLevel)
 {
@@ -406,7 +407,7 @@ void CAdaCounter::LSLOC(results* result, string line, string lineBak, string &st
 			if (!found_end)
 			{
 				// check for empty statement (=1 LSLOC)
-				if (CUtil::TrimString(line.substr(start, i + 1 - start)) == ";" && strLSLOC.length() < 1)
+				if (CUtil::TrimStringEquals(line, start, i + 1 - start, ";") && strLSLOC.length() < 1)
 				{
 					strLSLOC = ";";
 					strLSLOCBak = ";";
@@ -452,7 +453,8 @@ void CAdaCounter::LSLOC(results* result, string line, string lineBak, string &st
 			continue;
 
 		// if it ends in xxx, then it has already been counted, so ignore it
-		tmp = "xxx " + CUtil::TrimString(line.substr(start, i + 1 - start));
+		tmp = "xxx ";
+		CUtil::AppendTrimString(tmp, line, start, i + 1 - start);
 		tempi = CUtil::FindKeyword(tmp, "end", 0, TO_END_OF_STRING, false);
 		if (tempi != string::npos)
 		{
@@ -461,7 +463,7 @@ void CAdaCounter::LSLOC(results* result, string line, string lineBak, string &st
 			// record end loop for nested loop processing
 			if (print_cmplx)
 			{
-				tmp = CUtil::TrimString(line.substr(start, i + 5 - start));
+				CUtil::AssignTrimString(tmp, line, start, i + 5 - start);
 				if (CUtil::FindKeyword(tmp, "end loop", 0, TO_END_OF_STRING, false) != string::npos)
 					if (loopLevel > 0)
 						loopLevel--;
@@ -649,12 +651,12 @@ void CAdaCounter::LSLOC(results* result, string line, string lineBak, string &st
 		}
 	}
 
-	tmp = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
 	strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 	if (strSize > 0)
 	{
 		strLSLOC += tmp.substr(0, strSize);
-		tmp = CUtil::TrimString(lineBak.substr(start, i - start));
+		CUtil::AssignTrimString(tmp, lineBak, start, i - start);
 		strLSLOCBak += tmp.substr(0, strSize);
 
 		// drop continuation symbol
@@ -22,10 +22,10 @@ public:
 	CAdaCounter();
 
 protected:
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
 	virtual int ReplaceQuote(string &strline, size_t &idx_start, bool &contd, char &CurrentQuoteEnd);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 		bool &forflag, bool &found_forifwhile, bool &found_while, bool &found_type, bool &found_is, bool &found_accept,
 		unsigned int &loopLevel);
 	void FoundSLOC(results* result, string &strLSLOC, string &strLSLOCBak, bool &found_block, bool &found_forifwhile,
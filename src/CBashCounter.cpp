@@ -130,9 +130,9 @@ CBashCounter::CBashCounter()
 *
 * \return method status
 */
-int CBashCounter::PreCountProcess(filemap* fmap)
+int CBashCounter::PreCountProcess(filemapOverlay* fmap)
 {
-	filemap::iterator fit;
+	filemapOverlay::iterator fit;
 	for (fit = fmap->begin(); fit != fmap->end(); fit++) 
 	{
 		if (fit->line.empty())
@@ -141,7 +141,7 @@ int CBashCounter::PreCountProcess(filemap* fmap)
 		{
 			// replace $# and ${# with $ to avoid determination of a comment
 			if (fit->line[i] == '#' && (fit->line[i-1] == '$' || fit->line[i-1] == '{'))
-				fit->line[i] = '$';
+				fmap->edit(fit)[i] = '$';
 		}
 	}
 	return 0;
@@ -161,9 +161,9 @@ int CBashCounter::PreCountProcess(filemap* fmap)
 *
 * \return method status
 */
-int CBashCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CBashCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
 
 	bool data_continue = false;
@@ -174,7 +174,7 @@ int CBashCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 	unsigned int phys_data_lines = 0;
 	unsigned int temp_lines = 0;
 	unsigned int cnt = 0;
-	StringVector loopLevel;
+	ArenaStringVector loopLevel(arena);
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 
 	for (fit = fmap->begin(), fitbak = fmapBak->begin(); fit != fmap->end(); fit++, fitbak++)
@@ -192,7 +192,7 @@ int CBashCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 
 			// update physical SLOC lines
@@ -224,9 +224,9 @@ int CBashCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 * \param phys_data_lines number of physical data lines
 * \param loopLevel nested loop level
 */
-void CBashCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
+void CBashCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak,
 						 bool &data_continue, unsigned int &temp_lines, unsigned int &phys_exec_lines,
-						 unsigned int &phys_data_lines, StringVector &loopLevel)
+						 unsigned int &phys_data_lines, ArenaStringVector &loopLevel)
 {
 	size_t start, end;
 	size_t i = 0, m, strSize;
@@ -251,8 +251,8 @@ void CBashCounter::LSLOC(results* result, string line, string lineBak, string &s
 	// trim trailing '{'
 	if (tmp[tmp.length() - 1] == '{')
 	{
-		tmp = CUtil::TrimString(tmp.substr(0, tmp.length() - 1));
-		tmpBak = CUtil::TrimString(tmpBak.substr(0, tmpBak.length() - 1));
+		CUtil::AssignTrimString(tmp, tmp, 0, tmp.length() - 1);
+		CUtil::AssignTrimString(tmpBak, tmpBak, 0, tmpBak.length() - 1);
 	}
 
 	// there may be more than 1 logical SLOC in this line
@@ -263,7 +263,7 @@ void CBashCounter::LSLOC(results* result, string line, string lineBak, string &s
 		if (end != string::npos)
 		{
 			// handle empty statement
-			if (CUtil::TrimString(tmp.substr(start, end - start + 1)) == ";")
+			if (CUtil::TrimStringEquals(tmp, start, end - start + 1, ";"))
 			{
 				start = end + 1;
 				strLSLOC = strLSLOCBak = "";
@@ -310,7 +310,7 @@ void CBashCounter::LSLOC(results* result, string line, string lineBak, string &s
 		// process nested loops
 		if (print_cmplx)
 		{
-			str = CUtil::TrimString(tmp.substr(start, end - start + 1));
+			CUtil::AssignTrimString(str, tmp, start, end - start + 1);
 			if (CUtil::FindKeyword(str, "for") != string::npos
 				|| CUtil::FindKeyword(str, "while") != string::npos
 				|| CUtil::FindKeyword(str, "until")!= string::npos
@@ -329,7 +329,7 @@ void CBashCounter::LSLOC(results* result, string line, string lineBak, string &s
 				if (CUtil::FindKeyword(str, "select") == string::npos)
 				{
 					unsigned int loopCnt = 0;
-					for (StringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
+					for (ArenaStringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
 					{
 						if ((*lit) != "")
 							loopCnt++;
@@ -352,7 +352,7 @@ void CBashCounter::LSLOC(results* result, string line, string lineBak, string &s
 			{
 				// strip specified keyword and skip if empty
 				start = i + (*it).length();
-				if (CUtil::CheckBlank(CUtil::TrimString(tmp.substr(start, end - start))))
+				if (CUtil::CheckBlank(tmp, start, end - start))
 					start = end + 1;
 				break;
 			}
@@ -367,9 +367,9 @@ void CBashCounter::LSLOC(results* result, string line, string lineBak, string &s
 		// check for continuation words
 		found = false;
 		if (tmp[end] == ';')
-			str = CUtil::TrimString(tmp.substr(start, end - start));
+			CUtil::AssignTrimString(str, tmp, start, end - start);
 		else
-			str = CUtil::TrimString(tmp.substr(start, end - start + 1));
+			CUtil::AssignTrimString(str, tmp, start, end - start + 1);
 		for (StringVector::iterator it = continue_keywords.begin(); it != continue_keywords.end(); it++)
 		{
 			if (str == (*it))
@@ -407,14 +407,16 @@ void CBashCounter::LSLOC(results* result, string line, string lineBak, string &s
 					if (str[0] == ' ')
 						spc += " ";
 				}
-				strLSLOC += CUtil::TrimString(tmp.substr(start, strSize)) + spc;
-				strLSLOCBak += CUtil::TrimString(tmpBak.substr(start, strSize)) + spc;
+				CUtil::AppendTrimString(strLSLOC, tmp, start, strSize);
+				strLSLOC += spc;
+				CUtil::AppendTrimString(strLSLOCBak, tmpBak, start, strSize);
+				strLSLOCBak += spc;
 			}
 			start = end + 1;
 
 			// make sure that we are not beginning to process a new data line
 			cnt = 0;
-			CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
+			CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
 
 			if (cnt > 0)
 				data_continue = true;
@@ -438,8 +440,8 @@ void CBashCounter::LSLOC(results* result, string line, string lineBak, string &s
 				strSize = CUtil::TruncateLine(end - start + 1, strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 			if (strSize > 0)
 			{
-				strLSLOC += CUtil::TrimString(tmp.substr(start, strSize));
-				strLSLOCBak += CUtil::TrimString(tmpBak.substr(start, strSize));
+				CUtil::AppendTrimString(strLSLOC, tmp, start, strSize);
+				CUtil::AppendTrimString(strLSLOCBak, tmpBak, start, strSize);
 			}
 			start = end + 1;
 			if (strLSLOCBak.length() > 0)
@@ -448,7 +450,7 @@ void CBashCounter::LSLOC(results* result, string line, string lineBak, string &s
 				{
 					// add a logical SLOC
 					cnt = 0;
-					CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
+					CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
 
 					temp_lines++;
 					if (data_continue == true || cnt > 0)
@@ -23,11 +23,11 @@ public:
 	CBashCounter();
 
 protected:
-	virtual int PreCountProcess(filemap* fmap);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
+	virtual int PreCountProcess(filemapOverlay* fmap);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak,
 		bool &data_continue, unsigned int &temp_lines, unsigned int &phys_exec_lines,
-		unsigned int &phys_data_lines, StringVector &loopLevel);
+		unsigned int &phys_data_lines, ArenaStringVector &loopLevel);
 
 	StringVector continue_keywords;		//!< List of keywords to continue to next line
 };
@@ -138,7 +138,7 @@ CCFScriptCounter::CCFScriptCounter()
 *
 * \return method status
 */
-int CCFScriptCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CCFScriptCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	unsigned int	paren_count			= 0;
 	bool			for_flag			= false;
@@ -151,9 +151,9 @@ int CCFScriptCounter::LanguageSpecificProcess(filemap* fmap, results* result, fi
 	string			strLSLOCBak			= "";
 	unsigned int	openBrackets		= 0;
 
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
-	StringVector loopLevel;
+	ArenaStringVector loopLevel(arena);
 
 	unsigned int phys_exec_lines = 0;
 	unsigned int phys_data_lines = 0;
@@ -182,7 +182,7 @@ int CCFScriptCounter::LanguageSpecificProcess(filemap* fmap, results* result, fi
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
 			}
 
 			result->exec_lines[PHY] += phys_exec_lines;
@@ -221,10 +221,10 @@ int CCFScriptCounter::LanguageSpecificProcess(filemap* fmap, results* result, fi
 * \param openBrackets number of open brackets (no matching close bracket)
 * \param loopLevel nested loop level
 */
-void CCFScriptCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+void CCFScriptCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 							 bool &forflag, bool &found_forifwhile, bool &found_while, char &prev_char, bool &data_continue,
 							 unsigned int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines, bool &inArrayDec,
-							 unsigned int &openBrackets, StringVector &loopLevel)
+							 unsigned int &openBrackets, ArenaStringVector &loopLevel)
 {
 	// paren_cnt is used with 'for' statement only
 	size_t start = 0;	//starting index of the working string
@@ -298,7 +298,7 @@ void CCFScriptCounter::LSLOC(results* result, string line, string lineBak, strin
 				if (!found_do && !found_try && !found_else)
 				{
 					// find for 'do' in string before tmp string
-					tmp = CUtil::TrimString(line.substr(start, i - start));
+					CUtil::AssignTrimString(tmp, line, start, i - start);
 					found_do = (tmp == "do");		// found 'do' statement
 					found_try = (tmp == "try");		// found 'try' statement
 					// same as else
@@ -338,7 +338,7 @@ void CCFScriptCounter::LSLOC(results* result, string line, string lineBak, strin
 			inArrayDec = false;
 
 			// check for empty statement (=1 LSLOC)
-			if (CUtil::TrimString(line.substr(start, i + 1 - start)) == ";" && strLSLOC.length() < 1)
+			if (CUtil::TrimStringEquals(line, start, i + 1 - start, ";") && strLSLOC.length() < 1)
 			{
 				strLSLOC = ";";
 				strLSLOCBak = ";";
@@ -355,7 +355,7 @@ void CCFScriptCounter::LSLOC(results* result, string line, string lineBak, strin
 			if (result->addSLOC(strLSLOCBak, trunc_flag))
 			{
 				cnt = 0;
-				CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
+				CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
 
 				temp_lines++;
 				if (data_continue == true && line[i] == ';')
@@ -393,7 +393,7 @@ void CCFScriptCounter::LSLOC(results* result, string line, string lineBak, strin
 			else
 			{
 				// handle 'for', 'while', 'if' the same way
-				tmp = CUtil::TrimString(line.substr(start,i));
+				CUtil::AssignTrimString(tmp, line, start,i);
 				if (CUtil::FindKeyword(tmp, "for", 0, TO_END_OF_STRING, false) != string::npos
 					|| CUtil::FindKeyword(tmp, "while", 0, TO_END_OF_STRING, false)!= string::npos
 					|| CUtil::FindKeyword(tmp, "if", 0, TO_END_OF_STRING, false) != string::npos)
@@ -421,7 +421,7 @@ void CCFScriptCounter::LSLOC(results* result, string line, string lineBak, strin
 						if (CUtil::FindKeyword(tmp, "if", 0, TO_END_OF_STRING, false) == string::npos)
 						{
 							unsigned int loopCnt = 0;
-							for (StringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
+							for (ArenaStringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
 							{
 								if ((*lit) != "")
 									loopCnt++;
@@ -494,18 +494,18 @@ void CCFScriptCounter::LSLOC(results* result, string line, string lineBak, strin
 	
 	}
 
-	tmp = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
 	strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 	if (strSize > 0)
 	{
 		strLSLOC += tmp.substr(0, strSize);
-		tmp = CUtil::TrimString(lineBak.substr(start, i - start));
+		CUtil::AssignTrimString(tmp, lineBak, start, i - start);
 		strLSLOCBak += tmp.substr(0, strSize);
 	}
 	
 	// make sure that we are not beginning to process a new data line
 	cnt = 0;
-	CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL, false);
+	CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL, false);
 
 	if (cnt > 0)
 		data_continue = true;
@@ -55,6 +55,60 @@ CCJavaCsCounter::CCJavaCsCounter()
 	cmplx_assign_list.push_back("=");
 }
 
+/*!
+* Counts the file with one pass over its lines for all counting steps.
+* Each line goes through the steps of CountSLOCPasses in the same order,
+* so the counts are the same as those of the multi pass engine.
+*
+* \param fmap list of file lines
+* \param result counter results
+*
+* \return true (the file is counted)
+*/
+bool CCJavaCsCounter::CountSLOCFused(filemap* fmap, results* result)
+{
+	// working copies of the file content (see CountSLOCPasses)
+	filemapOverlay fmapMod(fmap);
+	filemapOverlay fmapModBak(fmap);
+
+	bool count_comments = HasComments();
+	bool count_complexity = print_cmplx && classtype != UNKNOWN && classtype != DATAFILE;
+	commentState cmtState;
+	complexityState cmplxState(arena);
+	directiveState dirState;
+	lslocState lslState(arena);
+
+	if (count_complexity)
+		BeginComplexity(result, cmplxState);
+
+	filemapOverlay::iterator itfmBak = fmapModBak.begin();
+	for (filemapOverlay::iterator iter = fmapMod.begin(); iter != fmapMod.end(); iter++, itfmBak++)
+	{
+		PreCountLine(&fmapMod, iter);
+
+		if (CUtil::CheckBlank(iter->line))
+		{
+			// a blank line stays blank in all later steps
+			result->blank_lines++;
+			continue;
+		}
+
+		if (count_comments)
+			CountCommentsLine(&fmapMod, iter, &fmapModBak, itfmBak, result, cmtState);
+
+		if (count_complexity)
+			CountComplexityLine(iter->line, result, cmplxState);
+
+		CountDirectiveLine(&fmapMod, iter, itfmBak, result, dirState);
+
+		LanguageSpecificLine(iter, itfmBak, result, lslState);
+	}
+
+	if (count_complexity)
+		EndComplexity(result, cmplxState);
+	return true;
+}
+
 /*!
 * Counts directive lines of code.
 *
@@ -64,72 +118,87 @@ CCJavaCsCounter::CCJavaCsCounter()
 *
 * \return method status
 */
-int CCJavaCsCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CCJavaCsCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
-	bool contd = false, trunc_flag = false;
+	directiveState state;
+
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+		CountDirectiveLine(fmap, iter, itfmBak, result, state);
+	return 1;
+}
+
+/*!
+* Counts a directive line of code and blanks it.
+*
+* \param fmap list of processed file lines
+* \param iter line to process
+* \param itfmBak original line to process
+* \param result counter results
+* \param state directive state continued from the previous line
+*/
+void CCJavaCsCounter::CountDirectiveLine(filemapOverlay* fmap, filemapOverlay::iterator iter, filemapOverlay::iterator itfmBak,
+										 results* result, directiveState &state)
+{
+	bool &contd = state.contd;
+	bool &trunc_flag = state.trunc_flag;
 	size_t idx, strSize;
 	unsigned int cnt = 0;
-	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
-	string strDirLine = "";
+	string &strDirLine = state.strDirLine;
 
-	filemap::iterator itfmBak = fmapBak->begin();
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
-	{
-		if (CUtil::CheckBlank(iter->line))
-			continue;
+	if (CUtil::CheckBlank(iter->line))
+		return;
 
-		if (print_cmplx)
-		{
-			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
-		}
+	if (print_cmplx)
+	{
+		cnt = 0;
+		CountTally(" " + iter->line, directive, cnt, 1, state.exclude, "", "", &result->directive_count);
+	}
 
-		if (!contd)
+	if (!contd)
+	{
+		// if not a continuation of a previous directive
+		for (vector<string>::iterator viter = directive.begin(); viter != directive.end(); viter++)
 		{
-			// if not a continuation of a previous directive
-			for (vector<string>::iterator viter = directive.begin(); viter != directive.end(); viter++)
+			// ensures the keyword stands alone, avoid, e.g., #ifabc
+			if (((idx = CUtil::FindKeyword(iter->line, *viter)) != string::npos) && idx == 0)
 			{
-				// ensures the keyword stands alone, avoid, e.g., #ifabc
-				if (((idx = CUtil::FindKeyword(iter->line, *viter)) != string::npos) && idx == 0)
-				{
-					contd = true;
-					break;
-				}
-			}
-			if (contd)
-			{
-				strSize = CUtil::TruncateLine(itfmBak->line.length(), 0, this->lsloc_truncate, trunc_flag);
-				if (strSize > 0)
-					strDirLine = itfmBak->line.substr(0, strSize);
-				result->directive_lines[PHY]++;
+				contd = true;
+				break;
 			}
- 		}
-		else
+		}
+		if (contd)
 		{
-			// continuation of a previous directive
-			strSize = CUtil::TruncateLine(itfmBak->line.length(), strDirLine.length(), this->lsloc_truncate, trunc_flag);
+			strSize = CUtil::TruncateLine(itfmBak->line.length(), 0, this->lsloc_truncate, trunc_flag);
 			if (strSize > 0)
-				strDirLine += "\n" + itfmBak->line.substr(0, strSize);
+				strDirLine = itfmBak->line.substr(0, strSize);
 			result->directive_lines[PHY]++;
 		}
-	
-		if (contd)
-		{
-			// drop continuation symbol
-			if (strDirLine[strDirLine.length()-1] == '\\')
-				strDirLine = strDirLine.substr(0, strDirLine.length()-1);
+	}
+	else
+	{
+		// continuation of a previous directive
+		strSize = CUtil::TruncateLine(itfmBak->line.length(), strDirLine.length(), this->lsloc_truncate, trunc_flag);
+		if (strSize > 0)
+			strDirLine += "\n" + itfmBak->line.substr(0, strSize);
+		result->directive_lines[PHY]++;
+	}
 
-			// if a directive or continuation of a directive (no continuation symbol found)
-			if (iter->line[iter->line.length()-1] != ',' && iter->line[iter->line.length()-1] != '\\')
-			{
-				contd = false;
-				if (result->addSLOC(strDirLine, trunc_flag))
-					result->directive_lines[LOG]++;
-			}
-			iter->line = "";
+	if (contd)
+	{
+		// drop continuation symbol
+		if (strDirLine[strDirLine.length()-1] == '\\')
+			strDirLine = strDirLine.substr(0, strDirLine.length()-1);
+
+		// if a directive or continuation of a directive (no continuation symbol found)
+		if (iter->line[iter->line.length()-1] != ',' && iter->line[iter->line.length()-1] != '\\')
+		{
+			contd = false;
+			if (result->addSLOC(strDirLine, trunc_flag))
+				result->directive_lines[LOG]++;
 		}
+		fmap->edit(iter) = "";
 	}
-	return 1;
 }
 
 /*!
@@ -146,60 +215,55 @@ int CCJavaCsCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 *
 * \return method status
 */
-int CCJavaCsCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CCJavaCsCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
-	unsigned int	paren_count			= 0;
-	bool			for_flag			= false;
-	bool			found_for			= false;
-	bool			found_forifwhile	= false;
-	bool			found_while			= false;
-	char			prev_char			= 0;
-	bool			data_continue		= false;
-	bool			inArrayDec			= false;
-	string			strLSLOC			= "";
-	string			strLSLOCBak			= "";
-	unsigned int	openBrackets		= 0;
-
-	filemap::iterator fit, fitbak;
-	string line, lineBak;
-	StringVector loopLevel;
+	lslocState state(arena);
+
+	filemapOverlay::iterator fit, fitbak;
+	for (fit = fmap->begin(), fitbak = fmapBak->begin(); fit != fmap->end(); fit++, fitbak++)
+		LanguageSpecificLine(fit, fitbak, result, state);
+	return 1;
+}
 
+/*!
+* Processes a physical line and the logical lines it ends according to language specific rules.
+*
+* \param fit processed line (blank if it is a blank, comment or directive line)
+* \param fitbak original line
+* \param result counter results
+* \param state logical line state continued from the previous line
+*/
+void CCJavaCsCounter::LanguageSpecificLine(filemapOverlay::iterator fit, filemapOverlay::iterator fitbak, results* result, lslocState &state)
+{
 	unsigned int phys_exec_lines = 0;
 	unsigned int phys_data_lines = 0;
-	unsigned int temp_lines = 0;
 	unsigned int cnt = 0;
-	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
-
-	for (fit = fmap->begin(), fitbak = fmapBak->begin(); fit != fmap->end(); fit++, fitbak++)
+	string &line = state.line;
+	string &lineBak = state.lineBak;
+
+	// insert blank at the beginning (for searching keywords)
+	line = ' ';
+	line += fit->line;
+	lineBak = ' ';
+	lineBak += fitbak->line;
+
+	// do not process blank lines
+	// blank line means blank_line/comment_line/directive
+	if (!CUtil::CheckBlank(line))
 	{
-		line = fit->line;
+		LSLOC(result, line, lineBak, state.strLSLOC, state.strLSLOCBak, state.paren_count, state.for_flag, state.found_forifwhile,
+			state.found_while, state.prev_char, state.data_continue, state.temp_lines, phys_exec_lines, phys_data_lines,
+			state.inArrayDec, state.found_for, state.openBrackets, state.loopLevel);
 
-		// insert blank at the beginning (for searching keywords)
-		line = ' ' + line;
-		lineBak = ' ' + fitbak->line;
-	
-		// do not process blank lines
-		// blank line means blank_line/comment_line/directive
-		if (!CUtil::CheckBlank(line))
+		if (print_cmplx)
 		{
-			LSLOC(result, line, lineBak, strLSLOC, strLSLOCBak, paren_count, for_flag, found_forifwhile, found_while,
-				prev_char, data_continue, temp_lines, phys_exec_lines, phys_data_lines, inArrayDec, found_for,
-				openBrackets, loopLevel);
-
-			if (print_cmplx)
-			{
-				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
-			}
-
-			result->exec_lines[PHY] += phys_exec_lines;
-			phys_exec_lines = 0;
-
-			result->data_lines[PHY] += phys_data_lines;
-			phys_data_lines = 0;
+			cnt = 0;
+			CountTally(line, exec_name_list, cnt, 1, state.exclude, "", "", &result->exec_name_count);
 		}
+
+		result->exec_lines[PHY] += phys_exec_lines;
+		result->data_lines[PHY] += phys_data_lines;
 	}
-	return 1;
 }
 
 /*!
@@ -228,10 +292,10 @@ int CCJavaCsCounter::LanguageSpecificProcess(filemap* fmap, results* result, fil
 * \param openBrackets number of open brackets (no matching close bracket)
 * \param loopLevel nested loop level
 */
-void CCJavaCsCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+void CCJavaCsCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 							bool &forflag, bool &found_forifwhile, bool &found_while, char &prev_char, bool &data_continue,
 							unsigned int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines,
-							bool &inArrayDec, bool &found_for, unsigned int &openBrackets, StringVector &loopLevel)
+							bool &inArrayDec, bool &found_for, unsigned int &openBrackets, ArenaStringVector &loopLevel)
 {
 	// paren_cnt is used with 'for' statement only
 	size_t start = 0; //starting index of the working string
@@ -313,7 +377,7 @@ void CCJavaCsCounter::LSLOC(results* result, string line, string lineBak, string
 				if (!found_do && !found_try && !found_else)
 				{
 					// find for 'do' in string before tmp string
-					tmp = CUtil::TrimString(line.substr(start, i - start));
+					CUtil::AssignTrimString(tmp, line, start, i - start);
 					found_do = (tmp == "do");		// found 'do' statement
 					found_try = (tmp == "try");		// found 'try' statement
 					// same as else
@@ -354,7 +418,7 @@ void CCJavaCsCounter::LSLOC(results* result, string line, string lineBak, string
 			inArrayDec = false;
 
 			// check for empty statement (=1 LSLOC)
-			if (CUtil::TrimString(line.substr(start, i + 1 - start)) == ";" && strLSLOC.length() < 1)
+			if (CUtil::TrimStringEquals(line, start, i + 1 - start, ";") && strLSLOC.length() < 1)
 			{
 				strLSLOC = ";";
 				strLSLOCBak = ";";
@@ -371,7 +435,7 @@ void CCJavaCsCounter::LSLOC(results* result, string line, string lineBak, string
 			if (result->addSLOC(strLSLOCBak, trunc_flag))
 			{
 				cnt = 0;
-				CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, dataExclude, "", "", &result->data_name_count);
+				CountTally(strLSLOC, data_name_list, cnt, 1, dataExclude, "", "", &result->data_name_count);
 
 				temp_lines++;
 				if (data_continue == true && line[i] == ';')
@@ -416,7 +480,7 @@ void CCJavaCsCounter::LSLOC(results* result, string line, string lineBak, string
 			else
 			{
 				// handle 'for', 'foreach', 'while', 'if' the same way
-				tmp = CUtil::TrimString(line.substr(start, i));
+				CUtil::AssignTrimString(tmp, line, start, i);
 				if (CUtil::FindKeyword(tmp, "for") != string::npos
 					|| CUtil::FindKeyword(tmp, "foreach") != string::npos
 					|| CUtil::FindKeyword(tmp, "while") != string::npos
@@ -449,7 +513,7 @@ void CCJavaCsCounter::LSLOC(results* result, string line, string lineBak, string
 						if (CUtil::FindKeyword(tmp, "if") == string::npos)
 						{
 							unsigned int loopCnt = 0;
-							for (StringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
+							for (ArenaStringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
 							{
 								if ((*lit) != "")
 									loopCnt++;
@@ -520,12 +584,12 @@ void CCJavaCsCounter::LSLOC(results* result, string line, string lineBak, string
 		i++;
 	}
 
-	tmp = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
 	strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 	if (strSize > 0)
 	{
 		strLSLOC += tmp.substr(0, strSize);
-		tmp = CUtil::TrimString(lineBak.substr(start, i - start));
+		CUtil::AssignTrimString(tmp, lineBak, start, i - start);
 		strLSLOCBak += tmp.substr(0, strSize);
 
 		// drop continuation symbol
@@ -538,7 +602,7 @@ void CCJavaCsCounter::LSLOC(results* result, string line, string lineBak, string
 	
 	// make sure that we are not beginning to process a new data line
 	cnt = 0;
-	CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
+	CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
 
 	if (cnt > 0)
 		data_continue = true;
@@ -560,7 +624,7 @@ void CCJavaCsCounter::LSLOC(results* result, string line, string lineBak, string
 * \return 1 if function name is found
 */
 int CCJavaCsCounter::ParseFunctionName(const string &line, string &lastline,
-	filemap &functionStack, string &functionName, unsigned int &functionCount)
+	ArenaFilemap &functionStack, string &functionName, unsigned int &functionCount)
 {
 	string tline, str;
 	size_t idx, tidx, cnt, cnt2;
@@ -659,7 +723,7 @@ int CCJavaCsCounter::ParseFunctionName(const string &line, string &lastline,
 		if (idx != string::npos)
 		{
 			// search for cyclomatic complexity keywords and other possible keywords
-			CUtil::CountTally(str, cmplx_cyclomatic_list, cyclomatic_cnt, 1, exclude, "", "", 0, casesensitive);
+			CountTally(str, cmplx_cyclomatic_list, cyclomatic_cnt, 1, exclude, "", "", 0, casesensitive);
 			if (cyclomatic_cnt <= 0 && CUtil::FindKeyword(str, "switch") == string::npos &&
 				CUtil::FindKeyword(str, "try") == string::npos && CUtil::FindKeyword(str, "finally") == string::npos &&
 				CUtil::FindKeyword(str, "return") == string::npos && str.find('=') == string::npos)
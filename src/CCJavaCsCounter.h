@@ -22,14 +22,57 @@ public:
 	CCJavaCsCounter();
 
 protected:
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapmBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapmBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+	//! State of CountDirectiveLine carried from one line to the next.
+	struct directiveState
+	{
+		directiveState() : contd(false), trunc_flag(false),
+			exclude("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$") {}
+
+		bool contd;					//!< Is the directive continued on the next line?
+		bool trunc_flag;			//!< Was the directive truncated?
+		string strDirLine;			//!< Directive logical line
+		string exclude;				//!< Chars that may not surround a keyword
+	};
+
+	//! State of LanguageSpecificLine carried from one line to the next.
+	struct lslocState
+	{
+		explicit lslocState(fileArena &arena)
+			: paren_count(0), for_flag(false), found_for(false), found_forifwhile(false), found_while(false),
+			prev_char(0), data_continue(false), inArrayDec(false), openBrackets(0), temp_lines(0),
+			exclude("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$"), loopLevel(arena) {}
+
+		unsigned int paren_count;	//!< Count of parenthesis (in a for statement)
+		bool for_flag;				//!< Found for flag
+		bool found_for;				//!< Found for loop
+		bool found_forifwhile;		//!< Found for, if, or while flag
+		bool found_while;			//!< Found while flag
+		char prev_char;				//!< Previous character
+		bool data_continue;			//!< Continuation of a data declaration line
+		bool inArrayDec;			//!< Marks an array declaration
+		unsigned int openBrackets;	//!< Number of open brackets (no matching close bracket)
+		unsigned int temp_lines;	//!< Tracks physical line count
+		string strLSLOC;			//!< Processed logical string
+		string strLSLOCBak;			//!< Original logical string
+		string line;				//!< Processed line (with a leading space)
+		string lineBak;				//!< Original line (with a leading space)
+		string exclude;				//!< Chars that may not surround a keyword
+		ArenaStringVector loopLevel;	//!< Nested loop level
+	};
+
+	virtual bool CountSLOCFused(filemap* fmap, results* result);
+	virtual void PreCountLine(filemapOverlay* /*fmap*/, filemapOverlay::iterator /*iter*/) {}
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapmBak = NULL);
+	void CountDirectiveLine(filemapOverlay* fmap, filemapOverlay::iterator iter, filemapOverlay::iterator itfmBak,
+		results* result, directiveState &state);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapmBak = NULL);
+	void LanguageSpecificLine(filemapOverlay::iterator fit, filemapOverlay::iterator fitbak, results* result, lslocState &state);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 		bool &forflag, bool &found_forifwhile, bool &found_while, char &prev_char, bool &data_continue,
 		unsigned int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines,
-		bool &inArrayDec, bool &found_for, unsigned int &openBrackets, StringVector &loopLevel);
+		bool &inArrayDec, bool &found_for, unsigned int &openBrackets, ArenaStringVector &loopLevel);
 	virtual int ParseFunctionName(const string &line, string &lastline,
-		filemap &functionStack, string &functionName, unsigned int &functionCount);
+		ArenaFilemap &functionStack, string &functionName, unsigned int &functionCount);
 };
 
 #endif
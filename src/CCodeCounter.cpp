@@ -23,6 +23,10 @@ CCodeCounter::CCodeCounter()
 	lsloc_truncate = DEFAULT_TRUNCATE;
 	QuoteStart = "";
 	QuoteEnd = "";
+	commentStartCharsSet = false;
+	commentStartAnyChar = false;
+	customReplaceQuote = false;
+	commentLineKernel = NULL;
 	QuoteEscapeFront = 0;
 	QuoteEscapeRear = 0;
 	ContinueLine = "";
@@ -90,21 +94,54 @@ void CCodeCounter::InitializeResultsCounts(results* result)
 
 /*!
 * Processes and counts the source file.
+* Languages with a fused engine count the file in one pass over its lines
+* unless the multi pass engine is selected (-engine).
+*
+* \Global g_count_engine	IN		counting engine
 *
 * \param fmap list of file lines
 * \param result counter results
 *
-* \return method status
+* \return method status (COUNT_ENGINES_DIFFER if the engines being verified disagree)
 */
 int CCodeCounter::CountSLOC(filemap* fmap, results* result)
 {
-	// backup file content before modifying it (comments and directive lines are cleared)
+	// all containers using the arena are local to the counting passes
+	fileArenaReset arenaReset(arena);
+	int status = 0;
+
+	InitializeResultsCounts(result);
+
+	if (g_count_engine == COUNT_ENGINE_VERIFY)
+	{
+		// count with both engines and keep the multi pass results
+		results fusedResult(*result);
+		bool fused = CountSLOCFused(fmap, &fusedResult);
+		arena.reset();
+		CountSLOCPasses(fmap, result);
+		if (fused && !SameCounts(*result, fusedResult))
+			status = COUNT_ENGINES_DIFFER;
+	}
+	else if (g_count_engine == COUNT_ENGINE_PASSES || !CountSLOCFused(fmap, result))
+		CountSLOCPasses(fmap, result);
+
+	return status;
+}
+
+/*!
+* Counts the source file with one pass over its lines for each counting step.
+*
+* \param fmap list of file lines
+* \param result counter results
+*/
+void CCodeCounter::CountSLOCPasses(filemap* fmap, results* result)
+{
+	// working copies of the file content (comments and directive lines are cleared)
 	// fmapBak is same as fmap except that it stores unmodified quoted strings
 	// fmap has quoted strings replaced with '$'
-	filemap fmapMod = *fmap;
-	filemap fmapModBak = *fmap;
-	
-	InitializeResultsCounts(result);
+	// both read through to the original lines and only copy the lines they rewrite
+	filemapOverlay fmapMod(fmap);
+	filemapOverlay fmapModBak(fmap);
 
 	PreCountProcess(&fmapMod);
 
@@ -118,8 +155,62 @@ int CCodeCounter::CountSLOC(filemap* fmap, results* result)
 	CountDirectiveSLOC(&fmapMod, result, &fmapModBak);
 
 	LanguageSpecificProcess(&fmapMod, result, &fmapModBak);
+}
 
-	return 0;
+/*!
+* Checks whether two results of the same file have the same counts.
+* Logical lines are compared as sets since the engines may store them in a different order.
+*
+* \param res1 first results
+* \param res2 second results
+*
+* \return same counts?
+*/
+bool CCodeCounter::SameCounts(results &res1, results &res2)
+{
+	if (res1.blank_lines != res2.blank_lines || res1.comment_lines != res2.comment_lines ||
+		res1.e_comm_lines != res2.e_comm_lines || res1.total_lines != res2.total_lines ||
+		res1.trunc_lines != res2.trunc_lines)
+		return false;
+	for (int i = PHY; i <= LOG; i++)
+	{
+		if (res1.directive_lines[i] != res2.directive_lines[i] || res1.data_lines[i] != res2.data_lines[i] ||
+			res1.exec_lines[i] != res2.exec_lines[i] || res1.SLOC_lines[i] != res2.SLOC_lines[i])
+			return false;
+	}
+	if (res1.cmplx_math_lines != res2.cmplx_math_lines || res1.cmplx_trig_lines != res2.cmplx_trig_lines ||
+		res1.cmplx_logarithm_lines != res2.cmplx_logarithm_lines || res1.cmplx_calc_lines != res2.cmplx_calc_lines ||
+		res1.cmplx_cond_lines != res2.cmplx_cond_lines || res1.cmplx_logic_lines != res2.cmplx_logic_lines ||
+		res1.cmplx_preproc_lines != res2.cmplx_preproc_lines || res1.cmplx_assign_lines != res2.cmplx_assign_lines ||
+		res1.cmplx_pointer_lines != res2.cmplx_pointer_lines)
+		return false;
+	if (res1.directive_count != res2.directive_count || res1.data_name_count != res2.data_name_count ||
+		res1.exec_name_count != res2.exec_name_count || res1.math_func_count != res2.math_func_count ||
+		res1.trig_func_count != res2.trig_func_count || res1.log_func_count != res2.log_func_count ||
+		res1.cmplx_calc_count != res2.cmplx_calc_count || res1.cmplx_cond_count != res2.cmplx_cond_count ||
+		res1.cmplx_logic_count != res2.cmplx_logic_count || res1.cmplx_preproc_count != res2.cmplx_preproc_count ||
+		res1.cmplx_assign_count != res2.cmplx_assign_count || res1.cmplx_pointer_count != res2.cmplx_pointer_count ||
+		res1.cmplx_nestloop_count != res2.cmplx_nestloop_count)
+		return false;
+
+	if (res1.cmplx_cycfunct_count.size() != res2.cmplx_cycfunct_count.size())
+		return false;
+	for (size_t i = 0; i < res1.cmplx_cycfunct_count.size(); i++)
+	{
+		if (res1.cmplx_cycfunct_count[i].lineNumber != res2.cmplx_cycfunct_count[i].lineNumber ||
+			res1.cmplx_cycfunct_count[i].line != res2.cmplx_cycfunct_count[i].line)
+			return false;
+	}
+
+	if (res1.mySLOCLines.size() != res2.mySLOCLines.size())
+		return false;
+	for (srcLineVector::iterator it = res1.mySLOCLines.begin(); it != res1.mySLOCLines.end(); it++)
+	{
+		srcLineVector::iterator it2 = res2.mySLOCLines.find(it->id);
+		if (it2 == res2.mySLOCLines.end() || it2->count != it->count)
+			return false;
+	}
+	return true;
 }
 
 /*!
@@ -249,6 +340,47 @@ void CCodeCounter::CloseOutputStream()
 		output_file_csv.close();
 }
 
+/*!
+* Checks whether a char is escaped (preceded by an odd number of escape chars).
+*
+* \param strline string line
+* \param idx index of the char
+* \param escape escape character (see Traits::escapeFront)
+*
+* \return is the char escaped?
+*/
+template <class Traits>
+static inline bool IsEscaped(string const &strline, size_t idx, char escape)
+{
+	size_t i;
+	escape = Traits::escapeFront(escape);
+	for (i = 1; i <= idx; i++)
+	{
+		if (strline[idx - i] != escape)
+			break;
+	}
+	return (i % 2 == 0);
+}
+
+/*!
+* Matches a line comment delimiter at a position (see CUtil::MatchAt).
+*
+* \param strline string line
+* \param pos position in the line
+* \param delimiter comment delimiter
+* \param case_sensitive is the delimiter case sensitive? (see Traits::caseSensitive)
+*
+* \return does the delimiter start at the position?
+*/
+template <class Traits>
+static inline bool MatchLineComment(string const &strline, size_t pos, string const &delimiter, bool case_sensitive)
+{
+	if (!Traits::caseSensitive(case_sensitive))
+		return CUtil::MatchAt(strline, pos, delimiter, false);
+	return (pos <= strline.length() && strline.length() - pos >= delimiter.length() &&
+		strline.compare(pos, delimiter.length(), delimiter) == 0);
+}
+
 /*!
 * Finds the first index of one of the characters of strQuote in strline.
 *
@@ -261,16 +393,30 @@ void CCodeCounter::CloseOutputStream()
 */
 size_t CCodeCounter::FindQuote(string const &strline, string const &strQuote, size_t idx_start, char QuoteEscapeFront)
 {
-	size_t min_idx, idx;
-	min_idx = strline.length();
-	for (size_t i = 0; i < strQuote.length(); i++)
+	return FindQuoteKernel<runtimeLangTraits>(strline, strQuote, idx_start, QuoteEscapeFront);
+}
+
+/*!
+* Finds the first index of one of the characters of strQuote in strline (see FindQuote).
+*
+* \param strline string line
+* \param strQuote string of character(s) to find in strline
+* \param idx_start index of line character to start search
+* \param QuoteEscapeFront quote escape character
+*
+* \return index of strQuote character in strline
+*/
+template <class Traits>
+size_t CCodeCounter::FindQuoteKernel(string const &strline, string const &strQuote, size_t idx_start, char QuoteEscapeFront)
+{
+	size_t idx = idx_start;
+	while ((idx = CUtil::FindFirstOf(strline, strQuote, idx)) != string::npos)
 	{
-		idx = CUtil::FindCharAvoidEscape(strline, strQuote[i], idx_start, QuoteEscapeFront);
-		if (idx != string::npos && idx < min_idx)
-			min_idx = idx;
+		// skip quote chars preceded by an odd number of escape chars
+		if (!IsEscaped<Traits>(strline, idx, QuoteEscapeFront))
+			return idx;
+		idx++;
 	}
-	if (min_idx < strline.length())
-		return min_idx;
 	return string::npos;
 }
 
@@ -285,6 +431,22 @@ size_t CCodeCounter::FindQuote(string const &strline, string const &strQuote, si
 * \return method status
 */
 int CCodeCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd, char &CurrentQuoteEnd)
+{
+	return ReplaceQuoteKernel<runtimeLangTraits>(strline, idx_start, contd, CurrentQuoteEnd);
+}
+
+/*!
+* Replaces up to ONE quoted string inside a string starting at idx_start (see ReplaceQuote).
+*
+* \param strline string to be processed
+* \param idx_start index of line character to start search
+* \param contd specifies the quote string is continued from the previous line
+* \param CurrentQuoteEnd end quote character of the current status
+*
+* \return method status
+*/
+template <class Traits>
+int CCodeCounter::ReplaceQuoteKernel(string &strline, size_t &idx_start, bool &contd, char &CurrentQuoteEnd)
 {
 	size_t idx_end, idx_quote;
 
@@ -302,7 +464,7 @@ int CCodeCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd,
 	else
 	{
 		// handle two quote chars in some languages, both " and ' may be accepted
-		idx_start = FindQuote(strline, QuoteStart, idx_start, QuoteEscapeFront);
+		idx_start = FindQuoteKernel<Traits>(strline, QuoteStart, idx_start, QuoteEscapeFront);
 		if (idx_start != string::npos)
 		{
 			idx_quote = QuoteStart.find_first_of(strline[idx_start]);
@@ -315,7 +477,10 @@ int CCodeCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd,
 		}
 	}
 
-	idx_end = CUtil::FindCharAvoidEscape(strline, CurrentQuoteEnd, idx_start + 1, QuoteEscapeFront);
+	// end quote not escaped (see CUtil::FindCharAvoidEscape)
+	idx_end = idx_start + 1;
+	while ((idx_end = strline.find(CurrentQuoteEnd, idx_end)) != string::npos && IsEscaped<Traits>(strline, idx_end, QuoteEscapeFront))
+		idx_end++;
 	if (idx_end == string::npos)
 	{
 		idx_end = strline.length() - 1;
@@ -325,7 +490,8 @@ int CCodeCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd,
 	}
 	else
 	{
-		if ((QuoteEscapeRear) && (strline.length() > idx_end + 1) && (strline[idx_end+1] == QuoteEscapeRear))
+		char escapeRear = Traits::escapeRear(QuoteEscapeRear);
+		if ((escapeRear) && (strline.length() > idx_end + 1) && (strline[idx_end+1] == escapeRear))
 		{
 			strline[idx_end] = '$';
 			strline[idx_end+1] = '$';
@@ -348,9 +514,9 @@ int CCodeCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd,
 *
 * \return method status
 */
-int CCodeCounter::CountBlankSLOC(filemap* fmap, results* result)
+int CCodeCounter::CountBlankSLOC(filemapOverlay* fmap, results* result)
 {
-	for (filemap::iterator i = fmap->begin(); i != fmap->end(); i++)
+	for (filemapOverlay::iterator i = fmap->begin(); i != fmap->end(); i++)
 	{
 		if (CUtil::CheckBlank(i->line))
 			result->blank_lines++;
@@ -369,16 +535,105 @@ int CCodeCounter::CountBlankSLOC(filemap* fmap, results* result)
 *
 * \return method status
 */
-int CCodeCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fmapBak)
+int CCodeCounter::CountCommentsSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
-	if (BlockCommentStart.empty() && LineCommentStart.empty())
+	if (!HasComments())
 		return 0;
+
+	if (commentLineKernel == NULL)
+		SelectKernels();
+
+	commentState state;
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+		(this->*commentLineKernel)(fmap, iter, fmapBak, itfmBak, result, state);
+	return 1;
+}
+
+/*!
+* Selects the kernels instantiated for the quote and comment rules of the counter.
+* The rules of the built-in languages are fixed at compile time, any other counter
+* (or one overriding ReplaceQuote) uses the kernels reading the rules from the counter.
+*/
+void CCodeCounter::SelectKernels()
+{
+	commentLineKernel = &CCodeCounter::CountCommentsLineKernel<runtimeLangTraits>;
+	if (customReplaceQuote)
+		return;
+
+	if (casesensitive)
+	{
+		if (QuoteEscapeFront == '\\' && QuoteEscapeRear == 0)			// C/C++, Java, Bash, PHP
+			commentLineKernel = &CCodeCounter::CountCommentsLineKernel< fixedLangTraits<true, '\\', 0> >;
+		else if (QuoteEscapeFront == 0 && QuoteEscapeRear == 0)		// CSS, HTML, XML, Makefile
+			commentLineKernel = &CCodeCounter::CountCommentsLineKernel< fixedLangTraits<true, 0, 0> >;
+		else if (QuoteEscapeFront == 0 && QuoteEscapeRear == '\'')		// MATLAB
+			commentLineKernel = &CCodeCounter::CountCommentsLineKernel< fixedLangTraits<true, 0, '\''> >;
+		else if (QuoteEscapeFront == '\"' && QuoteEscapeRear == 0)		// Verilog
+			commentLineKernel = &CCodeCounter::CountCommentsLineKernel< fixedLangTraits<true, '\"', 0> >;
+	}
+	else
+	{
+		if (QuoteEscapeFront == 0 && QuoteEscapeRear == 0)				// ColdFusion script, tag languages
+			commentLineKernel = &CCodeCounter::CountCommentsLineKernel< fixedLangTraits<false, 0, 0> >;
+		else if (QuoteEscapeFront == 0 && QuoteEscapeRear == '\"')		// Visual Basic
+			commentLineKernel = &CCodeCounter::CountCommentsLineKernel< fixedLangTraits<false, 0, '\"'> >;
+		else if (QuoteEscapeFront == '\"' && QuoteEscapeRear == 0)		// Midas
+			commentLineKernel = &CCodeCounter::CountCommentsLineKernel< fixedLangTraits<false, '\"', 0> >;
+	}
+}
+
+/*!
+* Checks whether comments are counted for the language.
+*
+* \return does the language have comments?
+*/
+bool CCodeCounter::HasComments() const
+{
+	if (BlockCommentStart.empty() && LineCommentStart.empty())
+		return false;
 	if (classtype == UNKNOWN || classtype == DATAFILE)
-		return 0;
+		return false;
+	return true;
+}
 
-	bool contd = false;
-	bool contd_nextline;
-	int comment_type = 0;
+/*!
+* Counts a comment line, removes its comments, and
+* replaces its quoted strings by special chars, e.g., $
+*
+* \param fmap list of processed file lines
+* \param iter line to process
+* \param fmapBak list of original file lines (same as fmap except it contains unmodified quoted strings)
+* \param itfmBak original line to process
+* \param result counter results
+* \param state comment and quote state continued from the previous line
+*/
+void CCodeCounter::CountCommentsLine(filemapOverlay* fmap, filemapOverlay::iterator iter, filemapOverlay* fmapBak,
+									 filemapOverlay::iterator itfmBak, results* result, commentState &state)
+{
+	if (commentLineKernel == NULL)
+		SelectKernels();
+	(this->*commentLineKernel)(fmap, iter, fmapBak, itfmBak, result, state);
+}
+
+/*!
+* Counts a comment line, removes its comments, and
+* replaces its quoted strings by special chars, e.g., $ (see CountCommentsLine)
+*
+* \param fmap list of processed file lines
+* \param iter line to process
+* \param fmapBak list of original file lines (same as fmap except it contains unmodified quoted strings)
+* \param itfmBak original line to process
+* \param result counter results
+* \param state comment and quote state continued from the previous line
+*/
+template <class Traits>
+void CCodeCounter::CountCommentsLineKernel(filemapOverlay* fmap, filemapOverlay::iterator iter, filemapOverlay* fmapBak,
+										   filemapOverlay::iterator itfmBak, results* result, commentState &state)
+{
+	bool &contd = state.contd;
+	bool contd_nextline = false;
+	int &comment_type = state.comment_type;
 	/*
 	comment_type:
 	0 : not a comment
@@ -388,144 +643,139 @@ int CCodeCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fma
 	4 : block comment, embedded
 	*/
 
-	size_t idx_start, idx_end, comment_start;
-	size_t quote_idx_start;
-	string curBlckCmtStart, curBlckCmtEnd;
-	char CurrentQuoteEnd = 0;
-	bool quote_contd = false;
-	filemap::iterator itfmBak = fmapBak->begin();
+	size_t idx_start = 0, idx_end, comment_start;
+	size_t quote_idx_start = 0;
+	string &curBlckCmtStart = state.curBlckCmtStart;
+	string &curBlckCmtEnd = state.curBlckCmtEnd;
+	char &CurrentQuoteEnd = state.CurrentQuoteEnd;
+	bool &quote_contd = state.quote_contd;
 
-	quote_idx_start = 0;
-
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	if (CUtil::CheckBlank(iter->line))
+		return;
+	if (quote_contd)
 	{
-		contd_nextline = false;
-
-		quote_idx_start = 0;
-		idx_start = 0;
-
-		if (CUtil::CheckBlank(iter->line))
-			continue;
+		// Replace quote until next character
+		if (Traits::virtualQuote())
+			ReplaceQuote(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
+		else
+			ReplaceQuoteKernel<Traits>(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
 		if (quote_contd)
-		{
-			// Replace quote until next character
-			ReplaceQuote(iter->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
-			if (quote_contd)
-				continue;
-		}
+			return;
+	}
 
-		if (contd)
-			comment_type = 3;
+	if (contd)
+		comment_type = 3;
 
-		while (!contd_nextline && idx_start < iter->line.length())
-		{
-			// need to handle multiple quote chars in some languages, both " and ' may be accepted
-			quote_idx_start = FindQuote(iter->line, QuoteStart, quote_idx_start, QuoteEscapeFront);
-			comment_start = idx_start;
-			if (!contd)
-				FindCommentStart(iter->line, comment_start, comment_type, curBlckCmtStart, curBlckCmtEnd);
+	while (!contd_nextline && idx_start < iter->line.length())
+	{
+		// need to handle multiple quote chars in some languages, both " and ' may be accepted
+		quote_idx_start = FindQuoteKernel<Traits>(iter->line, QuoteStart, quote_idx_start, QuoteEscapeFront);
+		comment_start = idx_start;
+		if (!contd)
+			FindCommentStartKernel<Traits>(iter->line, comment_start, comment_type, curBlckCmtStart, curBlckCmtEnd);
 
-			if (comment_start == string::npos && quote_idx_start == string::npos)
-				break;
+		if (comment_start == string::npos && quote_idx_start == string::npos)
+			break;
 
-			if (comment_start != string::npos)
-				idx_start = comment_start;
+		if (comment_start != string::npos)
+			idx_start = comment_start;
 
-			// if found quote before comment, e.g., "this is quote");//comment
-			if (quote_idx_start != string::npos && (comment_start == string::npos || quote_idx_start < comment_start))
+		// if found quote before comment, e.g., "this is quote");//comment
+		if (quote_idx_start != string::npos && (comment_start == string::npos || quote_idx_start < comment_start))
+		{
+			if (Traits::virtualQuote())
+				ReplaceQuote(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
+			else
+				ReplaceQuoteKernel<Traits>(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
+			if (quote_idx_start > idx_start && quote_idx_start != iter->line.length())
 			{
-				ReplaceQuote(iter->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
-				if (quote_idx_start > idx_start && quote_idx_start != iter->line.length())
-				{
-					// comment delimiter inside quote
-					idx_start = quote_idx_start;
-					continue;
-				}
+				// comment delimiter inside quote
+				idx_start = quote_idx_start;
+				continue;
 			}
-			else if (comment_start != string::npos)
+		}
+		else if (comment_start != string::npos)
+		{
+			// comment delimiter starts first
+			switch (comment_type)
 			{
-				// comment delimiter starts first
-				switch (comment_type)
+			case 1:	// line comment, definitely whole line
+				fmap->edit(iter) = "";
+				fmapBak->edit(itfmBak) = "";
+				result->comment_lines++;
+				contd_nextline = true;
+				break;
+			case 2:	// line comment, possibly embedded
+				fmap->edit(iter) = iter->line.substr(0, idx_start);
+				fmapBak->edit(itfmBak) = itfmBak->line.substr(0, idx_start);
+				// trim trailing space
+				fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+				fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
+				if (iter->line.empty())
+					result->comment_lines++;	// whole line
+				else
+					result->e_comm_lines++;		// embedded
+				contd_nextline = true;
+				break;
+			case 3:	// block comment
+			case 4:
+				if (contd)
+					idx_end = iter->line.find(curBlckCmtEnd);
+				else
+					idx_end = iter->line.find(curBlckCmtEnd, idx_start + curBlckCmtStart.length());
+
+				if (idx_end == string::npos)
 				{
-				case 1:	// line comment, definitely whole line
-					iter->line = "";
-					itfmBak->line = "";
-					result->comment_lines++;
+					if (comment_type == 3)
+					{
+						fmap->edit(iter) = "";
+						fmapBak->edit(itfmBak) = "";
+						result->comment_lines++;
+					}
+					else if (comment_type == 4)
+					{
+						fmap->edit(iter) = iter->line.substr(0, idx_start);
+						fmapBak->edit(itfmBak) = itfmBak->line.substr(0, idx_start);
+						// trim trailing space
+						fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+						fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
+						if (iter->line.empty())
+							result->comment_lines++;	// whole line
+						else
+							result->e_comm_lines++;		// embedded
+					}
+					contd = true;
 					contd_nextline = true;
 					break;
-				case 2:	// line comment, possibly embedded
-					iter->line = iter->line.substr(0, idx_start);
-					itfmBak->line = itfmBak->line.substr(0, idx_start);
-					// trim trailing space
-					iter->line = CUtil::TrimString(iter->line, 1);
-					itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+				}
+				else
+				{
+					contd = false;
+					fmap->edit(iter).erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
+					fmapBak->edit(itfmBak).erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
 					if (iter->line.empty())
-						result->comment_lines++;	// whole line
+						result->comment_lines++;
 					else
-						result->e_comm_lines++;		// embedded
-					contd_nextline = true;
-					break;
-				case 3:	// block comment
-				case 4:
-					if (contd)
-						idx_end = iter->line.find(curBlckCmtEnd);
-					else
-						idx_end = iter->line.find(curBlckCmtEnd, idx_start + curBlckCmtStart.length());
-
-					if (idx_end == string::npos)
 					{
-						if (comment_type == 3)
-						{
-							iter->line = "";
-							itfmBak->line = "";
-							result->comment_lines++;
-						}
-						else if (comment_type == 4)
-						{
-							iter->line = iter->line.substr(0, idx_start);
-							itfmBak->line = itfmBak->line.substr(0, idx_start);
-							// trim trailing space
-							iter->line = CUtil::TrimString(iter->line, 1);
-							itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
-							if (iter->line.empty())
-								result->comment_lines++;	// whole line
-							else
-								result->e_comm_lines++;		// embedded
-						}
-						contd = true;
-						contd_nextline = true;
-						break;
-					}
-					else
-					{
-						contd = false;
-						iter->line.erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
-						itfmBak->line.erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
+						// trim trailing space
+						fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+						fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 						if (iter->line.empty())
-							result->comment_lines++;
+							result->comment_lines++;	// whole line
 						else
-						{
-							// trim trailing space
-							iter->line = CUtil::TrimString(iter->line, 1);
-							itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
-							if (iter->line.empty())
-								result->comment_lines++;	// whole line
-							else
-								result->e_comm_lines++;		// embedded
-						}
-
-						// quote chars found may be erased as it is inside comment
-						quote_idx_start = idx_start;
+							result->e_comm_lines++;		// embedded
 					}
-					break;
-				default:
-					cout << "Error in CountCommentsSLOC()" << endl;
-					break;
+
+					// quote chars found may be erased as it is inside comment
+					quote_idx_start = idx_start;
 				}
+				break;
+			default:
+				cout << "Error in CountCommentsSLOC()" << endl;
+				break;
 			}
 		}
 	}
-	return 1;
 }
 
 /*!
@@ -539,54 +789,172 @@ int CCodeCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fma
 *
 * \return method status
 */
-int CCodeCounter::FindCommentStart(string strline, size_t &idx_start, int &comment_type,
-								   string &curBlckCmtStart, string &curBlckCmtEnd) 
+int CCodeCounter::FindCommentStart(const string &strline, size_t &idx_start, int &comment_type,
+								   string &curBlckCmtStart, string &curBlckCmtEnd)
 {
-	size_t idx_line, idx_tmp, idx_block;
-	string line = strline;
+	return FindCommentStartKernel<runtimeLangTraits>(strline, idx_start, comment_type, curBlckCmtStart, curBlckCmtEnd);
+}
+
+/*!
+* Finds a starting position of a comment in a string starting at idx_start (see FindCommentStart).
+*
+* \param strline string to be processed
+* \param idx_start index of line character to start search
+* \param comment_type comment type (0=not a comment, 1=whole line, 2=embedded line, 3=whole line block, 4=embedded block)
+* \param curBlckCmtStart current block comment start string
+* \param curBlckCmtEnd current block comment end string
+*
+* \return method status
+*/
+template <class Traits>
+int CCodeCounter::FindCommentStartKernel(const string &strline, size_t &idx_start, int &comment_type,
+										 string &curBlckCmtStart, string &curBlckCmtEnd)
+{
+	size_t idx;
 	comment_type = 0;
 
-	if (!casesensitive)
-		line = CUtil::ToLower(line);
+	if (!commentStartCharsSet)
+		SetCommentStartChars();
 
-	// searching for starting of line comment
-	idx_line = string::npos;
-	for (StringVector::iterator i = LineCommentStart.begin(); i != LineCommentStart.end(); i++)
+	// verify the comment delimiters only where one of their first chars appears
+	idx = idx_start;
+	while (idx != string::npos)
 	{
-		idx_tmp = line.find((casesensitive ? (*i) : CUtil::ToLower(*i)), idx_start);
-		if (idx_tmp < idx_line) idx_line = idx_tmp;
-	}
+		if (!commentStartAnyChar)
+		{
+			idx = CUtil::FindFirstOf(strline, commentStartChars, idx);
+			if (idx == string::npos)
+				break;
+		}
+		else if (idx > strline.length())
+			break;
 
-	// searching for starting of block comment
-	idx_block = string::npos;
-	for (StringVector::iterator i = BlockCommentStart.begin(); i != BlockCommentStart.end(); i++)
-	{
-		idx_tmp = strline.find(*i, idx_start);
-		if (idx_tmp < idx_block)
+		// a block comment takes precedence over a line comment at the same position
+		for (size_t i = 0; i < BlockCommentStart.size(); i++)
+		{
+			if (CUtil::MatchAt(strline, idx, BlockCommentStart[i]))
+			{
+				curBlckCmtStart = BlockCommentStart[i];
+				curBlckCmtEnd = BlockCommentEnd[i];
+				idx_start = idx;
+				comment_type = idx_start == 0 ? 3 : 4;
+				return 1;
+			}
+		}
+		for (size_t i = 0; i < LineCommentStart.size(); i++)
 		{
-			idx_block = idx_tmp;
-			curBlckCmtStart = *i;
-			curBlckCmtEnd = *(BlockCommentEnd.begin() + (i - BlockCommentStart.begin()));
+			if (MatchLineComment<Traits>(strline, idx, LineCommentStart[i], casesensitive))
+			{
+				idx_start = idx;
+				comment_type = idx_start == 0 ? 1 : 2;
+				return 1;
+			}
 		}
+		idx++;
 	}
+	idx_start = string::npos;
+	return 1;
+}
 
-	// see what kind of comment appears first
-	if (idx_line == string::npos && idx_block == string::npos)
-	{
-		comment_type = 0;
-		idx_start = idx_line;
-	}
-	else if (idx_block > idx_line)
+/*!
+* Collects the chars that may start a line or block comment (see FindCommentStart).
+*/
+void CCodeCounter::SetCommentStartChars()
+{
+	commentStartChars = "";
+	commentStartAnyChar = false;
+	for (size_t i = 0; i < BlockCommentStart.size() + LineCommentStart.size(); i++)
 	{
-		idx_start = idx_line;
-		comment_type = idx_start == 0 ? 1 : 2;
+		bool block = (i < BlockCommentStart.size());
+		const string &delimiter = block ? BlockCommentStart[i] : LineCommentStart[i - BlockCommentStart.size()];
+		if (delimiter.empty())
+		{
+			commentStartAnyChar = true;
+			continue;
+		}
+		char c = delimiter[0];
+		if (commentStartChars.find(c) == string::npos)
+			commentStartChars += c;
+		if (!block && !casesensitive)
+		{
+			char lower = (char)tolower((unsigned char)c), upper = (char)toupper((unsigned char)c);
+			if (commentStartChars.find(lower) == string::npos)
+				commentStartChars += lower;
+			if (commentStartChars.find(upper) == string::npos)
+				commentStartChars += upper;
+		}
 	}
-	else
+	commentStartCharsSet = true;
+}
+
+/*!
+* Counts keywords in string (see CUtil::CountTally).
+* Each keyword list of the counter is compiled once and kept for later calls.
+*
+* \param base string to search
+* \param container set of keywords
+* \param count number of keywords found
+* \param mode allowable leading/trailing character mode (1=exclude keywords surrounded by exclude characters, 2=include only keywords preceded by include1 characters and followed by include2 characters)
+* \param exclude list of characters that may not surround keywords found (if mode=1)
+* \param include1 list of characters that must precede keywords found (if mode=2)
+* \param include2 list of characters that must follow keywords found (if mode=2)
+* \param counter_container stores list of individual keyword counts (if specified)
+* \param case_sensitive language is case sensitive?
+*/
+void CCodeCounter::CountTally(const string &base, StringVector &container, unsigned int &count, int mode, const string &exclude,
+							  const string &include1, const string &include2, UIntVector *counter_container, bool case_sensitive)
+{
+	CUtil::CountTally(base, container, keywordMatchers[&container], count, mode, exclude,
+		include1, include2, counter_container, case_sensitive);
+}
+
+/*!
+* Counts the complexity keywords of a line in a single pass: the math, trig, log, calc,
+* cond, logic, preproc, assign and pointer lists, and the cyclomatic lists if requested.
+* Same as calling CountTally (mode 1) once per list. The lists are compiled into one
+* classifier on first use, since a language may set its lists after construction.
+*
+* \param line line to search
+* \param exclude list of characters that may not surround keywords found
+* \param logic_list logical operator list to count
+* \param assign_list assignment list to count
+* \param result counter results
+* \param cyclomatic_cnt cyclomatic complexity keyword count (if specified)
+* \param ignore_cyclomatic_cnt count of cyclomatic complexity keywords to ignore (if cyclomatic_cnt specified)
+*/
+void CCodeCounter::CountComplexityTallies(const string &line, const string &exclude, StringVector &logic_list, StringVector &assign_list,
+										  results* result, unsigned int *cyclomatic_cnt, unsigned int *ignore_cyclomatic_cnt)
+{
+	StringVector *lists[CMPLX_LIST_COUNT] = {
+		&math_func_list, &trig_func_list, &log_func_list, &cmplx_calc_list, &cmplx_cond_list, &logic_list,
+		&cmplx_preproc_list, &assign_list, &cmplx_pointer_list, &cmplx_cyclomatic_list, &ignore_cmplx_cyclomatic_list
+	};
+	UIntVector *counter_containers[CMPLX_LIST_COUNT] = {
+		&result->math_func_count, &result->trig_func_count, &result->log_func_count, &result->cmplx_calc_count,
+		&result->cmplx_cond_count, &result->cmplx_logic_count, &result->cmplx_preproc_count, &result->cmplx_assign_count,
+		&result->cmplx_pointer_count, 0, 0
+	};
+	unsigned int counts[CMPLX_LIST_COUNT] = {0};
+	size_t num_lists = cyclomatic_cnt ? CMPLX_LIST_COUNT : CMPLX_CYCLOMATIC;
+
+	if (!cmplxMatcher.IsCompiledFor(lists, num_lists, casesensitive))
+		cmplxMatcher.Compile(lists, num_lists, casesensitive);
+	cmplxMatcher.CountTallies(line, exclude, counts, counter_containers);
+
+	result->cmplx_math_lines += counts[CMPLX_MATH];
+	result->cmplx_trig_lines += counts[CMPLX_TRIG];
+	result->cmplx_logarithm_lines += counts[CMPLX_LOG];
+	result->cmplx_calc_lines += counts[CMPLX_CALC];
+	result->cmplx_cond_lines += counts[CMPLX_COND];
+	result->cmplx_logic_lines += counts[CMPLX_LOGIC];
+	result->cmplx_preproc_lines += counts[CMPLX_PREPROC];
+	result->cmplx_assign_lines += counts[CMPLX_ASSIGN];
+	result->cmplx_pointer_lines += counts[CMPLX_POINTER];
+	if (cyclomatic_cnt)
 	{
-		idx_start = idx_block;
-		comment_type = idx_start == 0 ? 3 : 4;
+		*cyclomatic_cnt += counts[CMPLX_CYCLOMATIC];
+		*ignore_cyclomatic_cnt += counts[CMPLX_IGNORE_CYCLOMATIC];
 	}
-	return 1;
 }
 
 /*!
@@ -597,24 +965,37 @@ int CCodeCounter::FindCommentStart(string strline, size_t &idx_start, int &comme
 *
 * \return method status
 */
-int CCodeCounter::CountComplexity(filemap* fmap, results* result)
+int CCodeCounter::CountComplexity(filemapOverlay* fmap, results* result)
 {
 	if (classtype == UNKNOWN || classtype == DATAFILE)
 		return 0;
-	filemap::iterator fit;
+
+	complexityState state(arena);
+	BeginComplexity(result, state);
+
+	// process each line
+	for (filemapOverlay::iterator fit = fmap->begin(); fit != fmap->end(); fit++)
+		CountComplexityLine(fit->line, result, state);
+
+	EndComplexity(result, state);
+	return 1;
+}
+
+/*!
+* Starts counting the complexity of a file.
+*
+* \param result counter results
+* \param state complexity state to set up
+*/
+void CCodeCounter::BeginComplexity(results* result, complexityState &state)
+{
 	size_t idx;
-	unsigned int cnt, ret, cyclomatic_cnt = 0, ignore_cyclomatic_cnt = 0, main_cyclomatic_cnt = 0, function_count = 0;
-	string line, lastline, file_ext, function_name = "";
-	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
-	filemap function_stack;
-	stack<unsigned int> cyclomatic_stack;
-	map<unsigned int, lineElement> function_map;
-	bool process_cyclomatic_complexity = false;
+	string file_ext;
 
 	// check whether to process cyclomatic complexity
 	if (cmplx_cyclomatic_list.size() > 0)
 	{
-		process_cyclomatic_complexity = true;
+		state.process_cyclomatic_complexity = true;
 		if (skip_cmplx_cyclomatic_file_extension_list.size() > 0)
 		{
 			idx = result->file_name.find_last_of(".");
@@ -623,161 +1004,137 @@ int CCodeCounter::CountComplexity(filemap* fmap, results* result)
 				file_ext = result->file_name.substr(idx);
 				file_ext = CUtil::ToLower(file_ext);
 				if (find(skip_cmplx_cyclomatic_file_extension_list.begin(), skip_cmplx_cyclomatic_file_extension_list.end(), file_ext) != skip_cmplx_cyclomatic_file_extension_list.end())
-					process_cyclomatic_complexity = false;
+					state.process_cyclomatic_complexity = false;
 			}
 		}
 	}
+}
 
-	// process each line
-	for (fit = fmap->begin(); fit != fmap->end(); fit++)
-	{
-		line = fit->line;
+/*!
+* Counts the complexity keywords of a line and follows the functions for cyclomatic complexity.
+*
+* \param text processed line
+* \param result counter results
+* \param state complexity state continued from the previous line
+*/
+void CCodeCounter::CountComplexityLine(const string &text, results* result, complexityState &state)
+{
+	unsigned int ret;
+	unsigned int line_cyclomatic_cnt, line_ignore_cyclomatic_cnt;
+	unsigned int &cyclomatic_cnt = state.cyclomatic_cnt;
+	unsigned int &ignore_cyclomatic_cnt = state.ignore_cyclomatic_cnt;
+	string &line = state.line;
 
-		if (CUtil::CheckBlank(line))
-			continue;
+	if (CUtil::CheckBlank(text))
+		return;
 
-		line = " " + line;
-
-		// mathematical functions
-		cnt = 0;
-		CUtil::CountTally(line, math_func_list, cnt, 1, exclude, "", "", &result->math_func_count, casesensitive);
-		result->cmplx_math_lines += cnt;
-
-		// trigonometric functions
-		cnt = 0;
-		CUtil::CountTally(line, trig_func_list, cnt, 1, exclude, "", "", &result->trig_func_count, casesensitive);
-		result->cmplx_trig_lines += cnt;
-
-		// logarithmic functions
-		cnt = 0;
-		CUtil::CountTally(line, log_func_list, cnt, 1, exclude, "", "", &result->log_func_count, casesensitive);
-		result->cmplx_logarithm_lines += cnt;
-
-		// calculations
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_calc_list, cnt, 1, exclude, "", "", &result->cmplx_calc_count, casesensitive);
-		result->cmplx_calc_lines += cnt;
-
-		// conditionals
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_cond_list, cnt, 1, exclude, "", "", &result->cmplx_cond_count, casesensitive);
-		result->cmplx_cond_lines += cnt;
-
-		// logical operators
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_logic_list, cnt, 1, exclude, "", "", &result->cmplx_logic_count, casesensitive);
-		result->cmplx_logic_lines += cnt;
-
-		// preprocessor directives
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_preproc_list, cnt, 1, exclude, "", "", &result->cmplx_preproc_count, casesensitive);
-		result->cmplx_preproc_lines += cnt;
-
-		// assignments
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_assign_list, cnt, 1, exclude, "", "", &result->cmplx_assign_count, casesensitive);
-		result->cmplx_assign_lines += cnt;
-
-		// pointers
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_pointer_list, cnt, 1, exclude, "", "", &result->cmplx_pointer_count, casesensitive);
-		result->cmplx_pointer_lines += cnt;
-
-		// cyclomatic complexity
-		if (process_cyclomatic_complexity)
-		{
-			// search for cyclomatic complexity keywords
-			CUtil::CountTally(line, cmplx_cyclomatic_list, cyclomatic_cnt, 1, exclude, "", "", 0, casesensitive);
+	line = " ";
+	line += text;
 
-			// search for keywords to exclude
-			if (ignore_cmplx_cyclomatic_list.size() > 0)
-				CUtil::CountTally(line, ignore_cmplx_cyclomatic_list, ignore_cyclomatic_cnt, 1, exclude, "", "", 0, casesensitive);
+	// complexity keywords of all lists
+	line_cyclomatic_cnt = line_ignore_cyclomatic_cnt = 0;
+	CountComplexityTallies(line, state.exclude, cmplx_logic_list, cmplx_assign_list, result, &line_cyclomatic_cnt, &line_ignore_cyclomatic_cnt);
 
-			// parse function name if found
-			ret = ParseFunctionName(line, lastline, function_stack, function_name, function_count);
-			if (ret != 1 && !cyclomatic_stack.empty() && cyclomatic_stack.size() == function_stack.size())
-			{
-				// remove count stack entry for non-function names
-				cyclomatic_cnt += cyclomatic_stack.top();
-				ignore_cyclomatic_cnt = 0;
-				cyclomatic_stack.pop();
-			}
-			if (ret == 1)
-			{
-				// capture count at end of function
-				lineElement element(cyclomatic_cnt - ignore_cyclomatic_cnt + 1, function_name);
-				function_map[function_count] = element;
+	// cyclomatic complexity
+	if (state.process_cyclomatic_complexity)
+	{
+		// add cyclomatic complexity keywords and keywords to exclude
+		cyclomatic_cnt += line_cyclomatic_cnt;
+		ignore_cyclomatic_cnt += line_ignore_cyclomatic_cnt;
 
-				if (!function_stack.empty())
+		// parse function name if found
+		ret = ParseFunctionName(line, state.lastline, state.function_stack, state.function_name, state.function_count);
+		if (ret != 1 && !state.cyclomatic_stack.empty() && state.cyclomatic_stack.size() == state.function_stack.size())
+		{
+			// remove count stack entry for non-function names
+			cyclomatic_cnt += state.cyclomatic_stack.top();
+			ignore_cyclomatic_cnt = 0;
+			state.cyclomatic_stack.pop();
+		}
+		if (ret == 1)
+		{
+			// capture count at end of function
+			lineElement element(cyclomatic_cnt - ignore_cyclomatic_cnt + 1, state.function_name);
+			state.function_map[state.function_count] = element;
+
+			if (!state.function_stack.empty())
+			{
+				// grab previous function from stack to continue
+				if (!state.cyclomatic_stack.empty())
 				{
-					// grab previous function from stack to continue
-					if (!cyclomatic_stack.empty())
-					{
-						cyclomatic_cnt = cyclomatic_stack.top();
-						cyclomatic_stack.pop();
-					}
+					cyclomatic_cnt = state.cyclomatic_stack.top();
+					state.cyclomatic_stack.pop();
 				}
-				else
-					cyclomatic_cnt = 0;
-				function_name = "";
-				ignore_cyclomatic_cnt = 0;
-			}
-			else if (ret == 2)
-			{
-				// some code doesn't belong to any function
-				main_cyclomatic_cnt += cyclomatic_cnt - ignore_cyclomatic_cnt;
-				if (main_cyclomatic_cnt < 1)
-					main_cyclomatic_cnt = 1;	// add 1 for main function here in case no other decision points are found in main
-				cyclomatic_cnt = ignore_cyclomatic_cnt = 0;
-			}
-			else if (!function_stack.empty() && (function_stack.size() > cyclomatic_stack.size() + 1 || (cyclomatic_stack.empty() && function_stack.size() > 1)))
-			{
-				// capture previous complexity count from open function
-				cyclomatic_stack.push(cyclomatic_cnt - ignore_cyclomatic_cnt);
-				cyclomatic_cnt = ignore_cyclomatic_cnt = 0;
 			}
+			else
+				cyclomatic_cnt = 0;
+			state.function_name = "";
+			ignore_cyclomatic_cnt = 0;
+		}
+		else if (ret == 2)
+		{
+			// some code doesn't belong to any function
+			state.main_cyclomatic_cnt += cyclomatic_cnt - ignore_cyclomatic_cnt;
+			if (state.main_cyclomatic_cnt < 1)
+				state.main_cyclomatic_cnt = 1;	// add 1 for main function here in case no other decision points are found in main
+			cyclomatic_cnt = ignore_cyclomatic_cnt = 0;
+		}
+		else if (!state.function_stack.empty() && (state.function_stack.size() > state.cyclomatic_stack.size() + 1 ||
+			(state.cyclomatic_stack.empty() && state.function_stack.size() > 1)))
+		{
+			// capture previous complexity count from open function
+			state.cyclomatic_stack.push(cyclomatic_cnt - ignore_cyclomatic_cnt);
+			cyclomatic_cnt = ignore_cyclomatic_cnt = 0;
 		}
 	}
+}
+
+/*!
+* Finishes counting the complexity of a file and stores the complexity of each function.
+*
+* \param result counter results
+* \param state complexity state after the last line
+*/
+void CCodeCounter::EndComplexity(results* result, complexityState &state)
+{
+	string function_name;
 
 	// done with a file
-	if (main_cyclomatic_cnt > 0)
+	if (state.main_cyclomatic_cnt > 0)
 	{
 		// add "main" code
-		lineElement element(main_cyclomatic_cnt, "main");
-		function_map[0] = element;
+		lineElement element(state.main_cyclomatic_cnt, "main");
+		state.function_map[0] = element;
 	}
 	else
 	{
 		// finish the first function if not closed
-		while (!function_stack.empty())
+		while (!state.function_stack.empty())
 		{
-			function_name = function_stack.back().line;
-			function_count = function_stack.back().lineNumber;
-			function_stack.pop_back();
+			function_name = state.function_stack.back().line;
+			state.function_stack.pop_back();
 
-			if (!function_stack.empty())
+			if (!state.function_stack.empty())
 			{
 				// grab previous function from stack to continue
-				if (!cyclomatic_stack.empty())
+				if (!state.cyclomatic_stack.empty())
 				{
-					cyclomatic_cnt = cyclomatic_stack.top();
-					cyclomatic_stack.pop();
+					state.cyclomatic_cnt = state.cyclomatic_stack.top();
+					state.cyclomatic_stack.pop();
 				}
 			}
 			else
 			{
 				// capture count at end of function
-				lineElement element(cyclomatic_cnt + 1, function_name);
-				function_map[0] = element;
+				lineElement element(state.cyclomatic_cnt + 1, function_name);
+				state.function_map[0] = element;
 			}
 		}
 	}
 
 	// process ordered functions
-	for (map<unsigned int, lineElement>::iterator it = function_map.begin(); it != function_map.end(); ++it)
+	for (map<unsigned int, lineElement>::iterator it = state.function_map.begin(); it != state.function_map.end(); ++it)
 		result->cmplx_cycfunct_count.push_back(it->second);
-
-	return 1;
 }
 
 /*!
@@ -790,9 +1147,9 @@ int CCodeCounter::CountComplexity(filemap* fmap, results* result)
 *
 * \return method status
 */
-int CCodeCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* /*fmapBak*/)
+int CCodeCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* /*fmapBak*/)
 {
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++)
 	{
 		if (!CUtil::CheckBlank(iter->line))
 			result->exec_lines[PHY]++;
@@ -11,6 +11,36 @@
 #include "cc_main.h"
 #include "CUtil.h"
 
+#define COUNT_ENGINES_DIFFER	2	//!< CountSLOC status when the engines being verified count a file differently
+
+//! Quote and comment rules of a language fixed when the counter kernels are compiled.
+/*!
+* \struct fixedLangTraits
+*
+* Each rule returns its template argument instead of the counter value passed in,
+* so the kernels instantiated with it are specialized for the language (see CCodeCounter::SelectKernels).
+*/
+template <bool CaseSensitive, char EscapeFront, char EscapeRear>
+struct fixedLangTraits
+{
+	static bool caseSensitive(bool /*value*/) { return CaseSensitive; }		//!< Are line comments case sensitive?
+	static char escapeFront(char /*value*/) { return EscapeFront; }			//!< Quote escape char before a char
+	static char escapeRear(char /*value*/) { return EscapeRear; }			//!< Quote escape char after a quote end
+	static bool virtualQuote() { return false; }							//!< Call the ReplaceQuote override?
+};
+
+//! Quote and comment rules of a language taken from the counter (any language).
+/*!
+* \struct runtimeLangTraits
+*/
+struct runtimeLangTraits
+{
+	static bool caseSensitive(bool value) { return value; }		//!< Are line comments case sensitive?
+	static char escapeFront(char value) { return value; }		//!< Quote escape char before a char
+	static char escapeRear(char value) { return value; }		//!< Quote escape char after a quote end
+	static bool virtualQuote() { return true; }					//!< Call the ReplaceQuote override?
+};
+
 //! Common code counter class.
 /*!
 * \class CCodeCounter
@@ -73,19 +103,92 @@ public:
 	unsigned int  total_dupFilesB;			//!< Total number of duplicate files in baseline B
 
 protected:
+	//! Keyword lists counted together by CountComplexityTallies (in scan order).
+	enum ComplexityList
+	{
+		CMPLX_MATH = 0,
+		CMPLX_TRIG,
+		CMPLX_LOG,
+		CMPLX_CALC,
+		CMPLX_COND,
+		CMPLX_LOGIC,
+		CMPLX_PREPROC,
+		CMPLX_ASSIGN,
+		CMPLX_POINTER,
+		CMPLX_CYCLOMATIC,
+		CMPLX_IGNORE_CYCLOMATIC,
+		CMPLX_LIST_COUNT
+	};
+
+	//! State of CountCommentsLine carried from one line to the next.
+	struct commentState
+	{
+		commentState() : contd(false), quote_contd(false), comment_type(0), CurrentQuoteEnd(0) {}
+
+		bool contd;					//!< Is a block comment continued on the next line?
+		bool quote_contd;			//!< Is a quote continued on the next line?
+		int comment_type;			//!< Comment type (see CountCommentsLine)
+		char CurrentQuoteEnd;		//!< End quote char of the continued quote
+		string curBlckCmtStart;		//!< Start of the current block comment
+		string curBlckCmtEnd;		//!< End of the current block comment
+	};
+
+	//! State of CountComplexityLine carried from one line to the next.
+	struct complexityState
+	{
+		explicit complexityState(fileArena &arena)
+			: cyclomatic_cnt(0), ignore_cyclomatic_cnt(0), main_cyclomatic_cnt(0), function_count(0),
+			process_cyclomatic_complexity(false), exclude("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$"), function_stack(arena), cyclomatic_stack((ArenaUIntVector(arena))) {}
+
+		unsigned int cyclomatic_cnt;		//!< Cyclomatic complexity of the current function
+		unsigned int ignore_cyclomatic_cnt;	//!< Decision keywords to ignore in the current function
+		unsigned int main_cyclomatic_cnt;	//!< Cyclomatic complexity of the code outside functions
+		unsigned int function_count;		//!< Number of functions found
+		bool process_cyclomatic_complexity;	//!< Is cyclomatic complexity counted for the file?
+		string exclude;						//!< Chars that may not surround a keyword
+		string line;						//!< Line being processed (with a leading space)
+		string lastline;					//!< Previous line (for function names split over lines)
+		string function_name;				//!< Name of the current function
+		ArenaFilemap function_stack;		//!< Open functions
+		ArenaUIntStack cyclomatic_stack;	//!< Counts of the enclosing open functions
+		map<unsigned int, lineElement> function_map;	//!< Complexity of each function (by function number)
+	};
+
 	virtual void InitializeResultsCounts(results* result);
+	void CountSLOCPasses(filemap* fmap, results* result);
+	virtual bool CountSLOCFused(filemap* /*fmap*/, results* /*result*/) { return false; }
+	static bool SameCounts(results &res1, results &res2);
 	static size_t FindQuote(string const &strline, string const &QuoteStart, size_t idx_start, char QuoteEscapeFront);
 	virtual int ReplaceQuote(string &strline, size_t &idx_start, bool &contd, char &CurrentQuoteEnd);
-	virtual int PreCountProcess(filemap* /*fmap*/) { return 0; }
-	int CountBlankSLOC(filemap* fmap, results* result);
-	virtual int CountCommentsSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	int FindCommentStart(string strline, size_t &idx_start, int &comment_type,
+	virtual int PreCountProcess(filemapOverlay* /*fmap*/) { return 0; }
+	int CountBlankSLOC(filemapOverlay* fmap, results* result);
+	virtual int CountCommentsSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	bool HasComments() const;
+	void CountCommentsLine(filemapOverlay* fmap, filemapOverlay::iterator iter, filemapOverlay* fmapBak,
+		filemapOverlay::iterator itfmBak, results* result, commentState &state);
+	int FindCommentStart(const string &strline, size_t &idx_start, int &comment_type,
+		string &curBlckCmtStart, string &curBlckCmtEnd);
+	void SetCommentStartChars();
+	void SelectKernels();
+	template <class Traits> static size_t FindQuoteKernel(string const &strline, string const &QuoteStart,
+		size_t idx_start, char QuoteEscapeFront);
+	template <class Traits> int ReplaceQuoteKernel(string &strline, size_t &idx_start, bool &contd, char &CurrentQuoteEnd);
+	template <class Traits> void CountCommentsLineKernel(filemapOverlay* fmap, filemapOverlay::iterator iter,
+		filemapOverlay* fmapBak, filemapOverlay::iterator itfmBak, results* result, commentState &state);
+	template <class Traits> int FindCommentStartKernel(const string &strline, size_t &idx_start, int &comment_type,
 		string &curBlckCmtStart, string &curBlckCmtEnd);
-	virtual int CountComplexity(filemap* fmap, results* result);
-	virtual int CountDirectiveSLOC(filemap* /*fmap*/, results* /*result*/, filemap* /*fmapBak = NULL*/) { return 0; }
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
+	virtual int CountComplexity(filemapOverlay* fmap, results* result);
+	void BeginComplexity(results* result, complexityState &state);
+	void CountComplexityLine(const string &text, results* result, complexityState &state);
+	void EndComplexity(results* result, complexityState &state);
+	virtual int CountDirectiveSLOC(filemapOverlay* /*fmap*/, results* /*result*/, filemapOverlay* /*fmapBak = NULL*/) { return 0; }
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
 	virtual int ParseFunctionName(const string & /*line*/, string & /*lastline*/,
-		filemap & /*functionStack*/, string & /*functionName*/, unsigned int & /*functionCount*/) { return 0; }
+		ArenaFilemap & /*functionStack*/, string & /*functionName*/, unsigned int & /*functionCount*/) { return 0; }
+	void CountTally(const string &base, StringVector &container, unsigned int &count, int mode, const string &exclude,
+		const string &include1, const string &include2, UIntVector *counter_container = 0, bool case_sensitive = true);
+	void CountComplexityTallies(const string &line, const string &exclude, StringVector &logic_list, StringVector &assign_list,
+		results* result, unsigned int *cyclomatic_cnt = 0, unsigned int *ignore_cyclomatic_cnt = 0);
 
 	StringVector  exclude_keywords;			//!< List of keywords to exclude from counts
 
@@ -99,9 +202,23 @@ protected:
 	StringVector BlockCommentStart;			//!< Block comment start character(s) (ex. /* in C++)
 	StringVector BlockCommentEnd;			//!< Block comment end character(s) (ex. */ in C++)
 	StringVector LineCommentStart;			//!< Single line or embedded comment character(s)
+	string commentStartChars;				//!< First chars of all comment delimiters (set on first use)
+	bool commentStartCharsSet;				//!< Is commentStartChars set?
+	bool commentStartAnyChar;				//!< Is a comment delimiter empty (so may start anywhere)?
+	bool customReplaceQuote;				//!< Does the counter override ReplaceQuote? (set by the counters that do)
+
+	//! CountCommentsLine instantiated for the rules of a language.
+	typedef void (CCodeCounter::*CommentLineKernel)(filemapOverlay* fmap, filemapOverlay::iterator iter,
+		filemapOverlay* fmapBak, filemapOverlay::iterator itfmBak, results* result, commentState &state);
+	CommentLineKernel commentLineKernel;	//!< CountCommentsLine kernel of the counter (selected on first use)
 
 	bool casesensitive;						//!< Is language is case sensitive?
 
+	fileArena arena;						//!< Transient allocations while counting a file (reset after each file)
+
+	map<const StringVector*, keywordMatcher> keywordMatchers;	//!< Compiled keyword lists (by list address)
+	keywordMatcher cmplxMatcher;			//!< Compiled complexity keyword lists (see CountComplexityTallies)
+
 	ofstream output_file;					//!< Output file stream
 	ofstream output_file_csv;				//!< Output CSV file stream
 };
@@ -103,9 +103,9 @@ CCshCounter::CCshCounter()
 *
 * \return method status
 */
-int CCshCounter::PreCountProcess(filemap* fmap)
+int CCshCounter::PreCountProcess(filemapOverlay* fmap)
 {
-	filemap::iterator fit;
+	filemapOverlay::iterator fit;
 	for (fit = fmap->begin(); fit != fmap->end(); fit++) 
 	{
 		if (fit->line.empty())
@@ -114,7 +114,7 @@ int CCshCounter::PreCountProcess(filemap* fmap)
 		{
 			// replace $# and ${# with $ to avoid determination of a comment
 			if (fit->line[i] == '#' && (fit->line[i-1] == '$' || fit->line[i-1] == '{'))
-				fit->line[i] = '$';
+				fmap->edit(fit)[i] = '$';
 		}
 	}
 	return 0;
@@ -134,9 +134,9 @@ int CCshCounter::PreCountProcess(filemap* fmap)
 *
 * \return method status
 */
-int CCshCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CCshCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
 
 	bool data_continue = false;
@@ -165,7 +165,7 @@ int CCshCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 
 			// update physical SLOC lines
@@ -197,7 +197,7 @@ int CCshCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 * \param phys_data_lines number of physical data lines
 * \param loopLevel nested loop level
 */
-void CCshCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
+void CCshCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak,
 						bool &data_continue, unsigned int &temp_lines, unsigned int &phys_exec_lines,
 						unsigned int &phys_data_lines, unsigned int &loopLevel)
 {
@@ -220,7 +220,7 @@ void CCshCounter::LSLOC(results* result, string line, string lineBak, string &st
 		if (end != string::npos)
 		{
 			// handle empty statement
-			if (CUtil::TrimString(tmp.substr(start, end - start + 1)) == ";")
+			if (CUtil::TrimStringEquals(tmp, start, end - start + 1, ";"))
 			{
 				start = end + 1;
 				strLSLOC = strLSLOCBak = "";
@@ -253,7 +253,7 @@ void CCshCounter::LSLOC(results* result, string line, string lineBak, string &st
 		// process nested loops
 		if (print_cmplx)
 		{
-			str = CUtil::TrimString(tmp.substr(start, end - start + 1));
+			CUtil::AssignTrimString(str, tmp, start, end - start + 1);
 			if (CUtil::FindKeyword(str, "foreach") != string::npos
 				|| CUtil::FindKeyword(str, "while") != string::npos)
 			{
@@ -277,7 +277,7 @@ void CCshCounter::LSLOC(results* result, string line, string lineBak, string &st
 			{
 				// strip specified keyword and skip if empty
 				start = i + (*it).length();
-				if (CUtil::CheckBlank(CUtil::TrimString(tmp.substr(start, end - start))))
+				if (CUtil::CheckBlank(tmp, start, end - start))
 					start = end + 1;
 				break;
 			}
@@ -292,9 +292,9 @@ void CCshCounter::LSLOC(results* result, string line, string lineBak, string &st
 		// check for continuation words
 		found = false;
 		if (tmp[end] == ';')
-			str = CUtil::TrimString(tmp.substr(start, end - start));
+			CUtil::AssignTrimString(str, tmp, start, end - start);
 		else
-			str = CUtil::TrimString(tmp.substr(start, end - start + 1));
+			CUtil::AssignTrimString(str, tmp, start, end - start + 1);
 		for (StringVector::iterator it = continue_keywords.begin(); it != continue_keywords.end(); it++)
 		{
 			i = str.find((*it));
@@ -306,9 +306,9 @@ void CCshCounter::LSLOC(results* result, string line, string lineBak, string &st
 					found = true;
 					strLSLOC += str + " ";
 					if (tmp[end] == ';')
-						str = CUtil::TrimString(tmpBak.substr(start, end - start));
+						CUtil::AssignTrimString(str, tmpBak, start, end - start);
 					else
-						str = CUtil::TrimString(tmpBak.substr(start, end - start + 1));
+						CUtil::AssignTrimString(str, tmpBak, start, end - start + 1);
 					strLSLOCBak += str + " ";
 					start = end + 1;
 					if (temp_lines == 0 && phys_data_lines == 0 && phys_exec_lines == 0)
@@ -380,14 +380,16 @@ void CCshCounter::LSLOC(results* result, string line, string lineBak, string &st
 					if (str[0] == ' ')
 						spc += " ";
 				}
-				strLSLOC += CUtil::TrimString(tmp.substr(start, strSize)) + spc;
-				strLSLOCBak += CUtil::TrimString(tmpBak.substr(start, strSize)) + spc;
+				CUtil::AppendTrimString(strLSLOC, tmp, start, strSize);
+				strLSLOC += spc;
+				CUtil::AppendTrimString(strLSLOCBak, tmpBak, start, strSize);
+				strLSLOCBak += spc;
 			}
 			start = end + 1;
 
 			// make sure that we are not beginning to process a new data line
 			cnt = 0;
-			CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
+			CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
 
 			if (cnt > 0)
 				data_continue = true;
@@ -405,8 +407,8 @@ void CCshCounter::LSLOC(results* result, string line, string lineBak, string &st
 				strSize = CUtil::TruncateLine(end - start + 1, strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 			if (strSize > 0)
 			{
-				strLSLOC += CUtil::TrimString(tmp.substr(start, strSize));
-				strLSLOCBak += CUtil::TrimString(tmpBak.substr(start, strSize));
+				CUtil::AppendTrimString(strLSLOC, tmp, start, strSize);
+				CUtil::AppendTrimString(strLSLOCBak, tmpBak, start, strSize);
 			}
 			start = end + 1;
 			if (strLSLOCBak.length() > 0)
@@ -415,7 +417,7 @@ void CCshCounter::LSLOC(results* result, string line, string lineBak, string &st
 				{
 					// add a logical SLOC
 					cnt = 0;
-					CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
+					CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
 
 					temp_lines++;
 					if (data_continue == true || cnt > 0)
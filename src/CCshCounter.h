@@ -23,9 +23,9 @@ public:
 	CCshCounter();
 
 protected:
-	virtual int PreCountProcess(filemap* fmap);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
+	virtual int PreCountProcess(filemapOverlay* fmap);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak,
 		bool &data_continue, unsigned int &temp_lines, unsigned int &phys_exec_lines,
 		unsigned int &phys_data_lines, unsigned int &loopLevel);
 
@@ -16,6 +16,7 @@ CCsharpCounter::CCsharpCounter()
 	language_name = "C#";
 
 	isVerbatim = false;
+	customReplaceQuote = true;
 
 	file_extension.push_back(".cs");
 
@@ -192,31 +193,40 @@ CCsharpCounter::CCsharpCounter()
 *
 * \return method status
 */
-int CCsharpCounter::PreCountProcess(filemap* fmap)
+int CCsharpCounter::PreCountProcess(filemapOverlay* fmap)
+{
+	filemapOverlay::iterator fit;
+	for (fit = fmap->begin(); fit != fmap->end(); fit++) 
+		PreCountLine(fmap, fit);
+	return 0;
+}
+
+/*!
+* Perform preprocessing of a line before counting.
+*
+* \param fmap list of file lines
+* \param fit line to process
+*/
+void CCsharpCounter::PreCountLine(filemapOverlay* fmap, filemapOverlay::iterator fit)
 {
 	size_t i;
 	bool found;
-	filemap::iterator fit;
-	for (fit = fmap->begin(); fit != fmap->end(); fit++) 
+	if (fit->line.empty())
+		return;
+	// check for parenthesis within attribute brackets [...()]
+	found = false;
+	for (i = 0; i < fit->line.length(); i++)
 	{
-		if (fit->line.empty())
-			continue;
-		// check for parenthesis within attribute brackets [...()]
-		found = false;
-		for (i = 0; i < fit->line.length(); i++)
+		if (fit->line[i] == '[')
+			found = true;
+		else if (found)
 		{
-			if (fit->line[i] == '[')
-				found = true;
-			else if (found)
-			{
-				if (fit->line[i] == ']')
-					found = false;
-				else if (fit->line[i] == '(' || fit->line[i] == ')')
-					fit->line[i] = '$';
-			}
+			if (fit->line[i] == ']')
+				found = false;
+			else if (fit->line[i] == '(' || fit->line[i] == ')')
+				fmap->edit(fit)[i] = '$';
 		}
 	}
-	return 0;
 }
 
 /*!
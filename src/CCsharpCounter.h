@@ -22,7 +22,8 @@ public:
 	CCsharpCounter();
 
 protected:
-	virtual int PreCountProcess(filemap* fmap);
+	virtual int PreCountProcess(filemapOverlay* fmap);
+	virtual void PreCountLine(filemapOverlay* fmap, filemapOverlay::iterator iter);
 	virtual int ReplaceQuote(string &strline, size_t &idx_start, bool &contd, char &CurrentQuoteEnd);
 
 private:
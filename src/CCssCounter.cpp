@@ -142,7 +142,7 @@ CCssCounter::CCssCounter()
 *
 * \return method status
 */
-int CCssCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* /*fmapBak*/) 
+int CCssCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* /*fmapBak*/) 
 {
 	string  exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	char	prev_char				= ' ';
@@ -166,7 +166,7 @@ int CCssCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 		return 1;
 
 	// iterating line-by-line of the file
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++)
 	{
 		line = iter->line;
 
@@ -179,7 +179,7 @@ int CCssCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(iter->line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(iter->line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 
 			// update physical SLOC
@@ -22,7 +22,7 @@ public:
 	CCssCounter();
 
 protected:
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
 	void LSLOC(results* result, string &line, string &strLSLOC, char &lastLinesLastChar,
 		unsigned int &phys_exec_lines, unsigned int &phys_data_lines);
 };
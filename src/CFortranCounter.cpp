@@ -210,10 +210,10 @@ CFortranCounter::CFortranCounter()
 *
 * \return method status
 */
-int CFortranCounter::PreCountProcess(filemap* fmap)
+int CFortranCounter::PreCountProcess(filemapOverlay* fmap)
 {
 	size_t i;
-	filemap::iterator fit;
+	filemapOverlay::iterator fit;
 	for (fit = fmap->begin(); fit != fmap->end(); fit++) 
 	{
 		if (fit->line.empty())
@@ -222,8 +222,8 @@ int CFortranCounter::PreCountProcess(filemap* fmap)
 		{
 			if ((fit->line[i] == '\'' && fit->line[i-1] == '\'') || (fit->line[i] == '"' && fit->line[i-1] == '"'))
 			{
-				fit->line[i] = '$';
-				fit->line[i-1] = '$';
+				fmap->edit(fit)[i] = '$';
+				fmap->edit(fit)[i-1] = '$';
 			}
 		}
 	}
@@ -241,7 +241,7 @@ int CFortranCounter::PreCountProcess(filemap* fmap)
 *
 * \return method status
 */
-int CFortranCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fmapBak)
+int CFortranCounter::CountCommentsSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	if (LineCommentStart.empty())
 		return 0;
@@ -262,12 +262,12 @@ int CFortranCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *
 	string curBlckCmtStart, curBlckCmtEnd, prevLine;
 	char CurrentQuoteEnd = 0;
 	bool quote_contd = false, found, foundSpc;
-	filemap::iterator itfmBak = fmapBak->begin();
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
 
 	quote_idx_start = 0;
 	prevLine = "";
 
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		contd_nextline = false;
 
@@ -279,7 +279,7 @@ int CFortranCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *
 		if (quote_contd)
 		{
 			// replace quote until next character
-			ReplaceQuote(iter->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
+			ReplaceQuote(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
 			prevLine = itfmBak->line;
 			if (quote_contd)
 				continue;
@@ -369,16 +369,16 @@ int CFortranCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *
 			// if found quote before comment
 			if (quote_idx_start != string::npos && (comment_start == string::npos || quote_idx_start < comment_start))
 			{
-				ReplaceQuote(iter->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
+				ReplaceQuote(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
 				if (quote_idx_start > idx_start)
 				{
 					if (quote_contd)
 					{
 						if (itfmBak->line[itfmBak->line.length() - 1] == '&')
 						{
-							iter->line[iter->line.length() - 1] = '&';
+							fmap->edit(iter)[iter->line.length() - 1] = '&';
 							if (itfmBak->line.length() > 2 && itfmBak->line[itfmBak->line.length() - 2] == ' ')
-								iter->line[iter->line.length() - 2] = ' ';
+								fmap->edit(iter)[iter->line.length() - 2] = ' ';
 						}
 					}
 					idx_start = quote_idx_start;
@@ -394,8 +394,8 @@ int CFortranCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *
 				case 1:	// line comment, definitely whole line
 				case 3:
 					prevLine = "";
-					iter->line = "";
-					itfmBak->line = "";
+					fmap->edit(iter) = "";
+					fmapBak->edit(itfmBak) = "";
 					result->comment_lines++;
 					contd_nextline = true;
 					break;
@@ -403,11 +403,11 @@ int CFortranCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *
 				case 4:
 					result->e_comm_lines++;
 					prevLine = "";
-					iter->line = iter->line.substr(0, idx_start);
-					itfmBak->line = itfmBak->line.substr(0, idx_start);
+					fmap->edit(iter) = iter->line.substr(0, idx_start);
+					fmapBak->edit(itfmBak) = itfmBak->line.substr(0, idx_start);
 					// trim trailing space
-					iter->line = CUtil::TrimString(iter->line, 1);
-					itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+					fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+					fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 					if (iter->line.empty())
 						result->comment_lines++;	// whole line
 					else
@@ -433,16 +433,16 @@ int CFortranCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *
 *
 * \return method status
 */
-int CFortranCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CFortranCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
 	unsigned int cnt = 0;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string strDirLine = "", tmp, str;
-	filemap::iterator itfmBak = fmapBak->begin();
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
 
-	for (filemap::iterator iter = fmap->begin(); iter!=fmap->end(); iter++, itfmBak++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter!=fmap->end(); iter++, itfmBak++)
 	{
 		tmp = CUtil::TrimString(iter->line);
 		if (CUtil::CheckBlank(iter->line))
@@ -451,7 +451,7 @@ int CFortranCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count, false);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count, false);
 		}
 
 		if (!contd)
@@ -469,9 +469,9 @@ int CFortranCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 			{
 				strSize = CUtil::TruncateLine(itfmBak->line.length(), 0, this->lsloc_truncate, trunc_flag);
 				if (strSize > 0)
-					strDirLine = CUtil::TrimString(itfmBak->line.substr(0, strSize));
+					CUtil::AssignTrimString(strDirLine, itfmBak->line, 0, strSize);
 				if (strDirLine[strDirLine.length() - 1] == '&')
-					strDirLine = CUtil::TrimString(strDirLine.substr(0, strDirLine.length() - 1));
+					CUtil::AssignTrimString(strDirLine, strDirLine, 0, strDirLine.length() - 1);
 				result->directive_lines[PHY]++;
 			}
  		}
@@ -481,9 +481,9 @@ int CFortranCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 			strSize = CUtil::TruncateLine(itfmBak->line.length(), strDirLine.length(), this->lsloc_truncate, trunc_flag);
 			if (strSize > 0)
 			{
-				str = CUtil::TrimString(itfmBak->line.substr(0, strSize));
+				CUtil::AssignTrimString(str, itfmBak->line, 0, strSize);
 				if (str[0] == '&')
-					strDirLine += CUtil::TrimString(str.substr(1, str.length() - 1));
+					CUtil::AppendTrimString(strDirLine, str, 1);
 				else
 					strDirLine += str;
 			}
@@ -499,7 +499,7 @@ int CFortranCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 				if (result->addSLOC(strDirLine, trunc_flag))
 					result->directive_lines[LOG]++;
 			}
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -519,9 +519,9 @@ int CFortranCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 *
 * \return method status
 */
-int CFortranCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CFortranCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
-	filemap::iterator fit, fitbak, fitNext = fmap->begin();
+	filemapOverlay::iterator fit, fitbak, fitNext = fmap->begin();
 	string line, lineBak, lineNext;
 
 	bool data_continue = false, fixed_continue = false;
@@ -532,7 +532,7 @@ int CFortranCounter::LanguageSpecificProcess(filemap* fmap, results* result, fil
 	unsigned int phys_data_lines = 0;
 	unsigned int temp_lines = 0;
 	unsigned int cnt = 0;
-	StringVector loopEnd;
+	ArenaStringVector loopEnd(arena);
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 
 	for (fit = fmap->begin(), fitbak = fmapBak->begin(); fit != fmap->end(); fit++, fitbak++)
@@ -573,7 +573,7 @@ int CFortranCounter::LanguageSpecificProcess(filemap* fmap, results* result, fil
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
 			}
 
 			// update physical SLOC lines
@@ -606,9 +606,9 @@ int CFortranCounter::LanguageSpecificProcess(filemap* fmap, results* result, fil
 * \param phys_data_lines number of physical data lines
 * \param loopEnd nested loop end string(s)
 */
-void CFortranCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
+void CFortranCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak,
 							bool &fixed_continue, bool &data_continue, unsigned int &temp_lines, unsigned int &phys_exec_lines,
-							unsigned int &phys_data_lines, StringVector &loopEnd)
+							unsigned int &phys_data_lines, ArenaStringVector &loopEnd)
 {
 	size_t start, end;
 	size_t i, j, k, m, strSize;
@@ -658,7 +658,7 @@ void CFortranCounter::LSLOC(results* result, string line, string lineBak, string
 		else
 		{
 			// skip empty ";"
-			str = CUtil::TrimString(tmp.substr(start, end - start + 1));
+			CUtil::AssignTrimString(str, tmp, start, end - start + 1);
 			if (str == ";")
 			{
 				start = end + 1;
@@ -691,7 +691,7 @@ void CFortranCounter::LSLOC(results* result, string line, string lineBak, string
 									break;
 							}
 							k--;
-							str = CUtil::TrimString(tmp.substr(j, k - j + 1));
+							CUtil::AssignTrimString(str, tmp, j, k - j + 1);
 							if (CUtil::IsInteger(str))
 							{
 								loopEnd.push_back(str);
@@ -783,7 +783,7 @@ void CFortranCounter::LSLOC(results* result, string line, string lineBak, string
 				if ((*it) == "elsewhere")
 				{
 					// make sure elsewhere does not have condition
-					str = CUtil::TrimString(tmp.substr(i + 9, end - (i + 9) + 1));
+					CUtil::AssignTrimString(str, tmp, i + 9, end - (i + 9) + 1);
 					if (str[0] != '(')
 						break;
 				}
@@ -837,15 +837,15 @@ void CFortranCounter::LSLOC(results* result, string line, string lineBak, string
 				{
 					if (j < end)
 					{
-						str = CUtil::TrimString(tmp.substr(j + 1, end - j + 1));
+						CUtil::AssignTrimString(str, tmp, j + 1, end - j + 1);
 						if (!CUtil::CheckBlank(str) && str != ";" && str != "&" && !fixed_continue)
 						{
 							// save LSLOC for if statement, then process in-line action
 							strSize = CUtil::TruncateLine(j - start + 1, strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 							if (strSize > 0)
 							{
-								strLSLOC += CUtil::TrimString(tmp.substr(start, strSize));
-								strLSLOCBak += CUtil::TrimString(tmpBak.substr(start, strSize));
+								CUtil::AppendTrimString(strLSLOC, tmp, start, strSize);
+								CUtil::AppendTrimString(strLSLOCBak, tmpBak, start, strSize);
 							}
 							if (result->addSLOC(strLSLOCBak, trunc_flag))
 								result->exec_lines[LOG]++;
@@ -882,14 +882,16 @@ void CFortranCounter::LSLOC(results* result, string line, string lineBak, string
 					if (str[0] == ' ')
 						spc += " ";
 				}
-				strLSLOC += CUtil::TrimString(tmp.substr(start, strSize)) + spc;
-				strLSLOCBak += CUtil::TrimString(tmpBak.substr(start, strSize)) + spc;
+				CUtil::AppendTrimString(strLSLOC, tmp, start, strSize);
+				strLSLOC += spc;
+				CUtil::AppendTrimString(strLSLOCBak, tmpBak, start, strSize);
+				strLSLOCBak += spc;
 			}
 			start = end + 1;
 
 			// make sure that we are not beginning to process a new data line
 			cnt = 0;
-			CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL, false);
+			CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL, false);
 
 			if (cnt > 0)
 				data_continue = true;
@@ -907,8 +909,8 @@ void CFortranCounter::LSLOC(results* result, string line, string lineBak, string
 				strSize = CUtil::TruncateLine(end - start + 1, strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 			if (strSize > 0)
 			{
-				strLSLOC += CUtil::TrimString(tmp.substr(start, strSize));
-				strLSLOCBak += CUtil::TrimString(tmpBak.substr(start, strSize));
+				CUtil::AppendTrimString(strLSLOC, tmp, start, strSize);
+				CUtil::AppendTrimString(strLSLOCBak, tmpBak, start, strSize);
 			}
 			start = end + 1;
 			if (strLSLOCBak.length() > 0)
@@ -917,7 +919,7 @@ void CFortranCounter::LSLOC(results* result, string line, string lineBak, string
 				{
 					// add a logical SLOC
 					cnt = 0;
-					CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
+					CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
 
 					temp_lines++;
 					if (data_continue == true || cnt > 0)
@@ -25,13 +25,13 @@ public:
 protected:
 	StringVector c_keywords;				//!< List of keywords starting with 'c' with flexible formats
 
-	virtual int PreCountProcess(filemap* fmap);
-	virtual int CountCommentsSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
+	virtual int PreCountProcess(filemapOverlay* fmap);
+	virtual int CountCommentsSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak,
 		bool &fixed_continue, bool &data_continue, unsigned int &temp_lines,
-		unsigned int &phys_exec_lines, unsigned int &phys_data_lines, StringVector &loopEnd);
+		unsigned int &phys_exec_lines, unsigned int &phys_data_lines, ArenaStringVector &loopEnd);
 };
 
 #endif
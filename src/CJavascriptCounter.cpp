@@ -20,6 +20,7 @@ CJavascriptCounter::CJavascriptCounter()
 	QuoteStart = "\"'/";
 	QuoteEnd = "\"'/";
 	QuoteEscapeFront = '\\';
+	customReplaceQuote = true;
 	LineCommentStart.push_back("//");
 	BlockCommentStart.push_back("/*");
 	BlockCommentEnd.push_back("*/");
@@ -250,16 +251,16 @@ int CJavascriptCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &c
 *
 * \return method status
 */
-int CJavascriptCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CJavascriptCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
 	unsigned int cnt = 0;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string strDirLine = "";
-	filemap::iterator itfmBak = fmapBak->begin();
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
 
-	for (filemap::iterator iter = fmap->begin(); iter!=fmap->end(); iter++, itfmBak++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter!=fmap->end(); iter++, itfmBak++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -267,7 +268,7 @@ int CJavascriptCounter::CountDirectiveSLOC(filemap* fmap, results* result, filem
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
 		}
 
 		if (!contd)
@@ -312,7 +313,7 @@ int CJavascriptCounter::CountDirectiveSLOC(filemap* fmap, results* result, filem
 				if (result->addSLOC(strDirLine, trunc_flag))
 					result->directive_lines[LOG]++;
 			}
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -332,7 +333,7 @@ int CJavascriptCounter::CountDirectiveSLOC(filemap* fmap, results* result, filem
 *
 * \return method status
 */
-int CJavascriptCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CJavascriptCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	unsigned int	paren_count			= 0;
 	bool			for_flag			= false;
@@ -345,9 +346,9 @@ int CJavascriptCounter::LanguageSpecificProcess(filemap* fmap, results* result,
 	string			strLSLOCBak			= "";
 	unsigned int	openBrackets		= 0;
 
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
-	StringVector loopLevel;
+	ArenaStringVector loopLevel(arena);
 
 	unsigned int phys_exec_lines = 0;
 	unsigned int phys_data_lines = 0;
@@ -374,7 +375,7 @@ int CJavascriptCounter::LanguageSpecificProcess(filemap* fmap, results* result,
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 
 			result->exec_lines[PHY] += phys_exec_lines;
@@ -412,10 +413,10 @@ int CJavascriptCounter::LanguageSpecificProcess(filemap* fmap, results* result,
 * \param openBrackets number of open brackets (no matching close bracket)
 * \param loopLevel nested loop level
 */
-void CJavascriptCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+void CJavascriptCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 							   bool &forflag, bool &found_forifwhile, bool &found_while, char &prev_char, bool &data_continue,
 							   unsigned  int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines, bool &inArrayDec,
-							   unsigned int &openBrackets, StringVector &loopLevel)
+							   unsigned int &openBrackets, ArenaStringVector &loopLevel)
 {
 	// paren_cnt is used with 'for' statement only
 	size_t start = 0; //starting index of the working string
@@ -424,7 +425,7 @@ void CJavascriptCounter::LSLOC(results* result, string line, string lineBak, str
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$:";
 	unsigned int cnt = 0;
 	unsigned int loopCnt = 0;
-	StringVector::iterator lit;
+	ArenaStringVector::iterator lit;
 
 	string tmp = CUtil::TrimString(strLSLOC);
 
@@ -498,7 +499,7 @@ void CJavascriptCounter::LSLOC(results* result, string line, string lineBak, str
 				if (!found_do && !found_try && !found_else)
 				{
 					// find for 'do' in string before tmp string
-					tmp = CUtil::TrimString(line.substr(start, i - start));
+					CUtil::AssignTrimString(tmp, line, start, i - start);
 					found_do = (tmp == "do");		// found 'do' statement
 					found_try = (tmp == "try");		// found 'try' statement
 					// same as else
@@ -540,7 +541,7 @@ void CJavascriptCounter::LSLOC(results* result, string line, string lineBak, str
 			inArrayDec = false;
 
 			// check for empty statement (=1 LSLOC)
-			if (CUtil::TrimString(line.substr(start, i + 1 - start)) == ";" && strLSLOC.length() < 1)
+			if (CUtil::TrimStringEquals(line, start, i + 1 - start, ";") && strLSLOC.length() < 1)
 			{
 				strLSLOC = ";";
 				strLSLOCBak = ";";
@@ -557,7 +558,7 @@ void CJavascriptCounter::LSLOC(results* result, string line, string lineBak, str
 			if (result->addSLOC(strLSLOCBak, trunc_flag))
 			{
 				cnt = 0;
-				CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
+				CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
 
 				temp_lines++;
 				if (data_continue == true && line[i] == ';')
@@ -595,7 +596,7 @@ void CJavascriptCounter::LSLOC(results* result, string line, string lineBak, str
 			else
 			{
 				// handle 'for', 'foreach', 'while', 'if' the same way
-				tmp = CUtil::TrimString(line.substr(start,i));
+				CUtil::AssignTrimString(tmp, line, start,i);
 				if (CUtil::FindKeyword(tmp, "for") != string::npos
 					|| CUtil::FindKeyword(tmp, "foreach") != string::npos
 					|| CUtil::FindKeyword(tmp, "while")!= string::npos
@@ -695,12 +696,12 @@ void CJavascriptCounter::LSLOC(results* result, string line, string lineBak, str
 		i++;
 	}
 
-	tmp = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
 	strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 	if (strSize > 0)
 	{
 		strLSLOC += tmp.substr(0, strSize);
-		tmp = CUtil::TrimString(lineBak.substr(start, i - start));
+		CUtil::AssignTrimString(tmp, lineBak, start, i - start);
 		strLSLOCBak += tmp.substr(0, strSize);
 
 		// drop continuation symbol
@@ -713,7 +714,7 @@ void CJavascriptCounter::LSLOC(results* result, string line, string lineBak, str
 	
 	// make sure that we are not beginning to process a new data line
 	cnt = 0;
-	CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
+	CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
 
 	if (cnt > 0)
 		data_continue = true;
@@ -23,12 +23,12 @@ public:
 
 protected:
 	virtual int ReplaceQuote(string &strline, size_t &idx_start, bool &contd, char &CurrentQuoteEnd);
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 		bool &forflag, bool &found_forifwhile, bool &found_while, char &prev_char, bool &data_continue,
 		unsigned int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines, bool &inArrayDec,
-		unsigned int &openBrackets, StringVector &loopLevel);
+		unsigned int &openBrackets, ArenaStringVector &loopLevel);
 };
 
 //! JavaScript in PHP code counter class.
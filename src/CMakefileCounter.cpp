@@ -45,7 +45,7 @@ CMakefileCounter::CMakefileCounter()
 *
 * \return method status
 */
-int CMakefileCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CMakefileCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
@@ -53,8 +53,8 @@ int CMakefileCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string strDirLine = "";
 
-	filemap::iterator itfmBak = fmapBak->begin();
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -62,7 +62,7 @@ int CMakefileCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
 		}
 
 		if (!contd)
@@ -107,7 +107,7 @@ int CMakefileCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap
 				if (result->addSLOC(strDirLine, trunc_flag))
 					result->directive_lines[LOG]++;
 			}
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -127,9 +127,9 @@ int CMakefileCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap
 *
 * \return method status
 */
-int CMakefileCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CMakefileCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
 	string strLSLOC = "";
 	string strLSLOCBak = "";
@@ -153,7 +153,7 @@ int CMakefileCounter::LanguageSpecificProcess(filemap* fmap, results* result, fi
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 			result->exec_lines[PHY]++;
 		}
@@ -174,7 +174,7 @@ int CMakefileCounter::LanguageSpecificProcess(filemap* fmap, results* result, fi
 * \param strLSLOC processed logical string
 * \param strLSLOCBak original logical string
 */
-void CMakefileCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak)
+void CMakefileCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak)
 {
 	size_t strSize;
 	bool trunc_flag = false;
@@ -188,8 +188,10 @@ void CMakefileCounter::LSLOC(results* result, string line, string lineBak, strin
 		strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 		if (strSize > 1)
 		{
-			strLSLOC += CUtil::TrimString(tmp.substr(0, strSize - 1)) + " ";
-			strLSLOCBak += CUtil::TrimString(tmpBak.substr(0, strSize - 1)) + " ";
+			CUtil::AppendTrimString(strLSLOC, tmp, 0, strSize - 1);
+			strLSLOC += " ";
+			CUtil::AppendTrimString(strLSLOCBak, tmpBak, 0, strSize - 1);
+			strLSLOCBak += " ";
 			return;
 		}
 	}
@@ -22,9 +22,9 @@ public:
 	CMakefileCounter();
 
 protected:
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak);
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak);
 };
 
 #endif
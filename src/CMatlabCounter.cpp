@@ -129,7 +129,7 @@ CMatlabCounter::CMatlabCounter()
 *
 * \return method status
 */
-int CMatlabCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CMatlabCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
@@ -137,8 +137,8 @@ int CMatlabCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string strDirLine = "";
 
-	filemap::iterator itfmBak = fmapBak->begin();
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -146,7 +146,7 @@ int CMatlabCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
 		}
 
 		if (!contd)
@@ -191,7 +191,7 @@ int CMatlabCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 				if (result->addSLOC(strDirLine, trunc_flag))
 					result->directive_lines[LOG]++;
 			}
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -211,15 +211,15 @@ int CMatlabCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 *
 * \return method status
 */
-int CMatlabCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CMatlabCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool cont_str = false;
 	unsigned int openBrackets = 0;
 	string strLSLOC = "";
 	string strLSLOCBak = "";
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
-	StringVector loopLevel;
+	ArenaStringVector loopLevel(arena);
 	unsigned int cnt = 0;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 
@@ -240,7 +240,7 @@ int CMatlabCounter::LanguageSpecificProcess(filemap* fmap, results* result, file
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 			result->exec_lines[PHY]++;
 		}
@@ -264,8 +264,8 @@ int CMatlabCounter::LanguageSpecificProcess(filemap* fmap, results* result, file
 * \param openBrackets number of open brackets (no matching close bracket)
 * \param loopLevel nested loop level
 */
-void CMatlabCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
-						   bool &cont_str, unsigned int &openBrackets, StringVector &loopLevel)
+void CMatlabCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak,
+						   bool &cont_str, unsigned int &openBrackets, ArenaStringVector &loopLevel)
 {
 	size_t start = 0, len;
 	size_t i = 0, strSize;
@@ -273,8 +273,8 @@ void CMatlabCounter::LSLOC(results* result, string line, string lineBak, string
 	string tmp, tmpBak, str;
 
 	// check exclusions/continuation
-	tmp = CUtil::TrimString(line);
-	tmpBak = CUtil::TrimString(lineBak);
+	CUtil::AssignTrimString(tmp, line);
+	CUtil::AssignTrimString(tmpBak, lineBak);
 	if (CUtil::FindKeyword(tmp, "end") == 0)
 	{
 		if (loopLevel.size() > 0)
@@ -299,7 +299,7 @@ void CMatlabCounter::LSLOC(results* result, string line, string lineBak, string
 
 			// record nested loop level
 			unsigned int loopCnt = 0;
-			for (StringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
+			for (ArenaStringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
 			{
 				if ((*lit) != "")
 					loopCnt++;
@@ -328,8 +328,8 @@ void CMatlabCounter::LSLOC(results* result, string line, string lineBak, string
 				continue;
 			}
 
-			tmp = CUtil::TrimString(line.substr(start, i - start + 1));
-			tmpBak = CUtil::TrimString(lineBak.substr(start, i - start + 1));
+			CUtil::AssignTrimString(tmp, line, start, i - start + 1);
+			CUtil::AssignTrimString(tmpBak, lineBak, start, i - start + 1);
 
 			if (cont_str && strLSLOC.length() > 0)
 			{
@@ -364,8 +364,8 @@ void CMatlabCounter::LSLOC(results* result, string line, string lineBak, string
 	}
 
 	// check for line continuation
-	tmp = CUtil::TrimString(line.substr(start, i - start));
-	tmpBak = CUtil::TrimString(lineBak.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
+	CUtil::AssignTrimString(tmpBak, lineBak, start, i - start);
 	if (tmp.length() > 3 && tmp.substr(tmp.length()-3, 3) == "...")
 	{
 		// strip off trailing (...)
@@ -373,7 +373,7 @@ void CMatlabCounter::LSLOC(results* result, string line, string lineBak, string
 		tmpBak = tmpBak.substr(0, tmpBak.length()-3);
 
 		// strip off trailing (') to continue string
-		str = CUtil::TrimString(tmp, 1);
+		CUtil::AssignTrimString(str, tmp, 0, string::npos, 1);
 		if (str[str.length()-1] == '\'')
 		{
 			len = str.length() - 1;
@@ -387,13 +387,15 @@ void CMatlabCounter::LSLOC(results* result, string line, string lineBak, string
 		{
 			if (cont_str)
 			{
-				strLSLOC += CUtil::TrimString(tmp.substr(0, strSize), -1);
-				strLSLOCBak += CUtil::TrimString(tmpBak.substr(0, strSize), -1);
+				CUtil::AppendTrimString(strLSLOC, tmp, 0, strSize, -1);
+				CUtil::AppendTrimString(strLSLOCBak, tmpBak, 0, strSize, -1);
 			}
 			else
 			{
-				strLSLOC += CUtil::TrimString(tmp.substr(0, strSize)) + " ";
-				strLSLOCBak += CUtil::TrimString(tmpBak.substr(0, strSize)) + " ";
+				CUtil::AppendTrimString(strLSLOC, tmp, 0, strSize);
+				strLSLOC += " ";
+				CUtil::AppendTrimString(strLSLOCBak, tmpBak, 0, strSize);
+				strLSLOCBak += " ";
 			}
 		}
 	}
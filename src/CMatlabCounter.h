@@ -22,10 +22,10 @@ public:
 	CMatlabCounter();
 
 protected:
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
-		bool &cont_str, unsigned int &openBrackets, StringVector &loopLevel);
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak,
+		bool &cont_str, unsigned int &openBrackets, ArenaStringVector &loopLevel);
 };
 
 #endif
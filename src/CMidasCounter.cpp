@@ -106,16 +106,16 @@ CMidasCounter::CMidasCounter()
 *
 * \return method status
 */
-int CMidasCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CMidasCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
 	unsigned int cnt = 0;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string strDirLine = "", tmp, tmpBak;
-	filemap::iterator itfmBak = fmapBak->begin();
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
 
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -126,7 +126,7 @@ int CMidasCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* f
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + tmp, directive, cnt, 1, exclude, "", "", &result->directive_count, false);
+			CountTally(" " + tmp, directive, cnt, 1, exclude, "", "", &result->directive_count, false);
 		}
 
 		if (!contd)
@@ -174,7 +174,7 @@ int CMidasCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* f
 				if (result->addSLOC(strDirLine, trunc_flag))
 					result->directive_lines[LOG]++;
 			}
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -194,9 +194,9 @@ int CMidasCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* f
 *
 * \return method status
 */
-int CMidasCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CMidasCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
 
 	bool data_continue = false;
@@ -206,7 +206,7 @@ int CMidasCounter::LanguageSpecificProcess(filemap* fmap, results* result, filem
 	unsigned int phys_data_lines = 0;
 	unsigned int temp_lines = 0;
 	unsigned int cnt = 0;
-	StringVector loopEnd;
+	ArenaStringVector loopEnd(arena);
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 
 	for (fit = fmap->begin(), fitbak = fmapBak->begin(); fit != fmap->end(); fit++, fitbak++)
@@ -227,7 +227,7 @@ int CMidasCounter::LanguageSpecificProcess(filemap* fmap, results* result, filem
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
 			}
 
 			// update physical SLOC lines
@@ -259,9 +259,9 @@ int CMidasCounter::LanguageSpecificProcess(filemap* fmap, results* result, filem
 * \param phys_data_lines number of physical data lines
 * \param loopEnd nested loop end string(s)
 */
-void CMidasCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
+void CMidasCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak,
 						  bool &data_continue, unsigned int &temp_lines, unsigned int &phys_exec_lines,
-						  unsigned int &phys_data_lines, StringVector &loopEnd)
+						  unsigned int &phys_data_lines, ArenaStringVector &loopEnd)
 {
 	size_t start = 0; //starting index of the working string
 	size_t i = 0, strSize;
@@ -356,8 +356,8 @@ void CMidasCounter::LSLOC(results* result, string line, string lineBak, string &
 				{
 					strLSLOC += tmp.substr(0, strSize);
 					strLSLOCBak += tmpBak.substr(0, strSize);
-					tmp = CUtil::TrimString(tmp.substr(start, tmp.length() - start));
-					tmpBak = CUtil::TrimString(tmpBak.substr(start, tmpBak.length() - start));
+					CUtil::AssignTrimString(tmp, tmp, start, tmp.length() - start);
+					CUtil::AssignTrimString(tmpBak, tmpBak, start, tmpBak.length() - start);
 				}
 				if (result->addSLOC(strLSLOCBak, trunc_flag))
 					result->exec_lines[LOG]++;
@@ -384,8 +384,8 @@ void CMidasCounter::LSLOC(results* result, string line, string lineBak, string &
 			{
 				strLSLOC += tmp.substr(0, strSize);
 				strLSLOCBak += tmpBak.substr(0, strSize);
-				tmp = CUtil::TrimString(tmp.substr(start, tmp.length() - start));
-				tmpBak = CUtil::TrimString(tmpBak.substr(start, tmpBak.length() - start));
+				CUtil::AssignTrimString(tmp, tmp, start, tmp.length() - start);
+				CUtil::AssignTrimString(tmpBak, tmpBak, start, tmpBak.length() - start);
 			}
 			if (result->addSLOC(strLSLOCBak, trunc_flag))
 				result->exec_lines[LOG]++;
@@ -416,7 +416,7 @@ void CMidasCounter::LSLOC(results* result, string line, string lineBak, string &
 
 		// make sure that we are not beginning to process a new data line
 		cnt = 0;
-		CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL, false);
+		CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL, false);
 
 		if (cnt > 0)
 			data_continue = true;
@@ -437,7 +437,7 @@ void CMidasCounter::LSLOC(results* result, string line, string lineBak, string &
 		if (result->addSLOC(strLSLOCBak, trunc_flag))
 		{
 			cnt = 0;
-			CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
+			CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
 
 			temp_lines++;
 			if (data_continue == true || cnt > 0)
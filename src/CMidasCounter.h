@@ -22,11 +22,11 @@ public:
 	CMidasCounter();
 
 protected:
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak,
 		bool &data_continue, unsigned int &temp_lines, unsigned int &phys_exec_lines,
-		unsigned int &phys_data_lines, StringVector &loopEnd);
+		unsigned int &phys_data_lines, ArenaStringVector &loopEnd);
 };
 
 #endif
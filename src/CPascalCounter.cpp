@@ -179,7 +179,7 @@ CPascalCounter::CPascalCounter()
 *
 * \return method status
 */
-int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fmapBak)
+int CPascalCounter::CountCommentsSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	if (BlockCommentStart.empty() && LineCommentStart.empty())
 		return 0;
@@ -203,7 +203,7 @@ int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 	string curBlckCmtStart, curBlckCmtEnd;
 	char CurrentQuoteEnd = 0;
 	bool quote_contd = false;
-	filemap::iterator itfmBak = fmapBak->begin();
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
 	
 	string strDirLine;
 	size_t strSize;
@@ -211,7 +211,7 @@ int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 
 	quote_idx_start = 0;
 
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		contd_nextline = false;
 
@@ -223,7 +223,7 @@ int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 		if (quote_contd)
 		{
 			// Replace quote until next character
-			ReplaceQuote(iter->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
+			ReplaceQuote(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
 			if (quote_contd)
 				continue;
 		}
@@ -247,7 +247,7 @@ int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 			// if found quote before comment, e.g., "this is quote");//comment
 			if (quote_idx_start != string::npos && (comment_start == string::npos || quote_idx_start < comment_start))
 			{
-				ReplaceQuote(iter->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
+				ReplaceQuote(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
 				if (quote_idx_start > idx_start)
 				{
 					// comment delimiter inside quote
@@ -261,17 +261,17 @@ int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 				switch (comment_type)
 				{
 				case 1:	// line comment, definitely whole line
-					iter->line = "";
-					itfmBak->line = "";
+					fmap->edit(iter) = "";
+					fmapBak->edit(itfmBak) = "";
 					result->comment_lines++;
 					contd_nextline = true;
 					break;
 				case 2:	// line comment, possibly embedded
-					iter->line = iter->line.substr(0, idx_start);
-					itfmBak->line = itfmBak->line.substr(0, idx_start);
+					fmap->edit(iter) = iter->line.substr(0, idx_start);
+					fmapBak->edit(itfmBak) = itfmBak->line.substr(0, idx_start);
 					// trim trailing space
-					iter->line = CUtil::TrimString(iter->line, 1);
-					itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+					fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+					fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 					if (iter->line.empty())
 						result->comment_lines++;	// whole line
 					else
@@ -317,8 +317,8 @@ int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 							}
 							else
 								result->comment_lines++;
-							iter->line = "";
-							itfmBak->line = "";
+							fmap->edit(iter) = "";
+							fmapBak->edit(itfmBak) = "";
 						}
 						else if (comment_type == 4)
 						{
@@ -329,11 +329,11 @@ int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 									strDirLine = itfmBak->line.substr(idx_start, strSize);
 								result->directive_lines[PHY]++;
 							}
-							iter->line = iter->line.substr(0, idx_start);
-							itfmBak->line = itfmBak->line.substr(0, idx_start);
+							fmap->edit(iter) = iter->line.substr(0, idx_start);
+							fmapBak->edit(itfmBak) = itfmBak->line.substr(0, idx_start);
 							// trim trailing space
-							iter->line = CUtil::TrimString(iter->line, 1);
-							itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+							fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+							fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 							if (!isDirective)
 							{
 								if (iter->line.empty())
@@ -361,8 +361,8 @@ int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 							result->directive_lines[PHY]++;
 						}
 						contd = false;
-						iter->line.erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
-						itfmBak->line.erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
+						fmap->edit(iter).erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
+						fmapBak->edit(itfmBak).erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
 						if (isDirective)
 						{
 							if (result->addSLOC(strDirLine, trunc_flag))
@@ -376,8 +376,8 @@ int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 							else
 							{
 								// trim trailing space
-								iter->line = CUtil::TrimString(iter->line, 1);
-								itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+								fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+								fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 								if (iter->line.empty())
 									result->comment_lines++;	// whole line
 								else
@@ -413,7 +413,7 @@ int CPascalCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 *
 * \return method status
 */
-int CPascalCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CPascalCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool		found_block			= false;
 	bool		found_forifwhile	= false;
@@ -422,9 +422,9 @@ int CPascalCounter::LanguageSpecificProcess(filemap* fmap, results* result, file
 	string		strLSLOC			= "";
 	string		strLSLOCBak			= "";
 
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
-	StringVector loopLevel;
+	ArenaStringVector loopLevel(arena);
 	unsigned int cnt = 0;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 
@@ -444,7 +444,7 @@ int CPascalCounter::LanguageSpecificProcess(filemap* fmap, results* result, file
 				found_forifwhile, found_end, found_loop, loopLevel);
 
 			cnt = 0;
-			CUtil::CountTally(line, data_name_list, cnt, 1, exclude, "", "", NULL, false);
+			CountTally(line, data_name_list, cnt, 1, exclude, "", "", NULL, false);
 
 			// need to check also if the data line continues
 			if (cnt > 0)
@@ -455,7 +455,7 @@ int CPascalCounter::LanguageSpecificProcess(filemap* fmap, results* result, file
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
 			}
 		}
 	}
@@ -480,8 +480,8 @@ int CPascalCounter::LanguageSpecificProcess(filemap* fmap, results* result, file
 * \param found_loop found loop flag
 * \param loopLevel nested loop level
 */
-void CPascalCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, bool &found_block,
-						   bool &found_forifwhile, bool &found_end, bool &found_loop, StringVector &loopLevel)
+void CPascalCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, bool &found_block,
+						   bool &found_forifwhile, bool &found_end, bool &found_loop, ArenaStringVector &loopLevel)
 {
 	size_t start = 0; // starting index of the working string
 	size_t i, tempi, strSize;
@@ -489,7 +489,7 @@ void CPascalCounter::LSLOC(results* result, string line, string lineBak, string
 	string tmp;
 	bool trunc_flag = false;
 	unsigned int loopCnt;
-	StringVector::iterator lit;
+	ArenaStringVector::iterator lit;
 	string keywordchars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 
 	// there may be more than 1 logical SLOC in a line
@@ -557,7 +557,8 @@ void CPascalCounter::LSLOC(results* result, string line, string lineBak, string
 		}
 
 		// if it ends in xxx, then it has already been counted, so ignore it
-		tmp = "xxx " + CUtil::TrimString(line.substr(start, i + 1 - start));
+		tmp = "xxx ";
+		CUtil::AppendTrimString(tmp, line, start, i + 1 - start);
 		if (CUtil::FindKeyword(tmp, "end", 0, TO_END_OF_STRING, false) != string::npos)
 		{
 			// check for 'end,' and skip
@@ -785,12 +786,12 @@ void CPascalCounter::LSLOC(results* result, string line, string lineBak, string
 		}
 	}
 
-	tmp = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
 	strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 	if (strSize > 0)
 	{
 		strLSLOC += tmp.substr(0, strSize);
-		tmp = CUtil::TrimString(lineBak.substr(start, i - start));
+		CUtil::AssignTrimString(tmp, lineBak, start, i - start);
 		strLSLOCBak += tmp.substr(0, strSize);
 	}
 	if (tmp == "")
@@ -822,7 +823,7 @@ void CPascalCounter::FoundSLOC(results* result, string &strLSLOC, string &strLSL
 	{
 		// determine logical type, data declaration or executable
 		unsigned int cnt = 0;
-		CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
+		CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
 		if (cnt > 0)
 			result->data_lines[LOG] += 1;
 		else
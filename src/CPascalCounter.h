@@ -22,10 +22,10 @@ public:
 	CPascalCounter();
 
 protected:
-	virtual int CountCommentsSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapmBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, bool &found_block,
-		bool &found_forifwhile, bool &found_end, bool &found_loop, StringVector &loopLevel);
+	virtual int CountCommentsSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapmBak = NULL);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, bool &found_block,
+		bool &found_forifwhile, bool &found_end, bool &found_loop, ArenaStringVector &loopLevel);
 	void FoundSLOC(results* result, string &strLSLOC, string &strLSLOCBak, bool &found_block,
 		bool &found_forifwhile, bool &found_end, bool &trunc_flag);
 };
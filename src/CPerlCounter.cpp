@@ -23,6 +23,7 @@ CPerlCounter::CPerlCounter()
 	QuoteStart = "\"'/";
 	QuoteEnd = "\"'/";
 	QuoteEscapeRear = '\"';
+	customReplaceQuote = true;
 
 	directive.push_back("import");
 	directive.push_back("no");
@@ -144,10 +145,10 @@ CPerlCounter::CPerlCounter()
 *
 * \return method status
 */
-int CPerlCounter::PreCountProcess(filemap* fmap)
+int CPerlCounter::PreCountProcess(filemapOverlay* fmap)
 {
 	size_t i, j;
-	filemap::iterator fit;
+	filemapOverlay::iterator fit;
 	for (fit = fmap->begin(); fit != fmap->end(); fit++) 
 	{
 		if (fit->line.empty())
@@ -157,19 +158,19 @@ int CPerlCounter::PreCountProcess(filemap* fmap)
 		{
 			if (fit->line[i-1] == '{' && fit->line[i] == '$')
 			{
-				fit->line[i-1] = '$';
+				fmap->edit(fit)[i-1] = '$';
 				for (j = i+1; j < fit->line.length(); j++)
 				{
 					if (fit->line[j] == '}')
 					{
-						fit->line[j] = '$';
+						fmap->edit(fit)[j] = '$';
 						break;
 					}
 				}
 			}
 			if (fit->line[i-1] == '$' &&
 				(fit->line[i] == '#' || fit->line[i] == '\'' || fit->line[i] == '"' || fit->line[i] == '`'))
-				fit->line[i] = '$';
+				fmap->edit(fit)[i] = '$';
 		}
 	}
 	return 0;
@@ -262,7 +263,7 @@ int CPerlCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd,
 *
 * \return method status
 */
-int CPerlCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CPerlCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
@@ -270,8 +271,8 @@ int CPerlCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fm
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$/\\<>.+?!@#$%^&*()-+*";
 	string strDirLine = "";
 
-	filemap::iterator itfmBak = fmapBak->begin();
-	for (filemap::iterator iter = fmap->begin(); iter!=fmap->end(); iter++, itfmBak++)
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
+	for (filemapOverlay::iterator iter = fmap->begin(); iter!=fmap->end(); iter++, itfmBak++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -279,7 +280,7 @@ int CPerlCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fm
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
 		}
 
 		if (!contd)
@@ -320,7 +321,7 @@ int CPerlCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fm
 				if (result->addSLOC(strDirLine, trunc_flag))
 					result->directive_lines[LOG]++;
 			}
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -340,7 +341,7 @@ int CPerlCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fm
 *
 * \return method status
 */
-int CPerlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CPerlCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	string strLSLOC;
 	string strLSLOCBak;
@@ -353,7 +354,7 @@ int CPerlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 	unsigned int cnt = 0;
 	size_t comPos = string::npos;
 	size_t p;
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_";
 	bool data_continue = false;
@@ -361,7 +362,7 @@ int CPerlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 	unsigned int phys_data_lines = 0;
 	unsigned int temp_lines = 0;
 	unsigned int openBrackets = 0;
-	StringVector loopLevel;
+	ArenaStringVector loopLevel(arena);
 
 	for (fit = fmap->begin(), fitbak = fmapBak->begin(); fit != fmap->end(); fit++, fitbak++)
 	{
@@ -409,7 +410,7 @@ int CPerlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 
 			result->exec_lines[PHY] += phys_exec_lines;
@@ -446,10 +447,10 @@ int CPerlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 * \param openBrackets number of open brackets (no matching close bracket)
 * \param loopLevel nested loop level
 */
-void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+void CPerlCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 	bool &forflag, bool &found_forifwhile, bool &found_while, char &prev_char, bool &data_continue,
 	unsigned int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines,
-	unsigned int &openBrackets, StringVector &loopLevel)
+	unsigned int &openBrackets, ArenaStringVector &loopLevel)
 {
 	size_t start = 0; // starting index of the working string
 	size_t i = 0, strSize, pos;
@@ -457,7 +458,7 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_";
 	unsigned int cnt = 0;
 	unsigned int loopCnt = 0;
-	StringVector::iterator lit;
+	ArenaStringVector::iterator lit;
 	string tmp = CUtil::TrimString(strLSLOC);
 	string tmp2;
 
@@ -521,7 +522,7 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 				if (!do_boolean)
 				{
 					// find for 'do' in string before tmp string
-					tmp = CUtil::TrimString(line.substr(start, i - start));
+					CUtil::AssignTrimString(tmp, line, start, i - start);
 
 					// check for 'do' statement
 					do_boolean = (tmp == "do");
@@ -560,14 +561,16 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 			if (line[i] == ';')
 			{
 				// check for empty statement (=1 LSLOC)
-				if (CUtil::TrimString(line.substr(start, i + 1 - start)) == ";" && strLSLOC.length() < 1)
+				if (CUtil::TrimStringEquals(line, start, i + 1 - start, ";") && strLSLOC.length() < 1)
 				{
 					strLSLOC = ";";
 					strLSLOCBak = ";";
 				}
 				else
 				{
-					tmp = CUtil::TrimString(strLSLOC + line.substr(start, i + 1 - start));
+					tmp = strLSLOC;
+					tmp.append(line, start, i + 1 - start);
+					CUtil::TrimStringInPlace(tmp);
 					pos = CUtil::FindKeyword(tmp, "foreach");
 					if (pos == string::npos)
 					{
@@ -587,7 +590,9 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 			if (pos != string::npos)
 			{
 				// capture statement before modifier
-				tmp2 = CUtil::TrimString(strLSLOCBak + lineBak.substr(start, i - start));
+				tmp2 = strLSLOCBak;
+				tmp2.append(lineBak, start, i - start);
+				CUtil::TrimStringInPlace(tmp2);
 				strSize = CUtil::TruncateLine(pos, 0, this->lsloc_truncate, trunc_flag);
 				if (strSize > 0)
 				{
@@ -621,7 +626,7 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 				if (result->addSLOC(strLSLOCBak, trunc_flag))
 				{
 					cnt = 0;
-					CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
+					CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
 
 					temp_lines++;
 					if (data_continue == true)
@@ -674,7 +679,8 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 			if (!forflag)
 			{
 				// handle 'for', 'foreach', 'while', 'if', 'elsif,  and 'unless'
-				tmp = "xxx " + CUtil::TrimString(line.substr(start, i));
+				tmp = "xxx ";
+				CUtil::AppendTrimString(tmp, line, start, i);
 				if ((CUtil::FindKeyword(tmp, "for") != string::npos) || (CUtil::FindKeyword(tmp, "foreach") != string::npos) ||
 					(CUtil::FindKeyword(tmp, "while")!= string::npos) || (CUtil::FindKeyword(tmp, "if") != string::npos) ||
 					(CUtil::FindKeyword(tmp, "elsif") != string::npos) || (CUtil::FindKeyword(tmp, "unless") != string::npos) ||
@@ -743,7 +749,9 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 				{
 					// handling 'for', 'foreach', 'while', 'if', 'elsif', 'unless', 'until'
 					// check for expression modifiers using 'foreach', 'while', 'if', 'unless', 'until' (for example, statement unless (condition);)
-					tmp = CUtil::TrimString(strLSLOC + line.substr(start, i + 1 - start));
+					tmp = strLSLOC;
+					tmp.append(line, start, i + 1 - start);
+					CUtil::TrimStringInPlace(tmp);
 					pos = CUtil::FindKeyword(tmp, "foreach");
 					if (pos == string::npos)
 					{
@@ -762,7 +770,9 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 					if (pos != string::npos)
 					{
 						// capture statement before modifier
-						tmp2 = CUtil::TrimString(strLSLOCBak + lineBak.substr(start, i + 1 - start));
+						tmp2 = strLSLOCBak;
+						tmp2.append(lineBak, start, i + 1 - start);
+						CUtil::TrimStringInPlace(tmp2);
 						strSize = CUtil::TruncateLine(pos, 0, this->lsloc_truncate, trunc_flag);
 						if (strSize > 0)
 						{
@@ -785,7 +795,7 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 						found_forifwhile = false;
 
 						// skip trailing ';'
-						tmp = CUtil::TrimString(line.substr(i + 1));
+						CUtil::AssignTrimString(tmp, line, i + 1);
 						if (tmp.length() > 0 && tmp[0] == ';')
 							i++;
 					}
@@ -844,12 +854,12 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 		i++;
 	}
 
-	tmp2 = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp2, line, start, i - start);
 	strSize = CUtil::TruncateLine(tmp2.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 	if (strSize > 0)
 	{
 		strLSLOC += tmp2.substr(0, strSize);
-		tmp2 = CUtil::TrimString(lineBak.substr(start, i - start));
+		CUtil::AssignTrimString(tmp2, lineBak, start, i - start);
 		strLSLOCBak += tmp2.substr(0, strSize);
 	}
 	if (tmp == "")
@@ -857,7 +867,7 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 
 	// make sure that we are not beginning to process a new data line
 	cnt = 0;
-	CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
+	CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
 
 	if (cnt > 0)
 		data_continue = true;
@@ -879,7 +889,7 @@ void CPerlCounter::LSLOC(results* result, string line, string lineBak, string &s
 * \return 1 if function name is found
 */
 int CPerlCounter::ParseFunctionName(const string &line, string &lastline,
-	filemap &functionStack, string &functionName, unsigned int &functionCount)
+	ArenaFilemap &functionStack, string &functionName, unsigned int &functionCount)
 {
 	string tline, str;
 	size_t i, idx, tidx, cnt;
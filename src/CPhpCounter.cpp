@@ -190,16 +190,16 @@ CPhpCounter::CPhpCounter()
 *
 * \return method status
 */
-int CPhpCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CPhpCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
 	unsigned int cnt = 0;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string strDirLine = "";
-	filemap::iterator itfmBak = fmapBak->begin();
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
 
-	for (filemap::iterator iter = fmap->begin(); iter!=fmap->end(); iter++, itfmBak++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter!=fmap->end(); iter++, itfmBak++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -207,7 +207,7 @@ int CPhpCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fma
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
 		}
 
 		if (!contd)
@@ -251,7 +251,7 @@ int CPhpCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fma
 				if (result->addSLOC(strDirLine, trunc_flag))
 					result->directive_lines[LOG]++;
 			}
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -271,7 +271,7 @@ int CPhpCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fma
 *
 * \return method status
 */
-int CPhpCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CPhpCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	unsigned int	paren_count			= 0;
 	bool			for_flag			= false;
@@ -284,9 +284,9 @@ int CPhpCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 	string			strLSLOC			= "";
 	string			strLSLOCBak			= "";
 
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
-	StringVector loopLevel;
+	ArenaStringVector loopLevel(arena);
 
 	unsigned int phys_exec_lines = 0;
 	unsigned int phys_data_lines = 0;
@@ -310,7 +310,7 @@ int CPhpCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 
 			result->exec_lines[PHY] += phys_exec_lines;
@@ -349,10 +349,10 @@ int CPhpCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 * \param found_for found for loop
 * \param loopLevel nested loop level
 */
-void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+void CPhpCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 						bool &forflag, bool &found_forifwhile, bool &found_while, char &prev_char, bool &data_continue,
 						unsigned int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines,
-						bool &inArrayDec, bool &found_for, StringVector &loopLevel)
+						bool &inArrayDec, bool &found_for, ArenaStringVector &loopLevel)
 {
 	size_t start = 0;
 	size_t i = 0, strSize;
@@ -388,7 +388,7 @@ void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &st
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exclude_loop, cnt, 1, exclude, "", "");
+				CountTally(line, exclude_loop, cnt, 1, exclude, "", "");
 				if (cnt > 0)
 				{
 					if ((unsigned int)loopLevel.size() > 0)
@@ -409,7 +409,7 @@ void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &st
 				{
 					if ((unsigned int)loopLevel.size() > 0 && loopLevel.back() != "")
 					{
-						tmp = CUtil::TrimString(line.substr(0, i));
+						CUtil::AssignTrimString(tmp, line, 0, i);
 						if (CUtil::FindKeyword(tmp, loopLevel.back()) != string::npos)
 						{
 							tmp = loopLevel.back() + ":";
@@ -422,7 +422,7 @@ void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &st
 
 			// check for excluded keywords for alternate control syntax (don't count as LSLOC)
 			cnt = 0;
-			CUtil::CountTally(line, exclude_keywords, cnt, 1, exclude, "", "");
+			CountTally(line, exclude_keywords, cnt, 1, exclude, "", "");
 			if (cnt > 0)
 			{
 				start = i + 1;
@@ -474,7 +474,7 @@ void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &st
 				if (!found_do && !found_try && !found_else && !found_declare)
 				{
 					// find 'do' in string before tmp string
-					tmp = CUtil::TrimString(line.substr(start, i - start));
+					CUtil::AssignTrimString(tmp, line, start, i - start);
 					found_do = (tmp == "do");			// found 'do' statement
 					found_try = (tmp == "try");			// found 'try' statement
 					found_else = (tmp == "else");		// found 'else' statement
@@ -516,7 +516,7 @@ void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &st
 			inArrayDec = false;
 
 			// check for empty statement (=1 LSLOC)
-			if (CUtil::TrimString(line.substr(start, i + 1 - start)) == ";" && strLSLOC.length() < 1)
+			if (CUtil::TrimStringEquals(line, start, i + 1 - start, ";") && strLSLOC.length() < 1)
 			{
 				strLSLOC = ";";
 				strLSLOCBak = ";";
@@ -533,7 +533,7 @@ void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &st
 			if (result->addSLOC(strLSLOCBak, trunc_flag))
 			{
 				cnt = 0;
-				CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
+				CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
 
 				temp_lines++;
 				if (data_continue == true && line[i] == ';')
@@ -589,7 +589,7 @@ void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &st
 			else
 			{
 				// handle 'for', 'foreach', 'while', 'if' the same way
-				tmp = CUtil::TrimString(line.substr(start, i));
+				CUtil::AssignTrimString(tmp, line, start, i);
 				if (CUtil::FindKeyword(tmp, "for") != string::npos
 					|| CUtil::FindKeyword(tmp, "foreach") != string::npos
 					|| CUtil::FindKeyword(tmp, "while")!= string::npos
@@ -626,7 +626,7 @@ void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &st
 							CUtil::FindKeyword(tmp, "switch") == string::npos)
 						{
 							unsigned int loopCnt = 0;
-							for (StringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
+							for (ArenaStringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
 							{
 								if ((*lit) != "")
 									loopCnt++;
@@ -705,12 +705,12 @@ void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &st
 		i++;
 	}
 
-	tmp = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
 	strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 	if (strSize > 0)
 	{
 		strLSLOC += tmp.substr(0, strSize);
-		tmp = CUtil::TrimString(lineBak.substr(start, i - start));
+		CUtil::AssignTrimString(tmp, lineBak, start, i - start);
 		strLSLOCBak += tmp.substr(0, strSize);
 
 		// drop continuation symbol
@@ -723,7 +723,7 @@ void CPhpCounter::LSLOC(results* result, string line, string lineBak, string &st
 	
 	// make sure that we are not beginning to process a new data line
 	cnt = 0;
-	CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
+	CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
 
 	if (cnt > 0)
 		data_continue = true;
@@ -243,7 +243,7 @@ int CPythonCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd
 *
 * \return method status
 */
-int CPythonCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fmapBak)
+int CPythonCounter::CountCommentsSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	if (BlockCommentStart.empty() && LineCommentStart.empty())
 		return 0;
@@ -267,11 +267,11 @@ int CPythonCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 	string curBlckCmtStart, curBlckCmtEnd, tmp;
 	string CurrentQuoteEnd = "";
 	bool quote_contd = false;
-	filemap::iterator itfmBak = fmapBak->begin();
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
 
 	quote_idx_start = 0;
 
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		contd_nextline = false;
 
@@ -283,7 +283,7 @@ int CPythonCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 		if (quote_contd)
 		{
 			// Replace quote until next character
-			ReplaceQuote(iter->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
+			ReplaceQuote(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
 			if (quote_contd)
 				continue;
 		}
@@ -320,7 +320,7 @@ int CPythonCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 			// if found quote before comment, e.g., "this is quote");//comment
 			if (quote_idx_start != string::npos && (comment_start == string::npos || quote_idx_start < comment_start))
 			{
-				ReplaceQuote(iter->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
+				ReplaceQuote(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
 				if (quote_idx_start > idx_start && quote_idx_start != iter->line.length())
 				{
 					// comment delimiter inside quote
@@ -334,17 +334,17 @@ int CPythonCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 				switch (comment_type)
 				{
 				case 1:	// line comment, definitely whole line
-					iter->line = "";
-					itfmBak->line = "";
+					fmap->edit(iter) = "";
+					fmapBak->edit(itfmBak) = "";
 					result->comment_lines++;
 					contd_nextline = true;
 					break;
 				case 2:	// line comment, possibly embedded
-					iter->line = iter->line.substr(0, idx_start);
-					itfmBak->line = itfmBak->line.substr(0, idx_start);
+					fmap->edit(iter) = iter->line.substr(0, idx_start);
+					fmapBak->edit(itfmBak) = itfmBak->line.substr(0, idx_start);
 					// trim trailing space
-					iter->line = CUtil::TrimString(iter->line, 1);
-					itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+					fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+					fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 					if (iter->line.empty())
 						result->comment_lines++;	// whole line
 					else
@@ -362,17 +362,17 @@ int CPythonCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 					{
 						if (comment_type == 3)
 						{
-							iter->line = "";
-							itfmBak->line = "";
+							fmap->edit(iter) = "";
+							fmapBak->edit(itfmBak) = "";
 							result->comment_lines++;
 						}
 						else if (comment_type == 4)
 						{
-							iter->line = iter->line.substr(0, idx_start);
-							itfmBak->line = itfmBak->line.substr(0, idx_start);
+							fmap->edit(iter) = iter->line.substr(0, idx_start);
+							fmapBak->edit(itfmBak) = itfmBak->line.substr(0, idx_start);
 							// trim trailing space
-							iter->line = CUtil::TrimString(iter->line, 1);
-							itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+							fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+							fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 							if (iter->line.empty())
 								result->comment_lines++;	// whole line
 							else
@@ -385,15 +385,15 @@ int CPythonCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 					else
 					{
 						contd = false;
-						iter->line.erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
-						itfmBak->line.erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
+						fmap->edit(iter).erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
+						fmapBak->edit(itfmBak).erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
 						if (iter->line.empty())
 							result->comment_lines++;
 						else
 						{
 							// trim trailing space
-							iter->line = CUtil::TrimString(iter->line, 1);
-							itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+							fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+							fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 							if (iter->line.empty())
 								result->comment_lines++;	// whole line
 							else
@@ -423,7 +423,7 @@ int CPythonCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *f
 *
 * \return method status
 */
-int CPythonCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CPythonCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
@@ -431,8 +431,8 @@ int CPythonCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string strDirLine = "";
 
-	filemap::iterator itfmBak = fmapBak->begin();
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -440,7 +440,7 @@ int CPythonCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
 		}
 
 		if (!contd)
@@ -484,7 +484,7 @@ int CPythonCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 				if (result->addSLOC(strDirLine, trunc_flag))
 					result->directive_lines[LOG]++;
 			}
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -504,13 +504,13 @@ int CPythonCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 *
 * \return method status
 */
-int CPythonCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CPythonCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	unsigned int	paren_count			= 0;
 	string			strLSLOC			= "";
 	string			strLSLOCBak			= "";
 
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
 	UIntVector loopWhiteSpace;
 
@@ -532,7 +532,7 @@ int CPythonCounter::LanguageSpecificProcess(filemap* fmap, results* result, file
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 		}
 	}
@@ -560,14 +560,14 @@ esp. compound statement with : in middle line, not in () [] {} or in else:
 * is handled before it is called.
 *
 * \param result counter results
-* \param line processed physical line of code
-* \param lineBak original physical line of code
+* \param physLine processed physical line of code
+* \param physLineBak original physical line of code
 * \param strLSLOC processed logical string
 * \param strLSLOCBak original logical string
 * \param paren_cnt count of parenthesis
 * \param loopWhiteSpace count of white space to determine loop ends
 */
-void CPythonCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
+void CPythonCounter::LSLOC(results* result, const string &physLine, const string &physLineBak, string &strLSLOC, string &strLSLOCBak,
 						   unsigned int &paren_cnt, UIntVector &loopWhiteSpace)
 {
 #define CONT_STR_LENGTH 18
@@ -599,9 +599,9 @@ void CPythonCounter::LSLOC(results* result, string line, string lineBak, string
 		if (loopWhiteSpace.size() > 0)
 		{
 			// get white space
-			tmp = line;
-			tmp = CUtil::TrimString(tmp, -1);
-			numWS = (unsigned)(line.length() - tmp.length());
+			tmp = physLine;
+			CUtil::TrimStringInPlace(tmp, -1);
+			numWS = (unsigned)(physLine.length() - tmp.length());
 
 			// check for loop ends
 			for (n = (int)loopWhiteSpace.size() - 1; n >= 0; n--)
@@ -615,15 +615,15 @@ void CPythonCounter::LSLOC(results* result, string line, string lineBak, string
 
 		// check for loop keywords (for, while)
 		cnt = 0;
-		CUtil::CountTally(line, loop_keywords, cnt, 1, exclude, "", "", NULL);
+		CountTally(physLine, loop_keywords, cnt, 1, exclude, "", "", NULL);
 		if (cnt > 0)
 		{
 			if (loopWhiteSpace.size() < 1)
 			{
 				// get white space
-				tmp = line;
-				tmp = CUtil::TrimString(tmp, -1);
-				numWS = (unsigned)(line.length() - tmp.length());
+				tmp = physLine;
+				CUtil::TrimStringInPlace(tmp, -1);
+				numWS = (unsigned)(physLine.length() - tmp.length());
 			}
 
 			// add nested loop white space and record nested loop level
@@ -639,8 +639,10 @@ void CPythonCounter::LSLOC(results* result, string line, string lineBak, string
 		}
 	}
 
-	line = CUtil::TrimString(line);
-	lineBak = CUtil::TrimString(lineBak);
+	// logical lines are built from the trimmed line
+	string line, lineBak;
+	CUtil::AssignTrimString(line, physLine);
+	CUtil::AssignTrimString(lineBak, physLineBak);
 	size_t line_length = line.length();
 	bool lineContinued = false;
 
@@ -660,7 +662,8 @@ void CPythonCounter::LSLOC(results* result, string line, string lineBak, string
 		// 2. if no parentheses enclosing, and if the char is a statement separator
 		if (paren_cnt == 0 && (line[i] == ';' || line[i] == ':'))
 		{
-			tmp = CUtil::ClearRedundantSpaces(line);
+			tmp = line;
+			CUtil::ClearRedundantSpacesInPlace(tmp);
 			// if line[..i] is else: then exit the outer if
 			if (tmp.rfind("else:") != tmp.length() - 5)
 			{
@@ -729,12 +732,12 @@ void CPythonCounter::LSLOC(results* result, string line, string lineBak, string
 		}
 		else
 		{
-			tmp = CUtil::TrimString(line.substr(start, line_length - start));
+			CUtil::AssignTrimString(tmp, line, start, line_length - start);
 			strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 			if (strSize > 0)
 			{
 				strLSLOC += tmp.substr(0, strSize);
-				tmp = CUtil::TrimString(lineBak.substr(start, line_length - start));
+				CUtil::AssignTrimString(tmp, lineBak, start, line_length - start);
 				strLSLOCBak += tmp.substr(0, strSize);
 			}
 		}
@@ -25,10 +25,10 @@ protected:
 	StringVector loop_keywords;		//!< List of keywords to indicate the beginning of a loop
 
 	virtual int ReplaceQuote(string &strline, size_t &idx_start, bool &contd, string &CurrentQuoteEnd);
-	virtual int CountCommentsSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak,
+	virtual int CountCommentsSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	void LSLOC(results* result, const string &physLine, const string &physLineBak, string &strLSLOC, string &strLSLOCBak,
 		unsigned int &paren_cnt, UIntVector &loopWhiteSpace);
 };
 
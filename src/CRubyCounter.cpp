@@ -20,6 +20,7 @@ CRubyCounter::CRubyCounter()
 	QuoteStart = "\"'%/<";
 	QuoteEnd = "\"'/";
 	QuoteEscapeFront = '\\';
+	customReplaceQuote = true;
 	ContinueLine = ".,\\+-*/";
 
 	BlockCommentStart.push_back("=begin");
@@ -240,7 +241,8 @@ int CRubyCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd,
 						if (idx == string::npos)
 							idx = strlen;
 						idx = idx - 1;
-						string tstrline = CUtil::TrimString(strline.substr(i + 2, idx + 1 - i - 2));
+						string tstrline;
+						CUtil::AssignTrimString(tstrline, strline, i + 2, idx + 1 - i - 2);
 						
 						strline[idx] = ContinueLine[0]; // indicate that the string will continue in the next line, so one SLOC is counted
 						idx_start = idx + 1;
@@ -249,9 +251,9 @@ int CRubyCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd,
 
 						// if yes, get the last delimiter
 						if (idx != string::npos)
-							tstrline = tstrline.substr(idx + 1, tstrline.length());
+							tstrline.erase(0, idx + 1);
 
-						tstrline = CUtil::TrimString(tstrline);
+						CUtil::TrimStringInPlace(tstrline);
 
 						size_t i1 = 0;
 						if (tstrline.length() > 2 && (tstrline.substr(0, 2) == "-\"" || tstrline.substr(0, 2) == "-'"))
@@ -370,14 +372,14 @@ int CRubyCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd,
 *
 * \return method status
 */
-int CRubyCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CRubyCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	string strLSLOC    = "";
 	string strLSLOCBak = "";
 
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
-	StringVector loopLevel;
+	ArenaStringVector loopLevel(arena);
 
 	unsigned int cnt = 0;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
@@ -397,7 +399,7 @@ int CRubyCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(" " + line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(" " + line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 
 			// no data declaration in Ruby
@@ -420,7 +422,7 @@ int CRubyCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 * \param strLSLOC processed logical string
 * \param strLSLOCBak original logical string
 */
-void CRubyCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak)
+void CRubyCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak)
 {
 	static string control_modifiers[] = {"if", "for", "unless", "while", "until", "when", "close", "elsif", "else", "then"};
 	static size_t control_mod_cnt = 10;
@@ -478,7 +480,7 @@ void CRubyCounter::LSLOC(results* result, string line, string lineBak, string &s
 			if (line[idx] == ';')
 			{
 				strSize = CUtil::TruncateLine(idx + 1 - start, strLSLOC.length(), this->lsloc_truncate, trunc_flag);
-				if (strSize > 1 && CUtil::TrimString(line.substr(start, strSize - 1)) != ";")
+				if (strSize > 1 && !CUtil::TrimStringEquals(line, start, strSize - 1, ";"))
 				{
 					// only include ';' if it stands alone
 					strSize--;
@@ -534,7 +536,7 @@ void CRubyCounter::LSLOC(results* result, string line, string lineBak, string &s
 				}
 			}
 		}
-		if (CUtil::TrimString(strLSLOC).length() == 0)
+		if (CUtil::CheckBlank(strLSLOC))
 			return;
 
 		// add SLOC
@@ -545,7 +547,7 @@ void CRubyCounter::LSLOC(results* result, string line, string lineBak, string &s
 		if (idx != 0 && idx != string::npos)
 		{
 			start = idx;
-			tline = CUtil::TrimString(line.substr(start));
+			CUtil::AssignTrimString(tline, line, start);
 		}
 		else
 			start = string::npos;
@@ -0,0 +1,680 @@
+//! Code counter class methods for languages defined by a specification file.
+/*!
+* \file CSpecCounter.cpp
+*
+* This file contains the code counter class methods for languages defined by a specification file.
+*/
+
+#include <sstream>
+#include <ctype.h>
+
+#include "CSpecCounter.h"
+
+//! Keyword lists of a language specification (by key name).
+static const struct
+{
+	const char *key;					// key in the specification file
+	StringVector langSpec::*list;		// keyword list
+} specKeywordLists[] =
+{
+	{ "directive",	&langSpec::directive },
+	{ "data",		&langSpec::data },
+	{ "exec",		&langSpec::exec },
+	{ "math",		&langSpec::math },
+	{ "trig",		&langSpec::trig },
+	{ "log",		&langSpec::logarithm },
+	{ "calc",		&langSpec::calc },
+	{ "cond",		&langSpec::cond },
+	{ "logic",		&langSpec::logic },
+	{ "preproc",	&langSpec::preproc },
+	{ "assign",		&langSpec::assign },
+	{ "pointer",	&langSpec::pointer },
+	{ "cyclomatic",	&langSpec::cyclomatic }
+};
+
+#define MAX_SPEC_DELIMITERS		255		//!< Most block comments or quotes of a language (indexes fit in a byte)
+
+/*!
+* Builds the delimiter automaton of the language.
+* Mode 0 is code, then one mode for each block comment and each quote.
+*/
+void langSpec::Compile()
+{
+	size_t i, modes = ModeCount();
+
+	next.assign(modes * 256, 0);
+	acceptToken.assign(modes, TOKEN_NONE);
+	acceptIndex.assign(modes, 0);
+
+	for (i = 0; i < lineComment.size(); i++)
+		AddDelimiter(0, lineComment[i], TOKEN_LINE_COMMENT, i);
+	for (i = 0; i < blockCommentStart.size(); i++)
+	{
+		AddDelimiter(0, blockCommentStart[i], TOKEN_BLOCK_START, i);
+		AddDelimiter(BlockMode(i), blockCommentEnd[i], TOKEN_BLOCK_END, i);
+	}
+	for (i = 0; i < quoteStart.size(); i++)
+	{
+		AddDelimiter(0, string(1, quoteStart[i]), TOKEN_QUOTE_START, i);
+		AddDelimiter(QuoteMode(i), string(1, quoteEnd[i]), TOKEN_QUOTE_END, i);
+		if (escape != 0 && escape == quoteEnd[i])
+			AddDelimiter(QuoteMode(i), string(2, escape), TOKEN_QUOTE_LITERAL, i);
+		else if (escape != 0)
+			AddDelimiter(QuoteMode(i), string(1, escape), TOKEN_ESCAPE, i);
+	}
+	for (i = 0; i < terminators.size(); i++)
+		AddDelimiter(0, string(1, terminators[i]), TOKEN_TERMINATOR, i);
+}
+
+/*!
+* Adds a delimiter to the automaton.
+* A delimiter already added to the mode keeps its token.
+*
+* \param mode automaton mode
+* \param text delimiter
+* \param token delimiter token
+* \param idx index of the delimiter in its list
+*/
+void langSpec::AddDelimiter(size_t mode, const string &text, SpecToken token, size_t idx)
+{
+	size_t state = mode;
+	unsigned int target;
+	unsigned char c, lower, upper;
+
+	if (text.empty())
+		return;
+	for (size_t i = 0; i < text.length(); i++)
+	{
+		c = (unsigned char)text[i];
+		lower = (unsigned char)tolower(c);
+		upper = (unsigned char)toupper(c);
+		target = next[state * 256 + c];
+		if (target == 0 && !caseSensitive)
+			target = (next[state * 256 + lower] != 0) ? next[state * 256 + lower] : next[state * 256 + upper];
+		if (target == 0)
+		{
+			target = (unsigned int)acceptToken.size();
+			next.resize(next.size() + 256, 0);
+			acceptToken.push_back(TOKEN_NONE);
+			acceptIndex.push_back(0);
+		}
+		next[state * 256 + c] = target;
+		if (!caseSensitive)
+		{
+			next[state * 256 + lower] = target;
+			next[state * 256 + upper] = target;
+		}
+		state = target;
+	}
+	if (acceptToken[state] == TOKEN_NONE)
+	{
+		acceptToken[state] = (unsigned char)token;
+		acceptIndex[state] = (unsigned char)idx;
+	}
+}
+
+/*!
+* Constructs a CSpecCounter object.
+*
+* \param langspec compiled specification of the language (kept for the life of the counter)
+*/
+CSpecCounter::CSpecCounter(const langSpec *langspec)
+{
+	spec = langspec;
+	classtype = spec->classtype;
+	language_name = spec->name;
+	casesensitive = spec->caseSensitive;
+	file_extension = spec->extensions;
+
+	// the delimiters are also kept in the common counter members
+	QuoteStart = spec->quoteStart;
+	QuoteEnd = spec->quoteEnd;
+	QuoteEscapeFront = spec->escape;
+	ContinueLine = spec->continuation;
+	LineCommentStart = spec->lineComment;
+	BlockCommentStart = spec->blockCommentStart;
+	BlockCommentEnd = spec->blockCommentEnd;
+
+	directive = spec->directive;
+	data_name_list = spec->data;
+	exec_name_list = spec->exec;
+	math_func_list = spec->math;
+	trig_func_list = spec->trig;
+	log_func_list = spec->logarithm;
+	cmplx_calc_list = spec->calc;
+	cmplx_cond_list = spec->cond;
+	cmplx_logic_list = spec->logic;
+	cmplx_preproc_list = spec->preproc;
+	cmplx_assign_list = spec->assign;
+	cmplx_pointer_list = spec->pointer;
+	cmplx_cyclomatic_list = spec->cyclomatic;
+
+	exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
+	emptyStatement = spec->terminators + " \t";
+}
+
+/*!
+* Processes and counts the source file.
+* Each line is scanned once: the automaton removes the comments and replaces the quoted
+* strings, then the line is counted as a directive or as part of the current statement.
+*
+* \param fmap list of file lines
+* \param result counter results
+*
+* \return method status
+*/
+int CSpecCounter::CountSLOC(filemap* fmap, results* result)
+{
+	// all containers using the arena are local to the count
+	fileArenaReset arenaReset(arena);
+	size_t mode = 0;
+	size_t first, last, segStart, strSize, i;
+	bool hasComment, continued, isDirective;
+	bool dirContd = false, dirTrunc = false, stmtTrunc = false, trunc;
+	unsigned int cnt, dataCnt, execCnt;
+	string code, codeBak, text, line, strDirLine, strLSLOC, strLSLOCBak;
+	UIntVector ends;
+	complexityState cmplxState(arena);
+
+	InitializeResultsCounts(result);
+	if (print_cmplx)
+		BeginComplexity(result, cmplxState);
+
+	for (filemap::iterator fit = fmap->begin(); fit != fmap->end(); fit++)
+	{
+		if (CUtil::CheckBlank(fit->line))
+		{
+			result->blank_lines++;
+			continue;
+		}
+
+		ScanLine(fit->line, mode, code, codeBak, ends, hasComment);
+
+		// trim the code left (code and codeBak have the same length and differ only inside quotes)
+		first = 0;
+		last = code.length();
+		while (first < last && (code[first] == ' ' || code[first] == '\t' || code[first] == '\r' || code[first] == '\f'))
+			first++;
+		while (last > first && (code[last-1] == ' ' || code[last-1] == '\t' || code[last-1] == '\r' || code[last-1] == '\f'))
+			last--;
+		if (first == last)
+		{
+			if (hasComment)
+				result->comment_lines++;
+			else
+				result->blank_lines++;
+			continue;
+		}
+		if (hasComment)
+			result->e_comm_lines++;
+
+		// continuation at the end of the line (outside quotes and comments)
+		continued = false;
+		if (mode == 0 && !spec->continuation.empty() && last - first >= spec->continuation.length() &&
+			code.compare(last - spec->continuation.length(), spec->continuation.length(), spec->continuation) == 0)
+		{
+			continued = true;
+			last -= spec->continuation.length();
+		}
+
+		text.assign(code, first, last - first);
+		line = " ";
+		line += text;
+
+		if (print_cmplx)
+			CountComplexityLine(text, result, cmplxState);
+
+		// directive lines
+		isDirective = dirContd;
+		if (!isDirective && strLSLOC.empty())
+		{
+			for (i = 0; i < directive.size(); i++)
+			{
+				if (CUtil::FindKeyword(text, directive[i], 0, TO_END_OF_STRING, casesensitive) == 0)
+				{
+					isDirective = true;
+					break;
+				}
+			}
+		}
+		if (isDirective)
+		{
+			if (print_cmplx)
+			{
+				cnt = 0;
+				CountTally(line, directive, cnt, 1, exclude, "", "", &result->directive_count, casesensitive);
+			}
+			result->directive_lines[PHY]++;
+			trunc = false;
+			strSize = CUtil::TruncateLine(last - first, strDirLine.length(), lsloc_truncate, trunc);
+			if (trunc)
+				dirTrunc = true;
+			if (strSize > 0)
+			{
+				if (!strDirLine.empty())
+					strDirLine += ' ';
+				strDirLine.append(codeBak, first, strSize);
+			}
+			dirContd = continued || mode != 0;
+			if (!dirContd)
+			{
+				if (result->addSLOC(strDirLine, dirTrunc))
+					result->directive_lines[LOG]++;
+				strDirLine.clear();
+				dirTrunc = false;
+			}
+			continue;
+		}
+
+		// physical line type from its keywords
+		dataCnt = execCnt = 0;
+		CountTally(line, data_name_list, dataCnt, 1, exclude, "", "", print_cmplx ? &result->data_name_count : NULL, casesensitive);
+		CountTally(line, exec_name_list, execCnt, 1, exclude, "", "", print_cmplx ? &result->exec_name_count : NULL, casesensitive);
+		if (dataCnt > 0 && execCnt == 0)
+			result->data_lines[PHY]++;
+		else
+			result->exec_lines[PHY]++;
+
+		// logical lines end at the terminators (or at the end of the line without terminators)
+		segStart = first;
+		for (i = 0; i < ends.size(); i++)
+		{
+			if (ends[i] <= segStart || ends[i] > last)
+				continue;
+			AppendStatement(code, codeBak, segStart, ends[i] - segStart, strLSLOC, strLSLOCBak, stmtTrunc);
+			EndStatement(result, strLSLOC, strLSLOCBak, stmtTrunc);
+			segStart = ends[i];
+		}
+		if (segStart < last)
+			AppendStatement(code, codeBak, segStart, last - segStart, strLSLOC, strLSLOCBak, stmtTrunc);
+		if (spec->terminators.empty() && !continued && mode == 0)
+			EndStatement(result, strLSLOC, strLSLOCBak, stmtTrunc);
+	}
+
+	// statements not ended by the end of the file
+	if (!strDirLine.empty() && result->addSLOC(strDirLine, dirTrunc))
+		result->directive_lines[LOG]++;
+	EndStatement(result, strLSLOC, strLSLOCBak, stmtTrunc);
+
+	if (print_cmplx)
+		EndComplexity(result, cmplxState);
+
+	return 0;
+}
+
+/*!
+* Adds the text of a scanned line to a plain run of the current mode.
+*
+* \param spec language specification
+* \param mode automaton mode
+* \param text chars of the run
+* \param len length of the run
+* \param code processed line
+* \param codeBak original line
+* \param hasComment set if the run is in a comment
+*/
+static inline void AppendScanRun(const langSpec *spec, size_t mode, const char *text, size_t len,
+								 string &code, string &codeBak, bool &hasComment)
+{
+	if (mode == 0)
+	{
+		code.append(text, len);
+		codeBak.append(text, len);
+	}
+	else if (mode >= spec->QuoteMode(0))
+	{
+		code.append(len, '$');
+		codeBak.append(text, len);
+	}
+	else
+		hasComment = true;
+}
+
+/*!
+* Scans a line with the delimiter automaton.
+* Comments are removed and quoted strings are replaced with '$' in code (codeBak keeps them).
+*
+* \param line line to scan
+* \param mode automaton mode at the start of the line, updated to the mode at its end
+* \param code processed line
+* \param codeBak original line without its comments
+* \param ends positions just past each statement terminator
+* \param hasComment does the line contain a comment?
+*/
+void CSpecCounter::ScanLine(const string &line, size_t &mode, string &code, string &codeBak, UIntVector &ends, bool &hasComment)
+{
+	const unsigned int *next = &spec->next[0];
+	const unsigned int *start;
+	const char *text = line.data();
+	size_t len = line.length(), pos = 0, run, end, matchEnd = 0;
+	unsigned int state, token, tokenIdx = 0;
+
+	code.clear();
+	codeBak.clear();
+	ends.clear();
+	hasComment = false;
+
+	while (pos < len)
+	{
+		// chars that cannot start a delimiter of the mode
+		start = next + mode * 256;
+		for (run = pos; run < len && start[(unsigned char)text[run]] == 0; run++)
+			;
+		if (run > pos)
+		{
+			AppendScanRun(spec, mode, text + pos, run - pos, code, codeBak, hasComment);
+			pos = run;
+			if (pos >= len)
+				break;
+		}
+
+		// longest delimiter starting here
+		token = langSpec::TOKEN_NONE;
+		state = (unsigned int)mode;
+		for (end = pos; end < len && (state = next[state * 256 + (unsigned char)text[end]]) != 0; end++)
+		{
+			if (spec->acceptToken[state] != langSpec::TOKEN_NONE)
+			{
+				token = spec->acceptToken[state];
+				tokenIdx = spec->acceptIndex[state];
+				matchEnd = end + 1;
+			}
+		}
+
+		switch (token)
+		{
+		case langSpec::TOKEN_LINE_COMMENT:
+			hasComment = true;
+			matchEnd = len;
+			break;
+		case langSpec::TOKEN_BLOCK_START:
+			hasComment = true;
+			mode = spec->BlockMode(tokenIdx);
+			break;
+		case langSpec::TOKEN_BLOCK_END:
+			hasComment = true;
+			mode = 0;
+			break;
+		case langSpec::TOKEN_QUOTE_START:
+			code.append(text + pos, matchEnd - pos);
+			codeBak.append(text + pos, matchEnd - pos);
+			mode = spec->QuoteMode(tokenIdx);
+			break;
+		case langSpec::TOKEN_QUOTE_END:
+			code.append(text + pos, matchEnd - pos);
+			codeBak.append(text + pos, matchEnd - pos);
+			mode = 0;
+			break;
+		case langSpec::TOKEN_ESCAPE:
+			// the escape char and the char it escapes
+			if (matchEnd < len)
+				matchEnd++;
+			AppendScanRun(spec, mode, text + pos, matchEnd - pos, code, codeBak, hasComment);
+			break;
+		case langSpec::TOKEN_QUOTE_LITERAL:
+			AppendScanRun(spec, mode, text + pos, matchEnd - pos, code, codeBak, hasComment);
+			break;
+		case langSpec::TOKEN_TERMINATOR:
+			code.append(text + pos, matchEnd - pos);
+			codeBak.append(text + pos, matchEnd - pos);
+			ends.push_back((unsigned int)code.length());
+			break;
+		default:
+			// only the start of a delimiter, keep the char
+			matchEnd = pos + 1;
+			AppendScanRun(spec, mode, text + pos, 1, code, codeBak, hasComment);
+			break;
+		}
+		pos = matchEnd;
+	}
+}
+
+/*!
+* Checks whether a logical line is a data declaration (data keywords and no executable keywords).
+*
+* \param text logical line
+*
+* \return is a data declaration?
+*/
+bool CSpecCounter::IsDataStatement(const string &text)
+{
+	unsigned int dataCnt = 0, execCnt = 0;
+	string line = " " + text;
+
+	CountTally(line, data_name_list, dataCnt, 1, exclude, "", "", NULL, casesensitive);
+	if (dataCnt == 0)
+		return false;
+	CountTally(line, exec_name_list, execCnt, 1, exclude, "", "", NULL, casesensitive);
+	return (execCnt == 0);
+}
+
+/*!
+* Appends a part of a line to the current logical line.
+*
+* \param code processed line
+* \param codeBak original line
+* \param pos start of the part
+* \param len length of the part
+* \param strLSLOC processed logical line
+* \param strLSLOCBak original logical line
+* \param trunc_flag set if the logical line is truncated
+*/
+void CSpecCounter::AppendStatement(const string &code, const string &codeBak, size_t pos, size_t len,
+								   string &strLSLOC, string &strLSLOCBak, bool &trunc_flag)
+{
+	bool trunc = false;
+	size_t strSize = CUtil::TruncateLine(len, strLSLOC.length(), lsloc_truncate, trunc);
+	if (trunc)
+		trunc_flag = true;
+	if (strSize > 0)
+	{
+		if (!strLSLOC.empty())
+		{
+			strLSLOC += ' ';
+			strLSLOCBak += ' ';
+		}
+		strLSLOC.append(code, pos, strSize);
+		strLSLOCBak.append(codeBak, pos, strSize);
+	}
+}
+
+/*!
+* Ends the current logical line and counts it as a data or executable line.
+*
+* \param result counter results
+* \param strLSLOC processed logical line
+* \param strLSLOCBak original logical line
+* \param trunc_flag is the logical line truncated?
+*/
+void CSpecCounter::EndStatement(results* result, string &strLSLOC, string &strLSLOCBak, bool &trunc_flag)
+{
+	// a statement of terminators only (empty statement) is not counted
+	if (strLSLOC.find_first_not_of(emptyStatement) != string::npos)
+	{
+		bool isData = IsDataStatement(strLSLOC);
+		if (result->addSLOC(strLSLOCBak, trunc_flag))
+		{
+			if (isData)
+				result->data_lines[LOG]++;
+			else
+				result->exec_lines[LOG]++;
+		}
+	}
+	strLSLOC.clear();
+	strLSLOCBak.clear();
+	trunc_flag = false;
+}
+
+/*!
+* Reads the language specifications of a file and compiles them.
+* Each language starts with "language = <name>" followed by "key = values" lines.
+* Values are separated by spaces or commas and lines starting with // are comments.
+*
+* \param fileName specification file
+* \param specs list of languages read
+* \param errors errors found (the languages with errors are not added)
+*
+* \return was the file read?
+*/
+bool CSpecCounter::ReadSpecFile(const string &fileName, vector<langSpec> &specs, StringVector &errors)
+{
+	ifstream fr(fileName.c_str(), ios::in);
+	string line, key, value, token, err;
+	StringVector tokens;
+	unsigned int lineNum = 0;
+	size_t idx, i, firstSpec = specs.size();
+	bool known;
+	StringVector badLanguages;
+
+	if (!fr.is_open())
+	{
+		errors.push_back("Error: Unable to open language specification file (" + fileName + ")");
+		return false;
+	}
+
+	while (getline(fr, line))
+	{
+		lineNum++;
+		CUtil::TrimStringInPlace(line);
+		if (line.empty() || line.compare(0, 2, "//") == 0)
+			continue;
+
+		stringstream where;
+		where << " in language specification file (" << fileName << ", line " << lineNum << ")";
+
+		idx = line.find('=');
+		if (idx == string::npos)
+		{
+			errors.push_back("Error: Expected <key> = <values>" + where.str());
+			continue;
+		}
+		key = CUtil::ToLower(CUtil::TrimString(line.substr(0, idx)));
+		value = CUtil::TrimString(line.substr(idx + 1));
+
+		if (key == "language")
+		{
+			specs.push_back(langSpec());
+			specs.back().name = value;
+			if (value.empty())
+				errors.push_back("Error: Missing language name" + where.str());
+			continue;
+		}
+		if (specs.size() == firstSpec)
+		{
+			errors.push_back("Error: Expected language = <name> first" + where.str());
+			continue;
+		}
+		langSpec &spec = specs.back();
+
+		// values may also be separated by commas (as extensions in -extfile)
+		for (i = 0; i < value.length(); i++)
+		{
+			if (value[i] == ',')
+				value[i] = ' ';
+		}
+		tokens.clear();
+		istringstream iss(value);
+		while (iss >> token)
+			tokens.push_back(token);
+
+		known = true;
+		if (key == "extensions")
+		{
+			for (i = 0; i < tokens.size(); i++)
+				spec.extensions.push_back(CUtil::ToLower(tokens[i]));
+		}
+		else if (key == "line_comment")
+			spec.lineComment.insert(spec.lineComment.end(), tokens.begin(), tokens.end());
+		else if (key == "block_comment")
+		{
+			if (tokens.size() % 2 != 0)
+				errors.push_back("Error: Block comments need a start and an end" + where.str());
+			for (i = 0; i + 1 < tokens.size(); i += 2)
+			{
+				spec.blockCommentStart.push_back(tokens[i]);
+				spec.blockCommentEnd.push_back(tokens[i+1]);
+			}
+		}
+		else if (key == "quote")
+		{
+			for (i = 0; i < tokens.size(); i++)
+			{
+				if (tokens[i].length() > 2)
+				{
+					errors.push_back("Error: A quote is one char (or a start and an end char)" + where.str());
+					continue;
+				}
+				spec.quoteStart += tokens[i][0];
+				spec.quoteEnd += tokens[i][tokens[i].length() - 1];
+			}
+		}
+		else if (key == "escape")
+		{
+			if (tokens.size() != 1 || tokens[0].length() != 1)
+				errors.push_back("Error: The escape is one char" + where.str());
+			else
+				spec.escape = tokens[0][0];
+		}
+		else if (key == "continuation")
+		{
+			if (tokens.size() > 1)
+				errors.push_back("Error: Only one line continuation is allowed" + where.str());
+			else if (tokens.size() == 1)
+				spec.continuation = tokens[0];
+		}
+		else if (key == "terminator")
+		{
+			for (i = 0; i < tokens.size(); i++)
+				spec.terminators += tokens[i];
+		}
+		else if (key == "case_sensitive")
+		{
+			value = CUtil::ToLower(value);
+			if (value == "yes" || value == "true")
+				spec.caseSensitive = true;
+			else if (value == "no" || value == "false")
+				spec.caseSensitive = false;
+			else
+				errors.push_back("Error: case_sensitive is yes or no" + where.str());
+		}
+		else
+		{
+			known = false;
+			for (i = 0; i < sizeof(specKeywordLists) / sizeof(specKeywordLists[0]); i++)
+			{
+				if (key == specKeywordLists[i].key)
+				{
+					StringVector &list = spec.*(specKeywordLists[i].list);
+					list.insert(list.end(), tokens.begin(), tokens.end());
+					known = true;
+					break;
+				}
+			}
+		}
+		if (!known)
+			errors.push_back("Error: Unknown key " + key + where.str());
+	}
+	fr.close();
+
+	// check and compile the languages
+	for (idx = firstSpec; idx < specs.size(); )
+	{
+		langSpec &spec = specs[idx];
+		err = "";
+		if (spec.name.empty())
+			err = "has no name";
+		else if (spec.extensions.empty())
+			err = "has no file extensions";
+		else if (spec.blockCommentStart.size() > MAX_SPEC_DELIMITERS || spec.quoteStart.size() > MAX_SPEC_DELIMITERS)
+			err = "has too many block comments or quotes";
+		if (!err.empty())
+		{
+			errors.push_back("Error: Language " + spec.name + " " + err + " in language specification file (" + fileName + ")");
+			specs.erase(specs.begin() + idx);
+			continue;
+		}
+		spec.Compile();
+		idx++;
+	}
+	return true;
+}
@@ -0,0 +1,110 @@
+//! Code counter class definition for languages defined by a specification file.
+/*!
+* \file CSpecCounter.h
+*
+* This file contains the code counter class definition for languages defined by a specification file.
+*/
+
+#ifndef CSpecCounter_h
+#define CSpecCounter_h
+
+#include "CCodeCounter.h"
+
+//! Language specification.
+/*!
+* \class langSpec
+*
+* Defines the comment, quote, continuation, keyword and statement rules of a language.
+* Compile() turns the delimiters into a byte level automaton that CSpecCounter runs over each line.
+*/
+class langSpec
+{
+public:
+	//! Delimiters recognized by the automaton.
+	enum SpecToken
+	{
+		TOKEN_NONE = 0,
+		TOKEN_LINE_COMMENT,			//!< Starts a comment to the end of the line
+		TOKEN_BLOCK_START,			//!< Starts a block comment
+		TOKEN_BLOCK_END,			//!< Ends a block comment
+		TOKEN_QUOTE_START,			//!< Starts a quoted string
+		TOKEN_QUOTE_END,			//!< Ends a quoted string
+		TOKEN_ESCAPE,				//!< Escapes the next char of a quoted string
+		TOKEN_QUOTE_LITERAL,		//!< Quote char written twice inside a quoted string
+		TOKEN_TERMINATOR			//!< Ends a statement
+	};
+
+	langSpec() : escape(0), caseSensitive(true), classtype(UNKNOWN) {}
+
+	void Compile();
+	size_t ModeCount() const { return 1 + blockCommentStart.size() + quoteStart.size(); }
+	size_t BlockMode(size_t idx) const { return 1 + idx; }									//!< Automaton mode inside a block comment
+	size_t QuoteMode(size_t idx) const { return 1 + blockCommentStart.size() + idx; }		//!< Automaton mode inside a quoted string
+
+	string name;							//!< Language name
+	StringVector extensions;				//!< File extensions
+	StringVector lineComment;				//!< Line comment delimiters
+	StringVector blockCommentStart;			//!< Block comment start delimiters
+	StringVector blockCommentEnd;			//!< Block comment end delimiters (same order as the starts)
+	string quoteStart;						//!< Quote start chars
+	string quoteEnd;						//!< Quote end chars (same order as the starts)
+	char escape;							//!< Escape char in quoted strings (0 if none)
+	string continuation;					//!< Line continuation at the end of a line
+	string terminators;						//!< Statement terminator chars (if empty each line is a statement)
+	bool caseSensitive;						//!< Are delimiters and keywords case sensitive?
+
+	StringVector directive;					//!< Directive keywords
+	StringVector data;						//!< Data declaration keywords
+	StringVector exec;						//!< Executable keywords
+	StringVector math;						//!< Math functions (complexity)
+	StringVector trig;						//!< Trigonometric functions (complexity)
+	StringVector logarithm;					//!< Logarithmic functions (complexity)
+	StringVector calc;						//!< Calculations (complexity)
+	StringVector cond;						//!< Conditionals (complexity)
+	StringVector logic;						//!< Logicals (complexity)
+	StringVector preproc;					//!< Preprocessor directives (complexity)
+	StringVector assign;					//!< Assignments (complexity)
+	StringVector pointer;					//!< Pointers (complexity)
+	StringVector cyclomatic;				//!< Cyclomatic complexity decision keywords (complexity)
+
+	ClassType classtype;					//!< Class type of the counters of the language
+
+	// delimiter automaton (built by Compile)
+	// state s has 256 transitions at next[s * 256], 0 is no transition
+	// the first ModeCount() states are the start states of the modes
+	vector<unsigned int> next;				//!< Transitions of each state
+	vector<unsigned char> acceptToken;		//!< Delimiter ending at each state (SpecToken)
+	vector<unsigned char> acceptIndex;		//!< Index of the delimiter in its list
+
+private:
+	void AddDelimiter(size_t mode, const string &text, SpecToken token, size_t idx);
+};
+
+//! Code counter class for languages defined by a specification file.
+/*!
+* \class CSpecCounter
+*
+* Defines the code counter class for languages defined by a specification file (-langfile).
+* Each line is scanned once with the compiled automaton of the language.
+*/
+class CSpecCounter : public CCodeCounter
+{
+public:
+	explicit CSpecCounter(const langSpec *langspec);
+	virtual int CountSLOC(filemap* fmap, results* result);
+
+	static bool ReadSpecFile(const string &fileName, vector<langSpec> &specs, StringVector &errors);
+
+protected:
+	void ScanLine(const string &line, size_t &mode, string &code, string &codeBak, UIntVector &ends, bool &hasComment);
+	bool IsDataStatement(const string &text);
+	void AppendStatement(const string &code, const string &codeBak, size_t pos, size_t len,
+		string &strLSLOC, string &strLSLOCBak, bool &trunc_flag);
+	void EndStatement(results* result, string &strLSLOC, string &strLSLOCBak, bool &trunc_flag);
+
+	const langSpec *spec;					//!< Specification of the language
+	string exclude;							//!< Chars that may not surround a keyword
+	string emptyStatement;					//!< Chars of a statement that is not counted (terminators and spaces)
+};
+
+#endif
@@ -23,6 +23,7 @@ CSqlCounter::CSqlCounter()
 	file_extension.push_back(".sql");
 	QuoteStart = "\"'";
 	QuoteEnd = "\"'";
+	customReplaceQuote = true;
 	LineCommentStart.push_back("--");
 
 	BlockCommentStart.push_back("/*");
@@ -217,12 +218,12 @@ int CSqlCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd, c
 *
 * \return method status
 */
-int CSqlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CSqlCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	size_t i, j, k, ind, nextInd;
 	unsigned int sloc_count, dsloc_count, lineNum;
 	string stmt, stmtBak, exec_keyword, data_keyword;
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 
 	unsigned int data_count	= 0;
 	unsigned int exec_count	= 0;
@@ -253,9 +254,9 @@ int CSqlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 
 		// check physical lines
 		exec_count = 0;
-		CUtil::CountTally(line, exec_name_list, exec_count, 1, exclude, "", "", &result->exec_name_count, false);
+		CountTally(line, exec_name_list, exec_count, 1, exclude, "", "", &result->exec_name_count, false);
 		data_count = 0;
-		CUtil::CountTally(line, data_name_list, data_count, 1, exclude, "", "", &result->data_name_count, false);
+		CountTally(line, data_name_list, data_count, 1, exclude, "", "", &result->data_name_count, false);
 		if (exec_count > 0 || (data_count <= 0 && !data_continue))
 		{
 			data_continue = false;
@@ -302,41 +303,41 @@ int CSqlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 				// check for executable statement keywords
 				sloc_count = 0;
 				dsloc_count = 0;
-				CUtil::CountTally(stmt, exec_name_list, sloc_count, 1, exclude, "", "", NULL, false);
+				CountTally(stmt, exec_name_list, sloc_count, 1, exclude, "", "", NULL, false);
 				if (sloc_count > 0)
 				{
 					// extract embedded SLOC from main content
 					if (pi == mapi)
 					{
-						fit->line.erase(pp, i - pp);
-						fitbak->line.erase(pp, i - pp);
+						fmap->edit(fit).erase(pp, i - pp);
+						fmapBak->edit(fitbak).erase(pp, i - pp);
 						line.erase(pp + 1, i - pp - 1);
 						lineBak.erase(pp + 1, i - pp - 1);
 						i = pp + 1;
 					}
 					else
 					{
-						fmap->at(pi).line.erase(pp);
-						fmapBak->at(pi).line.erase(pp);
+						fmap->edit(pi).erase(pp);
+						fmapBak->edit(pi).erase(pp);
 						for (j = pi + 1; j < mapi; j++)
 						{
-							fmap->at(j).line.clear();
-							fmapBak->at(j).line.clear();
+							fmap->edit(j).clear();
+							fmapBak->edit(j).clear();
 						}
-						fit->line.erase(0, i);
-						fitbak->line.erase(0, i);
+						fmap->edit(fit).erase(0, i);
+						fmapBak->edit(fitbak).erase(0, i);
 						line.erase(1, i - 1);
 						lineBak.erase(1, i - 1);
 						i = 1;
 					}
-					stmt = CUtil::TrimString(stmt.substr(1, stmt.length() - 2));
-					stmtBak = CUtil::TrimString(stmtBak.substr(1, stmtBak.length() - 2));
+					CUtil::AssignTrimString(stmt, stmt, 1, stmt.length() - 2);
+					CUtil::AssignTrimString(stmtBak, stmtBak, 1, stmtBak.length() - 2);
 					nestedSql.push_back(stmt);
 					nestedSqlBak.push_back(stmtBak);
 				}
 				else
 				{
-					CUtil::CountTally(stmt, data_name_list, dsloc_count, 1, exclude, "", "", NULL, false);
+					CountTally(stmt, data_name_list, dsloc_count, 1, exclude, "", "", NULL, false);
 					if (dsloc_count > 0)
 					{
 						// mark data keywords (not counted as LSLOC)
@@ -363,7 +364,7 @@ int CSqlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 									ind = CUtil::FindKeyword(fit->line, data_keyword, nextInd, i - 1, false);
 									if (ind != string::npos)
 									{
-										fit->line.replace(ind, 1, "$");
+										fmap->edit(fit).replace(ind, 1, "$");
 										nextInd = ind + 1;
 									}
 								}
@@ -375,7 +376,7 @@ int CSqlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 									ind = CUtil::FindKeyword(fmap->at(pi).line, data_keyword, nextInd, TO_END_OF_STRING, false);
 									if (ind != string::npos)
 									{
-										fmap->at(pi).line.replace(ind, 1, "$");
+										fmap->edit(pi).replace(ind, 1, "$");
 										nextInd = ind + 1;
 									}
 								}
@@ -388,7 +389,7 @@ int CSqlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 										ind = CUtil::FindKeyword(fmap->at(k).line, data_keyword, nextInd, TO_END_OF_STRING, false);
 										if (ind != string::npos)
 										{
-											fmap->at(k).line.replace(ind, 1, "$");
+											fmap->edit(k).replace(ind, 1, "$");
 											nextInd = ind + 1;
 										}
 									}
@@ -400,7 +401,7 @@ int CSqlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 									ind = CUtil::FindKeyword(fit->line, data_keyword, nextInd, i - 1, false);
 									if (ind != string::npos)
 									{
-										fit->line.replace(ind, 1, "$");
+										fmap->edit(fit).replace(ind, 1, "$");
 										nextInd = ind + 1;
 									}
 								}
@@ -472,7 +473,7 @@ int CSqlCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 * \param strLSLOCBak original logical string
 * \param data_continue continuation of a data declaration line
 */
-void CSqlCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, bool &data_continue)
+void CSqlCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, bool &data_continue)
 {
 	size_t i, ind, nextInd, startInd, endInd, strSize;
 	ptrdiff_t j;
@@ -495,7 +496,7 @@ void CSqlCounter::LSLOC(results* result, string line, string lineBak, string &st
 				if (exec_keyword == "grant" || exec_keyword == "revoke" || exec_keyword == "deny")
 				{
 					// ignore GRANT OPTION
-					if (line.length() <= ind + 12 || CUtil::ToLower(line.substr(ind, 12)) != "grant option")
+					if (line.length() <= ind + 12 || !CUtil::MatchAt(line, ind, "grant option", false))
 						gslocIndices.push_back(ind);
 				}
 				nextInd = ind + 1;
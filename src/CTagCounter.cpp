@@ -13,6 +13,7 @@
 CTagCounter::CTagCounter()
 {
 	casesensitive = false;
+	tagListSource = NULL;
 }
 
 /*!
@@ -28,10 +29,10 @@ CTagCounter::CTagCounter()
 *
 * \return method status
 */
-int CTagCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CTagCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	unsigned int cnt = 0;
-	filemap::iterator fit, fitBak;
+	filemapOverlay::iterator fit, fitBak;
 	string line, lineBak;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string strLSLOC, strLSLOCBak;
@@ -58,7 +59,7 @@ int CTagCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 			if (quote_contd)
 			{
 				// replace quote until next character
-				ReplaceQuote(fit->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
+				ReplaceQuote(fmap->edit(fit), quote_idx_start, quote_contd, CurrentQuoteEnd);
 			}
 			if (!quote_contd)
 			{
@@ -69,7 +70,7 @@ int CTagCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 					if (quote_idx_start == string::npos)
 						break;
 
-					ReplaceQuote(fit->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
+					ReplaceQuote(fmap->edit(fit), quote_idx_start, quote_contd, CurrentQuoteEnd);
 					if (quote_idx_start > idx_start)
 					{
 						// comment delimiter inside quote
@@ -111,7 +112,7 @@ int CTagCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 
 		cnt = 0;
 		if (data_name_list.size() > 0)
-			CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
+			CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
 
 		if (data_continue || cnt > 0)
 		{
@@ -129,7 +130,7 @@ int CTagCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 			{
 				fit = fmap->begin();
 				cnt = 0;
-				CUtil::CountTally(fit->line, data_name_list, cnt, 1, exclude, "", "", NULL);
+				CountTally(fit->line, data_name_list, cnt, 1, exclude, "", "", NULL);
 				if (cnt > 0)
 					result->exec_lines[PHY]++;
 			}
@@ -156,7 +157,7 @@ int CTagCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap
 * \param phys_exec_lines number of physical executable lines
 * \param phys_data_lines number of physical data lines
 */
-void CTagCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, char &prev_char,
+void CTagCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, char &prev_char,
 						bool &data_continue, unsigned int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines)
 {
 	size_t start = 0;
@@ -193,7 +194,7 @@ void CTagCounter::LSLOC(results* result, string line, string lineBak, string &st
 				{
 					cnt = 0;
 					if (data_name_list.size() > 0)
-						CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
+						CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
 
 					if (data_continue || cnt > 0)
 					{
@@ -226,7 +227,7 @@ void CTagCounter::LSLOC(results* result, string line, string lineBak, string &st
 			{
 				// skip excluded keywords
 				cnt = 0;
-				CUtil::CountTally(line.substr(start, i - start), exclude_keywords, cnt, 1, exclude, "", "", NULL);
+				CountTally(line.substr(start, i - start), exclude_keywords, cnt, 1, exclude, "", "", NULL);
 				if (cnt > 0)
 					start = i + 1;
 			}
@@ -234,7 +235,7 @@ void CTagCounter::LSLOC(results* result, string line, string lineBak, string &st
 		i++;
 	}
 
-	tmp = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
 	strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 	if (strSize > 0)
 	{
@@ -244,7 +245,7 @@ void CTagCounter::LSLOC(results* result, string line, string lineBak, string &st
 			strLSLOCBak += " ";
 		}
 		strLSLOC += tmp.substr(0, strSize);
-		tmp = CUtil::TrimString(lineBak.substr(start, i - start));
+		CUtil::AssignTrimString(tmp, lineBak, start, i - start);
 		strLSLOCBak += tmp.substr(0, strSize);
 	}
 
@@ -252,7 +253,7 @@ void CTagCounter::LSLOC(results* result, string line, string lineBak, string &st
 	cnt = 0;
 	if (!data_continue && data_name_list.size() > 0)
 	{
-		CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
+		CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
 		if (cnt > 0)
 			data_continue = true;
 	}
@@ -264,6 +265,8 @@ void CTagCounter::LSLOC(results* result, string line, string lineBak, string &st
 
 /*!
 * Counts HTML keywords in string.
+* The keywords are counted as tags ('<' followed by the keyword) with the compiled keyword lists
+* (see CCodeCounter::CountTally); the tag list is built once from the keyword list.
 *
 * \param base string to search
 * \param container set of keywords
@@ -275,67 +278,19 @@ void CTagCounter::LSLOC(results* result, string line, string lineBak, string &st
 * \param counter_container stores list of individual keyword counts (if specified)
 * \param case_sensitive language is case sensitive?
 */
-void CTagCounter::CountTagTally(string base, StringVector& container, unsigned int &count, int mode, string exclude,
-								string include1, string include2, UIntVector* counter_container, bool case_sensitive)
+void CTagCounter::CountTagTally(const string &base, StringVector &container, unsigned int &count, int mode, const string &exclude,
+								const string &include1, const string &include2, UIntVector* counter_container, bool case_sensitive)
 {
-	base = " " + base + " ";
-	string::size_type idx;
-	string base1, temp;
-	StringVector::iterator vit;
-	UIntVector::iterator cit;
-	unsigned int single_count = 0;
-
-	if (counter_container)
-		cit = counter_container->begin();
-
-	if (case_sensitive == false)
-	{
-		base1 = CUtil::ToLower(base);
-		for (vit = container.begin(); vit != container.end(); vit++)
-			(*vit) = CUtil::ToLower((*vit));
-	}
-	else
-		base1 = base;
-
-	if (mode == 1)
+	if (tagListSource != &container || tagList.size() != container.size())
 	{
-		// exclude mode
-		for (vit = container.begin(); vit != container.end(); vit++)
+		tagList.clear();
+		for (StringVector::iterator vit = container.begin(); vit != container.end(); vit++)
 		{
-			temp = "<" + *vit;
-			idx = base1.find(temp);
-			while (idx != string::npos)
-			{
-				if ((exclude.find(base1[idx+(temp.size())] ) == string::npos) &&
-					(exclude.find(base1[idx-1]) == string::npos))
-				{
-					count++;
-					single_count++;
-				}
-				idx = base1.find(temp, idx + (temp.size()));
-			}
-			if (counter_container)
-			{
-				(*cit) += single_count;
-				single_count = 0;
-				cit++;
-			}
-		}
-	}
-	else if (mode == 2)
-	{
-		// include mode
-		for (vit = container.begin(); vit != container.end(); vit++) 
-		{
-			temp = "<" + *vit;
-			idx = base1.find(temp);
-			while (idx != string::npos) 
-			{
-				if ((include1.find(base1[idx-1]) != string::npos) &&
-					(include2.find(base1[idx+(temp.size())]) != string::npos))
-					count++;
-				idx = base1.find(temp, idx + (temp.size()));
-			}
+			if (!case_sensitive)
+				CUtil::ToLowerInPlace(*vit);
+			tagList.push_back("<" + *vit);
 		}
+		tagListSource = &container;
 	}
+	CountTally(base, tagList, count, mode, exclude, include1, include2, counter_container, case_sensitive);
 }
@@ -22,11 +22,14 @@ public:
 	CTagCounter();
 
 protected:
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, char &prev_char,
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, char &prev_char,
 		bool &data_continue, unsigned int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines);
-	void CountTagTally(string base, StringVector& container, unsigned int &count, int mode, string exclude,
-		string include1, string include2, UIntVector* counter_container = 0, bool case_sensitive = true);
+	void CountTagTally(const string &base, StringVector &container, unsigned int &count, int mode, const string &exclude,
+		const string &include1, const string &include2, UIntVector* counter_container = 0, bool case_sensitive = true);
+
+	StringVector tagList;					//!< Keywords of tagListSource preceded by '<'
+	const StringVector *tagListSource;		//!< Keyword list tagList was built from
 };
 
 #endif
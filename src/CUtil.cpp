@@ -17,6 +17,7 @@
 #include <cstring>
 #include <time.h>
 #include <sstream>
+#include <stdexcept>
 
 #ifdef UNIX
 	#include <dirent.h>
@@ -28,6 +29,52 @@
 
 #include "UCCGlobals.h"
 
+#define MAX_SIMD_DELIMITERS	8	//!< Most delimiter chars searched with vector compares
+
+/*!
+* Checks whether a character is removed by trimming.
+*
+* \param c character
+*
+* \return space, tab or line break?
+*/
+static inline bool IsTrimSpace(char c)
+{
+	return (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f');
+}
+
+/*!
+* Finds the part of a substring without leading/trailing spaces or tabs.
+*
+* \param str original string
+* \param pos start of the substring, updated to the start of the trimmed part
+* \param len length of the substring (string::npos for the rest), updated to the trimmed length
+* \param mode trim mode (-1=left, 0=both, 1=right)
+*/
+static void TrimBounds(const string &str, size_t &pos, size_t &len, int mode)
+{
+	if (pos > str.length())
+		throw out_of_range("CUtil trim position out of range");
+	if (len > str.length() - pos)
+		len = str.length() - pos;
+
+	const char *data = str.data();
+	size_t first = pos;
+	size_t last = pos + len;
+	if (mode <= 0)
+	{
+		while (first < last && IsTrimSpace(data[first]))
+			first++;
+	}
+	if (mode >= 0)
+	{
+		while (last > first && IsTrimSpace(data[last - 1]))
+			last--;
+	}
+	pos = first;
+	len = last - first;
+}
+
 /*!
 * Returns a string without leading/trailing spaces or tabs.
 *
@@ -38,31 +85,79 @@
 */
 string CUtil::TrimString(const string &str, int mode)
 {
-	size_t	idx;
-	string	str1 = str;
-	bool	done = false;
-	if (mode <= 0)
-	{
-		idx = str1.find_first_not_of(" \t\n\r\f");
-		if (idx != string::npos)
-			str1 = str1.substr(idx);
-		else
-		{
-			// Nothing but whitespace in the string
-			str1 = "";
-			done = true;	// no need to check other direction
-		}
-	}
-	if ( ( false == done ) 
-	  && ( mode >= 0 ) )
+	size_t pos = 0;
+	size_t len = string::npos;
+	TrimBounds(str, pos, len, mode);
+	return str.substr(pos, len);
+}
+
+/*!
+* Removes leading/trailing spaces or tabs from a string without allocating.
+*
+* \param str string to trim
+* \param mode trim mode (-1=left, 0=both, 1=right)
+*/
+void CUtil::TrimStringInPlace(string &str, int mode)
+{
+	size_t pos = 0;
+	size_t len = string::npos;
+	TrimBounds(str, pos, len, mode);
+	str.erase(pos + len);
+	str.erase(0, pos);
+}
+
+/*!
+* Assigns a trimmed substring, same as dest = TrimString(str.substr(pos, len), mode)
+* but reusing the memory of dest.
+*
+* \param dest string assigned (may be str)
+* \param str original string
+* \param pos start of the substring
+* \param len length of the substring
+* \param mode trim mode (-1=left, 0=both, 1=right)
+*/
+void CUtil::AssignTrimString(string &dest, const string &str, size_t pos, size_t len, int mode)
+{
+	TrimBounds(str, pos, len, mode);
+	if (&dest == &str)
 	{
-		idx = str1.find_last_not_of(" \t\n\r\f");
-		if (idx != string::npos)
-			str1 = str1.substr(0, idx + 1);
-		else
-			str1 = "";
+		dest.erase(pos + len);
+		dest.erase(0, pos);
 	}
-	return str1;
+	else
+		dest.assign(str, pos, len);
+}
+
+/*!
+* Appends a trimmed substring, same as dest += TrimString(str.substr(pos, len), mode)
+* without any temporary strings.
+*
+* \param dest string appended to
+* \param str original string
+* \param pos start of the substring
+* \param len length of the substring
+* \param mode trim mode (-1=left, 0=both, 1=right)
+*/
+void CUtil::AppendTrimString(string &dest, const string &str, size_t pos, size_t len, int mode)
+{
+	TrimBounds(str, pos, len, mode);
+	dest.append(str, pos, len);
+}
+
+/*!
+* Compares a trimmed substring to a text, same as TrimString(str.substr(pos, len)) == text.
+*
+* \param str original string
+* \param pos start of the substring
+* \param len length of the substring
+* \param text text to compare to
+*
+* \return trimmed substring equals text?
+*/
+bool CUtil::TrimStringEquals(const string &str, size_t pos, size_t len, const char *text)
+{
+	TrimBounds(str, pos, len, 0);
+	return (len == strlen(text) && str.compare(pos, len, text) == 0);
 }
 
 /*!
@@ -75,13 +170,24 @@ string CUtil::TrimString(const string &str, int mode)
 */
 string CUtil::EraseString(const string &srcstr, const string &erasedstr)
 {
-	size_t idx = 0;
 	string srcstr1 = srcstr;
-	while ((idx = srcstr1.find(erasedstr, idx)) != string::npos)
+	EraseStringInPlace(srcstr1, erasedstr);
+	return srcstr1;
+}
+
+/*!
+* Erases all strings specified by erasedstr in str without allocating.
+*
+* \param str string to modify
+* \param erasedstr substring to be erased
+*/
+void CUtil::EraseStringInPlace(string &str, const string &erasedstr)
+{
+	size_t idx = 0;
+	while ((idx = str.find(erasedstr, idx)) != string::npos)
 	{
-		srcstr1.erase(idx, erasedstr.length());
+		str.erase(idx, erasedstr.length());
 	}
-	return srcstr1;
 }
 
 /*!
@@ -108,13 +214,35 @@ void CUtil::InitToLower()
 string CUtil::ToLower(const string &string_to_lower)
 {
 	string	string_to_lower1 = string_to_lower;
-	for (size_t i = 0; i < string_to_lower1.size(); i++)
-	{
-		string_to_lower1[ i ] = lowerChars[ string_to_lower1[ i ] ];
-    }
+	ToLowerInPlace(string_to_lower1);
 	return string_to_lower1;
 }
 
+/*!
+* Copies a string in lower case, reusing the memory of the destination.
+*
+* \param string_to_lower original string
+* \param lower lower case string (may be string_to_lower)
+*/
+void CUtil::ToLower(const string &string_to_lower, string &lower)
+{
+	size_t len = string_to_lower.size();
+	lower.resize(len);
+	for (size_t i = 0; i < len; i++)
+		lower[ i ] = lowerChars[ (unsigned char)string_to_lower[ i ] ];
+}
+
+/*!
+* Changes a string to lower case without allocating.
+*
+* \param str string to change
+*/
+void CUtil::ToLowerInPlace(string &str)
+{
+	for (size_t i = 0; i < str.size(); i++)
+		str[ i ] = lowerChars[ (unsigned char)str[ i ] ];
+}
+
 /*!
 * Checks whether the string passed is blank.
 *
@@ -132,6 +260,21 @@ bool CUtil::CheckBlank(const string &str)
 		return true;
 }
 
+/*!
+* Checks whether a substring is blank, same as CheckBlank(str.substr(pos, len)).
+*
+* \param str original string
+* \param pos start of the substring
+* \param len length of the substring
+*
+* \return blank substring?
+*/
+bool CUtil::CheckBlank(const string &str, size_t pos, size_t len)
+{
+	TrimBounds(str, pos, len, -1);
+	return (len == 0);
+}
+
 /*!
 * Checks whether the string passed is an integer.
 *
@@ -148,8 +291,41 @@ bool CUtil::IsInteger(const string &str)
 		return true;
 }
 
+/*!
+* Finds a lower case pattern in a string ignoring the case of the string
+* (same as ToLower(str).find(lower_pattern, start) without copying the string).
+*
+* \param str string to search
+* \param lower_pattern pattern to find (already in lower case)
+* \param start index to start search
+*
+* \return index of pattern in string
+*/
+size_t CUtil::FindLowerCase(const string &str, const string &lower_pattern, size_t start)
+{
+	size_t len = str.length(), plen = lower_pattern.length(), k;
+	if (start > len || len - start < plen)
+		return string::npos;
+	if (plen == 0)
+		return start;
+	for (size_t pos = start; pos + plen <= len; pos++)
+	{
+		if (lowerChars[(unsigned char)str[pos]] != lower_pattern[0])
+			continue;
+		for (k = 1; k < plen; k++)
+		{
+			if (lowerChars[(unsigned char)str[pos + k]] != lower_pattern[k])
+				break;
+		}
+		if (k == plen)
+			return pos;
+	}
+	return string::npos;
+}
+
 /*!
 * Finds the first appearance of each element of table's first value.
+* The table keys are in lower case, so the target is not copied.
 *
 * \param target string
 * \param table map table
@@ -160,13 +336,12 @@ bool CUtil::IsInteger(const string &str)
 */
 size_t CUtil::FindStringsCaseInsensitive(const string &target, map<string, int> &table, size_t &pos, size_t preLang)
 {
-	string target1 = ToLower(target);
 	size_t tmp_pos;
 	pos = string::npos;
 	size_t ret = INVALID_POSITION;
 	for (map<string, int>::iterator iter = table.begin(); iter != table.end(); iter++)
 	{
-		tmp_pos = target1.find(iter->first);
+		tmp_pos = FindLowerCase(target, iter->first);
 		if (tmp_pos != string::npos && (pos == string::npos || pos > tmp_pos))
 		{
 			// handle special case "width=100%>"
@@ -221,6 +396,206 @@ size_t CUtil::FindCharAvoidEscape(const string &source, char target, size_t star
 	return idx;
 }
 
+#ifdef UCC_SSE2
+/*!
+* Returns the index of the lowest set bit of a non zero mask.
+*
+* \param mask bit mask
+*
+* \return bit index
+*/
+static inline unsigned int LowestSetBit(unsigned int mask)
+{
+#if defined(__GNUC__)
+	return (unsigned int)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanForward(&idx, mask);
+	return (unsigned int)idx;
+#else
+	unsigned int idx = 0;
+	while (!(mask & 1))
+	{
+		mask >>= 1;
+		idx++;
+	}
+	return idx;
+#endif
+}
+
+/*!
+* Returns the index of the highest set bit of a non zero mask.
+*
+* \param mask bit mask
+*
+* \return bit index
+*/
+static inline unsigned int HighestSetBit(unsigned int mask)
+{
+#if defined(__GNUC__)
+	return 31 - (unsigned int)__builtin_clz(mask);
+#elif defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanReverse(&idx, mask);
+	return (unsigned int)idx;
+#else
+	unsigned int idx = 0;
+	while (mask >>= 1)
+		idx++;
+	return idx;
+#endif
+}
+
+/*!
+* Finds the first char of a set using 16 byte SSE2 compares.
+*
+* \param str string
+* \param len string length
+* \param pos index to start search
+* \param chars set of chars
+* \param num_chars number of chars in the set (1 to MAX_SIMD_DELIMITERS)
+*
+* \return index of the first char found, or len if none
+*/
+static size_t FindFirstOfSSE2(const char *str, size_t len, size_t pos, const char *chars, size_t num_chars)
+{
+	__m128i sets[MAX_SIMD_DELIMITERS];
+	for (size_t i = 0; i < num_chars; i++)
+		sets[i] = _mm_set1_epi8(chars[i]);
+	for (; pos + 16 <= len; pos += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i *)(str + pos));
+		__m128i hit = _mm_cmpeq_epi8(block, sets[0]);
+		for (size_t i = 1; i < num_chars; i++)
+			hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, sets[i]));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(hit);
+		if (mask != 0)
+			return pos + LowestSetBit(mask);
+	}
+	for (; pos < len; pos++)
+	{
+		if (memchr(chars, str[pos], num_chars) != NULL)
+			return pos;
+	}
+	return len;
+}
+#endif
+
+#ifdef UCC_AVX2
+/*!
+* Finds the first char of a set using 32 byte AVX2 compares.
+* Only called when the processor supports AVX2.
+*
+* \param str string
+* \param len string length
+* \param pos index to start search
+* \param chars set of chars
+* \param num_chars number of chars in the set (1 to MAX_SIMD_DELIMITERS)
+*
+* \return index of the first char found, or len if none
+*/
+__attribute__((target("avx2")))
+static size_t FindFirstOfAVX2(const char *str, size_t len, size_t pos, const char *chars, size_t num_chars)
+{
+	__m256i sets[MAX_SIMD_DELIMITERS];
+	for (size_t i = 0; i < num_chars; i++)
+		sets[i] = _mm256_set1_epi8(chars[i]);
+	for (; pos + 32 <= len; pos += 32)
+	{
+		__m256i block = _mm256_loadu_si256((const __m256i *)(str + pos));
+		__m256i hit = _mm256_cmpeq_epi8(block, sets[0]);
+		for (size_t i = 1; i < num_chars; i++)
+			hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(block, sets[i]));
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(hit);
+		if (mask != 0)
+			return pos + LowestSetBit(mask);
+	}
+	return FindFirstOfSSE2(str, len, pos, chars, num_chars);
+}
+
+/*!
+* Checks whether the processor supports AVX2.
+*
+* \return AVX2 supported?
+*/
+static bool CpuHasAVX2()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+}
+
+static const bool cpuHasAVX2 = CpuHasAVX2();	//!< Set once at start up
+#endif
+
+/*!
+* Finds the first occurrence of any of a set of chars (same as string::find_first_of).
+* Small sets are searched with vector compares when the build supports them.
+*
+* \param str string to search
+* \param chars set of chars
+* \param start index to start search
+*
+* \return index of the first char found
+*/
+size_t CUtil::FindFirstOf(const string &str, const string &chars, size_t start)
+{
+#ifdef UCC_SSE2
+	size_t len = str.length();
+	if (start >= len || chars.empty())
+		return string::npos;
+	if (chars.length() <= MAX_SIMD_DELIMITERS)
+	{
+		size_t idx;
+#ifdef UCC_AVX2
+		if (cpuHasAVX2)
+			idx = FindFirstOfAVX2(str.data(), len, start, chars.data(), chars.length());
+		else
+#endif
+			idx = FindFirstOfSSE2(str.data(), len, start, chars.data(), chars.length());
+		return (idx < len) ? idx : string::npos;
+	}
+#endif
+	return str.find_first_of(chars, start);
+}
+
+/*!
+* Checks whether AVX2 code may be run (the build and the processor support it).
+*
+* \return AVX2 supported?
+*/
+bool CUtil::HasAVX2()
+{
+#ifdef UCC_AVX2
+	return cpuHasAVX2;
+#else
+	return false;
+#endif
+}
+
+/*!
+* Checks whether a string contains text at a position.
+*
+* \param str string
+* \param pos position in str
+* \param text text to match
+* \param case_sensitive match case sensitively?
+*
+* \return text found at pos?
+*/
+bool CUtil::MatchAt(const string &str, size_t pos, const string &text, bool case_sensitive)
+{
+	if (pos > str.length() || str.length() - pos < text.length())
+		return false;
+	if (case_sensitive)
+		return (str.compare(pos, text.length(), text) == 0);
+	for (size_t k = 0; k < text.length(); k++)
+	{
+		if (lowerChars[(unsigned char)str[pos + k]] != lowerChars[(unsigned char)text[k]])
+			return false;
+	}
+	return true;
+}
+
 /*!
 * Finds the keyword in the string starting from start to end.
 *
@@ -233,29 +608,70 @@ size_t CUtil::FindCharAvoidEscape(const string &source, char target, size_t star
 * \return index of keyword in string
 */
 size_t CUtil::FindKeyword(const string &str, const string &keyword, size_t start, size_t end, bool case_sensitive)
+{
+	return FindKeyword(str.data(), str.length(), keyword.data(), keyword.length(), start, end, case_sensitive);
+}
+
+/*!
+* Finds the keyword in a character buffer starting from start to end.
+* Neither the buffer nor the keyword is copied, a case insensitive search compares lower case chars.
+*
+* \param str characters to search
+* \param str_len number of characters
+* \param keyword keyword to find
+* \param kw_length keyword length
+* \param start starting index for search
+* \param end ending index for search
+* \param case_sensitive is case sensitive?
+*
+* \return index of keyword in string
+*/
+size_t CUtil::FindKeyword(const char *str, size_t str_len, const char *keyword, size_t kw_length,
+						  size_t start, size_t end, bool case_sensitive)
 {
 #define SPECIAL_CHARS	" \t;[]()+/-*<>=,&~!^?:%{}|"
-	size_t kw_length = keyword.length();
-	size_t idx, i = start;
-	string str1 = str;
-	string keyword1 = keyword;
+	size_t idx, k, i = start;
 	if (end == TO_END_OF_STRING)
-		end = str1.length() - 1;	// inclusive
-
-	if (!case_sensitive)
-	{
-		str1 = CUtil::ToLower(str1);
-		keyword1 = CUtil::ToLower(keyword1);
-	}
+		end = str_len - 1;	// inclusive
 
 	while (i <= end)
 	{
-		idx = str1.find(keyword1, i);
+		// same as string::find for the keyword starting at i
+		idx = string::npos;
+		if (kw_length == 0)
+		{
+			if (i <= str_len)
+				idx = i;
+		}
+		else if (i < str_len)
+		{
+			for (size_t pos = i; pos + kw_length <= str_len; pos++)
+			{
+				if (case_sensitive)
+				{
+					if (str[pos] != keyword[0] || memcmp(str + pos, keyword, kw_length) != 0)
+						continue;
+				}
+				else
+				{
+					for (k = 0; k < kw_length; k++)
+					{
+						if (lowerChars[(unsigned char)str[pos + k]] != lowerChars[(unsigned char)keyword[k]])
+							break;
+					}
+					if (k < kw_length)
+						continue;
+				}
+				idx = pos;
+				break;
+			}
+		}
+
 		if (idx != string::npos && idx + kw_length - 1 <= end)
 		{
-			if ((idx == 0 || strchr(SPECIAL_CHARS, str1[idx - 1]) != NULL) &&
-				(idx + kw_length >= str1.length() ||
-				strchr(SPECIAL_CHARS, str1[idx + kw_length]) != NULL))
+			if ((idx == 0 || strchr(SPECIAL_CHARS, str[idx - 1]) != NULL) &&
+				(idx + kw_length >= str_len ||
+				strchr(SPECIAL_CHARS, str[idx + kw_length]) != NULL))
 			{
 				// the keyword stands alone or surrounded by special chars
 				return idx;
@@ -275,6 +691,8 @@ size_t CUtil::FindKeyword(const string &str, const string &keyword, size_t start
 
 /*!
 * Counts keywords in string.
+* The keyword list is compiled for this call only; use the overload taking a keywordMatcher
+* to keep the compiled list between calls.
 *
 * \param base string to search
 * \param container set of keywords
@@ -289,59 +707,574 @@ size_t CUtil::FindKeyword(const string &str, const string &keyword, size_t start
 void CUtil::CountTally(const string &base, StringVector &container, unsigned int &count, int mode, const string &exclude,
 					   const string &include1, const string &include2, UIntVector* counter_container, bool case_sensitive)
 {
-	string::size_type idx;
-	string base1;
-	StringVector::iterator vit;
-	UIntVector::iterator cit;
-	unsigned int single_count = 0;
-	base1 = " " + base + " ";
+	keywordMatcher matcher;
+	CountTally(base, container, matcher, count, mode, exclude, include1, include2, counter_container, case_sensitive);
+}
+
+/*!
+* Counts keywords in string using a compiled keyword list.
+* The matcher is (re)compiled from the container when it was not compiled for it.
+* If the language is not case sensitive the keywords in the container are lower cased.
+*
+* \param base string to search
+* \param container set of keywords
+* \param matcher compiled keyword list (kept by the caller)
+* \param count number of keywords found
+* \param mode allowable leading/trailing character mode (1=exclude keywords surrounded by exclude characters, 2=include only keywords preceded by include1 characters and followed by include2 characters)
+* \param exclude list of characters that may not surround keywords found (if mode=1)
+* \param include1 list of characters that must precede keywords found (if mode=2)
+* \param include2 list of characters that must follow keywords found (if mode=2)
+* \param counter_container stores list of individual keyword counts (if specified)
+* \param case_sensitive language is case sensitive?
+*/
+void CUtil::CountTally(const string &base, StringVector &container, keywordMatcher &matcher, unsigned int &count, int mode,
+					   const string &exclude, const string &include1, const string &include2, UIntVector* counter_container, bool case_sensitive)
+{
+	if (!matcher.IsCompiledFor(container, case_sensitive))
+		matcher.Compile(container, case_sensitive);
+	matcher.CountTally(base, count, mode, exclude, include1, include2, counter_container);
+}
+
+/*!
+* Builds the automaton for a keyword list.
+* If not case sensitive the keywords in the list are lower cased (as CountTally always did).
+*
+* \param keywords list of keywords
+* \param case_sensitive match case sensitively?
+*/
+void keywordMatcher::Compile(StringVector &keywords, bool case_sensitive)
+{
+	StringVector *keywordLists = &keywords;
+	Compile(&keywordLists, 1, case_sensitive);
+}
 
-	if (counter_container)
-		cit = counter_container->begin();
+/*!
+* Checks whether the automaton was built for a keyword list.
+*
+* \param keywords list of keywords
+* \param case_sensitive match case sensitively?
+*
+* \return automaton is up to date
+*/
+bool keywordMatcher::IsCompiledFor(const StringVector &keywords, bool case_sensitive) const
+{
+	return (lists.size() == 1 && lists[0] == &keywords && listSizes[0] == keywords.size() &&
+		caseSensitive == case_sensitive && !delta.empty());
+}
 
-	if (case_sensitive == false)
+/*!
+* Checks whether the automaton was built for a set of keyword lists.
+*
+* \param keywordLists keyword lists
+* \param numLists number of keyword lists
+* \param case_sensitive match case sensitively?
+*
+* \return automaton is up to date
+*/
+bool keywordMatcher::IsCompiledFor(StringVector *const *keywordLists, size_t numLists, bool case_sensitive) const
+{
+	if (delta.empty() || caseSensitive != case_sensitive || lists.size() != numLists)
+		return false;
+	for (size_t l = 0; l < numLists; l++)
 	{
-		base1 = CUtil::ToLower(base1);
-		for (vit = container.begin(); vit != container.end(); vit++)
-			(*vit) = CUtil::ToLower((*vit));
+		if (lists[l] != keywordLists[l] || listSizes[l] != keywordLists[l]->size())
+			return false;
 	}
+	return true;
+}
 
-	if (mode == 1)
+/*!
+* Builds one automaton for a set of keyword lists.
+* Each match is tagged with its list and its index within the list.
+* If not case sensitive the keywords in the lists are lower cased (as CountTally always did).
+*
+* \param keywordLists keyword lists
+* \param numLists number of keyword lists
+* \param case_sensitive match case sensitively?
+*/
+void keywordMatcher::Compile(StringVector *const *keywordLists, size_t numLists, bool case_sensitive)
+{
+	caseSensitive = case_sensitive;
+	lists.assign(keywordLists, keywordLists + numLists);
+	listSizes.clear();
+	keywordList.clear();
+	keywordIndex.clear();
+	StringVector keywords;
+	for (size_t l = 0; l < numLists; l++)
+	{
+		StringVector &list = *keywordLists[l];
+		listSizes.push_back(list.size());
+		for (size_t i = 0; i < list.size(); i++)
+		{
+			if (!case_sensitive)
+				CUtil::ToLowerInPlace(list[i]);
+			keywords.push_back(list[i]);
+			keywordList.push_back((unsigned int)l);
+			keywordIndex.push_back(i);
+		}
+	}
+	numKeywords = keywords.size();
+
+	// number the chars used by the keywords; all other chars share class 0
+	memset(charClass, 0, sizeof(charClass));
+	numClasses = 1;
+	for (size_t i = 0; i < keywords.size(); i++)
+	{
+		for (size_t j = 0; j < keywords[i].size(); j++)
+		{
+			unsigned char c = (unsigned char)keywords[i][j];
+			if (charClass[c] == 0)
+				charClass[c] = (unsigned char)numClasses++;
+		}
+	}
+	if (!case_sensitive)
+	{
+		// fold upper case chars of the line onto the class of their lower case char
+		for (unsigned int c = 0; c < 256; c++)
+			charClass[c] = charClass[(unsigned char)lowerChars[c]];
+	}
+
+	// build the keyword trie (0 = no transition yet, the root is never a target)
+	delta.assign(numClasses, 0);
+	firstKeyword.assign(1, -1);
+	nextKeyword.assign(keywords.size(), -1);
+	keywordLength.assign(keywords.size(), 0);
+	maxKeywordLength = 0;
+	for (size_t i = 0; i < keywords.size(); i++)
+	{
+		keywordLength[i] = keywords[i].size();
+		if (keywordLength[i] > maxKeywordLength)
+			maxKeywordLength = keywordLength[i];
+		if (keywords[i].empty())
+			continue;
+		unsigned int state = 0;
+		for (size_t j = 0; j < keywords[i].size(); j++)
+		{
+			unsigned int cls = charClass[(unsigned char)keywords[i][j]];
+			if (delta[state * numClasses + cls] == 0)
+			{
+				delta[state * numClasses + cls] = (unsigned int)firstKeyword.size();
+				delta.resize(delta.size() + numClasses, 0);
+				firstKeyword.push_back(-1);
+			}
+			state = delta[state * numClasses + cls];
+		}
+		nextKeyword[i] = firstKeyword[state];
+		firstKeyword[state] = (int)i;
+	}
+
+	// add the failure transitions breadth first
+	size_t numStates = firstKeyword.size();
+	vector<unsigned int> fail(numStates, 0);
+	vector<unsigned int> queue;
+	outLink.assign(numStates, 0);
+	for (unsigned int cls = 0; cls < numClasses; cls++)
+	{
+		if (delta[cls] != 0)
+			queue.push_back(delta[cls]);
+	}
+	for (size_t q = 0; q < queue.size(); q++)
+	{
+		unsigned int state = queue[q];
+		for (unsigned int cls = 0; cls < numClasses; cls++)
+		{
+			unsigned int &next = delta[state * numClasses + cls];
+			unsigned int failNext = delta[fail[state] * numClasses + cls];
+			if (next == 0)
+				next = failNext;
+			else
+			{
+				fail[next] = failNext;
+				outLink[next] = (firstKeyword[failNext] >= 0) ? failNext : outLink[failNext];
+				queue.push_back(next);
+			}
+		}
+	}
+
+	BuildKeywordHash(keywords);
+}
+
+/*!
+* Computes the two hash values of a word used by the keyword hash table.
+*
+* \param str word
+* \param len word length
+* \param fold lower case the chars?
+* \param hashA first hash value (bucket and slot)
+* \param hashB second hash value (odd slot step)
+*/
+static inline void KeywordHash(const char *str, size_t len, bool fold, unsigned int &hashA, unsigned int &hashB)
+{
+	hashA = 2166136261u;
+	hashB = 0x9E3779B9u;
+	for (size_t i = 0; i < len; i++)
+	{
+		unsigned char c = fold ? (unsigned char)lowerChars[(unsigned char)str[i]] : (unsigned char)str[i];
+		hashA = (hashA ^ c) * 16777619u;
+		hashB = (hashB + c) * 0x85EBCA6Bu;
+		hashB ^= hashB >> 13;
+	}
+	hashB |= 1;
+}
+
+/*!
+* Builds a perfect hash table of the keywords (hash and displace): the keywords are
+* grouped in buckets by their first hash value and each bucket gets the smallest
+* displacement that puts all its keywords in free slots. Keywords with the same text
+* share a slot and are chained. If no table is found the words are not hashed.
+*
+* \param keywords keywords (lower case if not case sensitive)
+*/
+void keywordMatcher::BuildKeywordHash(const StringVector &keywords)
+{
+	keywordText = keywords;
+	sameKeyword.assign(keywords.size(), -1);
+	hashSlot.clear();
+	hashDisplace.clear();
+	hashMask = 0;
+	wordExclude = "";
+	wordScan = false;
+
+	// chain keywords with the same text behind the first one
+	vector<int> distinct;
+	map<string, int> lastOfText;
+	for (size_t i = 0; i < keywords.size(); i++)
 	{
-		// exclude mode
-		for (vit = container.begin(); vit != container.end(); vit++)
+		if (keywords[i].empty())
+			continue;
+		map<string, int>::iterator it = lastOfText.find(keywords[i]);
+		if (it == lastOfText.end())
 		{
-			idx = base1.find((*vit));
-			while (idx != string::npos)
+			distinct.push_back((int)i);
+			lastOfText[keywords[i]] = (int)i;
+		}
+		else
+		{
+			sameKeyword[it->second] = (int)i;
+			it->second = (int)i;
+		}
+	}
+	if (distinct.empty())
+		return;
+
+	size_t numBuckets = distinct.size() / 4 + 1;
+	vector<unsigned int> hashA(distinct.size()), hashB(distinct.size());
+	vector< vector<size_t> > buckets(numBuckets);
+	for (size_t i = 0; i < distinct.size(); i++)
+	{
+		const string &text = keywords[distinct[i]];
+		KeywordHash(text.data(), text.size(), false, hashA[i], hashB[i]);
+		buckets[hashA[i] % numBuckets].push_back(i);
+	}
+
+	// place the largest buckets first
+	vector< pair<size_t, size_t> > order;
+	for (size_t b = 0; b < numBuckets; b++)
+		order.push_back(make_pair(buckets[b].size(), b));
+	sort(order.rbegin(), order.rend());
+
+	size_t tableSize = 1;
+	while (tableSize < distinct.size() * 2)
+		tableSize <<= 1;
+	for (int attempt = 0; attempt < 4; attempt++, tableSize <<= 1)
+	{
+		unsigned int mask = (unsigned int)(tableSize - 1);
+		hashSlot.assign(tableSize, -1);
+		hashDisplace.assign(numBuckets, 0);
+		bool placed = true;
+		for (size_t o = 0; o < order.size() && placed; o++)
+		{
+			const vector<size_t> &bucket = buckets[order[o].second];
+			if (bucket.empty())
+				break;
+			placed = false;
+			for (unsigned int d = 0; d < tableSize && !placed; d++)
 			{
-				if ((exclude.find(base1[idx+((*vit).size())]) == string::npos) &&
-					(exclude.find(base1[idx-1]) == string::npos))
+				size_t j;
+				for (j = 0; j < bucket.size(); j++)
+				{
+					unsigned int slot = (hashA[bucket[j]] + d * hashB[bucket[j]]) & mask;
+					if (hashSlot[slot] >= 0)
+						break;
+					hashSlot[slot] = distinct[bucket[j]];
+				}
+				if (j == bucket.size())
 				{
-					count++;
-					single_count++;
+					hashDisplace[order[o].second] = d;
+					placed = true;
+				}
+				else
+				{
+					// undo the keywords of the bucket already placed
+					while (j-- > 0)
+						hashSlot[(hashA[bucket[j]] + d * hashB[bucket[j]]) & mask] = -1;
 				}
-				idx = base1.find((*vit), idx + ((*vit).size()));
 			}
-			if (counter_container)
+		}
+		if (placed)
+		{
+			hashMask = mask;
+			return;
+		}
+	}
+	hashSlot.clear();
+	hashDisplace.clear();
+}
+
+/*!
+* Checks whether the keywords can be counted by words for a set of exclude chars:
+* every keyword char must be an exclude char (so a keyword found is a whole word)
+* and the padding space must not be one.
+*
+* \param exclude list of characters that may not surround keywords found
+* \param allowed chars allowed around a keyword (not in exclude)
+*
+* \return count by words?
+*/
+bool keywordMatcher::UseWordScan(const string &exclude, const bool *allowed) const
+{
+	if (hashSlot.empty())
+		return false;
+	if (exclude == wordExclude)
+		return wordScan;
+
+	wordExclude = exclude;
+	wordScan = allowed[(unsigned char)' '] && allowed[0];
+	for (unsigned int c = 0; c < 256 && wordScan; c++)
+	{
+		unsigned char folded = caseSensitive ? (unsigned char)c : (unsigned char)lowerChars[c];
+		if (charClass[c] != 0 && allowed[folded])
+			wordScan = false;
+	}
+	return wordScan;
+}
+
+/*!
+* Counts the keywords of a string word by word (see UseWordScan).
+* A word is a run of chars that may not surround a keyword; it is looked up with one probe.
+*
+* \param base string to search
+* \param allowed chars allowed around a keyword (word separators)
+* \param counts number of keywords found per list (incremented)
+* \param counter_containers stores list of individual keyword counts per list (entries may be NULL)
+*/
+void keywordMatcher::ScanWords(const string &base, const bool *allowed, unsigned int *counts,
+							   UIntVector **counter_containers) const
+{
+	const char *str = base.data();
+	size_t len = base.size(), pos = 0, start, k;
+	size_t numBuckets = hashDisplace.size();
+	unsigned int hashA, hashB;
+	while (pos < len)
+	{
+		// skip separators, then take the word
+		while (pos < len && allowed[caseSensitive ? (unsigned char)str[pos] : (unsigned char)lowerChars[(unsigned char)str[pos]]])
+			pos++;
+		start = pos;
+		while (pos < len && !allowed[caseSensitive ? (unsigned char)str[pos] : (unsigned char)lowerChars[(unsigned char)str[pos]]])
+			pos++;
+		if (pos == start)
+			continue;
+
+		KeywordHash(str + start, pos - start, !caseSensitive, hashA, hashB);
+		int kw = hashSlot[(hashA + hashDisplace[hashA % numBuckets] * hashB) & hashMask];
+		if (kw < 0 || keywordLength[kw] != pos - start)
+			continue;
+		const string &text = keywordText[kw];
+		for (k = 0; k < text.size(); k++)
+		{
+			char c = caseSensitive ? str[start + k] : lowerChars[(unsigned char)str[start + k]];
+			if (c != text[k])
+				break;
+		}
+		if (k < text.size())
+			continue;
+
+		for (; kw >= 0; kw = sameKeyword[kw])
+		{
+			unsigned int list = keywordList[kw];
+			counts[list]++;
+			UIntVector *counter_container = counter_containers[list];
+			if (counter_container && keywordIndex[kw] < counter_container->size())
+				(*counter_container)[keywordIndex[kw]]++;
+		}
+	}
+}
+
+/*!
+* Returns a char of a line padded with a space on each side.
+*
+* \param str line
+* \param paddedLen length of the padded line
+* \param pos position within the padded line (out of range positions read as '\0')
+*
+* \return char
+*/
+static inline unsigned char PaddedChar(const char *str, size_t paddedLen, size_t pos)
+{
+	if (pos >= paddedLen)
+		return '\0';
+	if (pos == 0 || pos == paddedLen - 1)
+		return ' ';
+	return (unsigned char)str[pos - 1];
+}
+
+/*!
+* Counts the keywords in a string.
+*
+* \param base string to search
+* \param count number of keywords found
+* \param mode allowable leading/trailing character mode (1=exclude keywords surrounded by exclude characters, 2=include only keywords preceded by include1 characters and followed by include2 characters)
+* \param exclude list of characters that may not surround keywords found (if mode=1)
+* \param include1 list of characters that must precede keywords found (if mode=2)
+* \param include2 list of characters that must follow keywords found (if mode=2)
+* \param counter_container stores list of individual keyword counts (if specified, mode 1 only)
+*/
+void keywordMatcher::CountTally(const string &base, unsigned int &count, int mode, const string &exclude,
+								const string &include1, const string &include2, UIntVector *counter_container) const
+{
+	if ((mode != 1 && mode != 2) || delta.empty())
+		return;
+
+	// boundary chars allowed before and after a keyword
+	bool before[256], after[256];
+	if (mode == 1)
+	{
+		for (unsigned int c = 0; c < 256; c++)
+			before[c] = true;
+		for (size_t i = 0; i < exclude.size(); i++)
+			before[(unsigned char)exclude[i]] = false;
+		memcpy(after, before, sizeof(after));
+	}
+	else
+	{
+		memset(before, 0, sizeof(before));
+		memset(after, 0, sizeof(after));
+		for (size_t i = 0; i < include1.size(); i++)
+			before[(unsigned char)include1[i]] = true;
+		for (size_t i = 0; i < include2.size(); i++)
+			after[(unsigned char)include2[i]] = true;
+	}
+	if (mode != 1)
+		counter_container = 0;
+	if (mode == 1 && UseWordScan(exclude, before))
+		ScanWords(base, before, &count, &counter_container);
+	else
+		Scan(base, before, after, &count, &counter_container);
+}
+
+/*!
+* Counts the keywords of each compiled list in a string in a single pass
+* (same as calling CountTally with mode 1 once per list).
+*
+* \param base string to search
+* \param exclude list of characters that may not surround keywords found
+* \param counts number of keywords found per list (incremented)
+* \param counter_containers stores list of individual keyword counts per list (entries may be NULL)
+*/
+void keywordMatcher::CountTallies(const string &base, const string &exclude, unsigned int *counts,
+								  UIntVector **counter_containers) const
+{
+	if (delta.empty())
+		return;
+
+	bool allowed[256];
+	for (unsigned int c = 0; c < 256; c++)
+		allowed[c] = true;
+	for (size_t i = 0; i < exclude.size(); i++)
+		allowed[(unsigned char)exclude[i]] = false;
+	if (UseWordScan(exclude, allowed))
+		ScanWords(base, allowed, counts, counter_containers);
+	else
+		Scan(base, allowed, allowed, counts, counter_containers);
+}
+
+/*!
+* Finds the first keyword in a string (the one starting first, or if several start
+* at the same position, the first one compiled). No boundary chars are checked.
+*
+* \param str string to search
+* \param start index to start search
+* \param keyword index of the keyword found
+*
+* \return index of the keyword found in str
+*/
+size_t keywordMatcher::FindFirst(const string &str, size_t start, size_t &keyword) const
+{
+	size_t best = string::npos, len = str.size();
+	unsigned int state = 0;
+	keyword = 0;
+	if (delta.empty())
+		return best;
+	for (size_t pos = start; pos < len; pos++)
+	{
+		// a keyword ending here or later cannot start before the best one
+		if (best != string::npos && pos >= best + maxKeywordLength)
+			break;
+		state = delta[state * numClasses + charClass[(unsigned char)str[pos]]];
+		unsigned int out = (firstKeyword[state] >= 0) ? state : outLink[state];
+		for (; out != 0; out = outLink[out])
+		{
+			for (int k = firstKeyword[out]; k >= 0; k = nextKeyword[k])
 			{
-				(*cit) += single_count;
-				single_count = 0;
-				cit++;
+				size_t idx = pos + 1 - keywordLength[k];
+				if (best == string::npos || idx < best || (idx == best && (size_t)k < keyword))
+				{
+					best = idx;
+					keyword = (size_t)k;
+				}
 			}
 		}
 	}
-	else if (mode == 2)
+	return best;
+}
+
+/*!
+* Scans a string for all compiled keywords.
+*
+* \param base string to search
+* \param before chars allowed before a keyword
+* \param after chars allowed after a keyword
+* \param counts number of keywords found per list (incremented)
+* \param counter_containers stores list of individual keyword counts per list (entries may be NULL)
+*/
+void keywordMatcher::Scan(const string &base, const bool *before, const bool *after, unsigned int *counts,
+						  UIntVector **counter_containers) const
+{
+	// scan the line padded with a space on each side (positions are within the padded line)
+	searchFrom.assign(numKeywords, 0);
+	const char *str = base.data();
+	size_t paddedLen = base.size() + 2;
+	unsigned int state = 0;
+	for (size_t pos = 0; pos < paddedLen; pos++)
 	{
-		// include mode
-		for (vit = container.begin(); vit != container.end(); vit++)
+		unsigned char c = PaddedChar(str, paddedLen, pos);
+		state = delta[state * numClasses + charClass[c]];
+		unsigned int out = (firstKeyword[state] >= 0) ? state : outLink[state];
+		for (; out != 0; out = outLink[out])
 		{
-			idx = base1.find((*vit));
-			while (idx != string::npos)
+			for (int k = firstKeyword[out]; k >= 0; k = nextKeyword[k])
 			{
-				if ((include1.find(base1[idx-1]) != string::npos) &&
-					(include2.find(base1[idx+((*vit).size())]) != string::npos))
-					count++;
-				idx = base1.find((*vit), idx + ((*vit).size()));
+				size_t start = pos + 1 - keywordLength[k];
+				if (start < searchFrom[k])
+					continue;	// overlaps the previous occurrence of this keyword
+				searchFrom[k] = pos + 1;
+
+				unsigned char prev = PaddedChar(str, paddedLen, start - 1);
+				unsigned char next = PaddedChar(str, paddedLen, pos + 1);
+				if (!caseSensitive)
+				{
+					prev = (unsigned char)lowerChars[prev];
+					next = (unsigned char)lowerChars[next];
+				}
+				if (before[prev] && after[next])
+				{
+					unsigned int list = keywordList[k];
+					counts[list]++;
+					UIntVector *counter_container = counter_containers[list];
+					if (counter_container && keywordIndex[k] < counter_container->size())
+						(*counter_container)[keywordIndex[k]]++;
+				}
 			}
 		}
 	}
@@ -836,12 +1769,24 @@ size_t CUtil::TruncateLine(size_t length, size_t totalLength, size_t truncate, b
 * \return new string
 */
 string CUtil::ClearRedundantSpaces(const string &str)
+{
+	string str_new = str;
+	ClearRedundantSpacesInPlace(str_new);
+	return str_new;
+}
+
+/*!
+* Clear redundant/unnecessary white spaces in a string without allocating.
+* Characters only move toward the front, so the neighbors checked are still the original ones.
+*
+* \param str string to be processed
+*/
+void CUtil::ClearRedundantSpacesInPlace(string &str)
 {
 #define SPECIAL_CHARS " \t;[]()+/-*<>=,&~!^?:%{}|"
 	size_t len = str.length();
 	size_t idx = 0;
 	size_t idx_new = 0;
-	string str_new(len, '\0');
 
 	for (idx = 0; idx < len; idx++)
 	{
@@ -855,13 +1800,11 @@ string CUtil::ClearRedundantSpaces(const string &str)
 			}
 		}
 		if (str[idx] == '\t')
-			str_new[idx_new++] = ' ';
+			str[idx_new++] = ' ';
 		else
-			str_new[idx_new++] = str[idx];
+			str[idx_new++] = str[idx];
 	}
-	str_new.resize(idx_new);
-
-	return str_new;	
+	str.resize(idx_new);
 #undef SPECIAL_CHARS
 }
 
@@ -875,13 +1818,185 @@ string CUtil::ClearRedundantSpaces(const string &str)
 string CUtil::ReplaceSmartQuotes(const string &str)
 {
 	string str1 = str;
-	std::replace(str1.begin(), str1.end(), char((unsigned char)145), '\'');
-	std::replace(str1.begin(), str1.end(), char((unsigned char)146), '\'');
-	std::replace(str1.begin(), str1.end(), char((unsigned char)147), '\"');
-	std::replace(str1.begin(), str1.end(), char((unsigned char)148), '\"');
+	ReplaceSmartQuotesInPlace(str1);
 	return str1;
 }
 
+/*!
+* Replaces smart quotes in a string without allocating.
+*
+* \param str string to update
+*/
+void CUtil::ReplaceSmartQuotesInPlace(string &str)
+{
+	for (size_t i = 0; i < str.size(); i++)
+	{
+		switch ((unsigned char)str[i])
+		{
+		case 145:
+		case 146:
+			str[i] = '\'';
+			break;
+		case 147:
+		case 148:
+			str[i] = '\"';
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/*!
+* Starts the extent of the next line.
+*
+* \param ext line extent to reset
+* \param start offset of the first char of the line
+*/
+static inline void StartLineExtent(lineExtent &ext, size_t start)
+{
+	ext.start = start;
+	ext.end = start;
+	ext.trimStart = string::npos;
+	ext.trimEnd = start;
+	ext.smartQuotes = false;
+}
+
+/*!
+* Ends the extent of the current line and adds it to the list.
+*
+* \param ext line extent
+* \param end offset of the line break (or the end of the buffer)
+* \param lines list of line extents
+*/
+static inline void EndLineExtent(lineExtent &ext, size_t end, LineExtentVector &lines)
+{
+	ext.end = end;
+	if (ext.trimStart == string::npos)
+		ext.trimStart = ext.trimEnd = end;
+	lines.push_back(ext);
+}
+
+/*!
+* Splits a file buffer into physical lines in one pass.
+* Each line records its trimmed extent and whether it holds smart quotes, so the
+* caller copies every line once and skips the smart quote pass for most lines.
+* Lines are split the way getline splits them (a final empty line is dropped).
+*
+* \param buf file buffer
+* \param len buffer length
+* \param lines list of line extents (cleared first)
+*/
+void CUtil::SplitLines(const char *buf, size_t len, LineExtentVector &lines)
+{
+	lineExtent ext;
+	size_t pos = 0;
+
+	lines.clear();
+	StartLineExtent(ext, 0);
+#ifdef UCC_SSE2
+	// masks of line breaks, text (not trim spaces) and smart quotes for 16 chars at a time
+	const __m128i lineBreak = _mm_set1_epi8('\n');
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+	const __m128i carriage = _mm_set1_epi8('\r');
+	const __m128i formFeed = _mm_set1_epi8('\f');
+	const __m128i quoteBase = _mm_set1_epi8((char)145);
+	const __m128i quoteRange = _mm_set1_epi8(3);
+	for (; pos + 16 <= len; pos += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i *)(buf + pos));
+		__m128i breaks = _mm_cmpeq_epi8(block, lineBreak);
+		__m128i spaces = _mm_or_si128(_mm_or_si128(breaks, _mm_cmpeq_epi8(block, space)),
+			_mm_or_si128(_mm_cmpeq_epi8(block, tab), _mm_or_si128(_mm_cmpeq_epi8(block, carriage), _mm_cmpeq_epi8(block, formFeed))));
+		__m128i offset = _mm_sub_epi8(block, quoteBase);
+		unsigned int breakMask = (unsigned int)_mm_movemask_epi8(breaks);
+		unsigned int textMask = ~(unsigned int)_mm_movemask_epi8(spaces) & 0xFFFF;
+		unsigned int quoteMask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(offset, quoteRange), offset));
+		unsigned int segStart = 0;
+		while (true)
+		{
+			// chars of the current line within this block
+			unsigned int segMask = (breakMask ? (1u << LowestSetBit(breakMask)) - 1 : 0xFFFF) & ~((1u << segStart) - 1);
+			unsigned int text = textMask & segMask;
+			if (text)
+			{
+				if (ext.trimStart == string::npos)
+					ext.trimStart = pos + LowestSetBit(text);
+				ext.trimEnd = pos + HighestSetBit(text) + 1;
+			}
+			if (quoteMask & segMask)
+				ext.smartQuotes = true;
+			if (!breakMask)
+				break;
+			segStart = LowestSetBit(breakMask);
+			EndLineExtent(ext, pos + segStart, lines);
+			StartLineExtent(ext, pos + ++segStart);
+			breakMask &= breakMask - 1;
+		}
+	}
+#endif
+	for (; pos < len; pos++)
+	{
+		char c = buf[pos];
+		if (c == '\n')
+		{
+			EndLineExtent(ext, pos, lines);
+			StartLineExtent(ext, pos + 1);
+		}
+		else if (!IsTrimSpace(c))
+		{
+			if (ext.trimStart == string::npos)
+				ext.trimStart = pos;
+			ext.trimEnd = pos + 1;
+			if ((unsigned char)c >= 145 && (unsigned char)c <= 148)
+				ext.smartQuotes = true;
+		}
+	}
+	if (ext.start < len)
+		EndLineExtent(ext, len, lines);
+}
+
+/*!
+* Computes a 64 bit hash of a file buffer (MurmurHash64A, 8 chars at a time).
+* Files with the same hash are taken to have the same contents.
+*
+* \param buf file buffer
+* \param len buffer length
+*
+* \return hash value
+*/
+unsigned long long CUtil::HashBuffer(const char *buf, size_t len)
+{
+	const unsigned long long m = 0xC6A4A7935BD1E995ULL;
+	const int r = 47;
+	unsigned long long h = 0x9E3779B97F4A7C15ULL ^ ((unsigned long long)len * m);
+	unsigned long long k;
+	size_t pos;
+
+	for (pos = 0; pos + 8 <= len; pos += 8)
+	{
+		memcpy(&k, buf + pos, 8);
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		h ^= k;
+		h *= m;
+	}
+	if (pos < len)
+	{
+		k = 0;
+		for (size_t i = len - pos; i > 0; i--)
+			k = (k << 8) | (unsigned char)buf[pos + i - 1];
+		h ^= k;
+		h *= m;
+	}
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+	return h;
+}
+
 /*!
 * Adds an uncounted file log if wanted.
 *
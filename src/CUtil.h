@@ -15,6 +15,19 @@
 
 #include "cc_main.h"
 
+// Vector code: SSE2 is the baseline, AVX2 is chosen at run time (CUtil::HasAVX2) where the compiler supports it
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define UCC_SSE2
+	#include <emmintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#endif
+	#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		#define UCC_AVX2
+		#include <immintrin.h>
+	#endif
+#endif
+
 using namespace std;
 
 #define INVALID_POSITION ((unsigned int)-1)
@@ -28,6 +41,67 @@ using namespace std;
 */
 typedef vector<string> vectorString;
 
+//! Compiled keyword lists for counting keyword occurrences.
+/*!
+* \class keywordMatcher
+*
+* Defines an Aho-Corasick automaton built from one or more keyword lists, so all
+* keywords of all lists are found in one pass over a line. Counts match CUtil::CountTally
+* exactly: occurrences of each keyword are searched left to right without overlapping
+* each other, and mode 1 (exclude) / mode 2 (include) boundary checks are applied.
+* The line is scanned as if padded with a space on each side.
+* When every keyword is made of chars that may not surround a keyword (mode 1, the usual
+* identifier keywords), the line is split into words instead and each word is classified
+* with a single probe of a perfect hash table of the keywords.
+* Not thread safe: keep one matcher per thread (for example one per language counter).
+*/
+class keywordMatcher
+{
+public:
+	keywordMatcher() : caseSensitive(true), numClasses(1), numKeywords(0), maxKeywordLength(0), hashMask(0), wordScan(false) {}
+
+	void Compile(StringVector &keywords, bool case_sensitive);
+	void Compile(StringVector *const *keywordLists, size_t numLists, bool case_sensitive);
+	bool IsCompiledFor(const StringVector &keywords, bool case_sensitive) const;
+	bool IsCompiledFor(StringVector *const *keywordLists, size_t numLists, bool case_sensitive) const;
+	void CountTally(const string &base, unsigned int &count, int mode, const string &exclude,
+		const string &include1, const string &include2, UIntVector *counter_container = 0) const;
+	void CountTallies(const string &base, const string &exclude, unsigned int *counts,
+		UIntVector **counter_containers) const;
+	size_t FindFirst(const string &str, size_t start, size_t &keyword) const;
+
+private:
+	void Scan(const string &base, const bool *before, const bool *after, unsigned int *counts,
+		UIntVector **counter_containers) const;
+	void BuildKeywordHash(const StringVector &keywords);
+	bool UseWordScan(const string &exclude, const bool *allowed) const;
+	void ScanWords(const string &base, const bool *allowed, unsigned int *counts,
+		UIntVector **counter_containers) const;
+
+	bool caseSensitive;						//!< Are keywords matched case sensitively?
+	unsigned int numClasses;				//!< Number of character classes (class 0 is any char not in a keyword)
+	size_t numKeywords;						//!< Number of keywords compiled (including empty ones, never matched)
+	vector<const StringVector*> lists;		//!< Keyword lists compiled
+	vector<size_t> listSizes;				//!< Size of each keyword list when compiled
+	unsigned char charClass[256];			//!< Character class of each (case folded) char
+	vector<unsigned int> delta;				//!< Transition table (state * numClasses + class)
+	vector<int> firstKeyword;				//!< First keyword ending at each state (-1 if none)
+	vector<unsigned int> outLink;			//!< Nearest proper suffix state that ends a keyword (0 if none)
+	vector<int> nextKeyword;				//!< Next keyword ending at the same state (-1 if none)
+	vector<size_t> keywordLength;			//!< Length of each keyword
+	size_t maxKeywordLength;				//!< Length of the longest keyword
+	vector<unsigned int> keywordList;		//!< List of each keyword
+	vector<size_t> keywordIndex;			//!< Index of each keyword within its list
+	mutable vector<size_t> searchFrom;		//!< Position where the next occurrence of each keyword may start
+	StringVector keywordText;				//!< Text of each keyword (lower case if not case sensitive)
+	vector<int> sameKeyword;				//!< Next keyword with the same text (-1 if none)
+	vector<unsigned int> hashDisplace;		//!< Displacement of each hash bucket (perfect hash of the keywords)
+	vector<int> hashSlot;					//!< First keyword of each hash table slot (-1 if none, empty if no hash)
+	unsigned int hashMask;					//!< Hash table size - 1
+	mutable string wordExclude;				//!< Exclude chars wordScan was checked for
+	mutable bool wordScan;					//!< Can wordExclude be counted with ScanWords?
+};
+
 //! Utility class.
 /*!
 * \class CUtil
@@ -38,7 +112,12 @@ class CUtil
 {
 public:
 	static string TrimString(const string &str, int mode = 0);
+	static void TrimStringInPlace(string &str, int mode = 0);
+	static void AssignTrimString(string &dest, const string &str, size_t pos = 0, size_t len = string::npos, int mode = 0);
+	static void AppendTrimString(string &dest, const string &str, size_t pos = 0, size_t len = string::npos, int mode = 0);
+	static bool TrimStringEquals(const string &str, size_t pos, size_t len, const char *text);
 	static string EraseString(const string &srcstr, const string &erasedstr);
+	static void EraseStringInPlace(string &str, const string &erasedstr);
 
 	/*!
 	* Initialize an array of lower case chars used by ToLower.  Much faster performance.
@@ -48,13 +127,24 @@ public:
 	static void InitToLower();
 
 	static string ToLower(const string &string_to_lower);
+	static void ToLower(const string &string_to_lower, string &lower);
+	static void ToLowerInPlace(string &str);
 	static bool CheckBlank(const string &str);
+	static bool CheckBlank(const string &str, size_t pos, size_t len = string::npos);
 	static bool IsInteger(const string &str);
+	static size_t FindLowerCase(const string &str, const string &lower_pattern, size_t start = 0);
 	static size_t FindStringsCaseInsensitive(const string &target, map<string, int> &table, size_t &pos, size_t preLang = INVALID_POSITION);
 	static size_t FindCharAvoidEscape(const string &source, char target, size_t start_idx, char escape);
+	static size_t FindFirstOf(const string &str, const string &chars, size_t start = 0);
+	static bool HasAVX2();
+	static bool MatchAt(const string &str, size_t pos, const string &text, bool case_sensitive = true);
 	static size_t FindKeyword(const string &str, const string &keyword, size_t start = 0, size_t end = TO_END_OF_STRING, bool case_sensitive = true);
+	static size_t FindKeyword(const char *str, size_t str_len, const char *keyword, size_t kw_length,
+		size_t start = 0, size_t end = TO_END_OF_STRING, bool case_sensitive = true);
 	static void CountTally(const string &base, StringVector &container, unsigned int &count, int mode, const string &exclude,
 		const string &include1, const string &include2, UIntVector *counter_container = 0, bool case_sensitive = true);
+	static void CountTally(const string &base, StringVector &container, keywordMatcher &matcher, unsigned int &count, int mode,
+		const string &exclude, const string &include1, const string &include2, UIntVector *counter_container = 0, bool case_sensitive = true);
 	static string ExtractFilename(const string &filepath);
 	static bool ListAllFiles(string &folder, StringVector &fileExtList, StringVector &fileList, bool symLinks);
 	static bool GetFileList(StringVector &fileList, const string &path, bool symLinks);
@@ -65,7 +155,11 @@ public:
 	static string ConvertClearCaseFile(const string &fileName);
 	static size_t TruncateLine(size_t length, size_t totalLength, size_t truncate, bool &trunc_flag);
 	static string ClearRedundantSpaces(const string &str);
+	static void ClearRedundantSpacesInPlace(string &str);
 	static string ReplaceSmartQuotes(const string &str);
+	static void ReplaceSmartQuotesInPlace(string &str);
+	static void SplitLines(const char *buf, size_t len, LineExtentVector &lines);
+	static unsigned long long HashBuffer(const char *buf, size_t len);
 	
 	// Returns	string of message to send to UI if not empty string
 	static string WriteUncountedFileUtil(const string &msg, const string &uncFile, bool useListA, bool csvOutput, string outDir);
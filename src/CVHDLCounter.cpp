@@ -23,6 +23,7 @@ CVHDLCounter::CVHDLCounter()
 	QuoteStart = "\"";
 	QuoteEnd = "\"";
 	QuoteEscapeFront = '\"';
+	customReplaceQuote = true;
 	
 	directive.push_back("pragma");
 
@@ -136,6 +137,12 @@ CVHDLCounter::CVHDLCounter()
 	cmplx_assign_list.push_back("=>");
 	cmplx_assign_list.push_back(":=");
 	cmplx_assign_list.push_back("<=");
+
+	// same lists without the '<=' operator, which is counted on another pass
+	cmplx_logic_list_no_le = cmplx_logic_list;
+	cmplx_logic_list_no_le.pop_back();
+	cmplx_assign_list_no_le = cmplx_assign_list;
+	cmplx_assign_list_no_le.pop_back();
 }
 /*!
 * Replaces quoted strings inside a string starting at idx_start with '$'.
@@ -173,7 +180,7 @@ int CVHDLCounter::ReplaceQuote(string &strline, size_t &idx_start, bool &contd,
 *
 * \return method status
 */
-int CVHDLCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fmapBak)
+int CVHDLCounter::CountCommentsSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	if (BlockCommentStart.empty() && LineCommentStart.empty())
 		return 0;
@@ -197,11 +204,11 @@ int CVHDLCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fma
 	string curBlckCmtStart, curBlckCmtEnd;
 	char CurrentQuoteEnd = 0;
 	bool quote_contd = false, directiveComment =false;
-	filemap::iterator itfmBak = fmapBak->begin();
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
 
 	quote_idx_start = 0;
 
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		directiveComment = false;
 		contd_nextline = false;
@@ -215,7 +222,7 @@ int CVHDLCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fma
 		if (quote_contd)
 		{
 			// Replace quote until next character
-			ReplaceQuote(iter->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
+			ReplaceQuote(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
 			if (quote_contd)
 				continue;
 		}
@@ -240,7 +247,7 @@ int CVHDLCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fma
 			// if found quote before comment, e.g., "this is quote");//comment
 			if (quote_idx_start != string::npos && (comment_start == string::npos || quote_idx_start < comment_start))
 			{
-				ReplaceQuote(iter->line, quote_idx_start, quote_contd, CurrentQuoteEnd);
+				ReplaceQuote(fmap->edit(iter), quote_idx_start, quote_contd, CurrentQuoteEnd);
 				if (quote_idx_start > idx_start && quote_idx_start != iter->line.length())
 				{
 					// comment delimiter inside quote
@@ -257,7 +264,7 @@ int CVHDLCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fma
 					if ((CUtil::FindKeyword(iter->line, *itDirective, comment_start+LineCommentStart.size(), TO_END_OF_STRING, false)) != string::npos)
 					{
 						directiveComment = true;
-						iter->line = *itDirective;
+						fmap->edit(iter) = *itDirective;
 						break;
 					} 
 				}
@@ -268,17 +275,17 @@ int CVHDLCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fma
 				switch (comment_type)
 				{
 				case 1:	// line comment, definitely whole line
-					iter->line = "";
-					itfmBak->line = "";
+					fmap->edit(iter) = "";
+					fmapBak->edit(itfmBak) = "";
 					result->comment_lines++;
 					contd_nextline = true;
 					break;
 				case 2:	// line comment, possibly embedded
-					iter->line = iter->line.substr(0, idx_start);
-					itfmBak->line = itfmBak->line.substr(0, idx_start);
+					fmap->edit(iter) = iter->line.substr(0, idx_start);
+					fmapBak->edit(itfmBak) = itfmBak->line.substr(0, idx_start);
 					// trim trailing space
-					iter->line = CUtil::TrimString(iter->line, 1);
-					itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+					fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+					fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 					if (iter->line.empty())
 						result->comment_lines++;	// whole line
 					else
@@ -296,17 +303,17 @@ int CVHDLCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fma
 					{
 						if (comment_type == 3)
 						{
-							iter->line = "";
-							itfmBak->line = "";
+							fmap->edit(iter) = "";
+							fmapBak->edit(itfmBak) = "";
 							result->comment_lines++;
 						}
 						else if (comment_type == 4)
 						{
-							iter->line = iter->line.substr(0, idx_start);
-							itfmBak->line = itfmBak->line.substr(0, idx_start);
+							fmap->edit(iter) = iter->line.substr(0, idx_start);
+							fmapBak->edit(itfmBak) = itfmBak->line.substr(0, idx_start);
 							// trim trailing space
-							iter->line = CUtil::TrimString(iter->line, 1);
-							itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+							fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+							fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 							if (iter->line.empty())
 								result->comment_lines++;	// whole line
 							else
@@ -319,15 +326,15 @@ int CVHDLCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fma
 					else
 					{
 						contd = false;
-						iter->line.erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
-						itfmBak->line.erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
+						fmap->edit(iter).erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
+						fmapBak->edit(itfmBak).erase(idx_start, idx_end - idx_start + curBlckCmtEnd.length());
 						if (iter->line.empty())
 							result->comment_lines++;
 						else
 						{
 							// trim trailing space
-							iter->line = CUtil::TrimString(iter->line, 1);
-							itfmBak->line = CUtil::TrimString(itfmBak->line, 1);
+							fmap->edit(iter) = CUtil::TrimString(iter->line, 1);
+							fmapBak->edit(itfmBak) = CUtil::TrimString(itfmBak->line, 1);
 							if (iter->line.empty())
 								result->comment_lines++;	// whole line
 							else
@@ -358,14 +365,13 @@ int CVHDLCounter::CountCommentsSLOC(filemap* fmap, results* result, filemap *fma
 *
 * \return method status
 */
-int CVHDLCounter::CountComplexity(filemap* fmap, results* result)
+int CVHDLCounter::CountComplexity(filemapOverlay* fmap, results* result)
 {
 	if (classtype == UNKNOWN || classtype == DATAFILE)
 		return 0;
-	filemap::iterator fit;
+	filemapOverlay::iterator fit;
 	filemap fitBak;
-	filemap::iterator fitForw, fitBack;//used to check prior an later lines for semicolons
-	unsigned int cnt;
+	filemapOverlay::iterator fitForw, fitBack;//used to check prior an later lines for semicolons
 	string line, line2;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$><=:";
 	tokLocVect conditionalVector;
@@ -386,55 +392,8 @@ int CVHDLCounter::CountComplexity(filemap* fmap, results* result)
 
 		line = " " + line;
 
-		// mathematical functions
-		cnt = 0;
-		CUtil::CountTally(line, math_func_list, cnt, 1, exclude, "", "", &result->math_func_count, casesensitive);
-		result->cmplx_math_lines += cnt;
-
-		// trigonometric functions
-		cnt = 0;
-		CUtil::CountTally(line, trig_func_list, cnt, 1, exclude, "", "", &result->trig_func_count, casesensitive);
-		result->cmplx_trig_lines += cnt;
-
-		// logarithmic functions
-		cnt = 0;
-		CUtil::CountTally(line, log_func_list, cnt, 1, exclude, "", "", &result->log_func_count, casesensitive);
-		result->cmplx_logarithm_lines += cnt;
-
-		// calculations
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_calc_list, cnt, 1, exclude, "", "", &result->cmplx_calc_count, casesensitive);
-		result->cmplx_calc_lines += cnt;
-
-		// conditionals
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_cond_list, cnt, 1, exclude, "", "", &result->cmplx_cond_count, casesensitive);
-		result->cmplx_cond_lines += cnt;
-
-		// logical operators
-		cnt = 0;
-		StringVector tmpList = cmplx_logic_list;//making a temporary list with the '<=' operator removed from the list; counting it on another pass;
-		tmpList.pop_back();
-		CUtil::CountTally(line, tmpList, cnt, 1, exclude, "", "", &result->cmplx_logic_count, casesensitive);
-		result->cmplx_logic_lines += cnt;
-
-		// preprocessor directives
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_preproc_list, cnt, 1, exclude, "", "", &result->cmplx_preproc_count, casesensitive);
-		result->cmplx_preproc_lines += cnt;
-
-		// assignments
-		cnt = 0;
-		tmpList.clear();
-		tmpList = cmplx_assign_list;//making a temporary list with the '<=' operator removed from the list; counting it on another pass;
-		tmpList.pop_back();
-		CUtil::CountTally(line, tmpList, cnt, 1, exclude, "", "", &result->cmplx_assign_count, casesensitive);
-		result->cmplx_assign_lines += cnt;
-
-		// pointers
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_pointer_list, cnt, 1, exclude, "", "", &result->cmplx_pointer_count, casesensitive);
-		result->cmplx_pointer_lines += cnt;
+		// complexity keywords of all lists
+		CountComplexityTallies(line, exclude, cmplx_logic_list_no_le, cmplx_assign_list_no_le, result);
 	}
 
 	// do a single pass to mark and replace logical operator lessThan or equal "<="
@@ -442,8 +401,7 @@ int CVHDLCounter::CountComplexity(filemap* fmap, results* result)
 	// the remaining are signal assignment operators
 	for (fit = fmap->begin(); fit != fmap->end(); fit++)
 	{
-		line = fit->line;
-		line = CUtil::ToLower(line);
+		CUtil::ToLower(fit->line, line);
 		
 		if (CUtil::CheckBlank(line))
 			continue;
@@ -645,15 +603,15 @@ int CVHDLCounter::CountComplexity(filemap* fmap, results* result)
 *
 * \return method status
 */
-int CVHDLCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CVHDLCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	size_t idx;
 	unsigned int cnt = 0;
 	string strDirLine = "";
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$><=:";
 
-	filemap::iterator itfmBak = fmapBak->begin();
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -661,7 +619,7 @@ int CVHDLCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fm
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count, false);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count, false);
 		}
 
 		// if not a continuation of a previous directive
@@ -671,7 +629,7 @@ int CVHDLCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fm
 			// e.g. package should not be considered a directive (only 'pack' is)
 			if (((idx = CUtil::FindKeyword(iter->line, *viter, 0, TO_END_OF_STRING, false)) != string::npos) && idx == 0)
 			{
-				iter->line = "";
+				fmap->edit(iter) = "";
 				result->directive_lines[PHY]++;
 				break;
 			}
@@ -694,7 +652,7 @@ int CVHDLCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fm
 *
 * \return method status
 */
-int CVHDLCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CVHDLCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool			blank_flag		= false;
 	bool			found_unit	= false;
@@ -703,7 +661,7 @@ int CVHDLCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 	unsigned int	cnt				= 0;
 	unsigned int	loopLevel		= 0;
 
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak, tmp;
 	string special = "[]()+/-*<>=,@&~!^?:%{}";
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$><=:";
@@ -711,7 +669,7 @@ int CVHDLCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 	unsigned int l_paren_cnt = 0;
 	bool l_foundblock, found_forifwhile, found_end, found_type, found_is, processSignatureFound, found_withSelect, found_whenConditional, foundWait, blockSignatureFound, found_record;
 	l_foundblock = found_forifwhile = found_end = found_is = processSignatureFound = found_withSelect = found_whenConditional = foundWait = blockSignatureFound = found_record = false;
-	vectorString currentBlock;
+	ArenaStringVector currentBlock(arena);
 
 	for (fit = fmap->begin(), fitbak = fmapBak->begin(); fit != fmap->end(); fit++, fitbak++)
 	{
@@ -737,7 +695,7 @@ int CVHDLCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 				blockSignatureFound, found_record);
 
 			cnt = 0;
-			CUtil::CountTally(line, data_name_list, cnt, 1, exclude, "", "", NULL, false);	//tie breaker in favor of physical data rather than physical exec 		
+			CountTally(line, data_name_list, cnt, 1, exclude, "", "", NULL, false);	//tie breaker in favor of physical data rather than physical exec 		
 	
 			// need to check also if the data line continues
 			if ((cnt > 0 && currentBlock.size() == 0 ) || (currentBlock.size()>0 && (currentBlock.back().compare("record") == 0 || currentBlock.back().compare("units") == 0)))
@@ -748,7 +706,7 @@ int CVHDLCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count, false);
 			}
 		}
 	}
@@ -773,7 +731,7 @@ int CVHDLCounter::LanguageSpecificProcess(filemap* fmap, results* result, filema
 * \param currentBlock current block vector
 */
 void CVHDLCounter::FoundSLOC(results* result, string &strLSLOC, string &strLSLOCBak, bool &found_block, bool &found_forifwhile,
-	bool &found_end, bool &found_type, bool &found_is, bool &found_unit, bool &trunc_flag, StringVector currentBlock)
+	bool &found_end, bool &found_type, bool &found_is, bool &found_unit, bool &trunc_flag, const ArenaStringVector &currentBlock)
 {
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$:";
 
@@ -783,7 +741,7 @@ void CVHDLCounter::FoundSLOC(results* result, string &strLSLOC, string &strLSLOC
 		// determine logical type, data declaration or executable
 		unsigned int cnt = 0;
 
-		CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
+		CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count, false);
 		if ((cnt > 0 && currentBlock.size() == 0) || (currentBlock.size()>0 && (currentBlock.back().compare("record") == 0 || currentBlock.back().compare("units") == 0))  )
 			result->data_lines[LOG]++;
 		else
@@ -829,9 +787,9 @@ void CVHDLCounter::FoundSLOC(results* result, string &strLSLOC, string &strLSLOC
 * \param blockSignatureStartFound found block signature start flag
 * \param found_recort found record flag
 */
-void CVHDLCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+void CVHDLCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 	bool &found_block, bool &found_forifwhile, bool &found_end, bool &found_type, bool &found_is, bool &found_unit,
-	unsigned int &loopLevel, vectorString &currentBlock, bool &processSignatureStartFound, bool &found_withSelect, bool &found_whenConditional, bool &foundWait,
+	unsigned int &loopLevel, ArenaStringVector &currentBlock, bool &processSignatureStartFound, bool &found_withSelect, bool &found_whenConditional, bool &foundWait,
 	bool &blockSignatureStartFound, bool &found_record)
 {
 	size_t start = 0, forstart = 0; //starting index of the working string
@@ -880,7 +838,7 @@ void CVHDLCounter::LSLOC(results* result, string line, string lineBak, string &s
 				if (foundWait) foundWait = false;
 
 				// check for empty statement (=1 LSLOC)
-				if (CUtil::TrimString(line.substr(start, i + 1 - start)) == ";" && strLSLOC.length() < 1)
+				if (CUtil::TrimStringEquals(line, start, i + 1 - start, ";") && strLSLOC.length() < 1)
 				{
 					strLSLOC = ";";
 					strLSLOCBak = ";";
@@ -965,7 +923,8 @@ void CVHDLCounter::LSLOC(results* result, string line, string lineBak, string &s
 			if (currentBlock.size() != 0)
 			{
 				// check for is here first
-				tmp = "xxx " + CUtil::TrimString(line.substr(start, i + 1 - start));
+				tmp = "xxx ";
+				CUtil::AppendTrimString(tmp, line, start, i + 1 - start);
 				
 				//try to locate the is at the end of the string if a block has been found
 				if (found_block)
@@ -1028,8 +987,10 @@ void CVHDLCounter::LSLOC(results* result, string line, string lineBak, string &s
 			continue;
 
 		// if it ends in xxx, then it has already been counted, so ignore it
-		tmp = "xxx " + CUtil::TrimString(line.substr(start, i + 1 - start));
-		fortmp = "xxx " + CUtil::TrimString(line.substr(forstart, i + 1 - start));
+		tmp = "xxx ";
+		CUtil::AppendTrimString(tmp, line, start, i + 1 - start);
+		fortmp = "xxx ";
+		CUtil::AppendTrimString(fortmp, line, forstart, i + 1 - start);
 
 		if (found_block)
 		{
@@ -1061,13 +1022,13 @@ void CVHDLCounter::LSLOC(results* result, string line, string lineBak, string &s
 			// record end loop for nested loop processing
 			if (print_cmplx)
 			{
-				tmp = CUtil::TrimString(line.substr(start, i + 5 - start));
+				CUtil::AssignTrimString(tmp, line, start, i + 5 - start);
 				if (CUtil::FindKeyword(tmp, "end loop", 0, TO_END_OF_STRING, false) != string::npos)
 				{
 					if (loopLevel > 0)
 						loopLevel--;
 				}
-				tmp = CUtil::TrimString(line.substr(start, i + 9 - start));
+				CUtil::AssignTrimString(tmp, line, start, i + 9 - start);
 				if (CUtil::FindKeyword(tmp, "end generate", 0, TO_END_OF_STRING, false) != string::npos)
 				{
 					if (loopLevel > 0)
@@ -1429,12 +1390,12 @@ void CVHDLCounter::LSLOC(results* result, string line, string lineBak, string &s
 		}
 	}
 
-	tmp = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
 	strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 	if (strSize > 0)
 	{
 		strLSLOC += tmp.substr(0, strSize);
-		tmp = CUtil::TrimString(lineBak.substr(start, i - start));
+		CUtil::AssignTrimString(tmp, lineBak, start, i - start);
 		strLSLOCBak += tmp.substr(0, strSize);
 
 		// drop continuation symbol
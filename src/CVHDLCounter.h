@@ -33,16 +33,19 @@ public:
 
 protected:
 	virtual int ReplaceQuote(string &strline, size_t &idx_start, bool &contd, char &CurrentQuoteEnd);
-	virtual int CountCommentsSLOC(filemap* fmap, results* result, filemap *fmapBak);
-	virtual int CountComplexity(filemap* fmap, results* result);
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak);
+	virtual int CountCommentsSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak);
+	virtual int CountComplexity(filemapOverlay* fmap, results* result);
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak);
 	void FoundSLOC(results* result, string &strLSLOC, string &strLSLOCBak, bool &found_block, bool &found_forifwhile,
-		bool &found_end, bool &found_type, bool &found_is, bool &found_unit, bool &trunc_flag, StringVector currentBlock);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+		bool &found_end, bool &found_type, bool &found_is, bool &found_unit, bool &trunc_flag, const ArenaStringVector &currentBlock);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 		bool &forflag, bool &found_forifwhile, bool &found_while, bool &found_type, bool &found_is, bool &found_unit,
-		unsigned int &loopLevel, vectorString &currentBlock, bool &processSignatureFound, bool &found_withSelect, bool &found_whenConditional, bool &foundWait,
+		unsigned int &loopLevel, ArenaStringVector &currentBlock, bool &processSignatureFound, bool &found_withSelect, bool &found_whenConditional, bool &foundWait,
 		bool &blockSignatureFound, bool &found_record);
+
+	StringVector cmplx_logic_list_no_le;	//!< Logicals without '<=' (complexity)
+	StringVector cmplx_assign_list_no_le;	//!< Assignments without '<=' (complexity)
 };
 
 #endif
@@ -244,7 +244,7 @@ CVbCounter::CVbCounter()
 *
 * \return method status
 */
-int CVbCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* /*fmapBak*/)
+int CVbCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* /*fmapBak*/)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
@@ -252,7 +252,7 @@ int CVbCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* /*fm
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string strDirLine = "";
 
-	for (filemap::iterator iter = fmap->begin(); iter!=fmap->end(); iter++)
+	for (filemapOverlay::iterator iter = fmap->begin(); iter!=fmap->end(); iter++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -260,7 +260,7 @@ int CVbCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* /*fm
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
 		}
 
 		if (!contd)
@@ -304,7 +304,7 @@ int CVbCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* /*fm
 				if (result->addSLOC(strDirLine, trunc_flag))
 					result->directive_lines[LOG]++;
 			}
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -324,16 +324,16 @@ int CVbCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* /*fm
 *
 * \return method status
 */
-int CVbCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CVbCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	string strLSLOC = "";
     string strLSLOCBak = "";
 
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
 	size_t i, pos, prev_pos, strSize, tmpLoc;
 	unsigned int cnt = 0;
-	StringVector loopEnd;
+	ArenaStringVector loopEnd(arena);
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string special = "[]()+/-*<>=,@&~!^?:%{}";
 
@@ -417,7 +417,7 @@ int CVbCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap*
 					tmpLoc = string::npos;
 				}
 				else
-					tmpstr = CUtil::TrimString(tmp.substr(prev_pos, i - prev_pos + 1));
+					CUtil::AssignTrimString(tmpstr, tmp, prev_pos, i - prev_pos + 1);
 
 				// exclude SLOC defined in the exclude_keywords
 				line_skipped = false;
@@ -467,7 +467,7 @@ int CVbCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap*
 				if (result->addSLOC(strLSLOCBak, trunc_flag))
 				{
 					cnt = 0;
-					CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
+					CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", &result->data_name_count);
 					if (cnt > 0)
 					{
 						isDataLine = true;
@@ -478,7 +478,7 @@ int CVbCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap*
 						if (print_cmplx)
 						{
 							cnt = 0;
-							CUtil::CountTally(strLSLOC, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+							CountTally(strLSLOC, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 						}
 						result->exec_lines[LOG]++;
 					}
@@ -517,7 +517,7 @@ int CVbCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap*
 * \return 1 if function name is found
 */
 int CVbCounter::ParseFunctionName(const string &line, string &/*lastline*/,
-	filemap &functionStack, string &functionName, unsigned int &functionCount)
+	ArenaFilemap &functionStack, string &functionName, unsigned int &functionCount)
 {
 	string str;
 	size_t idx;
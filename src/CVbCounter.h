@@ -22,10 +22,10 @@ public:
 	CVbCounter();
 
 protected:
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak = NULL);
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak = NULL);
 	int ParseFunctionName(const string &line, string &lastline,
-		filemap &functionStack, string &functionName, unsigned int &functionCount);
+		ArenaFilemap &functionStack, string &functionName, unsigned int &functionCount);
 
 	StringVector exclude_start_keywords;		//!< SLOC lines excluded from counts starting with keywords
 };
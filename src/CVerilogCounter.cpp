@@ -185,6 +185,12 @@ CVerilogCounter::CVerilogCounter()
 
 	cmplx_assign_list.push_back("=");
 	cmplx_assign_list.push_back("<=");
+
+	// same lists without the '<=' operator, which is counted on another pass
+	cmplx_logic_list_no_le = cmplx_logic_list;
+	cmplx_logic_list_no_le.pop_back();
+	cmplx_assign_list_no_le = cmplx_assign_list;
+	cmplx_assign_list_no_le.pop_back();
 }
 
 /*!
@@ -195,14 +201,13 @@ CVerilogCounter::CVerilogCounter()
 *
 * \return method status
 */
-int CVerilogCounter::CountComplexity(filemap* fmap, results* result)
+int CVerilogCounter::CountComplexity(filemapOverlay* fmap, results* result)
 {
 	if (classtype == UNKNOWN || classtype == DATAFILE)
 		return 0;
-	filemap::iterator fit;
+	filemapOverlay::iterator fit;
 	filemap fitBak;
-	filemap::iterator fitForw, fitBack;	// used to check prior an later lines for semicolons
-	unsigned int cnt;
+	filemapOverlay::iterator fitForw, fitBack;	// used to check prior an later lines for semicolons
 	string line, line2;
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$><=:";
 	tokLocVect conditionalVector;
@@ -212,10 +217,6 @@ int CVerilogCounter::CountComplexity(filemap* fmap, results* result)
 	stringstream ss;	// insert the string into a stream
 	int count = 0;
 	int condCount = 0;
-	StringVector tmpLogicList = cmplx_logic_list;	// making a temporary list with the '<=' operator removed from the list;  counting it on another pass;
-	tmpLogicList.pop_back();
-	StringVector tmpAssignList = cmplx_assign_list;	// making a temporary list with the '<=' operator removed from the list;  counting it on another pass;
-	tmpAssignList.pop_back();
 	string::iterator it;
 
 	for (fit = fmap->begin(); fit != fmap->end(); fit++)
@@ -227,52 +228,8 @@ int CVerilogCounter::CountComplexity(filemap* fmap, results* result)
 
 		line = " " + line;
 
-		// mathematical functions
-		cnt = 0;
-		CUtil::CountTally(line, math_func_list, cnt, 1, exclude, "", "", &result->math_func_count, casesensitive);
-		result->cmplx_math_lines += cnt;
-
-		// trigonometric functions
-		cnt = 0;
-		CUtil::CountTally(line, trig_func_list, cnt, 1, exclude, "", "", &result->trig_func_count, casesensitive);
-		result->cmplx_trig_lines += cnt;
-
-		// logarithmic functions
-		cnt = 0;
-		CUtil::CountTally(line, log_func_list, cnt, 1, exclude, "", "", &result->log_func_count, casesensitive);
-		result->cmplx_logarithm_lines += cnt;
-
-		// calculations
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_calc_list, cnt, 1, exclude, "", "", &result->cmplx_calc_count, casesensitive);
-		result->cmplx_calc_lines += cnt;
-
-		// conditionals
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_cond_list, cnt, 1, exclude, "", "", &result->cmplx_cond_count, casesensitive);
-		result->cmplx_cond_lines += cnt;
-
-		// logical operators
-		cnt = 0;
-		//using tmpLogicList
-		CUtil::CountTally(line, tmpLogicList, cnt, 1, exclude, "", "", &result->cmplx_logic_count, casesensitive);
-		result->cmplx_logic_lines += cnt;
-
-		// preprocessor directives
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_preproc_list, cnt, 1, exclude, "", "", &result->cmplx_preproc_count, casesensitive);
-		result->cmplx_preproc_lines += cnt;
-
-		// assignments
-		cnt = 0;
-		//using tmpAssignList
-		CUtil::CountTally(line, tmpAssignList, cnt, 1, exclude, "", "", &result->cmplx_assign_count, casesensitive);
-		result->cmplx_assign_lines += cnt;
-
-		// pointers
-		cnt = 0;
-		CUtil::CountTally(line, cmplx_pointer_list, cnt, 1, exclude, "", "", &result->cmplx_pointer_count, casesensitive);
-		result->cmplx_pointer_lines += cnt;
+		// complexity keywords of all lists
+		CountComplexityTallies(line, exclude, cmplx_logic_list_no_le, cmplx_assign_list_no_le, result);
 	}
 
 	// do another pass since we ignored every less than or equal to symbol
@@ -282,8 +239,7 @@ int CVerilogCounter::CountComplexity(filemap* fmap, results* result)
 	condCount = 0;
 	for (fit = fmap->begin(); fit != fmap->end(); fit++)
 	{
-		line = fit->line;
-		line = CUtil::ToLower(line);
+		CUtil::ToLower(fit->line, line);
 
 		if (CUtil::CheckBlank(line))
 			continue;
@@ -337,7 +293,7 @@ int CVerilogCounter::CountComplexity(filemap* fmap, results* result)
 *
 * \return method status
 */
-int CVerilogCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapBak)
+int CVerilogCounter::CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	bool contd = false, trunc_flag = false;
 	size_t idx, strSize;
@@ -345,8 +301,8 @@ int CVerilogCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 	string exclude = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_$";
 	string strDirLine = "";
 
-	filemap::iterator itfmBak = fmapBak->begin();
-	for (filemap::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
+	filemapOverlay::iterator itfmBak = fmapBak->begin();
+	for (filemapOverlay::iterator iter = fmap->begin(); iter != fmap->end(); iter++, itfmBak++)
 	{
 		if (CUtil::CheckBlank(iter->line))
 			continue;
@@ -354,7 +310,7 @@ int CVerilogCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 		if (print_cmplx)
 		{
 			cnt = 0;
-			CUtil::CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
+			CountTally(" " + iter->line, directive, cnt, 1, exclude, "", "", &result->directive_count);
 		}
 
 		if (!contd)
@@ -391,7 +347,7 @@ int CVerilogCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 			contd = false;
 			if (result->addSLOC(strDirLine, trunc_flag))
 				result->directive_lines[LOG]++;
-			iter->line = "";
+			fmap->edit(iter) = "";
 		}
 	}
 	return 1;
@@ -411,7 +367,7 @@ int CVerilogCounter::CountDirectiveSLOC(filemap* fmap, results* result, filemap*
 *
 * \return method status
 */
-int CVerilogCounter::LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapBak)
+int CVerilogCounter::LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapBak)
 {
 	unsigned int	paren_count			= 0;
 	bool			for_flag			= false;
@@ -426,9 +382,9 @@ int CVerilogCounter::LanguageSpecificProcess(filemap* fmap, results* result, fil
 	string			strLSLOC			= "";
 	string			strLSLOCBak			= "";
 
-	filemap::iterator fit, fitbak;
+	filemapOverlay::iterator fit, fitbak;
 	string line, lineBak;
-	StringVector loopLevel;
+	ArenaStringVector loopLevel(arena);
 
 	unsigned int phys_exec_lines = 0;
 	unsigned int phys_data_lines = 0;
@@ -455,7 +411,7 @@ int CVerilogCounter::LanguageSpecificProcess(filemap* fmap, results* result, fil
 			if (print_cmplx)
 			{
 				cnt = 0;
-				CUtil::CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
+				CountTally(line, exec_name_list, cnt, 1, exclude, "", "", &result->exec_name_count);
 			}
 
 			result->exec_lines[PHY] += phys_exec_lines;
@@ -495,10 +451,10 @@ int CVerilogCounter::LanguageSpecificProcess(filemap* fmap, results* result, fil
 * \param case_flag found case
 * \param repeat_flag found repeat
 */
-void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+void CVerilogCounter::LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 	bool &forflag, bool &found_forifwhile, bool &found_while, char &prev_char, bool &data_continue,
 	unsigned int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines,
-	bool &found_for, StringVector &loopLevel, bool &always_flag, bool &case_flag, bool &repeat_flag)
+	bool &found_for, ArenaStringVector &loopLevel, bool &always_flag, bool &case_flag, bool &repeat_flag)
 {
 	// paren_cnt is used with 'for' statement only
 	size_t start = 0, startmax = 0; // starting index of the working string
@@ -516,7 +472,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 	// there may be more than 1 logical SLOC in this line
 	while (i < line.length())
 	{
-		tmp = CUtil::TrimString(line.substr(start, i + 1 - start));
+		CUtil::AssignTrimString(tmp, line, start, i + 1 - start);
 		if (CUtil::FindKeyword(tmp, "end") != string::npos && loopLevel.size() > 0 && loopLevel.back().compare("begin") == 0)
 		{
 			loopLevel.pop_back();	// pop begin
@@ -549,7 +505,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 		{
 			if (print_cmplx)
 			{
-				tmp = CUtil::TrimString(line.substr(start, i + 1 - start));
+				CUtil::AssignTrimString(tmp, line, start, i + 1 - start);
 				tmp = strLSLOC + " " + tmp;
 				if (CUtil::FindKeyword(tmp, "begin") != string::npos && loopLevel.size() > 0 && loopLevel.back().compare("looping") == 0)
 				{
@@ -563,7 +519,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 				loopLevel.push_back("looping");
 				// forever doesn't have any conditions so just add it to sloc
 				unsigned int loopCnt = 0;
-				for (StringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
+				for (ArenaStringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
 				{
 					if ((*lit) != "begin")
 						loopCnt++;
@@ -608,7 +564,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 			// record open bracket for nested loop processing
 			if (print_cmplx)
 			{
-				tmp = CUtil::TrimString(line.substr(start, i + 1 - start));
+				CUtil::AssignTrimString(tmp, line, start, i + 1 - start);
 				tmp = strLSLOC + " " + tmp;
 				
 				if (CUtil::FindKeyword(tmp, "begin") != string::npos && loopLevel.size() > 0 && loopLevel.back().compare("looping") == 0)
@@ -632,7 +588,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 			}
 
 			// check for empty statement (=1 LSLOC)
-			if (CUtil::TrimString(line.substr(start, i + 1 - start)) == ";" && strLSLOC.length() < 1)
+			if (CUtil::TrimStringEquals(line, start, i + 1 - start, ";") && strLSLOC.length() < 1)
 			{
 				strLSLOC = ";";
 				strLSLOCBak = ";";
@@ -649,7 +605,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 			if (result->addSLOC(strLSLOCBak, trunc_flag))
 			{
 				cnt = 0;
-				CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, dataExclude, "", "", &result->data_name_count);
+				CountTally(strLSLOC, data_name_list, cnt, 1, dataExclude, "", "", &result->data_name_count);
 
 				temp_lines++;
 				if (data_continue == true && line[i] == ';')
@@ -699,7 +655,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 
 			break;
 		case '(':
-			tmp = CUtil::TrimString(line.substr(start, i));
+			CUtil::AssignTrimString(tmp, line, start, i);
 			if (CUtil::FindKeyword(tmp, "always") != string::npos)
 			{
 				// found always
@@ -728,7 +684,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 
 					if (print_cmplx)
 					{
-						tmp = CUtil::TrimString(line.substr(start, i + 1 - start));
+						CUtil::AssignTrimString(tmp, line, start, i + 1 - start);
 						tmp = strLSLOC + " " + tmp;
 						if (CUtil::FindKeyword(tmp, "begin") != string::npos && loopLevel.size() > 0 && loopLevel.back().compare("looping") == 0)
 						{
@@ -767,7 +723,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 						if (CUtil::FindKeyword(tmp, "if") == string::npos)
 						{
 							unsigned int loopCnt = 0;
-							for (StringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
+							for (ArenaStringVector::iterator lit = loopLevel.begin(); lit < loopLevel.end(); lit++)
 							{
 								if ((*lit) != "begin")
 									loopCnt++;
@@ -827,7 +783,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 	}
 
 	// don't save end statements to add to next sloc, they will be counted as physical sloc but not logical
-	tmp = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
 	if ((tmpi = CUtil::FindKeyword(tmp, "endcase")) != string::npos)
 	{
 		startmax = max((start + tmpi + 8), startmax);
@@ -852,12 +808,12 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 	}
 	if (startmax != 0) start = min(i, startmax);	// if we found and end statement update start to be the max of i and startmax
 
-	tmp = CUtil::TrimString(line.substr(start, i - start));
+	CUtil::AssignTrimString(tmp, line, start, i - start);
 	strSize = CUtil::TruncateLine(tmp.length(), strLSLOC.length(), this->lsloc_truncate, trunc_flag);
 	if (strSize > 0 || (strLSLOC.size() > 0 && found_end))
 	{
 		strLSLOC += tmp.substr(0, strSize);
-		tmp = CUtil::TrimString(lineBak.substr(start, i - start));
+		CUtil::AssignTrimString(tmp, lineBak, start, i - start);
 		strLSLOCBak += tmp.substr(0, strSize);
 
 		if (found_end)
@@ -876,7 +832,7 @@ void CVerilogCounter::LSLOC(results* result, string line, string lineBak, string
 
 	// make sure that we are not beginning to process a new data line
 	cnt = 0;
-	CUtil::CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
+	CountTally(strLSLOC, data_name_list, cnt, 1, exclude, "", "", NULL);
 
 	if (cnt > 0)
 		data_continue = true;
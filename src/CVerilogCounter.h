@@ -24,13 +24,16 @@ public:
 	CVerilogCounter();
 
 protected:
-	virtual int CountComplexity(filemap* fmap, results* result);
-	virtual int CountDirectiveSLOC(filemap* fmap, results* result, filemap* fmapmBak = NULL);
-	virtual int LanguageSpecificProcess(filemap* fmap, results* result, filemap* fmapmBak = NULL);
-	void LSLOC(results* result, string line, string lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
+	virtual int CountComplexity(filemapOverlay* fmap, results* result);
+	virtual int CountDirectiveSLOC(filemapOverlay* fmap, results* result, filemapOverlay* fmapmBak = NULL);
+	virtual int LanguageSpecificProcess(filemapOverlay* fmap, results* result, filemapOverlay* fmapmBak = NULL);
+	void LSLOC(results* result, const string &line, const string &lineBak, string &strLSLOC, string &strLSLOCBak, unsigned int &paren_cnt,
 		bool &forflag, bool &found_forifwhile, bool &found_while, char &prev_char, bool &data_continue,
 		unsigned int &temp_lines, unsigned int &phys_exec_lines, unsigned int &phys_data_lines,
-		bool &found_for, StringVector &loopLevel, bool &always_flag, bool &case_flag, bool &repeat_flag);
+		bool &found_for, ArenaStringVector &loopLevel, bool &always_flag, bool &case_flag, bool &repeat_flag);
+
+	StringVector cmplx_logic_list_no_le;	//!< Logicals without '<=' (complexity)
+	StringVector cmplx_assign_list_no_le;	//!< Assignments without '<=' (complexity)
 };
 
 #endif
@@ -6,6 +6,7 @@
 */
 
 #include <set>
+#include <algorithm>
 
 #include "CWebCounter.h"
 
@@ -178,6 +179,58 @@ CWebCounter::CWebCounter()
 	ScriptTable.insert(map<string, int>::value_type(string("c#")		,CSHARP_HTML));
 	ScriptTable.insert(map<string, int>::value_type(string("php")		,PHP));
 	ScriptTable.insert(map<string, int>::value_type(string("vb")		,VB));
+
+	// compile the tags in table order (the first tag wins if several start at the same position)
+	StringVector tags;
+	for (map<string, int>::iterator iter = TagTable.begin(); iter != TagTable.end(); iter++)
+	{
+		tags.push_back(iter->first);
+		tagIds.push_back(iter->second);
+	}
+	tagMatcher.Compile(tags, false);
+}
+
+/*!
+* Finds the first script tag in the rest of a line (same as CUtil::FindStringsCaseInsensitive
+* with TagTable, but the line is scanned once from start and is not copied).
+*
+* \param line line
+* \param start start of the rest of the line
+* \param pos position of the tag found (relative to start)
+* \param preLang previous tag found
+*
+* \return tag found (INVALID_POSITION if none or an end tag without its start tag)
+*/
+size_t CWebCounter::FindTag(const string &line, size_t start, size_t &pos, size_t preLang) const
+{
+	size_t tag, ret;
+	pos = tagMatcher.FindFirst(line, start, tag);
+	if (pos == string::npos)
+		return INVALID_POSITION;
+	pos -= start;
+	ret = (size_t)tagIds[tag];
+
+	// handle special case "width=100%>"
+	if ((ret == WEB_ASP_JSP_END && preLang != WEB_ASP_JSP_START) ||
+		(ret == WEB_PHP_END && (preLang != WEB_PHP_START && preLang != WEB_PHP_START2)))
+		ret = INVALID_POSITION;
+	return ret;
+}
+
+/*!
+* Finds a char in the rest of a line.
+*
+* \param line line
+* \param start start of the rest of the line
+* \param c char to find
+* \param idx index to start search (relative to start)
+*
+* \return index of the char (relative to start)
+*/
+static size_t FindRest(const string &line, size_t start, char c, size_t idx)
+{
+	size_t found = line.find(c, start + idx);
+	return (found == string::npos) ? found : found - start;
 }
 
 /*!
@@ -221,7 +274,7 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 	CleanSeparatedFile();
 	lineElement current_line;
 	lineElement separate_line;
-	size_t pos, close_pos, search_result, tempi, lng;
+	size_t pos, close_pos, search_result, tempi, lng, cur;
 	char c;
 	int current_language, cf_mode = -1, tag_open_mode = -1;
 	int script_language_of_asp = VBS_ASP_S;
@@ -267,9 +320,11 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 		else
 			blank_line = false;
 
-		while (current_line.line.length() > 0)
+		// the rest of the line starts at cur (positions found are relative to cur)
+		cur = 0;
+		while (cur < current_line.line.length())
 		{
-			search_result = CUtil::FindStringsCaseInsensitive(current_line.line, TagTable, pos, preLang);
+			search_result = FindTag(current_line.line, cur, pos, preLang);
 			if (search_result != INVALID_POSITION)
 				preLang = search_result;
 
@@ -277,32 +332,31 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 			{
 			case WEB_PHP_START:
 				{
-					SeparatedLine[current_language].line += current_line.line.substr(0, pos + 5);
+					SeparatedLine[current_language].line.append(current_line.line, cur, pos + 5);
 					PreviousLanguage.push(current_language);
 					current_language = PHP;
-					current_line.line = current_line.line.substr(pos + 5);
+					cur += pos + 5;
 				}
 				break;
 			case WEB_PHP_START2:
 				{
 					// check for <?php since map order is by string
 					tempi = 2;
-					if (current_line.line.length() >= pos + 5)
+					if (current_line.line.length() - cur >= pos + 5)
 					{
-						tempstr = CUtil::ToLower(current_line.line);
-						if (tempstr.substr(pos + 2, 3) == "php")
+						if (CUtil::MatchAt(current_line.line, cur + pos + 2, "php", false))
 							tempi = 5;
 					}
-					SeparatedLine[current_language].line += current_line.line.substr(0, pos + tempi);
+					SeparatedLine[current_language].line.append(current_line.line, cur, pos + tempi);
 					PreviousLanguage.push(current_language);
 					current_language = PHP;
-					current_line.line = current_line.line.substr(pos + tempi);
+					cur += pos + tempi;
 				}
 				break;
 			case WEB_PHP_END:
 				{
 					// check for line termination (not required at an end tag), add semi-colon if none
-					tempstr = CUtil::TrimString(current_line.line.substr(0, pos));
+					CUtil::AssignTrimString(tempstr, current_line.line, cur, pos);
 					if (CUtil::CheckBlank(tempstr))
 					{
 						filemap::iterator iter2 = Separation[current_language].first.end();
@@ -327,7 +381,7 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 						c = tempstr[tempstr.length() - 1];
 						if (c != ';' && c != '{' && c != '}' && c != ':')
 						{
-							current_line.line.insert(pos, ";");
+							current_line.line.insert(cur + pos, ";");
 							pos++;
 						}
 					}
@@ -342,7 +396,7 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 				break;
 			case WEB_ASP_JSP_END:
 				{
-					SeparatedLine[current_language].line += current_line.line.substr(0, pos);
+					SeparatedLine[current_language].line.append(current_line.line, cur, pos);
 					if (current_language == JAVA_JSP || current_language == CSHARP_ASP_S)
 					{
 						// special process for JSP; add semicolon at the end of line if there is no semicolon
@@ -360,18 +414,18 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 					}
 
 					// remove %>, next line
-					current_line.line = current_line.line.substr(pos + 2);
+					cur += pos + 2;
 				}
 				break;
 			case WEB_SCRIPT_START:
 				{
-					close_pos = current_line.line.find_first_of(">", pos + 7);
-					SeparatedLine[current_language].line += current_line.line.substr(0, close_pos + 1);
-					string language = CUtil::ToLower(current_line.line.substr(pos + 7, close_pos-pos + 7));
-					if (close_pos < current_line.line.size())
-						current_line.line = current_line.line.substr(close_pos + 1);
+					close_pos = FindRest(current_line.line, cur, '>', pos + 7);
+					SeparatedLine[current_language].line.append(current_line.line, cur, close_pos + 1);
+					string language = CUtil::ToLower(current_line.line.substr(cur + pos + 7, close_pos-pos + 7));
+					if (close_pos < current_line.line.size() - cur)
+						cur += close_pos + 1;
 					else
-						current_line.line = "";
+						cur = current_line.line.length();
 
 					PreviousLanguage.push(current_language);
 					current_language = (int)CUtil::FindStringsCaseInsensitive(language, ScriptTable, pos);	
@@ -455,10 +509,10 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 				break;
 			case WEB_SCRIPT_END:
 				{
-					SeparatedLine[current_language].line += current_line.line.substr(0, pos);
+					SeparatedLine[current_language].line.append(current_line.line, cur, pos);
 					// fixed an error when </script> appears w/o <script>, next two lines
 					if (PreviousLanguage.empty())
-						current_line.line = current_line.line.substr(pos + 9);
+						cur = min(cur + pos + 9, current_line.line.length());
 					else
 					{
 						if (cf_mode >= 0)
@@ -468,19 +522,19 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 							current_language = PreviousLanguage.top();
 							PreviousLanguage.pop();
 						}
-						close_pos = current_line.line.find_first_of(">", pos + 8);
-						SeparatedLine[current_language].line += current_line.line.substr(pos, close_pos - pos + 1);
-						if (close_pos < current_line.line.size())
-							current_line.line = current_line.line.substr(close_pos + 1);
+						close_pos = FindRest(current_line.line, cur, '>', pos + 8);
+						SeparatedLine[current_language].line.append(current_line.line, cur + pos, close_pos - pos + 1);
+						if (close_pos < current_line.line.size() - cur)
+							cur += close_pos + 1;
 						else
-							current_line.line = "";
+							cur = current_line.line.length();
 					}
 				}
 				break;
 			case WEB_ASP_JSP_START:
 				{
 					// removed <% from HTML page, next line, changed pos + 2 to pos
-					SeparatedLine[current_language].line += current_line.line.substr(0, pos);
+					SeparatedLine[current_language].line.append(current_line.line, cur, pos);
 					PreviousLanguage.push(current_language);
 					if (webType == WEB_ASP)		// includes .aspx
 					{
@@ -489,15 +543,14 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 							// the following lines within this "if" are used to 
 							// check the language used in the page
 							// case: <%@ Page language="???">
-							tempstr = CUtil::ToLower(current_line.line);
-							if (tempstr.find("@") != string::npos)
+							if (current_line.line.find('@', cur) != string::npos)
 							{
-								if ((tempstr.find("javascript") != string::npos) ||
-									(tempstr.find("js") != string::npos))
+								if ((CUtil::FindLowerCase(current_line.line, "javascript", cur) != string::npos) ||
+									(CUtil::FindLowerCase(current_line.line, "js", cur) != string::npos))
 									script_language_of_asp = JAVASCRIPT_ASP_S;
-								else if ((tempstr.find("c#") != string::npos) ||
-									(tempstr.find("cs") != string::npos) ||
-									(tempstr.find("csharp") != string::npos))
+								else if ((CUtil::FindLowerCase(current_line.line, "c#", cur) != string::npos) ||
+									(CUtil::FindLowerCase(current_line.line, "cs", cur) != string::npos) ||
+									(CUtil::FindLowerCase(current_line.line, "csharp", cur) != string::npos))
 									script_language_of_asp = CSHARP_ASP_S;
 							}
 							first_line_of_asp = false;
@@ -510,35 +563,31 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 						current_language = PHP;
 					else
 						current_language = VBS_ASP_S;
-					current_line.line = current_line.line.substr(pos + 2);
+					cur += pos + 2;
 				}
 				break;
 			case WEB_CFM_START:
 				{
 					// check for <cfscript
 					found = false;
-					if (current_line.line.length() >= pos + 9)
+					if (current_line.line.length() - cur >= pos + 9)
 					{
-						tempstr = CUtil::ToLower(current_line.line);
-						if (tempstr.substr(pos, 9) == "<cfscript")
+						if (CUtil::MatchAt(current_line.line, cur + pos, "<cfscript", false))
 						{
 							found = true;
-							SeparatedLine[current_language].line += current_line.line.substr(0, pos);
-							close_pos = tempstr.find_first_of(">", pos + 9);
+							SeparatedLine[current_language].line.append(current_line.line, cur, pos);
+							close_pos = FindRest(current_line.line, cur, '>', pos + 9);
 							if (close_pos != string::npos)
 							{
-								SeparatedLine[COLDFUSION].line += current_line.line.substr(pos, close_pos - pos + 1);
-								if (close_pos < current_line.line.size())
-									current_line.line = current_line.line.substr(close_pos + 1);
-								else
-									current_line.line = "";
+								SeparatedLine[COLDFUSION].line.append(current_line.line, cur + pos, close_pos - pos + 1);
+								cur += close_pos + 1;
 								current_language = CFSCRIPT;
 							}
 							else
 							{
 								tag_open_mode = CFSCRIPT;
-								SeparatedLine[COLDFUSION].line += current_line.line.substr(pos);
-								current_line.line = "";
+								SeparatedLine[COLDFUSION].line.append(current_line.line, cur + pos, string::npos);
+								cur = current_line.line.length();
 								current_language = COLDFUSION;
 							}
 						}
@@ -546,28 +595,24 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 					if (!found)
 					{
 						// check for <cfquery
-						if (current_line.line.length() >= pos + 8)
+						if (current_line.line.length() - cur >= pos + 8)
 						{
-							tempstr = CUtil::ToLower(current_line.line);
-							if (tempstr.substr(pos, 8) == "<cfquery")
+							if (CUtil::MatchAt(current_line.line, cur + pos, "<cfquery", false))
 							{
 								found = true;
-								SeparatedLine[current_language].line += current_line.line.substr(0, pos);
-								close_pos = tempstr.find_first_of(">", pos + 8);
+								SeparatedLine[current_language].line.append(current_line.line, cur, pos);
+								close_pos = FindRest(current_line.line, cur, '>', pos + 8);
 								if (close_pos != string::npos)
 								{
-									SeparatedLine[COLDFUSION].line += current_line.line.substr(pos, close_pos - pos + 1);
-									if (close_pos < current_line.line.size())
-										current_line.line = current_line.line.substr(close_pos + 1);
-									else
-										current_line.line = "";
+									SeparatedLine[COLDFUSION].line.append(current_line.line, cur + pos, close_pos - pos + 1);
+									cur += close_pos + 1;
 									current_language = SQL_CFM;
 								}
 								else
 								{
 									tag_open_mode = SQL_CFM;
-									SeparatedLine[COLDFUSION].line += current_line.line.substr(pos);
-									current_line.line = "";
+									SeparatedLine[COLDFUSION].line.append(current_line.line, cur + pos, string::npos);
+									cur = current_line.line.length();
 									current_language = COLDFUSION;
 								}
 							}
@@ -575,20 +620,17 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 					}
 					if (!found)
 					{
-						SeparatedLine[current_language].line += current_line.line.substr(0, pos);
-						close_pos = current_line.line.find_first_of(">", pos + 3);
+						SeparatedLine[current_language].line.append(current_line.line, cur, pos);
+						close_pos = FindRest(current_line.line, cur, '>', pos + 3);
 						if (close_pos != string::npos)
 						{
-							SeparatedLine[COLDFUSION].line += current_line.line.substr(pos, close_pos - pos + 1);
-							if (close_pos < current_line.line.size())
-								current_line.line = current_line.line.substr(close_pos + 1);
-							else
-								current_line.line = "";
+							SeparatedLine[COLDFUSION].line.append(current_line.line, cur + pos, close_pos - pos + 1);
+							cur += close_pos + 1;
 						}
 						else
 						{
-							SeparatedLine[COLDFUSION].line += current_line.line.substr(pos);
-							current_line.line = "";
+							SeparatedLine[COLDFUSION].line.append(current_line.line, cur + pos, string::npos);
+							cur = current_line.line.length();
 						}
 						current_language = COLDFUSION;
 					}
@@ -597,13 +639,13 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 				break;
 			case WEB_CFM_END:
 				{
-					SeparatedLine[current_language].line += current_line.line.substr(0, pos);
-					close_pos = current_line.line.find_first_of(">", pos + 4);
-					SeparatedLine[COLDFUSION].line += current_line.line.substr(pos, close_pos - pos + 1);
-					if (close_pos < current_line.line.size())
-						current_line.line = current_line.line.substr(close_pos + 1);
+					SeparatedLine[current_language].line.append(current_line.line, cur, pos);
+					close_pos = FindRest(current_line.line, cur, '>', pos + 4);
+					SeparatedLine[COLDFUSION].line.append(current_line.line, cur + pos, close_pos - pos + 1);
+					if (close_pos < current_line.line.size() - cur)
+						cur += close_pos + 1;
 					else
-						current_line.line = "";
+						cur = current_line.line.length();
 					current_language = COLDFUSION;
 					cf_mode = current_language;
 				}
@@ -613,11 +655,11 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 					if (tag_open_mode >= 0)
 					{
 						// check for closure on open tag line
-						pos = current_line.line.find(">");
+						pos = FindRest(current_line.line, cur, '>', 0);
 						if (pos != string::npos)
 						{
-							SeparatedLine[current_language].line += current_line.line.substr(0, pos + 1);
-							current_line.line = current_line.line.substr(pos + 1);
+							SeparatedLine[current_language].line.append(current_line.line, cur, pos + 1);
+							cur += pos + 1;
 							current_language = tag_open_mode;
 							cf_mode = current_language;
 							tag_open_mode = -1;
@@ -626,20 +668,20 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 					else if (cf_mode == COLDFUSION)
 					{
 						// check for switch to HTML in ColdFusion
-						pos = current_line.line.find("<");
+						pos = FindRest(current_line.line, cur, '<', 0);
 						if (pos != string::npos)
 						{
-							SeparatedLine[current_language].line += current_line.line.substr(0, pos);
-							current_line.line = current_line.line.substr(pos);
+							SeparatedLine[current_language].line.append(current_line.line, cur, pos);
+							cur += pos;
 							current_language = HTML_CFM;
 							cf_mode = current_language;
 						}
 					}
-					if (current_line.line.length() > 0)
+					if (cur < current_line.line.length())
 					{
-						SeparatedLine[current_language].line += current_line.line;
+						SeparatedLine[current_language].line.append(current_line.line, cur, string::npos);
 						SeparatedLine[current_language].lineNumber = current_line.lineNumber;
-						current_line.line = "";
+						cur = current_line.line.length();
 					}
 				}
 				break;
@@ -647,15 +689,16 @@ int CWebCounter::CountSLOC(filemap* fmap, results* result)
 		}
 		
 		// write into Separation
+		// (the text of the lines is moved, current_line is read again and SeparatedLine is cleaned below)
 		if (blank_line)
-			Separation[current_language].first.push_back(current_line);
+			AppendLineElement(Separation[current_language].first, current_line.lineNumber, current_line.line);
 		else
 		{			
 			for (map<int, lineElement>::iterator i = SeparatedLine.begin(); i != SeparatedLine.end(); i++)
 			{
 				if (i->second.line.length() > 0)
 				{
-					Separation[i->first].first.push_back(i->second);
+					AppendLineElement(Separation[i->first].first, i->second.lineNumber, i->second.line);
 
 					// name the newly created file with its embedding file's filename.
 					// the filename is used in the matching function for the comparison purpose
@@ -69,11 +69,14 @@ public:
 protected:
 	void CleanSeparatedFile();
 	void CleanSeparatedLine();
+	size_t FindTag(const string &line, size_t start, size_t &pos, size_t preLang) const;
 
 	map<int, SourceFileElement> Separation;		//!< Separation file map
 	map<int, lineElement> SeparatedLine;		//!< Separated line
 	map<string, int> TagTable;					//!< Script language tags
 	map<string, int> ScriptTable;				//!< Supported script languages
+	keywordMatcher tagMatcher;					//!< Script tags of TagTable (in table order)
+	vector<int> tagIds;							//!< TagTable value of each tag in tagMatcher
 	stack<int> PreviousLanguage;				//!< Previous language stack
 
 	ofstream php_output_file;					//!< PHP output file stream
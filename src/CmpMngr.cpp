@@ -21,32 +21,74 @@
 * Refactored to improve performance
 */
 
-#include <stdlib.h>		// for calloc/realloc/free
-
 #include "CmpMngr.h"
+#include "CUtil.h"
 
 using namespace std;
 
+/*!
+* Constructs a CmpMngr object.
+*/
+CmpMngr::CmpMngr()
+{
+	nAddedLines = nDeletedLines = nChangedLines = nNochangedLines = 0;
+	nCandidates = nHistogramRejects = nBigramRejects = nLCSExits = 0;
+	MATCH_THRESHOLD = 0;
+	lcsWords = 0;
+	memset(lcsHist, 0, sizeof(lcsHist));
+	searchStamp = 0;
+	searchMinCommon = searchAbsent = 0;
+}
+
+/*!
+* Orders candidate lines by length.
+*/
+struct lineCandidateShorter
+{
+	bool operator() (const lineCandidate &a, const lineCandidate &b) const { return a.size < b.size; }
+	bool operator() (const lineCandidate &a, int size) const { return a.size < size; }
+	bool operator() (int size, const lineCandidate &b) const { return size < b.size; }
+};
+
 /*!
 * Calls routines to get the final count of the differences between two files.
 *
 * \param baseFileMap list of base files
 * \param compFileMap list of comparison files
 * \param match_threshold % threshold for matching, if greater then added/deleted instead of modified
+*
+* \return false if lines spilled to disk could not be read back (nothing is counted)
 */
-void CmpMngr::Compare(srcLineVector* baseFileMap, srcLineVector* compFileMap, double match_threshold)
+bool CmpMngr::Compare(srcLineVector* baseFileMap, srcLineVector* compFileMap, double match_threshold)
 {
 	MATCH_THRESHOLD = match_threshold;
+	SetCompareLine("");
 	nNochangedLines = nChangedLines = nAddedLines = nDeletedLines = 0;
 
+	// read back any lines spilled to disk (-maxmem)
+	if (!baseFileMap->page_in() || !compFileMap->page_in())
+		return false;
+
 	FindUnmodifiedLines(baseFileMap, compFileMap);
 	FindModifiedLines(baseFileMap, compFileMap);
 
 	// remaining lines are added or deleted, no further details needed to be searched.
 	for (srcLineVector::iterator i = baseFileMap->begin(); i != baseFileMap->end(); i++)
-		nDeletedLines += (*i).second;
+		nDeletedLines += (*i).count;
 	for (srcLineVector::iterator i = compFileMap->begin(); i != compFileMap->end(); i++)
-		nAddedLines += (*i).second;
+		nAddedLines += (*i).count;
+	return true;
+}
+
+/*!
+* Sets the counts of two files with the same logical lines without comparing them.
+*
+* \param nLines number of logical lines in each file
+*/
+void CmpMngr::CompareIdentical(unsigned int nLines)
+{
+	nNochangedLines = nLines;
+	nChangedLines = nAddedLines = nDeletedLines = 0;
 }
 
 /*!
@@ -59,9 +101,9 @@ void CmpMngr::FindModifiedLines(srcLineVector* aHm, srcLineVector* bHm)
 {
 	srcLineVector* listA;
 	srcLineVector* listB;
-	stringSizeMap mySSList;
-	int i, minSize, maxSize, maxSizeListA = 0;
-	bool deleted, deletedA;
+	vector<size_t> order;
+	size_t i, first, last, block, blockSize, found;
+	int minSize, maxSize, maxSizeListA;
 
 	if (aHm->size() == 0 || bHm->size() == 0)
 		return;
@@ -78,132 +120,85 @@ void CmpMngr::FindModifiedLines(srcLineVector* aHm, srcLineVector* bHm)
 		listB = bHm;
 	}
 
-	// Allocate 2 int arrays for SimilarLine to use
-	unsigned int	my_line_size = 0;
-	unsigned int	x_array_count = 256;
-	int * x1 = (int *)calloc( x_array_count, sizeof( int ) );
-	int * x2 = (int *)calloc( x_array_count, sizeof( int ) );
+	filters.clear();
+	filterChars.clear();
+	filterCounts.clear();
+	filterBigrams.clear();
+	candidates.clear();
 
-	if ( ( NULL == x1 ) || ( NULL == x2 ) )
-	{
-		// Unable to allocate memory to use
-		cout << endl << "ERROR: FindModifiedLines unable to Allocate memory.  Returning early...\n" << endl;
-		if ( NULL != x1 )
-			free( x1 );
-		if ( NULL != x2 )
-			free( x2 );
-		return;
-	}
+	// the lines are matched in ascending text order
+	srcLineVector::sortedView viewA, viewB;
+	listA->sorted(viewA);
+	listB->sorted(viewB);
 
-	// create a map of string size -> [iterators]
+	// sort the lines by size, the lines of a size in descending text order
 	// quickly access the locations of lines that are in valid size range of modified line for the given search line
-	for (srcLineVector::iterator myI = listA->begin(); myI != listA->end(); myI++)
+	for (srcLineVector::sortedView::reverse_iterator itA = viewA.rbegin(); itA != viewA.rend(); itA++)
 	{
-		pair<stringSizeMap::iterator, bool> myResult;
-
-		// populate with the number of copies of this string
-		stringList myList((*myI).second, (*myI).first);
-		myResult = mySSList.insert(make_pair((int)(*myI).first.size(), myList));
-		if (!myResult.second)
-		{
-			// already had a copy of something this size
-			(*myResult.first).second.insert((*myResult.first).second.begin(), myList.begin(), myList.end());	//append the list
-		}
-		if (maxSizeListA < (int)(*myI).first.size())
-			maxSizeListA = (int)(*myI).first.size();
+		srcLineVector::iterator myI = *itA;
+		candidates.push_back(lineCandidate(myI, (int)(*myI).line().size(), 0));
 	}
+	stable_sort(candidates.begin(), candidates.end(), lineCandidateShorter());
+
+	// filter data in the order of the search
+	for (i = 0; i < candidates.size(); i++)
+		candidates[i].filter = AddLineFilter((*candidates[i].line).line());
+	maxSizeListA = candidates.back().size;
+	BuildCandidateIndex();
 
 	// iterate through the longer list and searches for modified lines in the shorter list
-	// find the min and max size range for modified lines and only looks through those specific locations
-	// since the map is sorted, lookup using find is log(n) to get the iterator
-	//
-	// Reading find() code from std lib from Microsoft makes me think of a Linear search: avg is N/2.  Randy Maxwell
-	
-	// once an entry is found of a list of lines that have the same size in valid modified range, checks each to see if it is modified
-	for (srcLineVector::iterator myI = listB->begin(); myI != listB->end();)
+	// find the min and max size range for modified lines and only looks through the lines of those sizes
+	// that share enough chars with the line (see StartCandidateSearch)
+	for (srcLineVector::sortedView::iterator itB = viewB.begin(); itB != viewB.end(); itB++)
 	{
+		srcLineVector::iterator myI = *itB;
+
 		// find the valid size range (dictated by the MATCH_TRESHOLD)
-		minSize = (int)((*myI).first.length() * (MATCH_THRESHOLD / 100));
-		maxSize = MATCH_THRESHOLD != 0 ? (int)((*myI).first.length() / (MATCH_THRESHOLD / 100)) : maxSizeListA;
+		minSize = (int)((*myI).line().length() * (MATCH_THRESHOLD / 100));
+		maxSize = MATCH_THRESHOLD != 0 ? (int)((*myI).line().length() / (MATCH_THRESHOLD / 100)) : maxSizeListA;
 		if (maxSize > maxSizeListA)
 			maxSize = maxSizeListA;
+		if (minSize > maxSize)
+			continue;
+		first = lower_bound(candidates.begin(), candidates.end(), minSize, lineCandidateShorter()) - candidates.begin();
+		last = lower_bound(candidates.begin(), candidates.end(), maxSize + 1, lineCandidateShorter()) - candidates.begin();
+		if (first == last)
+			continue;
 
-		deleted = false;
-		deletedA = false;
-		for (i = minSize; i <= maxSize; i++)
+		SetCompareLine((*myI).line());
+		if (StartCandidateSearch(first, last))
 		{
-			// find the list of strings of this length
-			stringSizeMap::iterator mySSI = mySSList.find(i);
-			if (mySSI != mySSList.end())
+			// lines found with the index in growing blocks (in the order of the lines, a similar line may come early)
+			found = candidates.size();
+			for (block = first, blockSize = LCS_INDEX_BLOCK; block < last && found == candidates.size(); block += blockSize, blockSize *= 2)
 			{
-				// found some
-				for (stringList::iterator mySLI = (*mySSI).second.begin(); mySLI != (*mySSI).second.end(); )
-				{
-					// Make sure int arrays have enough elements to match the first arg
-					my_line_size = (*mySLI).size();
-					if ( my_line_size >= x_array_count -1 )
-					{
-						x_array_count = ( ( my_line_size / 16 ) * 16 ) + 32;
-						x1 = (int *)realloc( x1, x_array_count * sizeof( int ) );
-						x2 = (int *)realloc( x2, x_array_count * sizeof( int ) );
-						if ( ( NULL == x1 ) || ( NULL == x2 ) )
-						{
-							// Unable to increase memory to use
-							cout << endl << "ERROR: FindModifiedLines unable to Reallocate memory.  Returning early...\n" << endl;
-							if ( NULL != x1 )
-								free( x1 );
-							if ( NULL != x2 )
-								free( x2 );
-							return;
-						}
-						// memset or anything else will be done within SimilarLine
-					}
-					if ( SimilarLine((*mySLI), x1, (*myI).first, x2 ) )
-					{
-						string prev = (*mySLI);
-						srcLineVector::iterator listAi = listA->find((*mySLI));
-
-						// eliminates the need to call SimilarLine function on every entry if they are the same
-						while ((*myI).second > 0 && (mySLI != (*mySSI).second.end() && (*mySLI) == prev))
-						{
-							(*myI).second--;
-							(*listAi).second--;
-							stringList::iterator tmpSLI = mySLI++;
-							(*mySSI).second.erase(tmpSLI);
-							deletedA = true;
-							nChangedLines++;
-						}
-						if ((*myI).second == 0)
-						{
-							srcLineVector::iterator tmpI = myI++;
-							listB->erase(tmpI);
-							deleted = true;
-						}
-						if ((*listAi).second == 0)
-							listA->erase(listAi);
-						if (deleted || deletedA)
-							break;
-					}
-					else
-						mySLI++;
-				}
-				if (deleted || deletedA)
-					break;
+				GatherCandidates(min(block + blockSize, last), order);
+				found = FindSimilarLine(&order, 0, 0, (*myI).line());
 			}
 		}
-		if (!deleted)
-			myI++;
-	}
+		else
+			found = FindSimilarLine(NULL, first, last, (*myI).line());
+		if (found == candidates.size())
+			continue;
 
-	free( x1 );
-	free( x2 );
+		// all the copies of the lines match up to the smaller count
+		srcLineVector::iterator listAi = candidates[found].line;
+		while ((*myI).count > 0 && (*listAi).count > 0)
+		{
+			(*myI).count--;
+			(*listAi).count--;
+			nChangedLines++;
+		}
+		if ((*myI).count == 0)
+			listB->erase(myI);
+		if ((*listAi).count == 0)
+			listA->erase(listAi);
+	}
 }
 
 /*!
-* Performs a binary search to find unmodified lines, relies on fact that they are in
-* STL hash (srcLineVector) so they are already sorted and the find function is log(n) ? ? ?
-*
-* Reading find() code from std lib from Microsoft makes me think of a Linear search: avg is N/2.  Randy Maxwell
+* Finds unmodified lines by looking up the interned ID of each line of the smaller list
+* in the hash multiset (srcLineVector) of the other list (an integer set intersection).
 *
 * \param aHm list of base files
 * \param bHm list of comparison files
@@ -226,22 +221,22 @@ void CmpMngr::FindUnmodifiedLines(srcLineVector* aHm, srcLineVector* bHm)
 	{
 		bool deleted = false;
 		srcLineVector::iterator result;
-		result = listB->find((*myI).first);
+		result = listB->find((*myI).id);
 		if (result != listB->end())
 		{
-			while ((*myI).second > 0 && (*result).second > 0)
+			while ((*myI).count > 0 && (*result).count > 0)
 			{
-				(*myI).second--;
-				(*result).second--;
+				(*myI).count--;
+				(*result).count--;
 				nNochangedLines++;
 			}
-			if ((*myI).second == 0)
+			if ((*myI).count == 0)
 			{
 				srcLineVector::iterator tmpI = myI++;
 				listA->erase(tmpI);
 				deleted = true;
 			}
-			if ((*result).second == 0)
+			if ((*result).count == 0)
 				listB->erase(result);
 		}
 		if (!deleted)
@@ -249,6 +244,160 @@ void CmpMngr::FindUnmodifiedLines(srcLineVector* aHm, srcLineVector* bHm)
 	}
 }
 
+/*!
+* Returns the number of set bits of a word.
+*
+* \param word bit vector
+*
+* \return number of set bits
+*/
+static inline unsigned int PopCount(lcsWord word)
+{
+#if defined(__GNUC__)
+	return (unsigned int)__builtin_popcountll(word);
+#else
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (unsigned int)((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/*!
+* Returns the LCS length of a bit-parallel LCS row (its zero bits over the n chars).
+*
+* \param row LCS row
+* \param n length of the comparison line
+*
+* \return LCS length
+*/
+static inline int LCSLength(const vector<lcsWord> &row, int n)
+{
+	int ones = 0;
+	size_t k, words = row.size();
+	lcsWord word;
+
+	for (k = 0; k < words; k++)
+	{
+		word = row[k];
+		if (k == words - 1 && n % LCS_WORD_BITS != 0)
+			word &= ((lcsWord)1 << (n % LCS_WORD_BITS)) - 1;
+		ones += (int)PopCount(word);
+	}
+	return n - ones;
+}
+
+/*!
+* Returns the bigram of a line at a position (two chars in a 16 bit code).
+*
+* \param line line
+* \param pos position of the first char
+*
+* \return bigram code
+*/
+static inline unsigned short Bigram(const string &line, size_t pos)
+{
+	return (unsigned short)(((unsigned char)line[pos] << 8) | (unsigned char)line[pos + 1]);
+}
+
+/*!
+* Caches the char histogram and the sorted bigrams of a line of the shorter list.
+*
+* \param line logical line
+*
+* \return index of the filter data of the line
+*/
+size_t CmpMngr::AddLineFilter( const string &line )
+{
+	lineFilter filter;
+	unsigned int counts[256];
+	size_t i;
+	unsigned char c;
+
+	memset(counts, 0, sizeof(counts));
+	for (i = 0; i < line.size(); i++)
+		counts[(unsigned char)line[i]]++;
+
+	// distinct chars in line order (a count is cleared once stored)
+	filter.histStart = filterChars.size();
+	for (i = 0; i < line.size(); i++)
+	{
+		c = (unsigned char)line[i];
+		if (counts[c] != 0)
+		{
+			filterChars.push_back(c);
+			filterCounts.push_back(counts[c]);
+			counts[c] = 0;
+		}
+	}
+	filter.histSize = filterChars.size() - filter.histStart;
+
+	filter.bigramStart = filterBigrams.size();
+	for (i = 0; i + 1 < line.size(); i++)
+		filterBigrams.push_back(Bigram(line, i));
+	filter.bigramSize = filterBigrams.size() - filter.bigramStart;
+	sort(filterBigrams.begin() + filter.bigramStart, filterBigrams.end());
+
+	filters.push_back(filter);
+	return filters.size() - 1;
+}
+
+/*!
+* Builds the LCS match masks of a comparison line (bit i of the mask of a char is set
+* if the char is at position i of the line), its char histogram and its sorted bigrams
+* for the following calls to SimilarLine.
+*
+* \param compareLine comparison line
+*/
+void CmpMngr::SetCompareLine( const string &compareLine )
+{
+	size_t i, words = (compareLine.size() + LCS_WORD_BITS - 1) / LCS_WORD_BITS;
+
+	if (words != lcsWords)
+	{
+		lcsWords = words;
+		lcsMatch.assign(256 * words, 0);
+	}
+	else
+	{
+		// only the masks of the chars of the previous line are set
+		for (i = 0; i < lcsCompareLine.size(); i++)
+			fill_n(lcsMatch.begin() + (unsigned char)lcsCompareLine[i] * words, words, (lcsWord)0);
+	}
+	for (i = 0; i < lcsCompareLine.size(); i++)
+		lcsHist[(unsigned char)lcsCompareLine[i]] = 0;
+
+	for (i = 0; i < compareLine.size(); i++)
+	{
+		lcsMatch[(unsigned char)compareLine[i] * words + i / LCS_WORD_BITS] |= (lcsWord)1 << (i % LCS_WORD_BITS);
+		lcsHist[(unsigned char)compareLine[i]]++;
+	}
+	lcsBigrams.clear();
+	for (i = 0; i + 1 < compareLine.size(); i++)
+		lcsBigrams.push_back(Bigram(compareLine, i));
+	sort(lcsBigrams.begin(), lcsBigrams.end());
+
+	lcsCompareLine = compareLine;
+	lcsRow.resize(words);
+}
+
+/*!
+* Checks whether an LCS length makes two lines similar (see SimilarLine).
+* The check only gets harder for a shorter LCS, so an upper bound of the LCS
+* that does not meet it rejects the lines.
+*
+* \param LCSlen length of the LCS
+* \param m length of the base line
+* \param n length of the comparison line
+*
+* \return does the LCS meet MATCH_THRESHOLD?
+*/
+bool CmpMngr::MeetsThreshold( double LCSlen, int m, int n ) const
+{
+	return ((LCSlen / (double)m * 100 >= MATCH_THRESHOLD) &&
+		(LCSlen / (double)n * 100 >= MATCH_THRESHOLD));
+}
+
 /*!
 * Determines whether two lines are similar.
 * Originally written by J. Kim 10/09/2006
@@ -273,60 +422,623 @@ void CmpMngr::FindUnmodifiedLines(srcLineVector* aHm, srcLineVector* bHm)
 * and get 1 MODIFIED 
 * instead of getting 1 ADDED + 1 DELETED
 *
-* \Precondition		x1 and x2 are large enough: >= (baseLine size + 1) * sizeof(int)
+* \Precondition		SetCompareLine(compareLine) was called
 *
 * \param baseLine base line
-* \param int array x1 passed to use here	(reduces memory alloc/free calls)
+* \param baseFilter filter data of the base line (see AddLineFilter)
 * \param compareLine comparison line
-* \param int array x2 passed to use here	(reduces memory alloc/free calls)
 *
 * \return whether two lines are similar
 */
-bool CmpMngr::SimilarLine( const string &baseLine, int *x1, const string &compareLine, int *x2 )
+bool CmpMngr::SimilarLine( const string &baseLine, const lineFilter &baseFilter, const string &compareLine )
 {
-	bool	retVal = false;
-	int		m, n, i, j;			// k;
-	double	LCSlen;
-	char	cmp_j = 0;
+	return (PassesFilters(baseLine, baseFilter, compareLine) && SimilarLCS(baseLine, compareLine));
+}
+
+/*!
+* Checks the upper bounds of the LCS length of two lines against MATCH_THRESHOLD:
+* - the char histogram intersection (each LCS char is a common char)
+* - (common bigrams + m + n + 1) / 3: for an LCS of length L, at most 2 * (m - L) bigrams
+*   of baseLine have an unmatched char and at most n - L of the others are split
+*   by an unmatched char of compareLine, so at least 3 * L - m - n - 1 bigrams are common
+*
+* \Precondition		SetCompareLine(compareLine) was called
+*
+* \param baseLine base line
+* \param baseFilter filter data of the base line (see AddLineFilter)
+* \param compareLine comparison line
+*
+* \return may the lines be similar?
+*/
+bool CmpMngr::PassesFilters( const string &baseLine, const lineFilter &baseFilter, const string &compareLine )
+{
+	int		m, n;
+	size_t	i;
+	unsigned int	common;
 
 	m = (int)baseLine.size();
 	n = (int)compareLine.size();
+	nCandidates++;
 
-	memset( x1, 0, (m + 1) * sizeof( int ) );
-	memset( x2, 0, (m + 1) * sizeof( int ) );
+	// common chars
+	common = 0;
+	for (i = baseFilter.histStart; i < baseFilter.histStart + baseFilter.histSize; i++)
+		common += min(filterCounts[i], lcsHist[filterChars[i]]);
+	if (!MeetsThreshold((double)common, m, n))
+	{
+		nHistogramRejects++;
+		return false;
+	}
+
+	// common bigrams (only if even no common bigram could reject the lines)
+	if (!MeetsThreshold((double)((m + n + 1) / 3), m, n))
+	{
+		const unsigned short *a = baseFilter.bigramSize ? &filterBigrams[baseFilter.bigramStart] : NULL;
+		const unsigned short *aEnd = a + baseFilter.bigramSize;
+		const unsigned short *b = lcsBigrams.empty() ? NULL : &lcsBigrams[0];
+		const unsigned short *bEnd = b + lcsBigrams.size();
+		common = 0;
+		while (a < aEnd && b < bEnd)
+		{
+			if (*a < *b)
+				a++;
+			else if (*b < *a)
+				b++;
+			else
+			{
+				common++;
+				a++;
+				b++;
+			}
+		}
+		if (!MeetsThreshold((double)((common + m + n + 1) / 3), m, n))
+		{
+			nBigramRejects++;
+			return false;
+		}
+	}
+	return true;
+}
+
+/*!
+* Checks whether the LCS of two lines meets MATCH_THRESHOLD.
+* The LCS length is computed bit-parallel (Allison-Dix, Hyyro): each row of the
+* LCS table is a bit vector over the chars of compareLine, updated one word at a time
+* for each char of baseLine. The zero bits of the last row count the LCS length.
+* The LCS stops early once its length so far plus the remaining chars of baseLine
+* cannot meet the threshold.
+*
+* \Precondition		SetCompareLine(compareLine) was called
+*
+* \param baseLine base line
+* \param compareLine comparison line
+*
+* \return whether two lines are similar
+*/
+bool CmpMngr::SimilarLCS( const string &baseLine, const string &compareLine )
+{
+	int		m, n;
+	size_t	i, k, words = lcsWords;
+	lcsWord	row, match, sum, carry, carryOut, ones;
+	const lcsWord *matchRow;
+
+	m = (int)baseLine.size();
+	n = (int)compareLine.size();
 
 	// compute length of LCS
-	// - no need to use CBitMatrix
-	for (j = n - 1; j >= 0; j--)
+	// row' = (row + (row & match)) | (row & ~match), a 0 bit for each LCS char
+	if (words == 1)
+	{
+		row = ~(lcsWord)0;
+		for (i = 0; i < baseLine.size(); i++)
+		{
+			match = row & lcsMatch[(unsigned char)baseLine[i]];
+			row = (row + match) | (row - match);
+			if ((i + 1) % LCS_CHECK_CHARS == 0 && i + 1 < baseLine.size())
+			{
+				// LCS so far and the remaining chars of the base line
+				ones = PopCount(n % LCS_WORD_BITS ? row & (((lcsWord)1 << n) - 1) : row);
+				if (!MeetsThreshold((double)(n - (int)ones + (m - (int)i - 1)), m, n))
+				{
+					nLCSExits++;
+					return false;
+				}
+			}
+		}
+		lcsRow[0] = row;
+	}
+	else if (words > 1)
+	{
+		fill(lcsRow.begin(), lcsRow.end(), ~(lcsWord)0);
+		for (i = 0; i < baseLine.size(); i++)
+		{
+			// add with the carry across the words of the row
+			matchRow = &lcsMatch[(unsigned char)baseLine[i] * words];
+			carry = 0;
+			for (k = 0; k < words; k++)
+			{
+				row = lcsRow[k];
+				match = row & matchRow[k];
+				sum = row + match;
+				carryOut = (sum < row) ? 1 : 0;
+				sum += carry;
+				if (sum < carry)
+					carryOut = 1;
+				carry = carryOut;
+				lcsRow[k] = sum | (row - match);
+			}
+			if ((i + 1) % LCS_CHECK_CHARS == 0 && i + 1 < baseLine.size() &&
+				!MeetsThreshold((double)(LCSLength(lcsRow, n) + (m - (int)i - 1)), m, n))
+			{
+				nLCSExits++;
+				return false;
+			}
+		}
+	}
+
+	return MeetsThreshold((double)(words ? LCSLength(lcsRow, n) : 0), m, n);
+}
+
+#ifndef UCC_SSE2
+/*!
+* Advances the one word LCS rows of a batch of base lines over their chars [from, to).
+*
+* \param match match masks of the comparison line (one word for each char value)
+* \param lines chars of the LCS_BATCH_LINES base lines
+* \param from index of the first char
+* \param to index after the last char
+* \param rows LCS rows of the base lines
+*/
+static void AdvanceLCSRows(const lcsWord *match, const unsigned char * const *lines, size_t from, size_t to, lcsWord *rows)
+{
+	size_t i, j;
+	lcsWord m;
+	for (i = from; i < to; i++)
+	{
+		for (j = 0; j < LCS_BATCH_LINES; j++)
+		{
+			m = rows[j] & match[lines[j][i]];
+			rows[j] = (rows[j] + m) | (rows[j] - m);
+		}
+	}
+}
+#endif
+
+#ifdef UCC_SSE2
+/*!
+* Advances the one word LCS rows of a batch of base lines with 2 rows in each SSE2 register.
+*
+* \param match match masks of the comparison line (one word for each char value)
+* \param lines chars of the LCS_BATCH_LINES base lines
+* \param from index of the first char
+* \param to index after the last char
+* \param rows LCS rows of the base lines
+*/
+static void AdvanceLCSRowsSSE2(const lcsWord *match, const unsigned char * const *lines, size_t from, size_t to, lcsWord *rows)
+{
+	__m128i r[LCS_BATCH_LINES / 2], m;
+	lcsWord masks[LCS_BATCH_LINES];
+	size_t i, j;
+
+	for (j = 0; j < LCS_BATCH_LINES / 2; j++)
+		r[j] = _mm_loadu_si128((const __m128i *)(rows + 2 * j));
+	for (i = from; i < to; i++)
+	{
+		for (j = 0; j < LCS_BATCH_LINES; j++)
+			masks[j] = match[lines[j][i]];
+		for (j = 0; j < LCS_BATCH_LINES / 2; j++)
+		{
+			m = _mm_and_si128(r[j], _mm_loadu_si128((const __m128i *)(masks + 2 * j)));
+			r[j] = _mm_or_si128(_mm_add_epi64(r[j], m), _mm_sub_epi64(r[j], m));
+		}
+	}
+	for (j = 0; j < LCS_BATCH_LINES / 2; j++)
+		_mm_storeu_si128((__m128i *)(rows + 2 * j), r[j]);
+}
+#endif
+
+#ifdef UCC_AVX2
+/*!
+* Advances the one word LCS rows of a batch of base lines with 4 rows in each AVX2 register.
+* Only called when the processor supports AVX2.
+*
+* \param match match masks of the comparison line (one word for each char value)
+* \param lines chars of the LCS_BATCH_LINES base lines
+* \param from index of the first char
+* \param to index after the last char
+* \param rows LCS rows of the base lines
+*/
+__attribute__((target("avx2")))
+static void AdvanceLCSRowsAVX2(const lcsWord *match, const unsigned char * const *lines, size_t from, size_t to, lcsWord *rows)
+{
+	__m256i r[LCS_BATCH_LINES / 4], m;
+	lcsWord masks[LCS_BATCH_LINES];
+	size_t i, j;
+
+	for (j = 0; j < LCS_BATCH_LINES / 4; j++)
+		r[j] = _mm256_loadu_si256((const __m256i *)(rows + 4 * j));
+	for (i = from; i < to; i++)
+	{
+		for (j = 0; j < LCS_BATCH_LINES; j++)
+			masks[j] = match[lines[j][i]];
+		for (j = 0; j < LCS_BATCH_LINES / 4; j++)
+		{
+			m = _mm256_and_si256(r[j], _mm256_loadu_si256((const __m256i *)(masks + 4 * j)));
+			r[j] = _mm256_or_si256(_mm256_add_epi64(r[j], m), _mm256_sub_epi64(r[j], m));
+		}
+	}
+	for (j = 0; j < LCS_BATCH_LINES / 4; j++)
+		_mm256_storeu_si256((__m256i *)(rows + 4 * j), r[j]);
+}
+#endif
+
+/*!
+* Checks whether the LCS of each of a batch of base lines of the same length and a
+* comparison line of at most LCS_WORD_BITS chars meets MATCH_THRESHOLD (see SimilarLCS).
+* The rows of the lines are advanced together, one vector lane for each line.
+*
+* \Precondition		SetCompareLine(compareLine) was called
+*
+* \param baseLines base lines (all of the same length)
+* \param count number of base lines (at most LCS_BATCH_LINES)
+* \param compareLine comparison line
+* \param similar whether each base line is similar
+*/
+void CmpMngr::SimilarLCSBatch( const string **baseLines, size_t count, const string &compareLine, bool *similar )
+{
+	const unsigned char *lines[LCS_BATCH_LINES];
+	lcsWord rows[LCS_BATCH_LINES];
+	lcsWord mask;
+	int m, n;
+	size_t i, j, next;
+	bool useAVX2 = CUtil::HasAVX2();
+
+	m = (int)baseLines[0]->size();
+	n = (int)compareLine.size();
+	mask = (n % LCS_WORD_BITS != 0) ? ((lcsWord)1 << n) - 1 : ~(lcsWord)0;
+
+	// unused lanes repeat the first line
+	for (j = 0; j < LCS_BATCH_LINES; j++)
 	{
-		memcpy( x2, x1, ( m + 1 ) * sizeof( int ) );
-		memset( x1,  0, ( m + 1 ) * sizeof( int ) );
+		lines[j] = (const unsigned char *)baseLines[j < count ? j : 0]->data();
+		rows[j] = ~(lcsWord)0;
+	}
 
-		cmp_j = compareLine[ j ];		// Keep invariant expressions out of loops
+	for (i = 0; i < (size_t)m; i = next)
+	{
+		next = min(i + LCS_CHECK_CHARS, (size_t)m);
+#ifdef UCC_AVX2
+		if (useAVX2)
+			AdvanceLCSRowsAVX2(&lcsMatch[0], lines, i, next, rows);
+		else
+#endif
+#ifdef UCC_SSE2
+			AdvanceLCSRowsSSE2(&lcsMatch[0], lines, i, next, rows);
+#else
+			AdvanceLCSRows(&lcsMatch[0], lines, i, next, rows);
+#endif
+		if (next < (size_t)m)
+		{
+			// stop once no line can meet the threshold (LCS so far and the remaining chars)
+			for (j = 0; j < count; j++)
+			{
+				if (MeetsThreshold((double)(n - (int)PopCount(rows[j] & mask) + (m - (int)next)), m, n))
+					break;
+			}
+			if (j == count)
+			{
+				nLCSExits += count;
+				for (j = 0; j < count; j++)
+					similar[j] = false;
+				return;
+			}
+		}
+	}
+	for (j = 0; j < count; j++)
+		similar[j] = MeetsThreshold((double)(n - (int)PopCount(rows[j] & mask)), m, n);
+}
+
+/*!
+* Finds the first candidate line that is similar to a comparison line.
+* When the comparison line fits one LCS word, the lines of the same length that pass
+* the filters are compared in batches (see SimilarLCSBatch), otherwise one at a time.
+*
+* \Precondition		SetCompareLine(compareLine) was called
+*
+* \param order candidate lines in ascending order (or NULL for all the lines of the range)
+* \param first first candidate of the range
+* \param last end of the range
+* \param compareLine comparison line
+*
+* \return index of the first similar line (or candidates.size() if none)
+*/
+size_t CmpMngr::FindSimilarLine( const vector<size_t> *order, size_t first, size_t last, const string &compareLine )
+{
+	size_t batch[LCS_BATCH_LINES];
+	const string *batchLines[LCS_BATCH_LINES];
+	bool similar[LCS_BATCH_LINES];
+	size_t count, pos, end, idx, j;
+	int batchSize;
 
-		for ( i = m - 1; i >= 0; i-- )
+	pos = 0;
+	end = (order != NULL) ? order->size() : last - first;
+	while (pos < end)
+	{
+		count = 0;
+		batchSize = candidates[(order != NULL) ? (*order)[pos] : first + pos].size;
+		for (; pos < end && count < LCS_BATCH_LINES; pos++)
 		{
-			if ( baseLine[i] == cmp_j )
+			idx = (order != NULL) ? (*order)[pos] : first + pos;
+			const lineCandidate &candidate = candidates[idx];
+			if (candidate.size != batchSize)
+				break;
+			if ((*candidate.line).count == 0)
+				continue;
+			const string &baseLine = candidate.line->line();
+			if (!PassesFilters(baseLine, filters[candidate.filter], compareLine))
+				continue;
+			if (lcsWords != 1)
 			{
-				x1[i] = 1 + x2[i+1];
+				if (SimilarLCS(baseLine, compareLine))
+					return idx;
 			}
 			else
 			{
-				if (x1[i+1] > x2[i])
-				{
-					x1[i] = x1[i+1];
-				}
-				else
-				{
-					x1[i] = x2[i];
-				}
+				batch[count] = idx;
+				batchLines[count] = &baseLine;
+				count++;
+			}
+		}
+
+		if (count == 1)
+		{
+			if (SimilarLCS(*batchLines[0], compareLine))
+				return batch[0];
+		}
+		else if (count > 1)
+		{
+			SimilarLCSBatch(batchLines, count, compareLine, similar);
+			for (j = 0; j < count; j++)
+			{
+				if (similar[j])
+					return batch[j];
 			}
 		}
 	}
-	LCSlen = x1[0];
-	if ((LCSlen / (double)m * 100 >= MATCH_THRESHOLD) &&
-		(LCSlen / (double)n * 100 >= MATCH_THRESHOLD))
-		retVal = true;
+	return candidates.size();
+}
 
-	return retVal;
+/*!
+* Returns the fewest common chars of two lines of a length that may meet MATCH_THRESHOLD
+* (each LCS char is a common char, see MeetsThreshold).
+*
+* \param len length of a line
+*
+* \return fewest common chars
+*/
+int CmpMngr::MinCommonChars( int len ) const
+{
+	int common = (int)(len * (MATCH_THRESHOLD / 100));
+
+	// adjust for the rounding of the threshold check
+	while (common > 0 && MeetsThreshold((double)(common - 1), len, len))
+		common--;
+	while (!MeetsThreshold((double)common, len, len))
+		common++;
+	return common;
+}
+
+/*!
+* Builds the inverted index of the candidate lines.
+* The chars of a line are tokens (the k-th occurrence of a char is token k of the char), so the
+* common chars of two lines are their common tokens. Ordering the tokens of each line from the
+* rarest (in the candidate lines) to the most frequent, two lines with T common tokens share a
+* token among the first (length - T + 1) tokens of each line (the rarest common token). Only these
+* prefix tokens of a line are indexed, with T = MinCommonChars(length), and with their position
+* since the common tokens after a position are at most the tokens left after it in either line.
+* Nothing is indexed without a threshold since any two lines are similar then.
+*/
+void CmpMngr::BuildCandidateIndex()
+{
+	vector<unsigned long long> keys;
+	vector<unsigned int> prefixTokens, nextPosting;
+	vector<size_t> prefixStart;
+	size_t idx, i, token, pos;
+	unsigned int k, c;
+	int prefix;
+
+	tokenBase.assign(257, 0);
+	tokenFreq.clear();
+	postingStart.clear();
+	postings.clear();
+	postingPos.clear();
+	candMinCommon.clear();
+	candStamp.assign(candidates.size(), 0);
+	candCommon.assign(candidates.size(), 0);
+	searchStamp = 0;
+	if (MATCH_THRESHOLD <= 0)
+		return;
+
+	// tokens of each char (up to its largest count in a line)
+	for (idx = 0; idx < candidates.size(); idx++)
+	{
+		const lineFilter &filter = filters[candidates[idx].filter];
+		for (i = filter.histStart; i < filter.histStart + filter.histSize; i++)
+		{
+			c = filterChars[i];
+			if (tokenBase[c + 1] < filterCounts[i])
+				tokenBase[c + 1] = filterCounts[i];
+		}
+	}
+	for (c = 0; c < 256; c++)
+		tokenBase[c + 1] += tokenBase[c];
+	tokenFreq.assign(tokenBase[256], 0);
+	for (idx = 0; idx < candidates.size(); idx++)
+	{
+		const lineFilter &filter = filters[candidates[idx].filter];
+		for (i = filter.histStart; i < filter.histStart + filter.histSize; i++)
+		{
+			for (k = 0; k < filterCounts[i]; k++)
+				tokenFreq[tokenBase[filterChars[i]] + k]++;
+		}
+	}
+
+	// prefix tokens of each line (rarest first)
+	postingStart.assign(tokenBase[256] + 1, 0);
+	prefixStart.push_back(0);
+	for (idx = 0; idx < candidates.size(); idx++)
+	{
+		const lineFilter &filter = filters[candidates[idx].filter];
+		keys.clear();
+		for (i = filter.histStart; i < filter.histStart + filter.histSize; i++)
+		{
+			for (k = 0; k < filterCounts[i]; k++)
+			{
+				token = tokenBase[filterChars[i]] + k;
+				keys.push_back(((unsigned long long)tokenFreq[token] << 32) | token);
+			}
+		}
+		candMinCommon.push_back(MinCommonChars(candidates[idx].size));
+		prefix = candidates[idx].size - candMinCommon.back() + 1;
+		if (prefix > (int)keys.size())
+			prefix = (int)keys.size();
+		if (prefix > 0)
+		{
+			partial_sort(keys.begin(), keys.begin() + prefix, keys.end());
+			for (i = 0; i < (size_t)prefix; i++)
+			{
+				token = (size_t)(keys[i] & 0xFFFFFFFFULL);
+				prefixTokens.push_back((unsigned int)token);
+				postingStart[token + 1]++;
+			}
+		}
+		prefixStart.push_back(prefixTokens.size());
+	}
+
+	// postings of each token by line index
+	for (token = 0; token < tokenBase[256]; token++)
+		postingStart[token + 1] += postingStart[token];
+	postings.resize(prefixTokens.size());
+	postingPos.resize(prefixTokens.size());
+	nextPosting.assign(postingStart.begin(), postingStart.end() - 1);
+	for (idx = 0; idx < candidates.size(); idx++)
+	{
+		for (i = prefixStart[idx]; i < prefixStart[idx + 1]; i++)
+		{
+			pos = nextPosting[prefixTokens[i]]++;
+			postings[pos] = (unsigned int)idx;
+			postingPos[pos] = (unsigned int)(i - prefixStart[idx]);
+		}
+	}
+}
+
+/*!
+* Starts a search of the index for the candidate lines in a range of lengths that may be similar to
+* the compare line. These are the lines with a prefix token in the prefix tokens of the compare line
+* (see BuildCandidateIndex) that may still share enough tokens after each common prefix token.
+*
+* \Precondition		SetCompareLine(compareLine) was called
+*
+* \param first first candidate of the range
+* \param last end of the range
+*
+* \return use the index? (false if there is no index or its postings are not much shorter than the range)
+*/
+bool CmpMngr::StartCandidateSearch( size_t first, size_t last )
+{
+	size_t idx, i, total, absent, postFirst, postLast;
+	unsigned int k, c, chars;
+	int n, prefix;
+
+	if (postingStart.empty())
+		return false;
+
+	// tokens of the compare line, the ones no candidate has come first
+	searchTokens.clear();
+	absent = 0;
+	for (c = 0; c < 256; c++)
+	{
+		chars = tokenBase[c + 1] - tokenBase[c];
+		for (k = 0; k < lcsHist[c]; k++)
+		{
+			if (k < chars)
+				searchTokens.push_back(((unsigned long long)tokenFreq[tokenBase[c] + k] << 32) | (tokenBase[c] + k));
+			else
+				absent++;
+		}
+	}
+	n = (int)lcsCompareLine.size();
+	searchMinCommon = MinCommonChars(n);
+	searchAbsent = (int)absent;
+	searchRanges.clear();
+	searchStamp++;
+	prefix = n - searchMinCommon + 1 - searchAbsent;
+	if (prefix <= 0)
+		return true;
+	if (prefix > (int)searchTokens.size())
+		prefix = (int)searchTokens.size();
+	partial_sort(searchTokens.begin(), searchTokens.begin() + prefix, searchTokens.end());
+
+	// postings in the range
+	total = 0;
+	for (i = 0; i < (size_t)prefix; i++)
+	{
+		idx = (size_t)(searchTokens[i] & 0xFFFFFFFFULL);
+		postFirst = lower_bound(postings.begin() + postingStart[idx], postings.begin() + postingStart[idx + 1], (unsigned int)first) - postings.begin();
+		postLast = lower_bound(postings.begin() + postFirst, postings.begin() + postingStart[idx + 1], (unsigned int)last) - postings.begin();
+		searchRanges.push_back(make_pair(postFirst, postLast));
+		total += postLast - postFirst;
+	}
+	return (total < (last - first) * LCS_INDEX_SCAN_RATIO);
+}
+
+/*!
+* Gathers the next unmatched candidate lines found by the search of the index, in ascending order.
+*
+* \Precondition		StartCandidateSearch() returned true
+*
+* \param last end of the candidates to gather (the gathered lines are before it)
+* \param order candidate lines (indexes of candidates)
+*/
+void CmpMngr::GatherCandidates( size_t last, vector<size_t> &order )
+{
+	size_t idx, i, p, end;
+	int n, left;
+
+	order.clear();
+	n = (int)lcsCompareLine.size();
+
+	// count the common prefix tokens (in the order of the compare line tokens)
+	for (i = 0; i < searchRanges.size(); i++)
+	{
+		end = searchRanges[i].second;
+		for (p = searchRanges[i].first; p < end && postings[p] < last; p++)
+		{
+			idx = postings[p];
+			if (candStamp[idx] != searchStamp)
+			{
+				candStamp[idx] = searchStamp;
+				candCommon[idx] = 0;
+				order.push_back(idx);
+			}
+			else if (candCommon[idx] < 0)
+				continue;
+			candCommon[idx]++;
+
+			// tokens left after this one
+			left = min(candidates[idx].size - (int)postingPos[p], n - (searchAbsent + (int)i)) - 1;
+			if (candCommon[idx] + left < max(searchMinCommon, candMinCommon[idx]))
+				candCommon[idx] = -1;
+		}
+		searchRanges[i].first = p;
+	}
+
+	// unmatched lines in ascending order
+	for (i = 0, p = 0; i < order.size(); i++)
+	{
+		if (candCommon[order[i]] >= 0 && (*candidates[order[i]].line).count > 0)
+			order[p++] = order[i];
+	}
+	order.resize(p);
+	sort(order.begin(), order.end());
 }
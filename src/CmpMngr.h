@@ -16,6 +16,49 @@
 
 using namespace std;
 
+//! Machine word of the bit-parallel LCS (one bit for each char of the compare line).
+/*!
+* \typedef lcsWord
+*
+* Defines the word of the bit-parallel LCS rows and match masks.
+*/
+typedef unsigned long long lcsWord;
+
+#define LCS_WORD_BITS	64		//!< Bits in an lcsWord
+#define LCS_CHECK_CHARS	16		//!< Base line chars between the early exit checks of the LCS
+#define LCS_BATCH_LINES	8		//!< Base lines of one length compared together by the batched LCS
+#define LCS_INDEX_SCAN_RATIO	2	//!< Postings for each line of a length range above which the range is scanned instead
+#define LCS_INDEX_BLOCK		32		//!< Lines gathered from the index at first (the blocks double)
+
+//! Cached data of a line for the LCS upper bounds (see CmpMngr::SimilarLine).
+/*!
+* \struct lineFilter
+*
+* Defines the char histogram and the sorted bigrams of a line, stored in the pools of the compare manager.
+*/
+struct lineFilter
+{
+	size_t histStart;			//!< First distinct char of the line in filterChars and filterCounts
+	size_t histSize;			//!< Number of distinct chars of the line
+	size_t bigramStart;			//!< First bigram of the line in filterBigrams
+	size_t bigramSize;			//!< Number of bigrams of the line
+};
+
+//! Logical line of the shorter list that may be a modified line.
+/*!
+* \struct lineCandidate
+*
+* Defines a logical line, its length and the index of its filter data.
+*/
+struct lineCandidate
+{
+	lineCandidate(srcLineVector::iterator lineIter, int lineSize, size_t filterIdx) : line(lineIter), size(lineSize), filter(filterIdx) {}
+
+	srcLineVector::iterator line;	//!< Logical line (its count is the number of unmatched copies)
+	int size;						//!< Length of the line
+	size_t filter;					//!< Index of the filter data of the line (see CmpMngr::filters)
+};
+
 //! Compare manager class.
 /*!
 * \class CmpMngr
@@ -25,35 +68,67 @@ using namespace std;
 class CmpMngr
 {
 public:
-	void Compare(srcLineVector* baseFileMap, srcLineVector* compFileMap, double match_threshold);
+	CmpMngr();
+	bool Compare(srcLineVector* baseFileMap, srcLineVector* compFileMap, double match_threshold);
+	void CompareIdentical(unsigned int nLines);
 
 	unsigned int nAddedLines;		//!< Number of lines added
 	unsigned int nDeletedLines;		//!< Number of lines deleted
 	unsigned int nChangedLines;		//!< Number of lines changed
 	unsigned int nNochangedLines;	//!< Number of lines unchanged
 
+	// candidate line pairs of all the comparisons (for tuning the filters)
+	unsigned long long nCandidates;			//!< Line pairs checked for a modified line
+	unsigned long long nHistogramRejects;	//!< Pairs rejected by the char histogram bound
+	unsigned long long nBigramRejects;		//!< Pairs rejected by the bigram bound
+	unsigned long long nLCSExits;			//!< Pairs rejected during the LCS (early exit)
+
 private:
 	void FindModifiedLines(srcLineVector* aHm, srcLineVector* bHm);
 	void FindUnmodifiedLines(srcLineVector *aHm, srcLineVector *bHm);
-	bool SimilarLine( const string &baseLine, int *x1, const string &compareLine, int *x2 );
+	size_t AddLineFilter( const string &line );
+	void SetCompareLine( const string &compareLine );
+	bool SimilarLine( const string &baseLine, const lineFilter &baseFilter, const string &compareLine );
+	bool PassesFilters( const string &baseLine, const lineFilter &baseFilter, const string &compareLine );
+	bool SimilarLCS( const string &baseLine, const string &compareLine );
+	void SimilarLCSBatch( const string **baseLines, size_t count, const string &compareLine, bool *similar );
+	size_t FindSimilarLine( const vector<size_t> *order, size_t first, size_t last, const string &compareLine );
+	bool MeetsThreshold( double LCSlen, int m, int n ) const;
+	int MinCommonChars( int len ) const;
+	void BuildCandidateIndex();
+	bool StartCandidateSearch( size_t first, size_t last );
+	void GatherCandidates( size_t last, vector<size_t> &order );
 
 	double MATCH_THRESHOLD;			//!< % threshold for matching, if greater then added/deleted instead of modified
-};
 
-//! List of strings.
-/*!
-* \typedef stringList
-*
-* Defines a list of strings.
-*/
-typedef list<string> stringList;
+	string lcsCompareLine;			//!< Compare line of the match masks (see SetCompareLine)
+	size_t lcsWords;				//!< Words of the match masks and row (bits for each char of lcsCompareLine)
+	vector<lcsWord> lcsMatch;		//!< Match masks (lcsWords words for each char value)
+	vector<lcsWord> lcsRow;			//!< Row of the bit-parallel LCS
+	unsigned int lcsHist[256];		//!< Char histogram of lcsCompareLine
+	vector<unsigned short> lcsBigrams;	//!< Sorted bigrams of lcsCompareLine
 
-//! Map of string lists.
-/*!
-* \typedef stringSizeMap
-*
-* Defines a map of string lists.
-*/
-typedef map<int, stringList> stringSizeMap;
+	vector<lineFilter> filters;		//!< Filter data of the lines of the shorter list
+	vector<unsigned char> filterChars;	//!< Distinct chars of the lines (see lineFilter)
+	vector<unsigned int> filterCounts;	//!< Count of each distinct char
+	vector<unsigned short> filterBigrams;	//!< Sorted bigrams of the lines
+
+	// lines of the shorter list by length (the lines of one length are a bucket) and their inverted index
+	// a token is the k-th occurrence of a char (see BuildCandidateIndex)
+	vector<lineCandidate> candidates;	//!< Lines of the shorter list by length
+	vector<unsigned int> tokenBase;		//!< First token of each char (257 entries)
+	vector<unsigned int> tokenFreq;		//!< Number of lines with each token
+	vector<unsigned int> postingStart;	//!< First posting of each token in postings
+	vector<unsigned int> postings;		//!< Lines with each token in the prefix of their tokens (by index)
+	vector<unsigned int> postingPos;	//!< Position of the token in the prefix of each posting line
+	vector<int> candMinCommon;			//!< Fewest common chars of each line with a similar line
+	vector<unsigned int> candStamp;		//!< Last search that reached each line
+	vector<int> candCommon;				//!< Common prefix tokens of each line found by the search (-1 if rejected)
+	unsigned int searchStamp;			//!< Number of the current search
+	vector<unsigned long long> searchTokens;	//!< Tokens of the compare line (frequency and token)
+	vector<pair<size_t, size_t> > searchRanges;	//!< Posting ranges of the compare line tokens left to gather
+	int searchMinCommon;				//!< Fewest common chars of the compare line with a similar line
+	int searchAbsent;					//!< Tokens of the compare line that no candidate has
+};
 
 #endif
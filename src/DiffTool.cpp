@@ -104,6 +104,11 @@ int DiffTool::diffToolProcess(int argc, char *argv[])
 	// parse the command line input
 	if (!ParseCommandLine(argc, argv))
 		ShowUsage();
+
+	// add the languages of the user language specification file (before the worker threads copy the counters)
+	if (userLangSpecFile.length() != 0)
+		ReadUserLangSpecs(userLangSpecFile);
+
 	SetCounterOptions( CounterForEachLanguage );
 
 	// handle input file lists
@@ -129,6 +134,9 @@ int DiffTool::diffToolProcess(int argc, char *argv[])
 	if ( start_threads_result_msg.size() )
 		userIF->updateProgress( start_threads_result_msg, false );
 
+	// with a memory budget (-maxmem) the files are counted as they are read and spilled once it is reached
+	OpenSpillFile();
+
 	if ( g_process_after_read )
 		userIF->updateProgress("\tOptimized processing in use ...");
 
@@ -271,6 +279,7 @@ int DiffTool::diffToolProcess(int argc, char *argv[])
 		time_end_match_baselines_web = time_end_print_resultsB;
 
 	ProcessPairs();
+	slocSpillFile::Close();
 
 #ifndef QTGUI
 	userIF->updateProgress("\b\b\b\bDONE");
@@ -379,7 +388,7 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 	if (SourceFileA.size() == 0) 
 	{
 		for (SourceFileList::iterator j = SourceFileB.begin(); j != SourceFileB.end(); j++) 
-			BaseBPrefs[&(*j)] = NULL;
+			BaseBPrefs[j.id()] = NULL;
 	}
 
 	// create the multimaps that will be used
@@ -389,11 +398,11 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 
 	// build multimap of all the file names for A
 	for (SourceFileList::iterator i = SourceFileA.begin(); i != SourceFileA.end(); i++)
-		mapA.insert(FileNamePair((*i).second.file_name_only, &(*i)));
+		mapA.insert(FileNamePair((*i).second.file_name_only, i.id()));
 
 	// build multimap of all the file names for B
 	for (SourceFileList::iterator i = SourceFileB.begin(); i != SourceFileB.end(); i++)
-		mapB.insert(FileNamePair((*i).second.file_name_only, &(*i)));
+		mapB.insert(FileNamePair((*i).second.file_name_only, i.id()));
 
 	PreferenceMapType *myAPrefs, *myBPrefs;
 	BaselinePreferenceMapType::iterator sfBIterator;
@@ -401,16 +410,16 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 	int ourPreference;
 	for (SortedPreferenceMapType::iterator i = mapA.begin(); i != mapA.end(); i++)
 	{
-		if ( webSepFilesOnly && ( (*i).second->second.file_name_isEmbedded == false ) )
+		if ( webSepFilesOnly && ( SourceFileA[(*i).second].second.file_name_isEmbedded == false ) )
 			continue;
 
 		myBPrefs = new PreferenceMapType;
 
 		// BaselineB
-		SortedPreferenceMapType::iterator stop_point = mapB.upper_bound((*i).second->second.file_name_only);
-		for (SortedPreferenceMapType::iterator j = mapB.lower_bound((*i).second->second.file_name_only); j != stop_point; j++)
+		SortedPreferenceMapType::iterator stop_point = mapB.upper_bound(SourceFileA[(*i).second].second.file_name_only);
+		for (SortedPreferenceMapType::iterator j = mapB.lower_bound(SourceFileA[(*i).second].second.file_name_only); j != stop_point; j++)
 		{
-			if ( webSepFilesOnly && ( (*j).second->second.file_name_isEmbedded == false ) )
+			if ( webSepFilesOnly && ( SourceFileB[(*j).second].second.file_name_isEmbedded == false ) )
 				continue;
 
 			// need to check if this file has a preference list, if so use it, if not create it
@@ -426,7 +435,7 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 				myAPrefs = new PreferenceMapType;
 			}
 
-			if ( (*i).second->second.file_name_only.compare( (*j).second->second.file_name_only ) )
+			if ( SourceFileA[(*i).second].second.file_name_only.compare( SourceFileB[(*j).second].second.file_name_only ) )
 			{
 				// Names different so no need to call CompareFilePaths
 				ourPreference = MAX_MISMATCH_COST;	// this should instead be based on the size of file1 and/or file2.
@@ -434,9 +443,9 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 			else
 			{
 				// compare this file path to the file path from A
-				ourPreference = CompareFilePaths( (*i).second->second.file_name, 
-												(*j).second->second.file_name, 
-												(*i).second->second.file_name_only.size() );
+				ourPreference = CompareFilePaths( SourceFileA[(*i).second].second.file_name, 
+												SourceFileB[(*j).second].second.file_name, 
+												SourceFileA[(*i).second].second.file_name_only.size() );
 			}
 
 			// update preference lists for both files
@@ -464,7 +473,7 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 	// add empty preference lists for unmatched B files
 	for (SortedPreferenceMapType::iterator j = mapB.begin(); j != mapB.end(); j++)
 	{
-		if ( webSepFilesOnly && ( (*j).second->second.file_name_isEmbedded == false ) )
+		if ( webSepFilesOnly && ( SourceFileB[(*j).second].second.file_name_isEmbedded == false ) )
 			continue;
 
 		// need to check if this file has a preference list, if so use it, if not create it
@@ -483,24 +492,24 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 	// we will want to match preferences that have the smallest value as it is actually the value of optimal alignment
 	// now run the Gale-Shapley algorithm
 
-	list<SourceFileElement *> FreeBaseAList;
-	map<SourceFileElement *, PreferenceMapType::iterator> NextSelectionMapBaseA;
+	list<SourceFileId> FreeBaseAList;
+	map<SourceFileId, PreferenceMapType::iterator> NextSelectionMapBaseA;
 	BaselineFileMapType BaseAMatches, BaseBMatches;
-	list<SourceFileElement *>::iterator myAFile;
+	list<SourceFileId>::iterator myAFile;
 	PreferenceMapType::iterator myBFile;
 	for (BaselinePreferenceMapType::iterator myI = BaseAPrefs.begin(); myI != BaseAPrefs.end(); myI++)
 	{
-		BaseAMatches[(*myI).first] = NULL;
+		BaseAMatches[(*myI).first] = NO_SOURCE_FILE;
 		FreeBaseAList.push_back((*myI).first);
 		NextSelectionMapBaseA.insert(make_pair((*myI).first, (*myI).second->begin()));
 	}
 	
 	// do this for completeness later on
 	for (BaselinePreferenceMapType::iterator myI = BaseBPrefs.begin(); myI != BaseBPrefs.end(); myI++)
-		BaseBMatches[(*myI).first] = NULL;
+		BaseBMatches[(*myI).first] = NO_SOURCE_FILE;
 
 	BaselineFileMapType::iterator mLocation;
-	SourceFileElement *myAFilePrime;
+	SourceFileId myAFilePrime;
 	bool foundAPrimeFirst;
 	while (!FreeBaseAList.empty())
 	{
@@ -510,7 +519,7 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 		if (myBFile == BaseAPrefs[(*myAFile)]->end())
 		{
 			// it has checked all and is not a good match, match to NULL
-			BaseAMatches[(*myAFile)] = NULL;
+			BaseAMatches[(*myAFile)] = NO_SOURCE_FILE;
 
 			// remove it from the "Free" list
 			FreeBaseAList.pop_front();
@@ -519,12 +528,12 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 
 		// if BFile is unmatched, then pair them...
 		mLocation = BaseBMatches.find((*myBFile).fileElement);
-		if (mLocation == BaseBMatches.end() || (*mLocation).second == NULL)
+		if (mLocation == BaseBMatches.end() || (*mLocation).second == NO_SOURCE_FILE)
 		{
 			// not matched up, pair it!
 			// if the filename is the same, match them
-			if ((*myBFile).fileElement->second.file_name_only.compare(
-				(*myAFile)->second.file_name_only) == 0)
+			if (SourceFileB[(*myBFile).fileElement].second.file_name_only.compare(
+				SourceFileA[(*myAFile)].second.file_name_only) == 0)
 			{
 				BaseAMatches[(*myAFile)] = (*myBFile).fileElement;
 				BaseBMatches[(*myBFile).fileElement] = (*myAFile);
@@ -532,8 +541,8 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 			else
 			{
 				// otherwise, match them to NULL
-				BaseAMatches[(*myAFile)] = NULL;
-				BaseBMatches[(*myBFile).fileElement] = NULL;
+				BaseAMatches[(*myAFile)] = NO_SOURCE_FILE;
+				BaseBMatches[(*myBFile).fileElement] = NO_SOURCE_FILE;
 			}
 
 			// now increase NextSelection for A as it has now examined this preference file entry
@@ -575,7 +584,7 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 				if (myBFile == BaseAPrefs[(*myAFile)]->end())
 				{
 					// it has checked all and is not a good match, match to NULL
-					BaseAMatches[(*myAFile)] = NULL;
+					BaseAMatches[(*myAFile)] = NO_SOURCE_FILE;
 
 					// remove it from the "Free" list
 					FreeBaseAList.pop_front();
@@ -585,7 +594,7 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 			{
 				// FileB and FileA are better matches....
 				// free FileAPrime or match it to NULL
-				BaseAMatches[myAFilePrime] = NULL;
+				BaseAMatches[myAFilePrime] = NO_SOURCE_FILE;
 
 				// now check to see if it has checked all the files
 				if (NextSelectionMapBaseA[myAFilePrime] != BaseAPrefs[myAFilePrime]->end())
@@ -595,8 +604,8 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 				}
 
 				// if FileA and FileB have the same name, match them
-				if ((*myBFile).fileElement->second.file_name_only.compare(
-					(*myAFile)->second.file_name_only) == 0)
+				if (SourceFileB[(*myBFile).fileElement].second.file_name_only.compare(
+					SourceFileA[(*myAFile)].second.file_name_only) == 0)
 				{
 					// match FileA and FileB
 					BaseAMatches[(*myAFile)] = (*myBFile).fileElement;
@@ -605,8 +614,8 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 				else
 				{
 					// match FileA and FileB to NULL
-					BaseAMatches[(*myAFile)] = NULL;
-					BaseBMatches[(*myBFile).fileElement] = NULL;
+					BaseAMatches[(*myAFile)] = NO_SOURCE_FILE;
+					BaseBMatches[(*myBFile).fileElement] = NO_SOURCE_FILE;
 				}
 				NextSelectionMapBaseA[(*myAFile)] = ++myBFile;
 
@@ -617,36 +626,26 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 	}
 
 	// now attempt to match unmatched files by checking content
-	vector<lineElement>::iterator baseLine, compareLine;
 	for (BaselineFileMapType::iterator i = BaseAMatches.begin(); i != BaseAMatches.end(); i++)
 	{
-		if ((*i).second == NULL)
+		if ((*i).second == NO_SOURCE_FILE)
 		{
 			for (BaselineFileMapType::iterator j = BaseBMatches.begin(); j != BaseBMatches.end(); j++)
 			{
-				if ((*j).second == NULL)
+				if ((*j).second == NO_SOURCE_FILE)
 				{
-					SourceFileElement* fileA = (*i).first;
-					SourceFileElement* fileB = (*j).first;
-					if (fileA->first.size() == fileB->first.size())
+					SourceFileElement* fileA = &SourceFileA[(*i).first];
+					SourceFileElement* fileB = &SourceFileB[(*j).first];
+					if (FileLineCount(*fileA) == FileLineCount(*fileB))
 					{
-						if (fileA->first.size() < 1 || fileB->first.size() < 1)
+						if (FileLineCount(*fileA) < 1 || FileLineCount(*fileB) < 1)
 							continue;	//don't match empty file with different names
 
-						baseLine = fileA->first.begin();
-						compareLine = fileB->first.begin();
-						while (baseLine != fileA->first.end() && compareLine != fileB->first.end())
-						{
-							if ((*baseLine).line.compare((*compareLine).line) != 0)
-								break;
-							baseLine++;
-							compareLine++;
-						}
-						if (baseLine == fileA->first.end() && compareLine == fileB->first.end())
+						if (SameFileLines(*fileA, *fileB))
 						{
 							// match files
-							(*i).second = fileB;
-							(*j).second = fileA;
+							(*i).second = (*j).first;
+							(*j).second = (*i).first;
 						}
 					}
 				}
@@ -664,13 +663,13 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 			continue;
 
 		// get the corresponding match
-		mLocation = BaseAMatches.find(&(*i));
+		mLocation = BaseAMatches.find(i.id());
 		if (mLocation != BaseAMatches.end())
 		{
 			resultStruct myResults;
 			MatchedFilePair myPair = make_pair((*mLocation).first, (*mLocation).second);
 			matchedFilesList.push_back(make_pair(myResults, myPair));
-			if (mLocation->second != NULL)
+			if (mLocation->second != NO_SOURCE_FILE)
 				(*i).second.matched = true;
 		}
 	}
@@ -681,10 +680,10 @@ void DiffTool::MatchBaseLines(bool webSepFilesOnly)
 			continue;
 
 		// get the corresponding match
-		mLocation = BaseBMatches.find(&(*i));
+		mLocation = BaseBMatches.find(i.id());
 		if (mLocation != BaseBMatches.end())
 		{
-			if (mLocation->second == NULL)
+			if (mLocation->second == NO_SOURCE_FILE)
 			{
 				resultStruct myResults;
 				MatchedFilePair myPair = make_pair((*mLocation).second, (*mLocation).first);
@@ -799,6 +798,67 @@ int DiffTool::CompareFilePaths( const string &file1, const string &file2, const
 	return rValue;
 }
 
+/*!
+* Creates the spill file if a memory budget is set (-maxmem).
+* The files are then counted as they are read, so their physical lines are freed before the next file is read,
+* and the logical lines of the files counted once the budget is reached are spilled (see ProcessSourceListFile).
+*/
+void DiffTool::OpenSpillFile()
+{
+	if (g_max_memory == 0)
+		return;
+
+	if (!slocSpillFile::Open(outDir + SLOC_SPILL_FILE))
+	{
+		string err = "Error: Unable to create spill file (";
+		err += outDir + SLOC_SPILL_FILE;
+		err += "). Continuing without a memory budget.";
+		userIF->AddError(err);
+		g_max_memory = 0;
+		return;
+	}
+	g_process_after_read = true;
+}
+
+/*!
+* Checks whether two files have the same contents and the same logical lines (from the hashes
+* of the file contents when read and of the logical lines when counted).
+* Files without logical lines (or whose lines were already compared) are not reported as identical.
+*
+* \param res1 results of the first file
+* \param res2 results of the second file
+*
+* \return are the files identical?
+*/
+static bool IdenticalFiles(const results &res1, const results &res2)
+{
+	return (res1.sloc_total > 0 &&
+		res1.file_hash == res2.file_hash &&
+		res1.sloc_hash == res2.sloc_hash &&
+		res1.sloc_total == res2.sloc_total &&
+		res1.mySLOCLines.size() == res2.mySLOCLines.size());
+}
+
+/*!
+* Frees the logical lines of a file once it has been compared for the last time,
+* else spills again the lines read back for the comparison.
+*
+* \param fileList list of files
+* \param id file (NO_SOURCE_FILE if none)
+* \param listings number of comparisons left for each file
+* \param wasSpilled were the lines of the file spilled before the comparison?
+*/
+static void ReleaseCompared(SourceFileList &fileList, SourceFileId id, vector<unsigned int> &listings, bool wasSpilled)
+{
+	if (id == NO_SOURCE_FILE)
+		return;
+	srcLineVector &sloc = fileList[id].second.mySLOCLines;
+	if (--listings[id] == 0)
+		sloc.clear();
+	else if (wasSpilled)
+		sloc.spill();
+}
+
 /*!
 * Executes the differencing comparison on the mapped pairs.
 * Assumes that the SLOC lines have been put int the mySLOCLines object in the results object of each file.
@@ -832,45 +892,60 @@ void DiffTool::ProcessPairs()
 	string web_file_name, base_file_name;
 	size_t web_marker;
 	bool unmatchedDup, found;
+	bool firstSpilled, secondSpilled;
+
+	// number of times each file is listed (embedded files are listed again with the web files)
+	vector<unsigned int> listingsA(SourceFileA.size(), 0);
+	vector<unsigned int> listingsB(SourceFileB.size(), 0);
+	for (MatchingType::iterator myI = matchedFilesList.begin(); myI != matchedFilesList.end(); myI++)
+	{
+		if ((*myI).second.first != NO_SOURCE_FILE)
+			listingsA[(*myI).second.first]++;
+		if ((*myI).second.second != NO_SOURCE_FILE)
+			listingsB[(*myI).second.second]++;
+	}
 
 	unsigned int	count_done        = 0;
 	unsigned int	percent_done      = 0;
 	unsigned int	prev_percent_done = 0;
 	unsigned int	num_in_list       = matchedFilesList.size();
 
+	g_identical_pairs = 0;
+
 	for (MatchingType::iterator myI = matchedFilesList.begin(); myI != matchedFilesList.end(); myI++)
 	{
 		// each source file elements results object has a mySLOCLines object with the SLOC to be diffed
 		// check for unmatched duplicates
 		firstFile = myNullFile;
 		secondFile = myNullFile;
+		firstSpilled = secondSpilled = false;
 		unmatchedDup = false;
 		web_file_name = "";
 
-		if ((*myI).second.first != NULL)
+		if ((*myI).second.first != NO_SOURCE_FILE)
 		{
-			firstFile = &(*myI).second.first->second.mySLOCLines;
+			firstFile = &SourceFileA[(*myI).second.first].second.mySLOCLines;
 
 			// keep track of classes of type WEB
-			current_file_name = myI->second.first->second.file_name;
-			if (myI->second.first->second.class_type == WEB)
+			current_file_name = SourceFileA[myI->second.first].second.file_name;
+			if (SourceFileA[myI->second.first].second.class_type == WEB)
 				web_file_name = current_file_name;
 
-			if ((*myI).second.first->second.duplicate || (*myI).second.first->second.firstDuplicate)
+			if (SourceFileA[(*myI).second.first].second.duplicate || SourceFileA[(*myI).second.first].second.firstDuplicate)
 				unmatchedDup = true;
 		}
-		if ((*myI).second.second != NULL)
+		if ((*myI).second.second != NO_SOURCE_FILE)
 		{
-			secondFile = &(*myI).second.second->second.mySLOCLines;
+			secondFile = &SourceFileB[(*myI).second.second].second.mySLOCLines;
 
 			// keep track of classes of type WEB
-			current_file_name = myI->second.second->second.file_name;
-			if (myI->second.second->second.class_type == WEB)
+			current_file_name = SourceFileB[myI->second.second].second.file_name;
+			if (SourceFileB[myI->second.second].second.class_type == WEB)
 				web_file_name = current_file_name;	// always overwrite with the second file if it exists
 
-			if ((*myI).second.second->second.duplicate || (*myI).second.second->second.firstDuplicate)
+			if (SourceFileB[(*myI).second.second].second.duplicate || SourceFileB[(*myI).second.second].second.firstDuplicate)
 			{
-				if ((*myI).second.first == NULL)
+				if ((*myI).second.first == NO_SOURCE_FILE)
 					unmatchedDup = true;
 				else
 					unmatchedDup = false;
@@ -879,8 +954,37 @@ void DiffTool::ProcessPairs()
 				unmatchedDup = false;
 		}
 
-		// this makes sure that if one of the files was unmatched it will just compare it against an empty set
-		myDiffManager.Compare(firstFile, secondFile, match_threshold);
+		// files with the same contents and logical lines are all unmodified (their lines are not read back or compared)
+		if ((*myI).second.first != NO_SOURCE_FILE && (*myI).second.second != NO_SOURCE_FILE &&
+			IdenticalFiles(SourceFileA[(*myI).second.first].second, SourceFileB[(*myI).second.second].second))
+		{
+			myDiffManager.CompareIdentical(SourceFileA[(*myI).second.first].second.sloc_total);
+			g_identical_pairs++;
+
+			// all lines are matched, so empty the files as Compare does (embedded files are listed again with the web files)
+			firstFile->clear();
+			secondFile->clear();
+			SourceFileA[(*myI).second.first].second.hashSLOC();
+			SourceFileB[(*myI).second.second].second.hashSLOC();
+		}
+		else
+		{
+			// this makes sure that if one of the files was unmatched it will just compare it against an empty set
+			// (lines spilled to disk are read back by Compare)
+			firstSpilled = firstFile->spilled();
+			secondSpilled = secondFile->spilled();
+			if (!myDiffManager.Compare(firstFile, secondFile, match_threshold))
+			{
+				string err = "Error: Unable to read back logical lines from the spill file (";
+				err += current_file_name;
+				err += "). The file was not compared.";
+				userIF->AddError(err);
+			}
+		}
+
+		// free the lines of the files compared for the last time, spill again the lines read back for the others
+		ReleaseCompared(SourceFileA, (*myI).second.first, listingsA, firstSpilled);
+		ReleaseCompared(SourceFileB, (*myI).second.second, listingsB, secondSpilled);
 
 		// if the file is a class of type WEB, keep a list
 		if (web_file_name.length() > 0)
@@ -901,14 +1005,14 @@ void DiffTool::ProcessPairs()
 					web_iter != web_files_vector.end(); ++web_iter)
 				{
 					base_file_name = current_file_name.substr(0, web_marker);
-					if (web_iter->second->second.second != NULL)
+					if (web_iter->second->second.second != NO_SOURCE_FILE)
 					{
-						if (base_file_name.compare(web_iter->second->second.second->second.file_name) == 0)
+						if (base_file_name.compare(SourceFileB[web_iter->second->second.second].second.file_name) == 0)
 							found = true;
 					}
-					if (!found && web_iter->second->second.first != NULL)
+					if (!found && web_iter->second->second.first != NO_SOURCE_FILE)
 					{
-						if (base_file_name.compare(web_iter->second->second.first->second.file_name) == 0)
+						if (base_file_name.compare(SourceFileA[web_iter->second->second.first].second.file_name) == 0)
 							found = true;
 					}
 					if (found)
@@ -951,6 +1055,12 @@ void DiffTool::ProcessPairs()
 	}
 	delete myNullFile;
 
+	// modified line candidates rejected by each filter, shown with the timing (for tuning)
+	g_modified_candidates = myDiffManager.nCandidates;
+	g_histogram_rejects = myDiffManager.nHistogramRejects;
+	g_bigram_rejects = myDiffManager.nBigramRejects;
+	g_lcs_exits = myDiffManager.nLCSExits;
+
 #ifdef	_DEBUG
 	if ( call_again )
 	{
@@ -1022,15 +1132,15 @@ void DiffTool::PrintMatchedPairs()
 	string fileA, fileB;
 	for (MatchingType::iterator myI = matchedFilesList.begin(); myI != matchedFilesList.end(); myI++)
 	{
-		if ((*myI).second.first == NULL)
+		if ((*myI).second.first == NO_SOURCE_FILE)
 			fileA = "NA";
 		else
-			fileA = (*myI).second.first->second.file_name;
+			fileA = SourceFileA[(*myI).second.first].second.file_name;
 
-		if ((*myI).second.second == NULL)
+		if ((*myI).second.second == NO_SOURCE_FILE)
 			fileB = "NA";
 		else
-			fileB = (*myI).second.second->second.file_name;
+			fileB = SourceFileB[(*myI).second.second].second.file_name;
 
 		if (print_ascii || print_legacy)
 		{
@@ -1206,8 +1316,8 @@ void DiffTool::PrintDiffResults()
 	for (MatchingType::iterator myI = matchedFilesList.begin(); myI != matchedFilesList.end(); myI++)
 	{
 		// select the filename, choose the baselineA unless this one was only in baselineB
-		filenameA = ((*myI).second.first != NULL) ? (*myI).second.first->second.file_name : "NA";
-		filenameB = ((*myI).second.second != NULL) ? (*myI).second.second->second.file_name : "NA";
+		filenameA = ((*myI).second.first != NO_SOURCE_FILE) ? SourceFileA[(*myI).second.first].second.file_name : "NA";
+		filenameB = ((*myI).second.second != NO_SOURCE_FILE) ? SourceFileB[(*myI).second.second].second.file_name : "NA";
 
 		if (((*myI).first.addedLines == 0 && (*myI).first.deletedLines == 0 &&
 			 (*myI).first.modifiedLines == 0 && (*myI).first.unmodifiedLines == 0) ||
@@ -1220,23 +1330,23 @@ void DiffTool::PrintDiffResults()
 		}
 		else
 		{
-			if ((*myI).second.first != NULL)
-				lang = GetLanguageName( CounterForEachLanguage, (*myI).second.first->second.class_type, (*myI).second.first->second.file_name);
+			if ((*myI).second.first != NO_SOURCE_FILE)
+				lang = GetLanguageName( CounterForEachLanguage, SourceFileA[(*myI).second.first].second.class_type, SourceFileA[(*myI).second.first].second.file_name);
 			else
-				lang = GetLanguageName( CounterForEachLanguage, (*myI).second.second->second.class_type, (*myI).second.second->second.file_name);
+				lang = GetLanguageName( CounterForEachLanguage, SourceFileB[(*myI).second.second].second.class_type, SourceFileB[(*myI).second.second].second.file_name);
 		}
 
 		unmatchedDup = false;
-		if ((*myI).second.first != NULL)
+		if ((*myI).second.first != NO_SOURCE_FILE)
 		{
-			if ((*myI).second.first->second.duplicate || (*myI).second.first->second.firstDuplicate)
+			if (SourceFileA[(*myI).second.first].second.duplicate || SourceFileA[(*myI).second.first].second.firstDuplicate)
 				unmatchedDup = true;
 		}
-		if ((*myI).second.second != NULL)
+		if ((*myI).second.second != NO_SOURCE_FILE)
 		{
-			if ((*myI).second.second->second.duplicate || (*myI).second.second->second.firstDuplicate)
+			if (SourceFileB[(*myI).second.second].second.duplicate || SourceFileB[(*myI).second.second].second.firstDuplicate)
 			{
-				if ((*myI).second.first == NULL)
+				if ((*myI).second.first == NO_SOURCE_FILE)
 					unmatchedDup = true;
 				else
 					unmatchedDup = false;
@@ -22,6 +22,7 @@
 // Differencing functionality defines
 #define BASELINE_INF1 "fileListA.txt"
 #define BASELINE_INF2 "fileListB.txt"
+#define SLOC_SPILL_FILE "ucc_sloc_spill.tmp"
 #define DIFF_OUTFILE "outfile_diff_results.txt"
 #define DIFF_OUTFILE_CSV "outfile_diff_results.csv"
 #define MATCH_PAIRS_OUTFILE "MatchedPairs.txt"
@@ -67,6 +68,7 @@ private:
 	void MatchBaseLines(bool webSepFilesOnly = false);
 	int CompareFilePaths( const string &file1, const string &file2, const unsigned int file_name_length );
 	void ProcessPairs();
+	void OpenSpillFile();
 	void PrintMatchedPairs();
 	void PrintDiffResults();
 
@@ -74,9 +76,10 @@ private:
 	/*!
 	* \typedef MatchedFilePair
 	*
-	* Defines a pair of matching source files.
+	* Defines a pair of matching source files by ID within SourceFileA and SourceFileB.
+	* An unmatched side is NO_SOURCE_FILE.
 	*/
-	typedef pair<SourceFileElement *, SourceFileElement *> MatchedFilePair;
+	typedef pair<SourceFileId, SourceFileId> MatchedFilePair;
 
 	//! Pair of file name to source file element
 	/*!
@@ -84,7 +87,7 @@ private:
 	*
 	* Defines a pair for file name and source file element.  Used for matching files
 	*/
-	typedef pair<const string, SourceFileElement *> FileNamePair;
+	typedef pair<const string, SourceFileId> FileNamePair;
 
 	//! Vector of matching file pairs and results.
 	/*!
@@ -102,7 +105,7 @@ private:
 	*/
 	struct PreferenceStruct
 	{
-		SourceFileElement *fileElement;	//!< File element
+		SourceFileId fileElement;		//!< File element ID (in the other baseline)
 		int value;						//!< File preference value
 	};
 
@@ -134,7 +137,7 @@ private:
 	*
 	* Defines a map of file elements and preferences.
 	*/
-	typedef map<SourceFileElement *, PreferenceMapType *> BaselinePreferenceMapType;
+	typedef map<SourceFileId, PreferenceMapType *> BaselinePreferenceMapType;
 
 	//! Map of file element pairs.
 	/*!
@@ -142,7 +145,7 @@ private:
 	*
 	* Defines a map of file element pairs.
 	*/
-	typedef map<SourceFileElement *, SourceFileElement *> BaselineFileMapType;
+	typedef map<SourceFileId, SourceFileId> BaselineFileMapType;
 
 	//! Multimap of file elements, sorted by file name
 	/*!
@@ -150,7 +153,7 @@ private:
 	*
 	* Defines a multimap of file elements and names
 	*/
-	typedef multimap<const string, SourceFileElement*> SortedPreferenceMapType;
+	typedef multimap<const string, SourceFileId> SortedPreferenceMapType;
 
 	MatchingType matchedFilesList;		//!< List of matching file pairs and differencing results
 
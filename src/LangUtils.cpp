@@ -15,6 +15,10 @@
 #include "UCCGlobals.h"
 #include "LangUtils.h"
 
+// Languages read from a specification file (-langfile)
+// Only changed by the main thread before any worker thread starts
+static vector<langSpec> userLangSpecs;
+
 // See note in UCCThreads.cpp for why this is exciting to call
 int Init_CounterForEachLanguage( CounterForEachLangType & CounterForEachLanguage )
 {
@@ -181,9 +185,75 @@ int Init_CounterForEachLanguage( CounterForEachLangType & CounterForEachLanguage
 	tmp = new CXmlCounter;
 	CounterForEachLanguage.insert(map<int, CCodeCounter*>::value_type(XML			,tmp));
 
+	AddLangSpecCounters(CounterForEachLanguage);
+
 	return retVal;
 }
 
+/*!
+* Reads and compiles the languages of a specification file.
+* The languages get class types from USER_LANGUAGE in file order.
+* A language with the name of a language already counted is not added.
+*
+* \param file					IN		language specification file
+* \param CounterForEachLanguage	IN		structure holding Language counter class instances
+* \param errors					IN/OUT	errors found in the file
+*
+* \return was the file read?
+*/
+bool ReadLangSpecs( const string &file, CounterForEachLangType & CounterForEachLanguage, StringVector &errors )
+{
+	size_t i = 0;
+	bool found;
+	CounterForEachLangType::iterator iter;
+
+	userLangSpecs.clear();
+	if (!CSpecCounter::ReadSpecFile(file, userLangSpecs, errors))
+		return false;
+	while (i < userLangSpecs.size())
+	{
+		found = false;
+		for (iter = CounterForEachLanguage.begin(); iter != CounterForEachLanguage.end(); iter++)
+		{
+			if (CUtil::ToLower(iter->second->language_name) == CUtil::ToLower(userLangSpecs[i].name))
+			{
+				found = true;
+				break;
+			}
+		}
+		for (size_t j = 0; j < i && !found; j++)
+			found = (CUtil::ToLower(userLangSpecs[j].name) == CUtil::ToLower(userLangSpecs[i].name));
+		if (found)
+		{
+			errors.push_back("Error: Language " + userLangSpecs[i].name + " of language specification file (" + file + ") is already counted");
+			userLangSpecs.erase(userLangSpecs.begin() + i);
+			continue;
+		}
+		userLangSpecs[i].classtype = (ClassType)(USER_LANGUAGE + i);
+		i++;
+	}
+	return true;
+}
+
+/*!
+* Adds a counter for each language of the specification file (if not already added).
+*
+* \param CounterForEachLanguage	IN/OUT	structure holding Language counter class instances
+*/
+void AddLangSpecCounters( CounterForEachLangType & CounterForEachLanguage )
+{
+	CCodeCounter* tmp;
+
+	for (size_t i = 0; i < userLangSpecs.size(); i++)
+	{
+		if (CounterForEachLanguage.find(userLangSpecs[i].classtype) != CounterForEachLanguage.end())
+			continue;
+		tmp = new CSpecCounter(&userLangSpecs[i]);
+		tmp->InitializeCounts();
+		CounterForEachLanguage.insert(map<int, CCodeCounter*>::value_type(userLangSpecs[i].classtype, tmp));
+	}
+}
+
 /*!
 * Resets all count lists (e.g., directive_count, data_name_count, etc.).
 */
@@ -288,13 +358,11 @@ void UpdateCounterCounts( CounterForEachLangType & eachLangCounters,
 						SourceFileList * mySourceFile,
 						const bool useListA, const bool resetCounts )
 {
-	int i;
 	ClassType class_type;
 	WebType webType;
 	SourceFileList::iterator its;
-	StringVector::iterator icnts, icnte;
-	UIntPairVector::iterator icntc;
-	UIntVector::iterator icnt;
+	KeywordCountVector::const_iterator ikw;
+	UIntPairVector *totals;
 	CCodeCounter* codeCounter;
 	CWebCounter* webCounter;
 
@@ -305,93 +373,19 @@ void UpdateCounterCounts( CounterForEachLangType & eachLangCounters,
 	{
 		class_type = its->second.class_type;
 		codeCounter = eachLangCounters[class_type];
-		for (i = 0; i < 12; i++)
+
+		// only the non zero keyword counts of the file are kept
+		its->second.compactCounts();
+		const KeywordCountVector &kwCounts = its->second.keyword_counts();
+		for (ikw = kwCounts.begin(); ikw != kwCounts.end(); ikw++)
 		{
-			switch (i)
-			{
-			case 0:
-				icnts = codeCounter->directive.begin();
-				icnte = codeCounter->directive.end();
-				icntc = codeCounter->directive_count.begin();
-				icnt = its->second.directive_count.begin();
-				break;
-			case 1:
-				icnts = codeCounter->data_name_list.begin();
-				icnte = codeCounter->data_name_list.end();
-				icntc = codeCounter->data_name_count.begin();
-				icnt = its->second.data_name_count.begin();
-				break;
-			case 2:
-				icnts = codeCounter->exec_name_list.begin();
-				icnte = codeCounter->exec_name_list.end();
-				icntc = codeCounter->exec_name_count.begin();
-				icnt = its->second.exec_name_count.begin();
-				break;
-			case 3:
-				icnts = codeCounter->math_func_list.begin();
-				icnte = codeCounter->math_func_list.end();
-				icntc = codeCounter->math_func_count.begin();
-				icnt = its->second.math_func_count.begin();
-				break;
-			case 4:
-				icnts = codeCounter->trig_func_list.begin();
-				icnte = codeCounter->trig_func_list.end();
-				icntc = codeCounter->trig_func_count.begin();
-				icnt = its->second.trig_func_count.begin();
-				break;
-			case 5:
-				icnts = codeCounter->log_func_list.begin();
-				icnte = codeCounter->log_func_list.end();
-				icntc = codeCounter->log_func_count.begin();
-				icnt = its->second.log_func_count.begin();
-				break;
-			case 6:
-				icnts = codeCounter->cmplx_calc_list.begin();
-				icnte = codeCounter->cmplx_calc_list.end();
-				icntc = codeCounter->cmplx_calc_count.begin();
-				icnt = its->second.cmplx_calc_count.begin();
-				break;
-			case 7:
-				icnts = codeCounter->cmplx_cond_list.begin();
-				icnte = codeCounter->cmplx_cond_list.end();
-				icntc = codeCounter->cmplx_cond_count.begin();
-				icnt = its->second.cmplx_cond_count.begin();
-				break;
-			case 8:
-				icnts = codeCounter->cmplx_logic_list.begin();
-				icnte = codeCounter->cmplx_logic_list.end();
-				icntc = codeCounter->cmplx_logic_count.begin();
-				icnt = its->second.cmplx_logic_count.begin();
-				break;
-			case 9:
-				icnts = codeCounter->cmplx_preproc_list.begin();
-				icnte = codeCounter->cmplx_preproc_list.end();
-				icntc = codeCounter->cmplx_preproc_count.begin();
-				icnt = its->second.cmplx_preproc_count.begin();
-				break;
-			case 10:
-				icnts = codeCounter->cmplx_assign_list.begin();
-				icnte = codeCounter->cmplx_assign_list.end();
-				icntc = codeCounter->cmplx_assign_count.begin();
-				icnt = its->second.cmplx_assign_count.begin();
-				break;
-			case 11:
-				icnts = codeCounter->cmplx_pointer_list.begin();
-				icnte = codeCounter->cmplx_pointer_list.end();
-				icntc = codeCounter->cmplx_pointer_count.begin();
-				icnt = its->second.cmplx_pointer_count.begin();
-				break;
-			}
-			while (icnts != icnte)
-			{
-				if (its->second.duplicate)
-					(*icntc).second += (*icnt);
-				else
-					(*icntc).first += (*icnt);
-				icnts++;
-				icnt++;
-				icntc++;
-			}
+			totals = KeywordListCounts<UIntPairVector>( *codeCounter, (KeywordListType)ikw->list );
+			if (totals == NULL || ikw->index >= totals->size())
+				continue;
+			if (its->second.duplicate)
+				(*totals)[ikw->index].second += ikw->count;
+			else
+				(*totals)[ikw->index].first += ikw->count;
 		}
 		if (its->second.duplicate)
 		{
@@ -38,6 +38,7 @@
 #include "CPhpCounter.h"
 #include "CPythonCounter.h"
 #include "CRubyCounter.h"
+#include "CSpecCounter.h"
 #include "CSqlCounter.h"
 #include "CVbCounter.h"
 #include "CVbscriptCounter.h"
@@ -59,6 +60,16 @@ typedef map<int, CCodeCounter*> CounterForEachLangType;
 
 int Init_CounterForEachLanguage( CounterForEachLangType & CounterForEachLanguage );
 
+/*!
+* Reads the languages of a specification file (-langfile).
+*/
+bool ReadLangSpecs( const string &file, CounterForEachLangType & CounterForEachLanguage, StringVector &errors );
+
+/*!
+* Adds a counter for each language read by ReadLangSpecs.
+*/
+void AddLangSpecCounters( CounterForEachLangType & CounterForEachLanguage );
+
 /*!
 * Resets all count lists (e.g., directive_count, data_name_count, etc.).
 */
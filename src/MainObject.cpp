@@ -179,6 +179,10 @@ int MainObject::MainProcess(int argc, char *argv[])
 	if (!ParseCommandLine(argc, argv))
 		ShowUsage();		// This will EXIT
 
+	// add the languages of the user language specification file (before the worker threads copy the counters)
+	if (userLangSpecFile.length() != 0)
+		ReadUserLangSpecs(userLangSpecFile);
+
 	SetCounterOptions( CounterForEachLanguage );
 
 	// handle input file list
@@ -200,6 +204,10 @@ int MainObject::MainProcess(int argc, char *argv[])
 	if ( g_process_after_read )
 		userIF->updateProgress("\tOptimized processing in use ...");
 
+	// each file is counted right after it is Read so its results can be printed (-stream)
+	if ( g_stream_results )
+		g_process_after_read = true;
+
 	// generate user-defined language extension map
 	if (userExtMapFile.length() != 0)
 		ReadUserExtMapping(userExtMapFile);
@@ -236,7 +244,12 @@ int MainObject::MainProcess(int argc, char *argv[])
 			return 0;
 	}
 
-	if (duplicate_threshold >= 0.0)
+	if ( g_stream_results )
+	{
+		// the counts were already added and the file results printed as each file was counted
+		time( &time_end_files_analysis );
+	}
+	else if (duplicate_threshold >= 0.0)
 	{
 		time( &time_end_files_analysis );
 
@@ -264,7 +277,9 @@ int MainObject::MainProcess(int argc, char *argv[])
 	userIF->updateProgress("Generating results to files........", false);
 	if (HasUserCancelled())
 		return 0;
-	if (print_unified)
+	if ( g_stream_results )
+		PrintStreamedCountTotals( CounterForEachLanguage );
+	else if (print_unified)
 		PrintTotalCountResults( CounterForEachLanguage, true, "", &duplicateFilesInA2);
 	else
 		PrintCountResults( CounterForEachLanguage, true, "", &duplicateFilesInA2);
@@ -490,6 +505,18 @@ int MainObject::ParseCommandLine(int argc, char *argv[])
 			i++;
 			userExtMapFile = argv[i];
 		}
+		else if (arg == "-langfile")
+		{
+			// read the user defined language specifications
+			if (i + 2 > argc)
+			{
+				string err = "Error: Unable to parse command line args";
+				userIF->AddError(err);
+				return 0;
+			}
+			i++;
+			userLangSpecFile = argv[i];
+		}
 		else if (arg == "-t" && isDiff)
 		{
 			if (i + 1 > argc)
@@ -601,6 +628,43 @@ int MainObject::ParseCommandLine(int argc, char *argv[])
 				workThreadsCount = myThreads;
 			}
 		}
+		else if ( arg == "-maxmem" )
+		{
+			if (i + 1 >= argc)
+				return 0;
+			i++;
+			// size in bytes with an optional K, M or G suffix
+			char *sizeEnd = NULL;
+			unsigned long long maxMem = strtoull(argv[i], &sizeEnd, 10);
+			switch (toupper(*sizeEnd))
+			{
+			case 'G':	maxMem <<= 30;	break;
+			case 'M':	maxMem <<= 20;	break;
+			case 'K':	maxMem <<= 10;	break;
+			case '\0':					break;
+			default:	return 0;
+			}
+			g_max_memory = maxMem;
+		}
+		else if ( arg == "-stream" )
+		{
+			g_stream_results = true;
+		}
+		else if ( arg == "-engine" )
+		{
+			if (i + 1 >= argc)
+				return 0;
+			i++;
+			string engine = argv[i];
+			if (engine == "passes")
+				g_count_engine = COUNT_ENGINE_PASSES;
+			else if (engine == "fused")
+				g_count_engine = COUNT_ENGINE_FUSED;
+			else if (engine == "verify")
+				g_count_engine = COUNT_ENGINE_VERIFY;
+			else
+				return 0;
+		}
 		else if ( arg == "-nowarnings" )
 		{
 			g_no_warnings_to_stdout = true;
@@ -612,6 +676,13 @@ int MainObject::ParseCommandLine(int argc, char *argv[])
 		else 
 			return 0;
 	}
+
+	// the results of each file are only printed as it is counted (-stream) when nothing needs all files
+	if ( g_stream_results && ( isDiff || duplicate_threshold >= 0.0 || print_unified || workThreadsCount > 1 ) )
+	{
+		userIF->updateProgress("Warning: -stream needs -nodup and is not used with -d, -unified or -threads 2 (or more)");
+		g_stream_results = false;
+	}
 	return 1;
 }
 
@@ -726,6 +797,18 @@ void MainObject::ShowUsage(const string &option, bool do_exit)
 		cout << "                     Please see the user manual for available language counter" << endl;
 		cout << "                     names." << endl;
 	}
+	else if (option == "-langfile")
+	{
+		cout << "Usage: ucc -langfile <langFile>" << endl << endl;
+		cout << " -langfile <langFile>: Specifies a file defining languages to count in addition" << endl;
+		cout << "                       to the available language counters. Each language starts" << endl;
+		cout << "                       with 'language = <name>' followed by 'key = <values>' lines" << endl;
+		cout << "                       for: extensions, line_comment, block_comment, quote, escape," << endl;
+		cout << "                       continuation, terminator, case_sensitive, directive, data," << endl;
+		cout << "                       exec, math, trig, log, calc, cond, logic, preproc, assign," << endl;
+		cout << "                       pointer and cyclomatic. Values are separated by spaces" << endl;
+		cout << "                       or commas. Lines starting with // are comments." << endl;
+	}
 	else if (option == "-unified")
 	{
 		cout << "Usage: ucc -unified" << endl << endl;
@@ -779,6 +862,39 @@ void MainObject::ShowUsage(const string &option, bool do_exit)
 		cout << "                      If not specified then no work threads are created." << endl;
 		cout << "                      1 = Faster processing and no work threads created." << endl;
 	}
+	else if ( option == "-maxmem" )
+	{
+		cout << "Usage: ucc -maxmem <size>" << endl << endl;
+		cout << " -maxmem <size>     Sets a memory budget for differencing (-d), for example 64G." << endl;
+		cout << "                      The size is in bytes, or in K, M or G with a suffix." << endl;
+		cout << "                      Files are counted as they are read and their lines" << endl;
+		cout << "                      are freed. Renamed and identical files are then" << endl;
+		cout << "                      matched by a hash of their lines. Once the budget" << endl;
+		cout << "                      is reached the logical lines of the files counted" << endl;
+		cout << "                      are moved to a temporary spill file in outDir." << endl;
+	}
+	else if ( option == "-stream" )
+	{
+		cout << "Usage: ucc -stream" << endl << endl;
+		cout << " -stream            Prints the results of each file as soon as it is counted." << endl;
+		cout << "                      Only the language totals are kept for the summaries" << endl;
+		cout << "                      so memory use does not grow with the number of files." << endl;
+		cout << "                      Complexity rows are kept in a temporary file in outDir" << endl;
+		cout << "                      until the complexity results are printed." << endl;
+		cout << "                      Needs -nodup and is not used with -d, -unified" << endl;
+		cout << "                      or -threads 2 (or more)." << endl;
+	}
+	else if ( option == "-engine" )
+	{
+		cout << "Usage: ucc -engine <passes|fused|verify>" << endl << endl;
+		cout << " -engine <engine>   Selects how the lines of each file are counted." << endl;
+		cout << "                      passes = one pass over the lines for each counting step.  (DEFAULT)" << endl;
+		cout << "                      fused  = one pass over the lines for all counting steps" << endl;
+		cout << "                               for languages that support it (C/C++, Java, C#)," << endl;
+		cout << "                               otherwise passes." << endl;
+		cout << "                      verify = counts with both and warns about any file" << endl;
+		cout << "                               they count differently (results of passes are kept)." << endl;
+	}
 	else if ( option == "-nowarnings" )
 	{
 		cout << "Usage: ucc -nowarnings" << endl << endl;
@@ -802,13 +918,15 @@ void MainObject::ShowUsage(const string &option, bool do_exit)
 	{
 		cout << "Usage: ucc [-v] [-d [-i1 fileListA] [-i2 <fileListB>] [-t <#>]] [-tdup <#>]" << endl;
 		cout << "           [-trunc <#>] [-cf] [-dir <dirA> [<dirB>] <fileSpecs>]" << endl;
-		cout << "           [-outdir <outDir>] [-extfile <extFile>] [-unified] [-ascii] [-legacy]" << endl;
+		cout << "           [-outdir <outDir>] [-extfile <extFile>] [-langfile <langFile>]" << endl;
+		cout << "           [-unified] [-ascii] [-legacy]" << endl;
 #ifdef UNIX
-		cout << "           [-nodup] [-nocomplex] [-nolinks] [-threads <#>] [-nowarnings]" << endl; 
-		cout << "           [-nouncounted] [-help [<option>]]" << endl << endl;
-#else
-		cout << "           [-nodup] [-nocomplex] [-threads <#>] [-nowarnings] [-nouncounted]" << endl;
+		cout << "           [-nodup] [-nocomplex] [-nolinks] [-threads <#>] [-maxmem <size>]" << endl; 
+		cout << "           [-stream] [-engine <engine>] [-nowarnings] [-nouncounted]" << endl;
 		cout << "           [-help [<option>]]" << endl << endl;
+#else
+		cout << "           [-nodup] [-nocomplex] [-threads <#>] [-maxmem <size>] [-stream]" << endl;
+		cout << "           [-engine <engine>] [-nowarnings] [-nouncounted] [-help [<option>]]" << endl << endl;
 #endif
 		cout << "Options:" << endl;
 		cout << " -v                 Lists the current version number." << endl;
@@ -835,6 +953,7 @@ void MainObject::ShowUsage(const string &option, bool do_exit)
 		cout << "                        For example, *.cpp *.h" << endl;
 		cout << " -outdir <outDir>   Specifies the directory to store the output files." << endl;
 		cout << " -extfile <extFile> Indicates language extension mapping filename" << endl;
+		cout << " -langfile <langFile> Indicates user language specification filename" << endl;
 		cout << " -unified           Print language report files to a single unified report file." << endl;
 		cout << " -ascii             Print ASCII text report files instead of CSV files." << endl;
 		cout << " -legacy            Print legacy formatted ASCII text report files" << endl;
@@ -847,6 +966,11 @@ void MainObject::ShowUsage(const string &option, bool do_exit)
 		cout << " -threads <#>       Specify the number of work threads. Minimum is 1." << endl;
 		cout << "                      If not specified then no work threads are created." << endl;
 		cout << "                      1 = Faster processing and no work threads created." << endl;
+		cout << " -maxmem <size>     Sets a memory budget for differencing, for example 64G." << endl;
+		cout << "                      Above it logical lines are spilled to a file in outDir." << endl;
+		cout << " -stream            Prints the results of each file as soon as it is counted." << endl;
+		cout << "                      Needs -nodup, not used with -d or -unified." << endl;
+		cout << " -engine <engine>   Counts lines with passes (default), fused or verify (both)." << endl;
 		cout << " -nowarnings        Disables warning messages on console." << endl;
 		cout << "                      Warning messages will still be logged." << endl;
 		cout << "                      Error messages will still show on console." << endl;
@@ -947,6 +1071,21 @@ void MainObject::ReadUserExtMapping(const string &extMapFile)
 	CreateExtMap();
 }
 
+/*!
+* Reads the user language specification file and adds a counter for each valid language.
+*
+* \param langSpecFile language specification file
+*/
+void MainObject::ReadUserLangSpecs(const string &langSpecFile)
+{
+	StringVector errors;
+
+	ReadLangSpecs(langSpecFile, CounterForEachLanguage, errors);
+	for (size_t i = 0; i < errors.size(); i++)
+		userIF->AddError(errors[i], false, 1);
+	AddLangSpecCounters(CounterForEachLanguage);
+}
+
 /*!
 * Create user-defined language extension map.
 */
@@ -1209,24 +1348,39 @@ int MainObject::ReadAllFiles(StringVector &inputFileVector, string const &inputF
 		// Not using extra worker threads
 		// May still use optimizations if -threads 1 is set
 		ErrMsgStructVector			err_msgs;	// Not used but needed for arg in call
-		UncountedFileStructVector	unc_files;	// Not used but needed for arg in call
+		UncountedFileStructVector	unc_files;	// Files that could not be counted with -stream
+
+		// With -stream only the file being counted is in the list, its results are printed right away
+		SourceFileList	streamFiles;
+		SourceFileList	*readList = ( g_stream_results ) ? &streamFiles : mySrcFileList;
 
 		error_count = ReadFilesInList( MAX_UCC_THREAD_COUNT + 1, userIF, 
 									CounterForEachLanguage, 
 									print_cmplx, 
 									print_csv, itStart, inputFileVector.end(), 
-									useListA, clearCaseFile, mySrcFileList, 
-									&SourceFileA, &SourceFileB, 
+									useListA, clearCaseFile, readList, 
+									( useListA ) ? readList : &SourceFileA, 
+									( useListA ) ? &SourceFileB : readList, 
 									errList,
 									outDir,
 									err_msgs, unc_files,
 									g_process_after_read,
-									g_discard_lines_after_process );
+									g_discard_lines_after_process,
+									( g_stream_results ) ? PrintCountResultsStreamed : NULL );
 		
 		// Here the error_count is for info purposes.  
 		// Single thread mode mostly does the Error reporting as expected.
 
-		count_done = mySrcFileList->size();
+		// files not counted are listed after the files not read, as without -stream
+		for ( UncountedFileStructVector::iterator itUnc = unc_files.begin(); itUnc != unc_files.end(); itUnc++ )
+		{
+			string writeErr = CUtil::WriteUncountedFileUtil( itUnc->msg, itUnc->uncFile, 
+											itUnc->useListA, itUnc->csvOutput, itUnc->outDir );
+			if ( writeErr.size() )
+				userIF->AddError( writeErr );
+		}
+
+		count_done = ( g_stream_results ) ? num_in_list : mySrcFileList->size();
 	}
 
 
@@ -1560,11 +1714,9 @@ bool MainObject::FindDuplicateFor(SourceFileList &compareList, SourceFileList::i
 	// Anything related to i
 	string			i_second_file_name_only      = (*i).second.file_name_only;
 	unsigned int	i_second_file_name_only_size = (*i).second.file_name_only.size();
-	unsigned int	i_first_size                 = (*i).first.size();
+	unsigned int	i_first_size                 = FileLineCount(*i);
 	int				i_second_file_type           = (*i).second.file_type;
 	ClassType		i_second_class_type          = (*i).second.class_type;
-	vector<lineElement>::iterator i_first_begin  = (*i).first.begin();
-	vector<lineElement>::iterator i_first_end    = (*i).first.end();
 
 	// Values that are set 1 time in the LOOP and used 2 or more times
 	unsigned int	j_first_size = 0;
@@ -1585,7 +1737,7 @@ bool MainObject::FindDuplicateFor(SourceFileList &compareList, SourceFileList::i
 		if ( i_second_file_name_only_size == (*j).second.file_name_only.size() )
 			filenameMatched = i_second_file_name_only.compare( (*j).second.file_name_only );
 
-		j_first_size = (*j).first.size();
+		j_first_size = FileLineCount(*j);
 		if ( i_first_size != j_first_size &&
 			filenameMatched != 0 )
 		{
@@ -1731,16 +1883,7 @@ bool MainObject::FindDuplicateFor(SourceFileList &compareList, SourceFileList::i
 			}
 
 			// note: two files have the same number of lines
-			vector<lineElement>::iterator baseLine = i_first_begin;
-			vector<lineElement>::iterator compareLine = (*j).first.begin();
-			while (baseLine != i_first_end && compareLine != (*j).first.end())
-			{
-				if ((*baseLine).line.compare((*compareLine).line) != 0)
-					break;
-				baseLine++;
-				compareLine++;
-			}
-			if (baseLine == i_first_end && compareLine == (*j).first.end())
+			if (SameFileLines(*i, *j))
 				filesMatched = true;
 		}
 		if (filesMatched)
@@ -1803,7 +1946,14 @@ void MainObject::CompareForDuplicate(srcLineVector &firstFile, srcLineVector &se
 	srcLineVector ff = firstFile;
 	srcLineVector sf = secondFile;
 
-	myDiffManager.Compare(&ff, &sf, 60);
+	if (!myDiffManager.Compare(&ff, &sf, 60))
+	{
+		// lines that cannot be read back from the spill file (-maxmem) are taken as all changed
+		userIF->AddError("Error: Unable to read back logical lines from the spill file. The files are not taken as duplicates.");
+		changedLines += firstFile.size() + secondFile.size();
+		totalLines += firstFile.size();
+		return;
+	}
 	changedLines += myDiffManager.nAddedLines + myDiffManager.nDeletedLines + myDiffManager.nChangedLines;
 	totalLines += myDiffManager.nDeletedLines + myDiffManager.nChangedLines + myDiffManager.nNochangedLines;
 }
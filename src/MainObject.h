@@ -60,6 +60,7 @@ protected:
 		StringVector &dupList1, StringVector &dupList2, const bool checkMatch = false);
 	void CompareForDuplicate(srcLineVector &firstFile, srcLineVector &secondFile, double &changedLines, double &totalLines);
 	void ReadUserExtMapping(const string &extMapFile);
+	void ReadUserLangSpecs(const string &langSpecFile);
 	void CreateExtMap();
 
 	string BaselineFileName1;						//!< Baseline file name 1
@@ -69,6 +70,7 @@ protected:
 	string dirnameB;								//!< Directory name for baseline B
 
 	string userExtMapFile;							//!< User extension map file
+	string userLangSpecFile;						//!< User language specification file
 
 	double duplicate_threshold;						//!< % changed threshold for determining duplicate content
 	StringVector listFilesToBeSearched;				//!< List of options for files to be searched
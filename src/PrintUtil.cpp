@@ -31,6 +31,7 @@ using namespace std;
 
 #define DUP_PAIRS_OUTFILE		"DuplicatePairs.txt"
 #define DUP_PAIRS_OUTFILE_CSV	"DuplicatePairs.csv"
+#define STREAM_CPLX_FILE		"ucc_cplx_rows.tmp"
 
 extern	UserIF *	userIF;					//!< User interface for presenting messages/progress to user
 
@@ -41,12 +42,65 @@ ofstream output_summary;					//!< Output summary file stream
 ofstream output_summary_csv;				//!< Output summary CSV file stream
 ofstream output_file;						//!< Total output file stream
 ofstream output_file_csv;					//!< Total output CSV file stream
+TotalValueMap streamTotal;					//!< Totals of the files printed so far (-stream)
+WebTotalValueMap streamWebTotal;			//!< WEB totals of the files printed so far (-stream)
+fstream streamCplxRows;						//!< Complexity rows of the files printed so far (-stream)
+size_t streamCplxLoopCol = 0;				//!< Most nested loop levels of the files printed so far (-stream)
+bool streamCplxCycFound = false;			//!< Do the files printed so far have cyclomatic complexity? (-stream)
+
+//! Line counts of one language section of a WEB file.
+/*!
+* Holds only the counters printed for a WEB file so the report does not
+* copy the whole results (keyword counts and logical lines) of each section.
+*/
+struct webLineCounts
+{
+	unsigned int blank_lines;			//!< # of blank lines
+	unsigned int comment_lines;			//!< # of whole line comment lines
+	unsigned int e_comm_lines;			//!< # of embedded comment lines
+	unsigned int directive_lines[2];	//!< # of compiler directive lines
+	unsigned int data_lines[2];			//!< # of data declaration lines
+	unsigned int exec_lines[2];			//!< # of executable lines
+	unsigned int SLOC_lines[2];			//!< # of SLOC lines
+	unsigned int total_lines;			//!< # of total lines
+
+	webLineCounts()
+	{
+		blank_lines = comment_lines = e_comm_lines = total_lines = 0;
+		for (int i = 0; i < 2; i++)
+			directive_lines[i] = data_lines[i] = exec_lines[i] = SLOC_lines[i] = 0;
+	}
+
+	webLineCounts& operator=(const results &r)
+	{
+		blank_lines = r.blank_lines;
+		comment_lines = r.comment_lines;
+		e_comm_lines = r.e_comm_lines;
+		total_lines = r.total_lines;
+		for (int i = 0; i < 2; i++)
+		{
+			directive_lines[i] = r.directive_lines[i];
+			data_lines[i] = r.data_lines[i];
+			exec_lines[i] = r.exec_lines[i];
+			SLOC_lines[i] = r.SLOC_lines[i];
+		}
+		return *this;
+	}
+};
 
 //
 //		Local Procedure prototypes
 //
 int PrintCyclomaticComplexity(const bool useListA, const string &outputFileNamePrePend, const bool printDuplicates);
 
+static SourceFileList::iterator SumEmbeddedComplexity(SourceFileList &fileList, SourceFileList::iterator itt2);
+
+static void WriteStreamedComplexity(SourceFileList *mySourceFile);
+
+static bool ReadStreamedComplexity(SourceFileList &rowList);
+
+static void CloseStreamedComplexity();
+
 void PrintDuplicateList(StringVector &myList1, StringVector &myList2, ofstream &outfile, const bool csvFormat = false);
 
 ofstream* GetTotalOutputStream(const string &outputFileNamePrePend = "", const bool csvOutput = false);
@@ -57,6 +111,15 @@ void CloseOutputSummaryStream();
 
 void CloseTotalOutputStream();
 
+int PrintCountFileResults( CounterForEachLangType & CounterForEachLanguage,
+						SourceFileList *mySourceFile, TotalValueMap &total, WebTotalValueMap &webtotal,
+						const string &outputFileNamePrePend = "", StringVector *filesToPrint = NULL, const bool excludeFiles = true );
+
+int PrintCountTotalsResults( CounterForEachLangType & CounterForEachLanguage,
+						TotalValueMap &total, WebTotalValueMap &webtotal,
+						const bool useListA = true, const string &outputFileNamePrePend = "",
+						StringVector *filesToPrint = NULL, const bool excludeFiles = true );
+
 /*!
 * Prints the counting results for a set of files.
 *
@@ -71,22 +134,47 @@ int PrintCountResults( CounterForEachLangType & CounterForEachLanguage,
 						const bool useListA, const string &outputFileNamePrePend, 
 						StringVector *filesToPrint, const bool excludeFiles )
 {
-	ofstream* pout     = NULL;
-	ofstream* pout_csv = NULL;
 	TotalValueMap total;
 	WebTotalValueMap webtotal;
-	StringVector::iterator sit;
-	ClassType class_type;
-	string file_type;
-	CWebCounter *webCounter;
-	WebType webType;
 
 	// skip if all files are excluded
 	if (filesToPrint != NULL && filesToPrint->size() < 1 && !excludeFiles)
 		return 0;
 
-	SourceFileList::iterator its;
 	SourceFileList* mySourceFile = (useListA) ? &SourceFileA : &SourceFileB;
+	if (!PrintCountFileResults( CounterForEachLanguage, mySourceFile, total, webtotal,
+								outputFileNamePrePend, filesToPrint, excludeFiles ))
+		return 0;
+
+	return PrintCountTotalsResults( CounterForEachLanguage, total, webtotal, useListA,
+									outputFileNamePrePend, filesToPrint, excludeFiles );
+}
+
+/*!
+* Prints the counting results of each file in a list and adds them to the language totals.
+* The language report files are left open so later calls can append more files.
+*
+* \param mySourceFile list of files
+* \param total totals of languages other than WEB (updated)
+* \param webtotal totals of WEB languages (updated)
+* \param outputFileNamePrePend name to prepend to the output file
+* \param filesToPrint list of files to include or exclude
+* \param excludeFiles exclude files? (if true excludes files in filesToPrint; if false includes only files in filesToPrint)
+*
+* \return method status
+*/
+int PrintCountFileResults( CounterForEachLangType & CounterForEachLanguage,
+						SourceFileList *mySourceFile, TotalValueMap &total, WebTotalValueMap &webtotal,
+						const string &outputFileNamePrePend, StringVector *filesToPrint, const bool excludeFiles )
+{
+	ofstream* pout     = NULL;
+	ofstream* pout_csv = NULL;
+	StringVector::iterator sit;
+	ClassType class_type;
+	string file_type;
+	WebType webType;
+
+	SourceFileList::iterator its;
 	for (its = mySourceFile->begin(); its != mySourceFile->end(); its++)
 	{
 		if (filesToPrint != NULL && filesToPrint->size() > 0)
@@ -173,10 +261,10 @@ int PrintCountResults( CounterForEachLangType & CounterForEachLanguage,
 
 			if (webType == WEB_PHP)
 			{
-				results r_htm;
-				results r_js;
-				results r_vbs;
-				results r_php;
+				webLineCounts r_htm;
+				webLineCounts r_js;
+				webLineCounts r_vbs;
+				webLineCounts r_php;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -321,10 +409,10 @@ int PrintCountResults( CounterForEachLangType & CounterForEachLanguage,
 			}
 			else if (webType == WEB_JSP)
 			{
-				results r_htm;
-				results r_js;
-				results r_vbs;
-				results r_java;
+				webLineCounts r_htm;
+				webLineCounts r_js;
+				webLineCounts r_vbs;
+				webLineCounts r_java;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -469,12 +557,12 @@ int PrintCountResults( CounterForEachLangType & CounterForEachLanguage,
 			}
 			else if (webType == WEB_ASP)
 			{
-				results r_htm;
-				results r_jsc;
-				results r_vbsc;
-				results r_jss;
-				results r_vbss;
-				results r_css;
+				webLineCounts r_htm;
+				webLineCounts r_jsc;
+				webLineCounts r_vbsc;
+				webLineCounts r_jss;
+				webLineCounts r_vbss;
+				webLineCounts r_css;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -656,10 +744,10 @@ int PrintCountResults( CounterForEachLangType & CounterForEachLanguage,
 			}
 			else if (webType == WEB_XML)
 			{
-				results r_xml;
-				results r_js;
-				results r_vbs;
-				results r_cs;
+				webLineCounts r_xml;
+				webLineCounts r_js;
+				webLineCounts r_vbs;
+				webLineCounts r_cs;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -799,12 +887,12 @@ int PrintCountResults( CounterForEachLangType & CounterForEachLanguage,
 			}
 			else if (webType == WEB_CFM)
 			{
-				results r_htm;
-				results r_js;
-				results r_vbs;
-				results r_sql;
-				results r_cfm;
-				results r_cfs;
+				webLineCounts r_htm;
+				webLineCounts r_js;
+				webLineCounts r_vbs;
+				webLineCounts r_sql;
+				webLineCounts r_cfm;
+				webLineCounts r_cfs;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -987,10 +1075,10 @@ int PrintCountResults( CounterForEachLangType & CounterForEachLanguage,
 			else
 			{
 				webType = WEB_HTM;
-				results r_htm;
-				results r_js;
-				results r_vbs;
-				results r_cs;
+				webLineCounts r_htm;
+				webLineCounts r_js;
+				webLineCounts r_vbs;
+				webLineCounts r_cs;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -1254,6 +1342,31 @@ int PrintCountResults( CounterForEachLangType & CounterForEachLanguage,
 		}
 	}
 
+	return 1;
+}
+
+/*!
+* Prints the summary of the counting results to each language report file and closes them.
+*
+* \param total totals of languages other than WEB
+* \param webtotal totals of WEB languages
+* \param useListA use file list A? (otherwise use list B)
+* \param outputFileNamePrePend name to prepend to the output file
+* \param filesToPrint list of files to include or exclude
+* \param excludeFiles exclude files? (if true excludes files in filesToPrint; if false includes only files in filesToPrint)
+*
+* \return method status
+*/
+int PrintCountTotalsResults( CounterForEachLangType & CounterForEachLanguage,
+						TotalValueMap &total, WebTotalValueMap &webtotal,
+						const bool useListA, const string &outputFileNamePrePend,
+						StringVector *filesToPrint, const bool excludeFiles )
+{
+	ofstream* pout     = NULL;
+	ofstream* pout_csv = NULL;
+	string file_type;
+	CWebCounter *webCounter;
+
 	// display summary for WEB languages
 	for (WebTotalValueMap::iterator itto = webtotal.begin(); itto != webtotal.end(); itto++)
 	{
@@ -3114,6 +3227,164 @@ int PrintCountResults( CounterForEachLangType & CounterForEachLanguage,
 	return 1;
 }
 
+/*!
+* Prints the counting results of files as soon as they are counted (-stream).
+* Adds the counts of the files to the language counters and to the totals kept for the summary.
+* The files are then freed; only their complexity rows are kept if complexity results are printed later.
+*
+* \param mySourceFile list holding only the files counted since the last call (emptied)
+* \param useListA use file list A? (otherwise use list B)
+*/
+void PrintCountResultsStreamed( CounterForEachLangType & CounterForEachLanguage,
+								SourceFileList * mySourceFile, const bool useListA )
+{
+	UpdateCounterCounts( CounterForEachLanguage, mySourceFile, useListA, false );
+
+	PrintCountFileResults( CounterForEachLanguage, mySourceFile, streamTotal, streamWebTotal,
+							"", (useListA) ? &duplicateFilesInA2 : &duplicateFilesInB2 );
+
+	// complexity reports are sized from all files, their rows are kept in a temporary file until then
+	if (print_cmplx)
+		WriteStreamedComplexity(mySourceFile);
+
+	// the files are not kept in the list, so they are counted here for the summary
+	g_stream_file_count += (unsigned int)mySourceFile->size();
+	mySourceFile->clear();
+}
+
+/*!
+* Writes the complexity rows of files to the temporary file read back by the complexity reports (-stream).
+* The counts of embedded files are added to those of their file, as when the reports are printed.
+*
+* \param mySourceFile list holding only the files counted since the last call
+*/
+static void WriteStreamedComplexity(SourceFileList *mySourceFile)
+{
+	if (!streamCplxRows.is_open())
+	{
+		string cplxRowsFileName = outDir + STREAM_CPLX_FILE;
+		streamCplxRows.open(cplxRowsFileName.c_str(), ios::in | ios::out | ios::trunc | ios::binary);
+		if (!streamCplxRows.is_open())
+		{
+			string err = "Error: Unable to create file (";
+			err += cplxRowsFileName;
+			err += "). Complexity results are not printed";
+			userIF->AddError(err, false, 1);
+			print_cmplx = false;
+			return;
+		}
+	}
+
+	size_t i;
+	for (SourceFileList::iterator itt2 = mySourceFile->begin(); itt2 != mySourceFile->end(); itt2++)
+	{
+		if (itt2->second.cmplx_cycfunct_count.size() > 0)
+			streamCplxCycFound = true;
+		if ( itt2->second.file_name_isEmbedded == true )
+			continue;
+
+		SourceFileList::iterator last = SumEmbeddedComplexity(*mySourceFile, itt2);
+		results &r = itt2->second;
+		if (r.cmplx_nestloop_count.size() > streamCplxLoopCol)
+			streamCplxLoopCol = r.cmplx_nestloop_count.size();
+
+		// the functions of WEB files are those of their embedded files
+		const filemap *functions = &r.cmplx_cycfunct_count;
+		filemap webFunctions;
+		if (r.class_type == WEB)
+		{
+			for (SourceFileList::iterator it = itt2; it != last; )
+			{
+				it++;
+				webFunctions.insert(webFunctions.end(), it->second.cmplx_cycfunct_count.begin(), it->second.cmplx_cycfunct_count.end());
+			}
+			functions = &webFunctions;
+		}
+
+		streamCplxRows << r.file_name << '\n';
+		streamCplxRows << r.cmplx_math_lines << ' ' << r.cmplx_trig_lines << ' ' << r.cmplx_logarithm_lines << ' '
+			<< r.cmplx_calc_lines << ' ' << r.cmplx_cond_lines << ' ' << r.cmplx_logic_lines << ' '
+			<< r.cmplx_preproc_lines << ' ' << r.cmplx_assign_lines << ' ' << r.cmplx_pointer_lines << ' '
+			<< r.cmplx_nestloop_count.size();
+		for (i = 0; i < r.cmplx_nestloop_count.size(); i++)
+			streamCplxRows << ' ' << r.cmplx_nestloop_count[i];
+		streamCplxRows << ' ' << functions->size() << '\n';
+		for (i = 0; i < functions->size(); i++)
+			streamCplxRows << (*functions)[i].lineNumber << ' ' << (*functions)[i].line << '\n';
+
+		itt2 = last;
+	}
+}
+
+/*!
+* Reads back the next complexity row written by WriteStreamedComplexity (-stream).
+*
+* \param rowList list emptied and given the counts and functions of the file read
+*
+* \return was a row read?
+*/
+static bool ReadStreamedComplexity(SourceFileList &rowList)
+{
+	SourceFileElement row;
+	results &r = row.second;
+	size_t i, n;
+
+	rowList.clear();
+	if (!getline(streamCplxRows, r.file_name))
+		return false;
+
+	streamCplxRows >> r.cmplx_math_lines >> r.cmplx_trig_lines >> r.cmplx_logarithm_lines
+		>> r.cmplx_calc_lines >> r.cmplx_cond_lines >> r.cmplx_logic_lines
+		>> r.cmplx_preproc_lines >> r.cmplx_assign_lines >> r.cmplx_pointer_lines >> n;
+	r.cmplx_nestloop_count.resize(n);
+	for (i = 0; i < n; i++)
+		streamCplxRows >> r.cmplx_nestloop_count[i];
+	streamCplxRows >> n;
+	streamCplxRows.get();
+	r.cmplx_cycfunct_count.resize(n);
+	for (i = 0; i < n; i++)
+	{
+		streamCplxRows >> r.cmplx_cycfunct_count[i].lineNumber;
+		streamCplxRows.get();
+		getline(streamCplxRows, r.cmplx_cycfunct_count[i].line);
+	}
+	if (streamCplxRows.fail())
+		return false;
+
+	rowList.take_back(row);
+	return true;
+}
+
+/*!
+* Closes and deletes the temporary file of complexity rows (-stream).
+*/
+static void CloseStreamedComplexity()
+{
+	if (!streamCplxRows.is_open())
+		return;
+	streamCplxRows.close();
+	string cplxRowsFileName = outDir + STREAM_CPLX_FILE;
+	remove(cplxRowsFileName.c_str());
+	streamCplxLoopCol = 0;
+	streamCplxCycFound = false;
+}
+
+/*!
+* Prints the summary of the counting results printed by PrintCountResultsStreamed (-stream).
+*
+* \param useListA use file list A? (otherwise use list B)
+*
+* \return method status
+*/
+int PrintStreamedCountTotals( CounterForEachLangType & CounterForEachLanguage, const bool useListA )
+{
+	int retVal = PrintCountTotalsResults( CounterForEachLanguage, streamTotal, streamWebTotal, useListA,
+										"", (useListA) ? &duplicateFilesInA2 : &duplicateFilesInB2 );
+	streamTotal.clear();
+	streamWebTotal.clear();
+	return retVal;
+}
+
 /*!
 * Prints the total counting results.
 *
@@ -3674,10 +3945,10 @@ int PrintTotalCountResults( CounterForEachLangType & CounterForEachLanguage,
 
 			if (webType == WEB_PHP)
 			{
-				results r_htm;
-				results r_js;
-				results r_vbs;
-				results r_php;
+				webLineCounts r_htm;
+				webLineCounts r_js;
+				webLineCounts r_vbs;
+				webLineCounts r_php;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -3935,10 +4206,10 @@ int PrintTotalCountResults( CounterForEachLangType & CounterForEachLanguage,
 			}
 			else if (webType == WEB_JSP)
 			{
-				results r_htm;
-				results r_js;
-				results r_vbs;
-				results r_java;
+				webLineCounts r_htm;
+				webLineCounts r_js;
+				webLineCounts r_vbs;
+				webLineCounts r_java;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -4196,12 +4467,12 @@ int PrintTotalCountResults( CounterForEachLangType & CounterForEachLanguage,
 			}
 			else if (webType == WEB_ASP)
 			{
-				results r_htm;
-				results r_jsc;
-				results r_vbsc;
-				results r_jss;
-				results r_vbss;
-				results r_css;
+				webLineCounts r_htm;
+				webLineCounts r_jsc;
+				webLineCounts r_vbsc;
+				webLineCounts r_jss;
+				webLineCounts r_vbss;
+				webLineCounts r_css;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -4489,10 +4760,10 @@ int PrintTotalCountResults( CounterForEachLangType & CounterForEachLanguage,
 			}
 			else if (webType == WEB_XML)
 			{
-				results r_xml;
-				results r_js;
-				results r_vbs;
-				results r_cs;
+				webLineCounts r_xml;
+				webLineCounts r_js;
+				webLineCounts r_vbs;
+				webLineCounts r_cs;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -4746,12 +5017,12 @@ int PrintTotalCountResults( CounterForEachLangType & CounterForEachLanguage,
 			}
 			else if (webType == WEB_CFM)
 			{
-				results r_htm;
-				results r_js;
-				results r_vbs;
-				results r_sql;
-				results r_cfm;
-				results r_cfs;
+				webLineCounts r_htm;
+				webLineCounts r_js;
+				webLineCounts r_vbs;
+				webLineCounts r_sql;
+				webLineCounts r_cfm;
+				webLineCounts r_cfs;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -5040,10 +5311,10 @@ int PrintTotalCountResults( CounterForEachLangType & CounterForEachLanguage,
 			else
 			{
 				webType = WEB_HTM;
-				results r_htm;
-				results r_js;
-				results r_vbs;
-				results r_cs;
+				webLineCounts r_htm;
+				webLineCounts r_js;
+				webLineCounts r_vbs;
+				webLineCounts r_cs;
 				for (SourceFileList::iterator i = startpos; i!= endpos; i++)
 				{
 					switch (i->second.class_type)
@@ -6292,6 +6563,153 @@ int PrintCountSummary( CounterForEachLangType & CounterForEachLanguage,
 }
 
 
+/*!
+* Adds the complexity counts of the embedded files following a file to its counts.
+*
+* \param fileList list of files
+* \param itt2 file
+*
+* \return position of the last embedded file of the file (the file itself if it has none)
+*/
+static SourceFileList::iterator SumEmbeddedComplexity(SourceFileList &fileList, SourceFileList::iterator itt2)
+{
+	size_t i;
+
+	// do not print temporary files, but sum all of their counts
+	SourceFileList::iterator it = itt2;
+	for (it++; it != fileList.end(); it++)
+	{
+		if ( it->second.file_name_isEmbedded == false ) 
+			break;
+		itt2->second.cmplx_math_lines += it->second.cmplx_math_lines;
+		itt2->second.cmplx_trig_lines += it->second.cmplx_trig_lines;
+		itt2->second.cmplx_logarithm_lines += it->second.cmplx_logarithm_lines;
+		itt2->second.cmplx_calc_lines += it->second.cmplx_calc_lines;
+		itt2->second.cmplx_cond_lines += it->second.cmplx_cond_lines;
+		itt2->second.cmplx_logic_lines += it->second.cmplx_logic_lines;
+		itt2->second.cmplx_preproc_lines += it->second.cmplx_preproc_lines;
+		itt2->second.cmplx_assign_lines += it->second.cmplx_assign_lines;
+		itt2->second.cmplx_pointer_lines += it->second.cmplx_pointer_lines;
+
+		for (i = 0; i < it->second.cmplx_nestloop_count.size(); i++)
+		{
+			if (itt2->second.cmplx_nestloop_count.size() < i + 1)
+				itt2->second.cmplx_nestloop_count.push_back(it->second.cmplx_nestloop_count[i]);
+			else
+				itt2->second.cmplx_nestloop_count[i] += it->second.cmplx_nestloop_count[i];
+		}
+	}
+
+	return --it;
+}
+
+/*!
+* Prints the complexity counts of a file.
+*
+* \param cplxOutputFile complexity output file
+* \param cplxOutputFileCSV complexity CSV output file
+* \param r counts of the file (including its embedded files)
+* \param loopCol number of nested loop columns
+* \param useListA use file list A? (otherwise use list B)
+* \param printDuplicates print duplicate files? (otherwise print unique files)
+* \param cmplxTotal totals the counts are added to
+*/
+static void PrintComplexityFileRow(ofstream &cplxOutputFile, ofstream &cplxOutputFileCSV, const results &r,
+								   size_t loopCol, bool useListA, bool printDuplicates, results &cmplxTotal)
+{
+	size_t i;
+	string nestedLoops;
+
+	if (print_legacy)
+	{
+		if (useListA)
+			cplxOutputFile << "A ";
+		else
+			cplxOutputFile << "B ";
+		if (printDuplicates)
+			cplxOutputFile << " X ";
+		else if (SourceFileB.size() > 0 && !r.matched)
+		{
+			if (useListA)
+				cplxOutputFile << " D ";
+			else
+				cplxOutputFile << " N ";
+		}
+		else
+			cplxOutputFile << " C ";
+		cplxOutputFile.width(8);	cplxOutputFile << r.cmplx_cond_lines;
+		cplxOutputFile.width(8);	cplxOutputFile << r.cmplx_logic_lines;
+		cplxOutputFile.width(8);	cplxOutputFile << r.cmplx_trig_lines;
+		cplxOutputFile.width(8);	cplxOutputFile << r.cmplx_logarithm_lines;
+		cplxOutputFile.width(8);	cplxOutputFile << r.cmplx_preproc_lines;
+		cplxOutputFile.width(8);	cplxOutputFile << r.cmplx_math_lines + r.cmplx_calc_lines;
+		cplxOutputFile.width(8);	cplxOutputFile << r.cmplx_assign_lines;
+		cplxOutputFile.width(8);	cplxOutputFile << r.cmplx_pointer_lines;
+
+		nestedLoops = "";
+		if (r.cmplx_nestloop_count.size() > 0)
+		{
+			std::stringstream ss;
+			ss << r.cmplx_nestloop_count[0];
+			for (i = 1; i < r.cmplx_nestloop_count.size(); i++)
+				ss << "," << r.cmplx_nestloop_count[i];
+			nestedLoops = ss.str();
+		}
+		cplxOutputFile << "  ";
+		cplxOutputFile.width(28);		cplxOutputFile.setf(ios::left);
+		cplxOutputFile << nestedLoops;	cplxOutputFile.unsetf(ios::left);
+		cplxOutputFile << "  ";
+		cplxOutputFile << r.file_name << endl;
+	}
+	else if (print_ascii)
+	{
+		cplxOutputFile.width(5);	cplxOutputFile << r.cmplx_math_lines;
+		cplxOutputFile.width(8);	cplxOutputFile << r.cmplx_trig_lines;
+		cplxOutputFile.width(11);	cplxOutputFile << r.cmplx_logarithm_lines;
+		cplxOutputFile.width(11);	cplxOutputFile << r.cmplx_calc_lines;
+		cplxOutputFile.width(11);	cplxOutputFile << r.cmplx_cond_lines;
+		cplxOutputFile.width(11);	cplxOutputFile << r.cmplx_logic_lines;
+		cplxOutputFile.width(11);	cplxOutputFile << r.cmplx_preproc_lines;
+		cplxOutputFile.width(11);	cplxOutputFile << r.cmplx_assign_lines;
+		cplxOutputFile.width(11);	cplxOutputFile << r.cmplx_pointer_lines;
+		for (i = 0; i < r.cmplx_nestloop_count.size(); i++)
+		{
+			cplxOutputFile.width(11);
+			cplxOutputFile << r.cmplx_nestloop_count[i];
+		}
+		for (i = r.cmplx_nestloop_count.size(); i < loopCol; i++)
+			cplxOutputFile << "          0";
+		cplxOutputFile << "       " << r.file_name << endl;
+	}
+	if (print_csv)
+	{
+		cplxOutputFileCSV << r.cmplx_math_lines << ",";
+		cplxOutputFileCSV << r.cmplx_trig_lines << ",";
+		cplxOutputFileCSV << r.cmplx_logarithm_lines << ",";
+		cplxOutputFileCSV << r.cmplx_calc_lines << ",";
+		cplxOutputFileCSV << r.cmplx_cond_lines << ",";
+		cplxOutputFileCSV << r.cmplx_logic_lines << ",";
+		cplxOutputFileCSV << r.cmplx_preproc_lines << ",";
+		cplxOutputFileCSV << r.cmplx_assign_lines << ",";
+		cplxOutputFileCSV << r.cmplx_pointer_lines << ",";
+		for (i = 0; i < r.cmplx_nestloop_count.size(); i++)
+			cplxOutputFileCSV << r.cmplx_nestloop_count[i] << ",";
+		for (i = r.cmplx_nestloop_count.size(); i < loopCol; i++)
+			cplxOutputFileCSV << "0,";
+		cplxOutputFileCSV << r.file_name << endl;
+	}
+
+	cmplxTotal.cmplx_math_lines += r.cmplx_math_lines;
+	cmplxTotal.cmplx_trig_lines += r.cmplx_trig_lines;
+	cmplxTotal.cmplx_logarithm_lines += r.cmplx_logarithm_lines;
+	cmplxTotal.cmplx_calc_lines += r.cmplx_calc_lines;
+	cmplxTotal.cmplx_cond_lines += r.cmplx_cond_lines;
+	cmplxTotal.cmplx_logic_lines += r.cmplx_logic_lines;
+	cmplxTotal.cmplx_preproc_lines += r.cmplx_preproc_lines;
+	cmplxTotal.cmplx_assign_lines += r.cmplx_assign_lines;
+	cmplxTotal.cmplx_pointer_lines += r.cmplx_pointer_lines;
+}
+
 /*!
 * Prints the complexity results.
 *
@@ -6320,7 +6738,6 @@ int PrintComplexityResults( CounterForEachLangType & CounterForEachLanguage,
 	string dots = "......................";
 	string COL_SP = "                           ";
 	string SP_BW_COL = "    ";
-	string nestedLoops = "";
 	SourceFileList* mySourceFile = (useListA) ? &SourceFileA : &SourceFileB;
 	size_t loopCol = 0;
 
@@ -6355,6 +6772,8 @@ int PrintComplexityResults( CounterForEachLangType & CounterForEachLanguage,
 	cmplxTotal.cmplx_pointer_lines = 0;
 
 	// check for counts
+	if (g_stream_results)
+		loopCol = streamCplxLoopCol;
 	for (SourceFileList::iterator itt2 = mySourceFile->begin(); itt2 != mySourceFile->end(); itt2++)
 	{
 		if ((!printDuplicates && !itt2->second.duplicate) || (printDuplicates && itt2->second.duplicate))
@@ -6426,128 +6845,28 @@ int PrintComplexityResults( CounterForEachLangType & CounterForEachLanguage,
 	}
 
 	// print counts for each file
-	for (SourceFileList::iterator itt2 = mySourceFile->begin(); itt2 != mySourceFile->end(); itt2++)
+	if (g_stream_results)
 	{
-		if ( itt2->second.file_name_isEmbedded == true )
-			continue;
-
-		if ((!printDuplicates && !itt2->second.duplicate) || (printDuplicates && itt2->second.duplicate))
+		// the rows of the files printed as they were counted are read back (-stream)
+		SourceFileList rowList;
+		streamCplxRows.clear();
+		streamCplxRows.seekg(0, ios::beg);
+		while (ReadStreamedComplexity(rowList))
+			PrintComplexityFileRow(cplxOutputFile, cplxOutputFileCSV, rowList.begin()->second, loopCol, useListA, printDuplicates, cmplxTotal);
+	}
+	else
+	{
+		for (SourceFileList::iterator itt2 = mySourceFile->begin(); itt2 != mySourceFile->end(); itt2++)
 		{
-			// do not print temporary files, but sum all of their counts
-			SourceFileList::iterator it = itt2;
-			for (it++; it != mySourceFile->end(); it++)
-			{
-				if ( it->second.file_name_isEmbedded == false ) 
-					break;
-				itt2->second.cmplx_math_lines += it->second.cmplx_math_lines;
-				itt2->second.cmplx_trig_lines += it->second.cmplx_trig_lines;
-				itt2->second.cmplx_logarithm_lines += it->second.cmplx_logarithm_lines;
-				itt2->second.cmplx_calc_lines += it->second.cmplx_calc_lines;
-				itt2->second.cmplx_cond_lines += it->second.cmplx_cond_lines;
-				itt2->second.cmplx_logic_lines += it->second.cmplx_logic_lines;
-				itt2->second.cmplx_preproc_lines += it->second.cmplx_preproc_lines;
-				itt2->second.cmplx_assign_lines += it->second.cmplx_assign_lines;
-				itt2->second.cmplx_pointer_lines += it->second.cmplx_pointer_lines;
-
-				for (i = 0; i < it->second.cmplx_nestloop_count.size(); i++)
-				{
-					if (itt2->second.cmplx_nestloop_count.size() < i + 1)
-						itt2->second.cmplx_nestloop_count.push_back(it->second.cmplx_nestloop_count[i]);
-					else
-						itt2->second.cmplx_nestloop_count[i] += it->second.cmplx_nestloop_count[i];
-				}
-			}
+			if ( itt2->second.file_name_isEmbedded == true )
+				continue;
 
-			if (print_legacy)
+			if ((!printDuplicates && !itt2->second.duplicate) || (printDuplicates && itt2->second.duplicate))
 			{
-				if (useListA)
-					cplxOutputFile << "A ";
-				else
-					cplxOutputFile << "B ";
-				if (printDuplicates)
-					cplxOutputFile << " X ";
-				else if (SourceFileB.size() > 0 && !itt2->second.matched)
-				{
-					if (useListA)
-						cplxOutputFile << " D ";
-					else
-						cplxOutputFile << " N ";
-				}
-				else
-					cplxOutputFile << " C ";
-				cplxOutputFile.width(8);	cplxOutputFile << itt2->second.cmplx_cond_lines;
-				cplxOutputFile.width(8);	cplxOutputFile << itt2->second.cmplx_logic_lines;
-				cplxOutputFile.width(8);	cplxOutputFile << itt2->second.cmplx_trig_lines;
-				cplxOutputFile.width(8);	cplxOutputFile << itt2->second.cmplx_logarithm_lines;
-				cplxOutputFile.width(8);	cplxOutputFile << itt2->second.cmplx_preproc_lines;
-				cplxOutputFile.width(8);	cplxOutputFile << itt2->second.cmplx_math_lines + itt2->second.cmplx_calc_lines;
-				cplxOutputFile.width(8);	cplxOutputFile << itt2->second.cmplx_assign_lines;
-				cplxOutputFile.width(8);	cplxOutputFile << itt2->second.cmplx_pointer_lines;
-
-				nestedLoops = "";
-				if (itt2->second.cmplx_nestloop_count.size() > 0)
-				{
-					std::stringstream ss;
-					ss << itt2->second.cmplx_nestloop_count[0];
-					for (i = 1; i < itt2->second.cmplx_nestloop_count.size(); i++)
-						ss << "," << itt2->second.cmplx_nestloop_count[i];
-					nestedLoops = ss.str();
-				}
-				cplxOutputFile << "  ";
-				cplxOutputFile.width(28);		cplxOutputFile.setf(ios::left);
-				cplxOutputFile << nestedLoops;	cplxOutputFile.unsetf(ios::left);
-				cplxOutputFile << "  ";
-				cplxOutputFile << itt2->second.file_name << endl;
-			}
-			else if (print_ascii)
-			{
-				cplxOutputFile.width(5);	cplxOutputFile << itt2->second.cmplx_math_lines;
-				cplxOutputFile.width(8);	cplxOutputFile << itt2->second.cmplx_trig_lines;
-				cplxOutputFile.width(11);	cplxOutputFile << itt2->second.cmplx_logarithm_lines;
-				cplxOutputFile.width(11);	cplxOutputFile << itt2->second.cmplx_calc_lines;
-				cplxOutputFile.width(11);	cplxOutputFile << itt2->second.cmplx_cond_lines;
-				cplxOutputFile.width(11);	cplxOutputFile << itt2->second.cmplx_logic_lines;
-				cplxOutputFile.width(11);	cplxOutputFile << itt2->second.cmplx_preproc_lines;
-				cplxOutputFile.width(11);	cplxOutputFile << itt2->second.cmplx_assign_lines;
-				cplxOutputFile.width(11);	cplxOutputFile << itt2->second.cmplx_pointer_lines;
-				for (i = 0; i < itt2->second.cmplx_nestloop_count.size(); i++)
-				{
-					cplxOutputFile.width(11);
-					cplxOutputFile << itt2->second.cmplx_nestloop_count[i];
-				}
-				for (i = itt2->second.cmplx_nestloop_count.size(); i < loopCol; i++)
-					cplxOutputFile << "          0";
-				cplxOutputFile << "       " << itt2->second.file_name << endl;
+				SourceFileList::iterator last = SumEmbeddedComplexity(*mySourceFile, itt2);
+				PrintComplexityFileRow(cplxOutputFile, cplxOutputFileCSV, itt2->second, loopCol, useListA, printDuplicates, cmplxTotal);
+				itt2 = last;
 			}
-			if (print_csv)
-			{
-				cplxOutputFileCSV << itt2->second.cmplx_math_lines << ",";
-				cplxOutputFileCSV << itt2->second.cmplx_trig_lines << ",";
-				cplxOutputFileCSV << itt2->second.cmplx_logarithm_lines << ",";
-				cplxOutputFileCSV << itt2->second.cmplx_calc_lines << ",";
-				cplxOutputFileCSV << itt2->second.cmplx_cond_lines << ",";
-				cplxOutputFileCSV << itt2->second.cmplx_logic_lines << ",";
-				cplxOutputFileCSV << itt2->second.cmplx_preproc_lines << ",";
-				cplxOutputFileCSV << itt2->second.cmplx_assign_lines << ",";
-				cplxOutputFileCSV << itt2->second.cmplx_pointer_lines << ",";
-				for (i = 0; i < itt2->second.cmplx_nestloop_count.size(); i++)
-					cplxOutputFileCSV << itt2->second.cmplx_nestloop_count[i] << ",";
-				for (i = itt2->second.cmplx_nestloop_count.size(); i < loopCol; i++)
-					cplxOutputFileCSV << "0,";
-				cplxOutputFileCSV << itt2->second.file_name << endl;
-			}
-
-			cmplxTotal.cmplx_math_lines += itt2->second.cmplx_math_lines;
-			cmplxTotal.cmplx_trig_lines += itt2->second.cmplx_trig_lines;
-			cmplxTotal.cmplx_logarithm_lines += itt2->second.cmplx_logarithm_lines;
-			cmplxTotal.cmplx_calc_lines += itt2->second.cmplx_calc_lines;
-			cmplxTotal.cmplx_cond_lines += itt2->second.cmplx_cond_lines;
-			cmplxTotal.cmplx_logic_lines += itt2->second.cmplx_logic_lines;
-			cmplxTotal.cmplx_preproc_lines += itt2->second.cmplx_preproc_lines;
-			cmplxTotal.cmplx_assign_lines += itt2->second.cmplx_assign_lines;
-			cmplxTotal.cmplx_pointer_lines += itt2->second.cmplx_pointer_lines;
-
-			itt2 = --it;
 		}
 	}
 
@@ -6954,9 +7273,226 @@ int PrintComplexityResults( CounterForEachLangType & CounterForEachLanguage,
 	// print cyclomatic complexity
 	PrintCyclomaticComplexity(useListA, outputFileNamePrePend, printDuplicates);
 
+	if (g_stream_results)
+		CloseStreamedComplexity();
+
 	return 1;
 }
 
+/*!
+* Prints the cyclomatic complexity of a file.
+*
+* \param cycCplxOutputFile cyclomatic complexity output file
+* \param cycCplxOutputFileCSV cyclomatic complexity CSV output file
+* \param fileList list of files
+* \param itt2 file (WEB files are counted from their embedded files)
+* \param tcc total cyclomatic complexity the file is added to
+* \param ntfunc total number of functions the file is added to
+*/
+static void PrintCyclomaticFileRow(ofstream &cycCplxOutputFile, ofstream &cycCplxOutputFileCSV,
+								   SourceFileList &fileList, SourceFileList::iterator itt2,
+								   unsigned int &tcc, unsigned int &ntfunc)
+{
+	unsigned int fcc = 0, nffunc = 0;
+	float afcc = 0.;
+	filemap::iterator it;
+
+	if (itt2->second.class_type == WEB)
+	{
+		// sum embedded web files
+		SourceFileList::iterator startpos = itt2;
+		SourceFileList::iterator endpos = ++startpos;
+		for (; endpos != fileList.end(); endpos++)
+		{
+			if ( endpos->second.file_name_isEmbedded == false )
+				break;
+			for (it = endpos->second.cmplx_cycfunct_count.begin(); it != endpos->second.cmplx_cycfunct_count.end(); it++)
+			{
+				fcc += (*it).lineNumber;
+				nffunc++;
+			}
+		}
+	}
+	else
+	{
+		for (it = itt2->second.cmplx_cycfunct_count.begin(); it != itt2->second.cmplx_cycfunct_count.end(); it++)
+		{
+			fcc += (*it).lineNumber;
+			nffunc++;
+		}
+	}
+	if (fcc < 1)
+		return;
+
+	tcc += fcc;
+	ntfunc += nffunc;
+	if (nffunc > 0)
+		afcc = (float)fcc / (float)nffunc;
+
+	if (print_ascii || print_legacy)
+	{
+		cycCplxOutputFile.setf(ofstream::right);
+		cycCplxOutputFile.width(10);
+		cycCplxOutputFile << fcc;
+		cycCplxOutputFile.setf(ios::fixed,ios::floatfield);
+		cycCplxOutputFile.width(10);
+		cycCplxOutputFile.precision(2);
+		cycCplxOutputFile << afcc;
+		cycCplxOutputFile.unsetf(ofstream::right);
+		cycCplxOutputFile << "    ";
+		cycCplxOutputFile.setf(ofstream::left);
+		cycCplxOutputFile.width(9);
+		if (afcc <= 10.)
+			cycCplxOutputFile << "Low";
+		else if (afcc <= 20.)
+			cycCplxOutputFile << "Medium";
+		else if (afcc <= 50.)
+			cycCplxOutputFile << "High";
+		else
+			cycCplxOutputFile << "Very High";
+		cycCplxOutputFile.unsetf(ofstream::right);
+		cycCplxOutputFile.setf(ofstream::left);
+		cycCplxOutputFile << "   |   " << itt2->second.file_name << endl;
+	}
+	if (print_csv)
+	{
+		cycCplxOutputFileCSV << fcc << ",";
+		cycCplxOutputFileCSV.setf(ios::fixed,ios::floatfield);
+		cycCplxOutputFileCSV.width(10);
+		cycCplxOutputFileCSV.precision(2);
+		cycCplxOutputFileCSV << afcc << ",";
+		if (afcc <= 10.)
+			cycCplxOutputFileCSV << "Low,";
+		else if (afcc <= 20.)
+			cycCplxOutputFileCSV << "Medium,";
+		else if (afcc <= 50.)
+			cycCplxOutputFileCSV << "High,";
+		else
+			cycCplxOutputFileCSV << "Very High,";
+		cycCplxOutputFileCSV << itt2->second.file_name << endl;
+	}
+}
+
+/*!
+* Prints the cyclomatic complexity of each function of a file.
+*
+* \param cycCplxOutputFile cyclomatic complexity output file
+* \param cycCplxOutputFileCSV cyclomatic complexity CSV output file
+* \param fileList list of files
+* \param itt2 file (the functions of WEB files are those of their embedded files)
+*/
+static void PrintCyclomaticFunctionRows(ofstream &cycCplxOutputFile, ofstream &cycCplxOutputFileCSV,
+										SourceFileList &fileList, SourceFileList::iterator itt2)
+{
+	filemap::iterator it;
+
+	if (itt2->second.class_type == WEB)
+	{
+		// sum embedded web files
+		SourceFileList::iterator startpos = itt2;
+		SourceFileList::iterator endpos = ++startpos;
+		if (print_ascii || print_legacy)
+		{
+			for (; endpos != fileList.end(); endpos++)
+			{
+				if ( endpos->second.file_name_isEmbedded == false )
+					break;
+				for (it = endpos->second.cmplx_cycfunct_count.begin(); it != endpos->second.cmplx_cycfunct_count.end(); it++)
+				{
+					cycCplxOutputFile.setf(ofstream::right);
+					cycCplxOutputFile.width(10);
+					cycCplxOutputFile << (*it).lineNumber;
+					cycCplxOutputFile.unsetf(ofstream::right);
+					cycCplxOutputFile << "   ";
+					cycCplxOutputFile.setf(ofstream::left);
+					cycCplxOutputFile.width(9);
+					if ((*it).lineNumber <= 10)
+						cycCplxOutputFile << "Low";
+					else if ((*it).lineNumber <= 20)
+						cycCplxOutputFile << "Medium";
+					else if ((*it).lineNumber <= 50)
+						cycCplxOutputFile << "High";
+					else
+						cycCplxOutputFile << "Very High";
+					cycCplxOutputFile.unsetf(ofstream::right);
+					cycCplxOutputFile.setf(ofstream::left);
+					cycCplxOutputFile << "   ";
+					cycCplxOutputFile.width(60);
+					cycCplxOutputFile << (*it).line;
+					cycCplxOutputFile << "   |   " << itt2->second.file_name << endl;
+				}
+			}
+		}
+		if (print_csv)
+		{
+			for (; endpos != fileList.end(); endpos++)
+			{
+				if ( endpos->second.file_name_isEmbedded == false )
+					break;
+				for (it = endpos->second.cmplx_cycfunct_count.begin(); it != endpos->second.cmplx_cycfunct_count.end(); it++)
+				{
+					cycCplxOutputFileCSV << (*it).lineNumber << ",";
+					if ((*it).lineNumber <= 10)
+						cycCplxOutputFileCSV << "Low,";
+					else if ((*it).lineNumber <= 20)
+						cycCplxOutputFileCSV << "Medium,";
+					else if ((*it).lineNumber <= 50)
+						cycCplxOutputFileCSV << "High,";
+					else
+						cycCplxOutputFileCSV << "Very High,";
+					cycCplxOutputFileCSV << (*it).line << "," << itt2->second.file_name << endl;
+				}
+			}
+		}
+	}
+	else
+	{
+		if (print_ascii || print_legacy)
+		{
+			for (it = itt2->second.cmplx_cycfunct_count.begin(); it != itt2->second.cmplx_cycfunct_count.end(); it++)
+			{
+				cycCplxOutputFile.setf(ofstream::right);
+				cycCplxOutputFile.width(10);
+				cycCplxOutputFile << (*it).lineNumber;
+				cycCplxOutputFile.unsetf(ofstream::right);
+				cycCplxOutputFile << "   ";
+				cycCplxOutputFile.setf(ofstream::left);
+				cycCplxOutputFile.width(9);
+				if ((*it).lineNumber <= 10)
+					cycCplxOutputFile << "Low";
+				else if ((*it).lineNumber <= 20)
+					cycCplxOutputFile << "Medium";
+				else if ((*it).lineNumber <= 50)
+					cycCplxOutputFile << "High";
+				else
+					cycCplxOutputFile << "Very High";
+				cycCplxOutputFile.unsetf(ofstream::right);
+				cycCplxOutputFile.setf(ofstream::left);
+				cycCplxOutputFile << "   ";
+				cycCplxOutputFile.width(60);
+				cycCplxOutputFile << (*it).line;
+				cycCplxOutputFile << "   |   " << itt2->second.file_name << endl;
+			}
+		}
+		if (print_csv)
+		{
+			for (it = itt2->second.cmplx_cycfunct_count.begin(); it != itt2->second.cmplx_cycfunct_count.end(); it++)
+			{
+				cycCplxOutputFileCSV << (*it).lineNumber << ",";
+				if ((*it).lineNumber <= 10)
+					cycCplxOutputFileCSV << "Low,";
+				else if ((*it).lineNumber <= 20)
+					cycCplxOutputFileCSV << "Medium,";
+				else if ((*it).lineNumber <= 50)
+					cycCplxOutputFileCSV << "High,";
+				else
+					cycCplxOutputFileCSV << "Very High,";
+				cycCplxOutputFileCSV << (*it).line << "," << itt2->second.file_name << endl;
+			}
+		}
+	}
+}
+
 /*!
 * Prints the cyclomatic complexity results.
 *
@@ -6980,7 +7516,7 @@ int PrintCyclomaticComplexity(const bool useListA, const string &outputFileNameP
 	}
 
 	SourceFileList* mySourceFile = (useListA) ? &SourceFileA : &SourceFileB;
-	bool found = false;
+	bool found = (g_stream_results) ? streamCplxCycFound : false;
 
 	// check for counts
 	for (SourceFileList::iterator itt2 = mySourceFile->begin(); itt2 != mySourceFile->end(); itt2++)
@@ -7044,93 +7580,27 @@ int PrintCyclomaticComplexity(const bool useListA, const string &outputFileNameP
 	}
 
 	// print cyclomatic complexity for each file
-	unsigned int fcc, tcc, nffunc, ntfunc;
-	float afcc, atcc;
+	unsigned int tcc, ntfunc;
+	float atcc;
 	tcc = ntfunc = 0;
-	for (SourceFileList::iterator itt2 = mySourceFile->begin(); itt2 != mySourceFile->end(); itt2++)
+	if (g_stream_results)
 	{
-		if ( itt2->second.file_name_isEmbedded == true )
-			continue;
-
-		fcc = nffunc = 0;
-		afcc = 0.;
-		if ((!printDuplicates && !itt2->second.duplicate) || (printDuplicates && itt2->second.duplicate))
+		// the rows of the files printed as they were counted are read back (-stream)
+		SourceFileList rowList;
+		streamCplxRows.clear();
+		streamCplxRows.seekg(0, ios::beg);
+		while (ReadStreamedComplexity(rowList))
+			PrintCyclomaticFileRow(cycCplxOutputFile, cycCplxOutputFileCSV, rowList, rowList.begin(), tcc, ntfunc);
+	}
+	else
+	{
+		for (SourceFileList::iterator itt2 = mySourceFile->begin(); itt2 != mySourceFile->end(); itt2++)
 		{
-			filemap::iterator it;
-			if (itt2->second.class_type == WEB)
-			{
-				// sum embedded web files
-				SourceFileList::iterator startpos = itt2;
-				SourceFileList::iterator endpos = ++startpos;
-				for (; endpos != mySourceFile->end(); endpos++)
-				{
-					if ( endpos->second.file_name_isEmbedded == false )
-						break;
-					for (it = endpos->second.cmplx_cycfunct_count.begin(); it != endpos->second.cmplx_cycfunct_count.end(); it++)
-					{
-						fcc += (*it).lineNumber;
-						nffunc++;
-					}
-				}
-			}
-			else
-			{
-				for (it = itt2->second.cmplx_cycfunct_count.begin(); it != itt2->second.cmplx_cycfunct_count.end(); it++)
-				{
-					fcc += (*it).lineNumber;
-					nffunc++;
-				}
-			}
-			if (fcc < 1)
+			if ( itt2->second.file_name_isEmbedded == true )
 				continue;
 
-			tcc += fcc;
-			ntfunc += nffunc;
-			if (nffunc > 0)
-				afcc = (float)fcc / (float)nffunc;
-
-			if (print_ascii || print_legacy)
-			{
-				cycCplxOutputFile.setf(ofstream::right);
-				cycCplxOutputFile.width(10);
-				cycCplxOutputFile << fcc;
-				cycCplxOutputFile.setf(ios::fixed,ios::floatfield);
-				cycCplxOutputFile.width(10);
-				cycCplxOutputFile.precision(2);
-				cycCplxOutputFile << afcc;
-				cycCplxOutputFile.unsetf(ofstream::right);
-				cycCplxOutputFile << "    ";
-				cycCplxOutputFile.setf(ofstream::left);
-				cycCplxOutputFile.width(9);
-				if (afcc <= 10.)
-					cycCplxOutputFile << "Low";
-				else if (afcc <= 20.)
-					cycCplxOutputFile << "Medium";
-				else if (afcc <= 50.)
-					cycCplxOutputFile << "High";
-				else
-					cycCplxOutputFile << "Very High";
-				cycCplxOutputFile.unsetf(ofstream::right);
-				cycCplxOutputFile.setf(ofstream::left);
-				cycCplxOutputFile << "   |   " << itt2->second.file_name << endl;
-			}
-			if (print_csv)
-			{
-				cycCplxOutputFileCSV << fcc << ",";
-				cycCplxOutputFileCSV.setf(ios::fixed,ios::floatfield);
-				cycCplxOutputFileCSV.width(10);
-				cycCplxOutputFileCSV.precision(2);
-				cycCplxOutputFileCSV << afcc << ",";
-				if (afcc <= 10.)
-					cycCplxOutputFileCSV << "Low,";
-				else if (afcc <= 20.)
-					cycCplxOutputFileCSV << "Medium,";
-				else if (afcc <= 50.)
-					cycCplxOutputFileCSV << "High,";
-				else
-					cycCplxOutputFileCSV << "Very High,";
-				cycCplxOutputFileCSV << itt2->second.file_name << endl;
-			}
+			if ((!printDuplicates && !itt2->second.duplicate) || (printDuplicates && itt2->second.duplicate))
+				PrintCyclomaticFileRow(cycCplxOutputFile, cycCplxOutputFileCSV, *mySourceFile, itt2, tcc, ntfunc);
 		}
 	}
 
@@ -7171,119 +7641,23 @@ int PrintCyclomaticComplexity(const bool useListA, const string &outputFileNameP
 	}
 
 	// print cyclomatic complexity for each file by function
-	for (SourceFileList::iterator itt2 = mySourceFile->begin(); itt2 != mySourceFile->end(); itt2++)
+	if (g_stream_results)
 	{
-		if ( itt2->second.file_name_isEmbedded == true )
-			continue;
-
-		if ((!printDuplicates && !itt2->second.duplicate) || (printDuplicates && itt2->second.duplicate))
+		SourceFileList rowList;
+		streamCplxRows.clear();
+		streamCplxRows.seekg(0, ios::beg);
+		while (ReadStreamedComplexity(rowList))
+			PrintCyclomaticFunctionRows(cycCplxOutputFile, cycCplxOutputFileCSV, rowList, rowList.begin());
+	}
+	else
+	{
+		for (SourceFileList::iterator itt2 = mySourceFile->begin(); itt2 != mySourceFile->end(); itt2++)
 		{
-			filemap::iterator it;
-			if (itt2->second.class_type == WEB)
-			{
-				// sum embedded web files
-				SourceFileList::iterator startpos = itt2;
-				SourceFileList::iterator endpos = ++startpos;
-				if (print_ascii || print_legacy)
-				{
-					for (; endpos != mySourceFile->end(); endpos++)
-					{
-						if ( endpos->second.file_name_isEmbedded == false )
-							break;
-						for (it = endpos->second.cmplx_cycfunct_count.begin(); it != endpos->second.cmplx_cycfunct_count.end(); it++)
-						{
-							cycCplxOutputFile.setf(ofstream::right);
-							cycCplxOutputFile.width(10);
-							cycCplxOutputFile << (*it).lineNumber;
-							cycCplxOutputFile.unsetf(ofstream::right);
-							cycCplxOutputFile << "   ";
-							cycCplxOutputFile.setf(ofstream::left);
-							cycCplxOutputFile.width(9);
-							if ((*it).lineNumber <= 10)
-								cycCplxOutputFile << "Low";
-							else if ((*it).lineNumber <= 20)
-								cycCplxOutputFile << "Medium";
-							else if ((*it).lineNumber <= 50)
-								cycCplxOutputFile << "High";
-							else
-								cycCplxOutputFile << "Very High";
-							cycCplxOutputFile.unsetf(ofstream::right);
-							cycCplxOutputFile.setf(ofstream::left);
-							cycCplxOutputFile << "   ";
-							cycCplxOutputFile.width(60);
-							cycCplxOutputFile << (*it).line;
-							cycCplxOutputFile << "   |   " << itt2->second.file_name << endl;
-						}
-					}
-				}
-				if (print_csv)
-				{
-					for (; endpos != mySourceFile->end(); endpos++)
-					{
-						if ( endpos->second.file_name_isEmbedded == false )
-							break;
-						for (it = endpos->second.cmplx_cycfunct_count.begin(); it != endpos->second.cmplx_cycfunct_count.end(); it++)
-						{
-							cycCplxOutputFileCSV << (*it).lineNumber << ",";
-							if ((*it).lineNumber <= 10)
-								cycCplxOutputFileCSV << "Low,";
-							else if ((*it).lineNumber <= 20)
-								cycCplxOutputFileCSV << "Medium,";
-							else if ((*it).lineNumber <= 50)
-								cycCplxOutputFileCSV << "High,";
-							else
-								cycCplxOutputFileCSV << "Very High,";
-							cycCplxOutputFileCSV << (*it).line << "," << itt2->second.file_name << endl;
-						}
-					}
-				}
-			}
-			else
-			{
-				if (print_ascii || print_legacy)
-				{
-					for (it = itt2->second.cmplx_cycfunct_count.begin(); it != itt2->second.cmplx_cycfunct_count.end(); it++)
-					{
-						cycCplxOutputFile.setf(ofstream::right);
-						cycCplxOutputFile.width(10);
-						cycCplxOutputFile << (*it).lineNumber;
-						cycCplxOutputFile.unsetf(ofstream::right);
-						cycCplxOutputFile << "   ";
-						cycCplxOutputFile.setf(ofstream::left);
-						cycCplxOutputFile.width(9);
-						if ((*it).lineNumber <= 10)
-							cycCplxOutputFile << "Low";
-						else if ((*it).lineNumber <= 20)
-							cycCplxOutputFile << "Medium";
-						else if ((*it).lineNumber <= 50)
-							cycCplxOutputFile << "High";
-						else
-							cycCplxOutputFile << "Very High";
-						cycCplxOutputFile.unsetf(ofstream::right);
-						cycCplxOutputFile.setf(ofstream::left);
-						cycCplxOutputFile << "   ";
-						cycCplxOutputFile.width(60);
-						cycCplxOutputFile << (*it).line;
-						cycCplxOutputFile << "   |   " << itt2->second.file_name << endl;
-					}
-				}
-				if (print_csv)
-				{
-					for (it = itt2->second.cmplx_cycfunct_count.begin(); it != itt2->second.cmplx_cycfunct_count.end(); it++)
-					{
-						cycCplxOutputFileCSV << (*it).lineNumber << ",";
-						if ((*it).lineNumber <= 10)
-							cycCplxOutputFileCSV << "Low,";
-						else if ((*it).lineNumber <= 20)
-							cycCplxOutputFileCSV << "Medium,";
-						else if ((*it).lineNumber <= 50)
-							cycCplxOutputFileCSV << "High,";
-						else
-							cycCplxOutputFileCSV << "Very High,";
-						cycCplxOutputFileCSV << (*it).line << "," << itt2->second.file_name << endl;
-					}
-				}
-			}
+			if ( itt2->second.file_name_isEmbedded == true )
+				continue;
+
+			if ((!printDuplicates && !itt2->second.duplicate) || (printDuplicates && itt2->second.duplicate))
+				PrintCyclomaticFunctionRows(cycCplxOutputFile, cycCplxOutputFileCSV, *mySourceFile, itt2);
 		}
 	}
 
@@ -173,6 +173,11 @@ int PrintComplexityResults( CounterForEachLangType & CounterForEachLanguage,
 							const bool useListA = true, const string &outputFileNamePrePend = "", 
 							const bool printDuplicates = false);
 
+void PrintCountResultsStreamed( CounterForEachLangType & CounterForEachLanguage,
+								SourceFileList * mySourceFile, const bool useListA = true );
+
+int PrintStreamedCountTotals( CounterForEachLangType & CounterForEachLanguage, const bool useListA = true );
+
 void PrintDuplicateSummary( const bool useListA = true, const string &outputFileNamePrePend = "" );
 
 int PrintCountSummary( CounterForEachLangType & CounterForEachLanguage,
@@ -38,6 +38,9 @@ bool		isDiff = false;					//!< Has differencing been requested (-d)?
 // Optimizations to do more processing per unit time
 bool	g_process_after_read = false;
 bool	g_discard_lines_after_process = false;
+bool	g_stream_results = false;			//!< Print the results of each file as soon as it is counted (-stream)
+unsigned int	g_stream_file_count = 0;		//!< Number of files whose results were printed as they were counted (-stream)
+CountEngine	g_count_engine = COUNT_ENGINE_PASSES;	//!< Engine that counts the lines of a file (-engine)
 
 bool print_cmplx;								//!< Print complexity and keyword counts
 bool print_csv;									//!< Print CSV report files
@@ -51,6 +54,16 @@ bool g_no_uncounted = false;						//!< Suppress any Uncounted files messages or
 
 unsigned int  workThreadsCount = 0;				//!< Number of helper work threads to create. May be zero if not given.
 
+unsigned long long	g_max_memory = 0;			//!< Memory budget in bytes for differencing (-maxmem), 0 if no limit
+
+unsigned int	g_identical_pairs = 0;			//!< Matched file pairs credited as identical without comparing their lines
+
+// Modified line candidates rejected by each filter while comparing the matched files (for tuning)
+unsigned long long	g_modified_candidates = 0;	//!< Line pairs checked for a modified line
+unsigned long long	g_histogram_rejects = 0;	//!< Pairs rejected by the char histogram bound
+unsigned long long	g_bigram_rejects = 0;		//!< Pairs rejected by the bigram bound
+unsigned long long	g_lcs_exits = 0;			//!< Pairs rejected during the LCS (early exit)
+
 size_t lsloc_truncate;							//!< # of characters allowed in LSLOC for differencing (0=no truncation)
 
 string outDir;									//!< Output directory
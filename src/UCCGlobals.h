@@ -153,6 +153,17 @@ extern	bool		isDiff;								//!< Has differencing been requested (-d)?
 // Optimizations to do more processing per unit time
 extern	bool	g_process_after_read;
 extern	bool	g_discard_lines_after_process;
+extern	bool	g_stream_results;						//!< Print the results of each file as soon as it is counted (-stream)
+extern	unsigned int	g_stream_file_count;			//!< Number of files whose results were printed as they were counted (-stream)
+
+//! Engines that count the lines of a file (-engine).
+enum CountEngine
+{
+	COUNT_ENGINE_PASSES,		//!< One pass over the lines for each counting step
+	COUNT_ENGINE_FUSED,			//!< One pass over the lines for all steps (where the language has one, else passes)
+	COUNT_ENGINE_VERIFY			//!< Both engines, warns about files they count differently
+};
+extern	CountEngine	g_count_engine;						//!< Engine that counts the lines of a file (-engine)
 
 extern	bool print_cmplx;								//!< Print complexity and keyword counts
 extern	bool print_csv;									//!< Print CSV report files
@@ -166,6 +177,16 @@ extern	bool g_no_uncounted;							//!< Suppress any Uncounted files messages or
 
 extern	unsigned int  workThreadsCount;					//!< Number of helper work threads to create. May be zero if not given.
 
+extern	unsigned long long	g_max_memory;				//!< Memory budget in bytes for differencing (-maxmem), 0 if no limit
+
+extern	unsigned int	g_identical_pairs;				//!< Matched file pairs credited as identical without comparing their lines
+
+// Modified line candidates rejected by each filter while comparing the matched files (for tuning)
+extern	unsigned long long	g_modified_candidates;		//!< Line pairs checked for a modified line
+extern	unsigned long long	g_histogram_rejects;		//!< Pairs rejected by the char histogram bound
+extern	unsigned long long	g_bigram_rejects;			//!< Pairs rejected by the bigram bound
+extern	unsigned long long	g_lcs_exits;				//!< Pairs rejected during the LCS (early exit)
+
 extern	size_t lsloc_truncate;							//!< # of characters allowed in LSLOC for differencing (0=no truncation)
 
 extern	string outDir;									//!< Output directory
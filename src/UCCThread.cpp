@@ -23,8 +23,7 @@
 * See UCC_Multithreading_Notes.doc for some older details of how the code got this way.
 */
 
-// Uncomment this to get 2 or more worker threads supported.  Requires Boost libarary.
-// #define		ENABLE_THREADS
+// To get 2 or more worker threads supported uncomment the define of ENABLE_THREADS in cc_main.h
 
 #ifdef	_DEBUG
 	// Debug utilities to support checking the Heap.  Implemented for Windows
@@ -48,6 +47,8 @@
 #include <sstream>
 using namespace std;
 
+#include "cc_main.h"
+
 #ifdef	ENABLE_THREADS
 	#include <boost/thread/thread.hpp>
 	#include <boost/thread/mutex.hpp>
@@ -117,6 +118,9 @@ using namespace std;
 // there would be a need for an extra 2 GB or 6 GB total at one time for success to advance to next step.
 #define		USE_LESS_MEM_ON_COPY
 
+// Size of each read when a source file is loaded into the per thread file buffer
+#define		READ_CHUNK_SIZE		1048576
+
 
 ////////////////////////////////////////////////////////////////////////
 //
@@ -1054,7 +1058,8 @@ int ReadFilesInList( const unsigned int					threadIdx,
 					ErrMsgStructVector			&		err_msgs,
 					UncountedFileStructVector	&		unc_files,
 					const		bool					process_after_read,
-					const		bool					discard_lines_after_process )
+					const		bool					discard_lines_after_process,
+					CountedFilesCallback				files_counted )
 {
 	int			error_count = 0;
 	CCodeCounter * pCounter = NULL;
@@ -1067,7 +1072,8 @@ int ReadFilesInList( const unsigned int					threadIdx,
 	bool			trim_line = true;
 	bool			isErr = false;
 	unsigned int	lineNum = 0;
-	string			oneline;
+	string			fileBuffer;
+	LineExtentVector	lineExtents;
 
 	ClassType	fileclass;
 	CWebCounter *webCounter;
@@ -1217,7 +1223,7 @@ int ReadFilesInList( const unsigned int					threadIdx,
 			mySrcFileList->push_back(s_element);
 
 			// Get pointer to the just created element at the end
-			list<SourceFileElement>::iterator it = mySrcFileList->end();
+			SourceFileList::iterator it = mySrcFileList->end();
 			--it;	// Move back 1 position to valid structure
 			SourceFileElement * pElement = &(*it);
 			unsigned int error_count = 0;
@@ -1265,29 +1271,40 @@ int ReadFilesInList( const unsigned int					threadIdx,
 			lineNum = 0;
 			lineTooLong = false;
 
-			while (fr.good() || fr.eof())
+			// Read the whole file into the reused buffer, then split it into lines
+			// in one pass that also finds the trimmed extents and smart quotes
+			fileBuffer.clear();
+			while (fr.good())
 			{
-				getline(fr, oneline);
-				if ((!fr.good() && !fr.eof()) || (fr.eof() && oneline.empty()))
-					break;
+				size_t oldSize = fileBuffer.size();
+				fileBuffer.resize(oldSize + READ_CHUNK_SIZE);
+				fr.read(&fileBuffer[oldSize], READ_CHUNK_SIZE);
+				fileBuffer.resize(oldSize + (size_t)fr.gcount());
+			}
+			CUtil::SplitLines(fileBuffer.data(), fileBuffer.size(), lineExtents);
+			r.file_hash = CUtil::HashBuffer(fileBuffer.data(), fileBuffer.size());
 
+			// Size the file map once so growing it does not copy the lines already added
+			fmap.reserve(lineExtents.size());
+			for (LineExtentVector::const_iterator itLine = lineExtents.begin(); itLine != lineExtents.end(); itLine++)
+			{
 				lineNum++;
-				if (oneline.length() > MAX_LINE_LENGTH)
+				if (itLine->end - itLine->start > MAX_LINE_LENGTH)
 				{
 					lineTooLong = true;
 					break;
 				}
-				
+
+				// Add the element first and copy the text into it once
+				fmap.push_back( lineElement() );
+				fmap.back().lineNumber = lineNum;
+				string &line = fmap.back().line;
 				if ( trim_line )
-					oneline = CUtil::TrimString(oneline);
-				if ( oneline.size() )
-					oneline = CUtil::ReplaceSmartQuotes(oneline);
-				
-				// Moved element(lineNum, oneline); as lineElement  
-				// inside call below to prevent Debug build memory leaks.
-				fmap.push_back( lineElement( lineNum, oneline ) );
-				if (!fr.good())
-					break;
+					line.assign(fileBuffer, itLine->trimStart, itLine->trimEnd - itLine->trimStart);
+				else
+					line.assign(fileBuffer, itLine->start, itLine->end - itLine->start);
+				if ( itLine->smartQuotes && line.size() )
+					CUtil::ReplaceSmartQuotesInPlace(line);
 			}
 			fr.clear();
 			fr.close();
@@ -1349,7 +1366,11 @@ int ReadFilesInList( const unsigned int					threadIdx,
 			r.file_name_only = CUtil::ExtractFilename( r.file_name );
 
 		// depending on which source file we are on...
-		mySrcFileList->push_back( SourceFileElement( fmap, r ) );
+		// the lines and results are swapped into the list rather than copied
+		SourceFileElement fileElement;
+		fileElement.first.swap( fmap );
+		fileElement.second.swap( r );
+		mySrcFileList->take_back( fileElement );
 
 		if ( process_after_read && OK_to_process )
 		{
@@ -1397,6 +1418,9 @@ int ReadFilesInList( const unsigned int					threadIdx,
 			}
 		}
 
+		// Let the caller use the file right away (for example print the results and free it)
+		if ( files_counted != NULL )
+			files_counted( CounterForEachLanguage, mySrcFileList, useListA );
 		
 		if ( threadIdx < MAX_UCC_THREAD_COUNT )
 		{
@@ -1473,7 +1497,23 @@ void ProcessSourceListFile( const unsigned int threadIdx, UserIF * userIF,
 		i->second.class_type = pCounter->classtype;
 
 		// Call down to Analyze the details of this file
-		pCounter->CountSLOC( &(i->first), &(i->second) );
+		int count_status = pCounter->CountSLOC( &(i->first), &(i->second) );
+
+		// Keep only the non zero keyword counts for the rest of the run
+		i->second.compactCounts();
+		i->second.hashSLOC();
+
+		// keep within the memory budget (-maxmem)
+		if (g_max_memory != 0 && slocSpillFile::IsOpen())
+		{
+			// the physical lines are freed once the file is counted (file matching and duplicate checks use their hash)
+			i->second.hashLines(i->first);
+			filemap().swap(i->first);
+
+			// once the budget is reached the files are spilled as they are counted
+			if (slocInternTable::MemoryUsed() + srcLineVector::ResidentMemory() > g_max_memory)
+				i->second.mySLOCLines.spill();
+		}
 
 		if (i->second.trunc_lines > 0)
 		{
@@ -1491,11 +1531,21 @@ void ProcessSourceListFile( const unsigned int threadIdx, UserIF * userIF,
 			_prv_SaveOrAddError( threadIdx, userIF, err_msgs, err, true );	// Log only
 		}
 
+		if (count_status == COUNT_ENGINES_DIFFER)
+		{
+			string err = "Warning: Counting engines differ for file (";
+			if (embFile != string::npos)
+				err += i->second.file_name.substr(0, embFile);
+			else
+				err += i->second.file_name;
+			err += ")";
+			errList += err + "\n";
+			_prv_SaveOrAddError( threadIdx, userIF, err_msgs, err );
+		}
+
 		// if webcounter, insert the separation file into list
 		if (pCounter->classtype == WEB)
 		{
-			SourceFileList::iterator pos = i;
-			pos++;
 			map<int, SourceFileElement>* smap = ((CWebCounter*)pCounter)->GetSeparationMap();
 			for (map<int, SourceFileElement>::iterator iter = smap->begin(); iter != smap->end(); iter++)
 			{
@@ -1516,7 +1566,15 @@ void ProcessSourceListFile( const unsigned int threadIdx, UserIF * userIF,
 						iter->second.second.file_name_only = CUtil::ExtractFilename( iter->second.second.file_name );
 					}
 
-					(useListA) ? mySourceFileA->insert(pos, iter->second) : mySourceFileB->insert(pos, iter->second);
+					// Embedded files are kept as a child range of the parent file
+					// The lines are moved rather than copied; the separation map keeps its file name for the next file
+					// The contents of an embedded file are known from the contents of the parent file
+					iter->second.second.file_hash = i->second.file_hash;
+					SourceFileList *srcList = (useListA) ? mySourceFileA : mySourceFileB;
+					filemap lines;
+					lines.swap(iter->second.first);
+					SourceFileId id = srcList->insert_embedded(i, iter->second);
+					(*srcList)[id].first.swap(lines);
 
 					num_inserted++;
 				}
@@ -1657,7 +1715,9 @@ void ProcessSourceListFile( const unsigned int threadIdx, UserIF * userIF,
 		_prv_SaveOrAddError( threadIdx, userIF, err_msgs, err, false );		// Show ERROR on console as well
 
 		//WriteUncountedFile("Unhandled Counting Error", i->second.file_name, useListA, print_csv);
-		_prv_SaveOrWriteUncountedFile( threadIdx, userIF, unc_files,
+		// With -stream files are counted as they are read, so the row is saved and written after all files
+		// are read, in the same order as when the files are counted after reading (see ProcessSourceList)
+		_prv_SaveOrWriteUncountedFile( ( g_stream_results ) ? 0 : threadIdx, userIF, unc_files,
 									"Unhandled Counting Error", i->second.file_name, 
 									useListA, print_csv, outDir );
 	}
@@ -2079,53 +2139,10 @@ void CombineThreadResults()
 		// Copy back results to main thread struct
 		SourceFileList * pSrcFiles = g_threads_status[ j ].mySrcFileList;
 
-		// Append to existing list
-
-	#ifdef	USE_LESS_MEM_ON_COPY
-		// Minimize use of temporary memory.  
-		// This can save several MB or GB or more depending on size of File list and Files
-		// Which can make the difference between success with Threads or not.
-		// So this is the default approach.
-		unsigned int num_to_copy = pSrcFiles->size();
-
-		if ( num_to_copy )
-		{
-			// Determine a chunk of File results to copy / erase at a time
-			// This is biased to work with a large number of Files.
-			// So it may be somewhat inefficient for small number of Files.
-			unsigned int chunk_size = num_to_copy / 20;
-			if ( chunk_size > 500 )
-				chunk_size = 500;
-			if ( 0 == chunk_size )
-				chunk_size = num_to_copy;
-			
-			list<SourceFileElement>::iterator itSrcPos1;
-			list<SourceFileElement>::iterator itSrcPos2;
-			while ( num_to_copy )
-			{
-				itSrcPos1 = pSrcFiles->begin();
-				itSrcPos2 = itSrcPos1;
-				advance( itSrcPos2, chunk_size );
-				rDestFiles.insert( rDestFiles.end(), itSrcPos1, itSrcPos2 );
-				pSrcFiles->erase( itSrcPos1, itSrcPos2 );
-
-				num_to_copy -= chunk_size;
-				if ( chunk_size > num_to_copy )
-					chunk_size = num_to_copy;
-			}
-			/*
-			// This works but is TOO SLOW if doing thousands of File results
-			for ( unsigned int k = 0; k < num_to_copy; k++ )
-			{
-				rDestFiles.push_back( *(pSrcFiles->begin()) );	// Append element to end of list
-				pSrcFiles->pop_front();						// Get rid of element just copied
-			} */
-		#else
-			// Use Faster but temporarily uses much MORE memory approach
-			rDestFiles.insert( rDestFiles.end(), pSrcFiles->begin(), pSrcFiles->end() );
-		#endif
-			pSrcFiles->clear();	// Release memory from thread struct
-		}
+		// Append to existing list.
+		// Physical and Logical lines are swapped (not copied) so there is
+		// no temporary doubling of memory use and the thread list is left empty.
+		rDestFiles.append( *pSrcFiles );
 
 		// Handle list of Errors
 		for ( itErr = g_threads_status[ j ].thread_err_msgs.begin(); itErr != g_threads_status[ j ].thread_err_msgs.end(); itErr++ )
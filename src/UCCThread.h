@@ -101,6 +101,10 @@ unsigned int NumThreadsBusy( unsigned int & count_done,
 						const unsigned int	sleep_milliseconds = 100, 
 						const bool			combine_results_from_threads = true );
 
+// Called from the main thread after each file (and its embedded files) is Read and counted
+typedef void (*CountedFilesCallback)( CounterForEachLangType & CounterForEachLanguage,
+									SourceFileList * mySrcFileList, const bool useListA );
+
 // ReadFilesInList
 // returns number of Errors found
 int ReadFilesInList( const unsigned int					threadIdx,
@@ -120,7 +124,8 @@ int ReadFilesInList( const unsigned int					threadIdx,
 					ErrMsgStructVector			&		err_msgs,
 					UncountedFileStructVector	&		unc_files,
 					const		bool					process_after_read = false,
-					const		bool					discard_lines_after_process = false );
+					const		bool					discard_lines_after_process = false,
+					CountedFilesCallback				files_counted = NULL );
 
 // Analyze and do Counts for a single Source File
 void ProcessSourceListFile( const unsigned int threadIdx, UserIF * userIF, 
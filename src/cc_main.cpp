@@ -12,9 +12,252 @@
 
 #include "cc_main.h"
 #include "CUtil.h"
+#include <cstdlib>
+#include <cstring>
+
+#ifdef	ENABLE_THREADS
+	#include <boost/thread/mutex.hpp>
+#endif
+
+/*!
+* Constructs a working copy of a filemap without copying any line text.
+*
+* \param fmap original file lines (must outlive the overlay)
+*/
+filemapOverlay::filemapOverlay(const filemap *fmap)
+{
+	lines.reserve(fmap->size());
+	for (filemap::const_iterator it = fmap->begin(); it != fmap->end(); it++)
+		lines.push_back(&(*it));
+	rewritten.assign(lines.size(), false);
+}
+
+/*!
+* Returns a modifiable line, copying it into the overlay on the first write.
+*
+* \param idx index of the line
+*
+* \return line text to modify
+*/
+string& filemapOverlay::edit(size_t idx)
+{
+	if (!rewritten.at(idx))
+	{
+		store.push_back(*lines[idx]);
+		lines[idx] = &store.back();
+		rewritten[idx] = true;
+	}
+	// overlay lines are owned by the store
+	return const_cast<lineElement*>(lines[idx])->line;
+}
+
+/*!
+* Appends a line to the working copy (the original filemap is not changed).
+*
+* \param element line to append
+*/
+void filemapOverlay::push_back(const lineElement &element)
+{
+	store.push_back(element);
+	lines.push_back(&store.back());
+	rewritten.push_back(true);
+}
+
+// alignment of the memory returned by fileArena::allocate
+#define ARENA_ALIGN		(2 * sizeof(void *))
+#define ARENA_HEADER	((sizeof(fileArena::block) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+/*!
+* Constructs an empty arena. No memory is reserved until the first allocation.
+*
+* \param blockSize default block size
+*/
+fileArena::fileArena(size_t blockSize)
+	: head(NULL), pos(NULL), end(NULL), blockSize(blockSize), used(0)
+{
+}
+
+/*!
+* Constructs an empty arena with the same block size (arena memory is never shared).
+*
+* \param other arena to copy the settings from
+*/
+fileArena::fileArena(const fileArena &other)
+	: head(NULL), pos(NULL), end(NULL), blockSize(other.blockSize), used(0)
+{
+}
+
+/*!
+* Destroys the arena and releases all of its blocks.
+*/
+fileArena::~fileArena()
+{
+	while (head != NULL)
+	{
+		block *next = head->next;
+		free(head);
+		head = next;
+	}
+}
+
+/*!
+* Allocates a block with the given usable size.
+*
+* \param size usable size
+*
+* \return new block (not linked)
+*/
+fileArena::block* fileArena::NewBlock(size_t size)
+{
+	block *blk = (block *)malloc(ARENA_HEADER + size);
+	if (blk == NULL)
+		throw bad_alloc();
+	blk->next = NULL;
+	blk->size = size;
+	return blk;
+}
+
+/*!
+* Allocates memory from the arena.
+*
+* \param size number of bytes
+*
+* \return aligned memory valid until the next reset
+*/
+void* fileArena::allocate(size_t size)
+{
+	size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+	used += size;
+	if (pos != NULL && (size_t)(end - pos) >= size)
+	{
+		void *mem = pos;
+		pos += size;
+		return mem;
+	}
+
+	block *blk = NewBlock(size > blockSize / 4 ? size : blockSize);
+	if (blk->size != blockSize && head != NULL)
+	{
+		// large requests get a block of their own so the current block keeps its free space
+		blk->next = head->next;
+		head->next = blk;
+		return (char *)blk + ARENA_HEADER;
+	}
+	blk->next = head;
+	head = blk;
+	pos = (char *)blk + ARENA_HEADER + size;
+	end = (char *)blk + ARENA_HEADER + blk->size;
+	return (char *)blk + ARENA_HEADER;
+}
+
+/*!
+* Releases all allocations at once.
+* One default sized block is kept so the next file does not allocate again.
+*/
+void fileArena::reset()
+{
+	block *keep = NULL;
+	while (head != NULL)
+	{
+		block *next = head->next;
+		if (keep == NULL && head->size == blockSize)
+			keep = head;
+		else
+			free(head);
+		head = next;
+	}
+	head = keep;
+	if (head != NULL)
+	{
+		head->next = NULL;
+		pos = (char *)head + ARENA_HEADER;
+		end = pos + head->size;
+	}
+	else
+		pos = end = NULL;
+	used = 0;
+}
+
+#ifdef	_DEBUG
+static unsigned long deepCopies[DEEP_COPY_TYPE_COUNT];	// Number of deep copies of each kind
+#ifdef	ENABLE_THREADS
+static boost::mutex deepCopiesLock;						// Guards deepCopies
+#endif
+
+/*!
+* Counts a deep copy (Debug builds only).
+*
+* \param type kind of object copied
+*/
+void CountDeepCopy(DeepCopyType type)
+{
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(deepCopiesLock);
+#endif
+	deepCopies[type]++;
+}
+
+/*!
+* Returns the number of deep copies made (Debug builds only).
+*
+* \param type kind of object copied
+*
+* \return number of copies
+*/
+unsigned long DeepCopyCount(DeepCopyType type)
+{
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(deepCopiesLock);
+#endif
+	return deepCopies[type];
+}
+#endif
+
+/*!
+* Appends a line to a file map, taking its text (line is left empty).
+* When the map grows the text of its lines is swapped into the new storage rather than copied.
+*
+* \param fmap file map
+* \param lineNumber line number
+* \param line line text
+*
+* \return line element added
+*/
+lineElement& AppendLineElement(filemap &fmap, unsigned int lineNumber, string &line)
+{
+	if (fmap.size() == fmap.capacity())
+	{
+		filemap grown;
+		grown.reserve((fmap.size() < 8) ? 16 : fmap.size() * 2);
+		grown.resize(fmap.size());
+		for (size_t i = 0; i < fmap.size(); i++)
+		{
+			grown[i].lineNumber = fmap[i].lineNumber;
+			grown[i].line.swap(fmap[i].line);
+		}
+		fmap.swap(grown);
+	}
+	fmap.push_back(lineElement());
+	lineElement &element = fmap.back();
+	element.lineNumber = lineNumber;
+	element.line.swap(line);
+	return element;
+}
+
+/*!
+* Constructs a copy of a results object, including the logical lines.
+*
+* \param obj results to copy
+*/
+results::results(const results& obj)
+	: mySLOCLines(obj.mySLOCLines)
+{
+	*this = obj;
+}
 
 /*!
 * Copies a results object.
+* The logical lines are not copied.
 *
 * \param obj results to copy
 *
@@ -22,6 +265,10 @@
 */
 results& results::operator= (const results& obj)
 {
+#ifdef	_DEBUG
+	if (!obj.file_name.empty())
+		CountDeepCopy(DEEP_COPY_RESULTS);
+#endif
 	error_code = obj.error_code;
 	blank_lines = obj.blank_lines;
 	comment_lines = obj.comment_lines;
@@ -57,6 +304,7 @@ results& results::operator= (const results& obj)
 	cmplx_pointer_count.assign(obj.cmplx_pointer_count.begin(), obj.cmplx_pointer_count.end());
 	cmplx_nestloop_count.assign(obj.cmplx_nestloop_count.begin(), obj.cmplx_nestloop_count.end());
 	cmplx_cycfunct_count.assign(obj.cmplx_cycfunct_count.begin(), obj.cmplx_cycfunct_count.end());
+	sparse_counts = obj.sparse_counts;
 	trunc_lines = obj.trunc_lines;
 	total_lines = obj.total_lines;
 	e_flag = obj.e_flag;
@@ -68,10 +316,82 @@ results& results::operator= (const results& obj)
 	firstDuplicate = obj.firstDuplicate;
 	duplicate = obj.duplicate;
 	matched = obj.matched;
+	file_hash = obj.file_hash;
+	sloc_hash = obj.sloc_hash;
+	sloc_total = obj.sloc_total;
+	lines_hash = obj.lines_hash;
+	lines_count = obj.lines_count;
 
 	return *this;
 }
 
+/*!
+* Exchanges the contents of two results objects (including the logical lines) without copying.
+*
+* \param obj results to exchange with
+*/
+void results::swap(results& obj)
+{
+	error_code.swap(obj.error_code);
+	std::swap(blank_lines, obj.blank_lines);
+	std::swap(comment_lines, obj.comment_lines);
+	std::swap(e_comm_lines, obj.e_comm_lines);
+	for (int i = 0; i < 2; i++)
+	{
+		std::swap(directive_lines[i], obj.directive_lines[i]);
+		std::swap(data_lines[i], obj.data_lines[i]);
+		std::swap(exec_lines[i], obj.exec_lines[i]);
+		std::swap(SLOC_lines[i], obj.SLOC_lines[i]);
+	}
+	std::swap(total_lines, obj.total_lines);
+	std::swap(cmplx_math_lines, obj.cmplx_math_lines);
+	std::swap(cmplx_trig_lines, obj.cmplx_trig_lines);
+	std::swap(cmplx_logarithm_lines, obj.cmplx_logarithm_lines);
+	std::swap(cmplx_calc_lines, obj.cmplx_calc_lines);
+	std::swap(cmplx_cond_lines, obj.cmplx_cond_lines);
+	std::swap(cmplx_logic_lines, obj.cmplx_logic_lines);
+	std::swap(cmplx_preproc_lines, obj.cmplx_preproc_lines);
+	std::swap(cmplx_assign_lines, obj.cmplx_assign_lines);
+	std::swap(cmplx_pointer_lines, obj.cmplx_pointer_lines);
+	std::swap(trunc_lines, obj.trunc_lines);
+
+	// bit fields can not be passed by reference
+	bool flag;
+	flag = e_flag; e_flag = obj.e_flag; obj.e_flag = flag;
+	flag = file_name_isEmbedded; file_name_isEmbedded = obj.file_name_isEmbedded; obj.file_name_isEmbedded = flag;
+	flag = firstDuplicate; firstDuplicate = obj.firstDuplicate; obj.firstDuplicate = flag;
+	flag = duplicate; duplicate = obj.duplicate; obj.duplicate = flag;
+	flag = matched; matched = obj.matched; obj.matched = flag;
+
+	file_name.swap(obj.file_name);
+	file_name_only.swap(obj.file_name_only);
+	std::swap(file_type, obj.file_type);
+	std::swap(class_type, obj.class_type);
+
+	directive_count.swap(obj.directive_count);
+	data_name_count.swap(obj.data_name_count);
+	exec_name_count.swap(obj.exec_name_count);
+	math_func_count.swap(obj.math_func_count);
+	trig_func_count.swap(obj.trig_func_count);
+	log_func_count.swap(obj.log_func_count);
+	cmplx_calc_count.swap(obj.cmplx_calc_count);
+	cmplx_cond_count.swap(obj.cmplx_cond_count);
+	cmplx_logic_count.swap(obj.cmplx_logic_count);
+	cmplx_preproc_count.swap(obj.cmplx_preproc_count);
+	cmplx_assign_count.swap(obj.cmplx_assign_count);
+	cmplx_pointer_count.swap(obj.cmplx_pointer_count);
+	cmplx_nestloop_count.swap(obj.cmplx_nestloop_count);
+	cmplx_cycfunct_count.swap(obj.cmplx_cycfunct_count);
+	sparse_counts.swap(obj.sparse_counts);
+
+	mySLOCLines.swap(obj.mySLOCLines);
+	std::swap(file_hash, obj.file_hash);
+	std::swap(sloc_hash, obj.sloc_hash);
+	std::swap(sloc_total, obj.sloc_total);
+	std::swap(lines_hash, obj.lines_hash);
+	std::swap(lines_count, obj.lines_count);
+}
+
 /*!
 * Resets results to initial values.
 */
@@ -112,6 +432,7 @@ void results::reset()
 	cmplx_pointer_count.clear();
 	cmplx_nestloop_count.clear();
 	cmplx_cycfunct_count.clear();
+	sparse_counts.clear();
 	trunc_lines = 0;
 	total_lines = 0;
 	e_flag = false;
@@ -123,6 +444,11 @@ void results::reset()
 	duplicate = false;
 	firstDuplicate = false;
 	matched = false;
+	file_hash = 0;
+	sloc_hash = 0;
+	sloc_total = 0;
+	lines_hash = 0;
+	lines_count = 0;
 }
 
 /*!
@@ -145,12 +471,8 @@ bool results::addSLOC(const string &line, bool &trunc_flag)
 	if (new_line.length() == 0)
 		return false;
 
-	pair<srcLineVector::iterator, bool> insertResult = mySLOCLines.insert(make_pair(new_line, 1U));
-	if (!insertResult.second) 
-	{
-		// element already exists
-		(*insertResult.first).second++;	// update number of times this SLOC exists
-	}
+	// a line that already exists has its number of occurrences increased
+	mySLOCLines.insert(new_line);
 	if (trunc_flag)
 	{
 		trunc_lines++;
@@ -158,3 +480,1071 @@ bool results::addSLOC(const string &line, bool &trunc_flag)
 	}
 	return true;
 }
+
+// Interned logical lines are kept in shards, each with its own lock.
+// The shard of a line is chosen from its hash and is kept in the low bits of its ID.
+#define SLOC_SHARD_BITS		4
+#define SLOC_SHARD_COUNT	(1 << SLOC_SHARD_BITS)
+#define SLOC_SLOT_FREED		((unsigned int)-1)	// Slot of a line that was freed (the search goes on past it)
+
+struct slocShard
+{
+	slocShard() : usedSlots(0), textBytes(0) {}
+
+#ifdef	ENABLE_THREADS
+	boost::mutex lock;					// Guards this shard
+#endif
+	deque<string> lines;				// Interned lines (stable addresses)
+	vector<unsigned long long> hashes;	// Hash of each line
+	vector<unsigned int> refs;			// Number of references to each line (0 once freed)
+	vector<unsigned int> freeLines;		// Freed line indexes to reuse
+	vector<unsigned int> slots;			// Open addressing table of line index + 1 (0 is empty)
+	size_t usedSlots;					// Slots not empty (lines and freed lines)
+	unsigned long long textBytes;		// Memory used by the text of the lines
+};
+
+// The shards are never freed: the global file lists release their lines when the process exits,
+// possibly after the objects of this file were destroyed.
+static slocShard *slocShards = new slocShard[SLOC_SHARD_COUNT];
+
+/*!
+* Computes the hash of a logical line (64 bit FNV-1a).
+*
+* \param line logical line
+*
+* \return hash value
+*/
+static unsigned long long HashSLOC(const string &line)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < line.size(); i++)
+	{
+		hash ^= (unsigned char)line[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/*!
+* Finds the slot of a line in a shard, or the slot where it would be added
+* (the first freed slot passed, else the empty slot ending the search).
+*
+* \param shard shard to search (must be locked and have an empty slot)
+* \param line logical line
+* \param hash hash of the line
+*
+* \return slot index
+*/
+static size_t FindSLOCSlot(const slocShard &shard, const string &line, unsigned long long hash)
+{
+	size_t mask = shard.slots.size() - 1;
+	size_t idx = (size_t)(hash >> SLOC_SHARD_BITS) & mask;
+	size_t freedIdx = (size_t)-1;
+	while (shard.slots[idx] != 0)
+	{
+		if (shard.slots[idx] == SLOC_SLOT_FREED)
+		{
+			if (freedIdx == (size_t)-1)
+				freedIdx = idx;
+		}
+		else
+		{
+			unsigned int lineIdx = shard.slots[idx] - 1;
+			if (shard.hashes[lineIdx] == hash && shard.lines[lineIdx] == line)
+				return idx;
+		}
+		idx = (idx + 1) & mask;
+	}
+	return (freedIdx != (size_t)-1) ? freedIdx : idx;
+}
+
+/*!
+* Checks whether a slot holds a line.
+*
+* \param slot slot value
+*
+* \return true if the slot holds a line
+*/
+static inline bool SLOCSlotUsed(unsigned int slot)
+{
+	return slot != 0 && slot != SLOC_SLOT_FREED;
+}
+
+/*!
+* Interns a logical line and takes a reference to it (see Release).
+*
+* \param line logical line (already normalized)
+* \param text if not NULL, receives the address of the interned text
+*
+* \return line ID
+*/
+SLOCId slocInternTable::Intern(const string &line, const string **text)
+{
+	unsigned long long hash = HashSLOC(line);
+	unsigned int shardIdx = (unsigned int)(hash & (SLOC_SHARD_COUNT - 1));
+	slocShard &shard = slocShards[shardIdx];
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(shard.lock);
+#endif
+
+	// keep the table at most half full (rebuilding it drops the freed slots)
+	if ((shard.usedSlots + 1) * 2 > shard.slots.size())
+	{
+		size_t numLines = shard.lines.size() - shard.freeLines.size();
+		size_t numSlots = 1024;
+		while ((numLines + 1) * 4 > numSlots)
+			numSlots *= 2;
+		shard.slots.assign(numSlots, 0);
+		for (size_t i = 0; i < shard.lines.size(); i++)
+		{
+			if (shard.refs[i] == 0)
+				continue;
+			size_t idx = (size_t)(shard.hashes[i] >> SLOC_SHARD_BITS) & (numSlots - 1);
+			while (shard.slots[idx] != 0)
+				idx = (idx + 1) & (numSlots - 1);
+			shard.slots[idx] = (unsigned int)(i + 1);
+		}
+		shard.usedSlots = numLines;
+	}
+
+	size_t idx = FindSLOCSlot(shard, line, hash);
+	unsigned int lineIdx;
+	if (SLOCSlotUsed(shard.slots[idx]))
+	{
+		lineIdx = shard.slots[idx] - 1;
+		shard.refs[lineIdx]++;
+	}
+	else
+	{
+		if (shard.freeLines.empty())
+		{
+			lineIdx = (unsigned int)shard.lines.size();
+			shard.lines.push_back(line);
+			shard.hashes.push_back(hash);
+			shard.refs.push_back(1);
+		}
+		else
+		{
+			lineIdx = shard.freeLines.back();
+			shard.freeLines.pop_back();
+			shard.lines[lineIdx] = line;
+			shard.hashes[lineIdx] = hash;
+			shard.refs[lineIdx] = 1;
+		}
+		shard.textBytes += shard.lines[lineIdx].capacity();
+		if (shard.slots[idx] == 0)
+			shard.usedSlots++;
+		shard.slots[idx] = lineIdx + 1;
+	}
+	if (text != NULL)
+		*text = &shard.lines[lineIdx];
+	return (SLOCId)((lineIdx << SLOC_SHARD_BITS) | shardIdx);
+}
+
+/*!
+* Finds the ID of a logical line without interning it.
+*
+* \param line logical line (already normalized)
+*
+* \return line ID, or NO_SLOC_ID if the line is not interned
+*/
+SLOCId slocInternTable::Find(const string &line)
+{
+	unsigned long long hash = HashSLOC(line);
+	unsigned int shardIdx = (unsigned int)(hash & (SLOC_SHARD_COUNT - 1));
+	slocShard &shard = slocShards[shardIdx];
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(shard.lock);
+#endif
+	if (shard.slots.empty())
+		return NO_SLOC_ID;
+	size_t idx = FindSLOCSlot(shard, line, hash);
+	if (!SLOCSlotUsed(shard.slots[idx]))
+		return NO_SLOC_ID;
+	return (SLOCId)(((shard.slots[idx] - 1) << SLOC_SHARD_BITS) | shardIdx);
+}
+
+/*!
+* Takes another reference to an interned logical line.
+*
+* \param id line ID
+*/
+void slocInternTable::AddRef(SLOCId id)
+{
+	slocShard &shard = slocShards[id & (SLOC_SHARD_COUNT - 1)];
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(shard.lock);
+#endif
+	shard.refs[id >> SLOC_SHARD_BITS]++;
+}
+
+/*!
+* Releases a reference to an interned logical line.
+* The text of the line is freed with its last reference.
+*
+* \param id line ID
+*/
+void slocInternTable::Release(SLOCId id)
+{
+	slocShard &shard = slocShards[id & (SLOC_SHARD_COUNT - 1)];
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(shard.lock);
+#endif
+	unsigned int lineIdx = id >> SLOC_SHARD_BITS;
+	if (--shard.refs[lineIdx] != 0)
+		return;
+
+	// the slot is marked freed rather than emptied so the search for other lines goes on past it
+	size_t mask = shard.slots.size() - 1;
+	size_t idx = (size_t)(shard.hashes[lineIdx] >> SLOC_SHARD_BITS) & mask;
+	while (shard.slots[idx] != lineIdx + 1)
+		idx = (idx + 1) & mask;
+	shard.slots[idx] = SLOC_SLOT_FREED;
+
+	shard.textBytes -= shard.lines[lineIdx].capacity();
+	string().swap(shard.lines[lineIdx]);
+	shard.freeLines.push_back(lineIdx);
+}
+
+/*!
+* Returns the number of distinct logical lines interned.
+*
+* \return number of lines
+*/
+size_t slocInternTable::Count()
+{
+	size_t count = 0;
+	for (int i = 0; i < SLOC_SHARD_COUNT; i++)
+	{
+#ifdef	ENABLE_THREADS
+		boost::mutex::scoped_lock guard(slocShards[i].lock);
+#endif
+		count += slocShards[i].lines.size() - slocShards[i].freeLines.size();
+	}
+	return count;
+}
+
+/*!
+* Returns the memory used by the table (text and bookkeeping of the lines).
+*
+* \return bytes used
+*/
+unsigned long long slocInternTable::MemoryUsed()
+{
+	unsigned long long used = 0;
+	for (int i = 0; i < SLOC_SHARD_COUNT; i++)
+	{
+		slocShard &shard = slocShards[i];
+#ifdef	ENABLE_THREADS
+		boost::mutex::scoped_lock guard(shard.lock);
+#endif
+		used += shard.textBytes;
+		used += shard.lines.size() * (sizeof(string) + sizeof(unsigned long long) + sizeof(unsigned int));
+		used += (shard.freeLines.capacity() + shard.slots.capacity()) * sizeof(unsigned int);
+	}
+	return used;
+}
+
+static fstream				spillStream;				// Spill file
+static string				spillPath;					// Spill file path
+static long long			spillEnd = 0;				// Size of the spill file
+static unsigned long long	spillBytesWritten = 0;		// Bytes written to the spill file
+static unsigned long long	spillBytesRead = 0;			// Bytes read from the spill file
+#ifdef	ENABLE_THREADS
+static boost::mutex			spillLock;					// Guards the spill file
+#endif
+
+/*!
+* Creates the spill file.
+*
+* \param path spill file path
+*
+* \return true if the file was created
+*/
+bool slocSpillFile::Open(const string &path)
+{
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(spillLock);
+#endif
+	if (spillStream.is_open())
+	{
+		spillStream.close();
+		remove(spillPath.c_str());
+	}
+	spillStream.open(path.c_str(), ios::in | ios::out | ios::binary | ios::trunc);
+	if (!spillStream.is_open())
+		return false;
+	spillPath = path;
+	spillEnd = 0;
+	return true;
+}
+
+/*!
+* Closes and removes the spill file.
+*/
+void slocSpillFile::Close()
+{
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(spillLock);
+#endif
+	if (!spillStream.is_open())
+		return;
+	spillStream.close();
+	remove(spillPath.c_str());
+	spillPath = "";
+}
+
+/*!
+* Checks whether the spill file is open.
+*
+* \return true if open
+*/
+bool slocSpillFile::IsOpen()
+{
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(spillLock);
+#endif
+	return spillStream.is_open();
+}
+
+/*!
+* Appends data to the spill file.
+*
+* \param data data to write
+* \param len number of bytes
+*
+* \return offset of the data, or -1 on error
+*/
+long long slocSpillFile::Write(const void *data, size_t len)
+{
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(spillLock);
+#endif
+	spillStream.clear();
+	spillStream.seekp(spillEnd);
+	spillStream.write((const char *)data, len);
+	if (!spillStream.good())
+		return -1;
+	long long offset = spillEnd;
+	spillEnd += len;
+	spillBytesWritten += len;
+	return offset;
+}
+
+/*!
+* Reads data back from the spill file.
+*
+* \param offset offset of the data
+* \param data buffer to fill
+* \param len number of bytes
+*
+* \return true if all the data was read
+*/
+bool slocSpillFile::Read(long long offset, void *data, size_t len)
+{
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(spillLock);
+#endif
+	spillStream.clear();
+	spillStream.seekg(offset);
+	spillStream.read((char *)data, len);
+	if ((size_t)spillStream.gcount() != len)
+		return false;
+	spillBytesRead += len;
+	return true;
+}
+
+/*!
+* Returns the number of bytes written to the spill file.
+*
+* \return bytes written
+*/
+unsigned long long slocSpillFile::BytesWritten()
+{
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(spillLock);
+#endif
+	return spillBytesWritten;
+}
+
+/*!
+* Returns the number of bytes read from the spill file.
+*
+* \return bytes read
+*/
+unsigned long long slocSpillFile::BytesRead()
+{
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(spillLock);
+#endif
+	return spillBytesRead;
+}
+
+// Memory used by the resident lines of all the multisets (for the memory budget)
+static unsigned long long	slocResidentBytes = 0;
+#ifdef	ENABLE_THREADS
+static boost::mutex			&slocResidentLock = *new boost::mutex;	// Guards slocResidentBytes (never freed, as the shards)
+#endif
+
+/*!
+* Constructs a copy of a multiset (the interned lines get a reference for the copy).
+*
+* \param other multiset to copy
+*/
+srcLineVector::srcLineVector(const srcLineVector &other)
+	: entries(other.entries), slots(other.slots), live(other.live),
+	spillOffset(other.spillOffset), spillLength(other.spillLength)
+{
+	for (size_t i = 0; i < entries.size(); i++)
+		slocInternTable::AddRef(entries[i].id);
+	UpdateResident(0);
+}
+
+/*!
+* Copies a multiset.
+*
+* \param other multiset to copy
+*
+* \return this multiset
+*/
+srcLineVector& srcLineVector::operator=(const srcLineVector &other)
+{
+	if (this != &other)
+	{
+		srcLineVector copy(other);
+		swap(copy);
+	}
+	return *this;
+}
+
+/*!
+* Removes all lines and releases the interned lines.
+*/
+void srcLineVector::clear()
+{
+	size_t oldMemory = memory_used();
+	for (size_t i = 0; i < entries.size(); i++)
+		slocInternTable::Release(entries[i].id);
+	vector<srcLineEntry>().swap(entries);
+	vector<unsigned int>().swap(slots);
+	live = 0;
+	spillOffset = -1;
+	spillLength = 0;
+	UpdateResident(oldMemory);
+}
+
+/*!
+* Exchanges the contents with another multiset.
+*
+* \param other multiset to swap with
+*/
+void srcLineVector::swap(srcLineVector &other)
+{
+	entries.swap(other.entries);
+	slots.swap(other.slots);
+	std::swap(live, other.live);
+	std::swap(spillOffset, other.spillOffset);
+	std::swap(spillLength, other.spillLength);
+}
+
+/*!
+* Returns the memory used by the resident lines (the interned text is shared and not included).
+*
+* \return bytes used
+*/
+size_t srcLineVector::memory_used() const
+{
+	return entries.capacity() * sizeof(srcLineEntry) + slots.capacity() * sizeof(unsigned int);
+}
+
+/*!
+* Adds the change in memory used since oldMemory to the total of all the multisets.
+*
+* \param oldMemory memory used before the change
+*/
+void srcLineVector::UpdateResident(size_t oldMemory)
+{
+	size_t newMemory = memory_used();
+	if (newMemory == oldMemory)
+		return;
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(slocResidentLock);
+#endif
+	slocResidentBytes += newMemory;
+	slocResidentBytes -= oldMemory;
+}
+
+/*!
+* Returns the memory used by the resident lines of all the multisets.
+*
+* \return bytes used
+*/
+unsigned long long srcLineVector::ResidentMemory()
+{
+#ifdef	ENABLE_THREADS
+	boost::mutex::scoped_lock guard(slocResidentLock);
+#endif
+	return slocResidentBytes;
+}
+
+/*!
+* Writes the lines to the spill file and frees their memory.
+* Each line is written with its text, so lines used only by spilled files are freed from the slocInternTable.
+* The spill file must be open.
+*
+* \return true if the lines were spilled
+*/
+bool srcLineVector::spill()
+{
+	if (spilled() || !slocSpillFile::IsOpen())
+		return false;
+
+	// each line is written as its count, its length and its text
+	vector<char> data;
+	unsigned int header[2];
+	for (iterator it = begin(); it != end(); it++)
+	{
+		header[0] = it->count;
+		header[1] = (unsigned int)it->line().size();
+		data.insert(data.end(), (const char *)header, (const char *)header + sizeof(header));
+		data.insert(data.end(), it->line().begin(), it->line().end());
+	}
+	long long offset = 0;
+	if (!data.empty())
+	{
+		offset = slocSpillFile::Write(&data[0], data.size());
+		if (offset < 0)
+			return false;
+	}
+
+	size_t numLines = live;
+	clear();
+	live = numLines;
+	spillOffset = offset;
+	spillLength = data.size();
+	return true;
+}
+
+/*!
+* Reads spilled lines back from the spill file (the lines are interned again).
+*
+* \return true if the lines are resident
+*/
+bool srcLineVector::page_in()
+{
+	if (!spilled())
+		return true;
+
+	size_t numLines = live;
+	vector<char> data(spillLength);
+	if (spillLength > 0 && !slocSpillFile::Read(spillOffset, &data[0], spillLength))
+		return false;
+
+	clear();
+	entries.reserve(numLines);
+	size_t numSlots = 16;
+	while (numSlots < numLines * 2)
+		numSlots *= 2;
+	string line;
+	unsigned int header[2];
+	for (size_t pos = 0; pos + sizeof(header) <= data.size(); )
+	{
+		memcpy(header, &data[pos], sizeof(header));
+		pos += sizeof(header);
+		line.assign(&data[0] + pos, header[1]);
+		pos += header[1];
+
+		srcLineEntry entry;
+		entry.count = header[0];
+		entry.id = slocInternTable::Intern(line, &entry.text);
+		entries.push_back(entry);
+	}
+	Rehash(numSlots);
+	live = entries.size();
+	UpdateResident(0);
+	return true;
+}
+
+/*!
+* Finds the slot holding a line, or the empty slot where it would be added.
+* There must be at least one empty slot.
+*
+* \param id interned line ID
+*
+* \return slot index
+*/
+size_t srcLineVector::FindSlot(SLOCId id) const
+{
+	size_t mask = slots.size() - 1;
+	size_t idx = (size_t)((id * 2654435761U) >> 8) & mask;
+	while (slots[idx] != 0 && entries[slots[idx] - 1].id != id)
+		idx = (idx + 1) & mask;
+	return idx;
+}
+
+/*!
+* Rebuilds the slot table.
+*
+* \param numSlots new number of slots (a power of 2)
+*/
+void srcLineVector::Rehash(size_t numSlots)
+{
+	slots.assign(numSlots, 0);
+	size_t mask = numSlots - 1;
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		size_t idx = (size_t)((entries[i].id * 2654435761U) >> 8) & mask;
+		while (slots[idx] != 0)
+			idx = (idx + 1) & mask;
+		slots[idx] = (unsigned int)(i + 1);
+	}
+}
+
+/*!
+* Finds a line.
+*
+* \param id interned line ID
+*
+* \return iterator to the line, or end() if not found
+*/
+srcLineVector::iterator srcLineVector::find(SLOCId id)
+{
+	if (live == 0 || id == NO_SLOC_ID)
+		return end();
+	size_t idx = FindSlot(id);
+	if (slots[idx] == 0 || entries[slots[idx] - 1].count == 0)
+		return end();
+	return iterator(this, slots[idx] - 1);
+}
+
+/*!
+* Finds a line.
+*
+* \param line logical line (already normalized)
+*
+* \return iterator to the line, or end() if not found
+*/
+srcLineVector::iterator srcLineVector::find(const string &line)
+{
+	return find(slocInternTable::Find(line));
+}
+
+/*!
+* Adds occurrences of a line (the line is interned).
+*
+* \param line logical line (already normalized)
+* \param count number of occurrences to add
+*
+* \return true if the line was not already present
+*/
+bool srcLineVector::insert(const string &line, unsigned int count)
+{
+	if (spilled())
+		page_in();
+
+	// keep the table at most half full
+	size_t oldMemory = memory_used();
+	if ((entries.size() + 1) * 2 > slots.size())
+		Rehash(slots.empty() ? 16 : slots.size() * 2);
+
+	const string *text = NULL;
+	SLOCId id = slocInternTable::Intern(line, &text);
+	size_t idx = FindSlot(id);
+	if (slots[idx] != 0)
+	{
+		// the entry already holds a reference to the line
+		slocInternTable::Release(id);
+		srcLineEntry &entry = entries[slots[idx] - 1];
+		bool added = (entry.count == 0);
+		if (added)
+			live++;
+		entry.count += count;
+		UpdateResident(oldMemory);
+		return added;
+	}
+
+	srcLineEntry entry;
+	entry.id = id;
+	entry.count = count;
+	entry.text = text;
+	entries.push_back(entry);
+	slots[idx] = (unsigned int)entries.size();
+	live++;
+	UpdateResident(oldMemory);
+	return true;
+}
+
+/*!
+* Erases a line (its entry is kept so the table does not need to be rebuilt).
+* The count of the line may already have been decreased to 0 by the caller.
+*
+* \param pos line to erase (not already erased)
+*/
+void srcLineVector::erase(const iterator &pos)
+{
+	entries[pos.pos].count = 0;
+	live--;
+}
+
+/*!
+* Compares entries by line text.
+*/
+struct srcLineLess
+{
+	bool operator() (const srcLineVector::iterator &a, const srcLineVector::iterator &b) const
+	{
+		return a->id != b->id && a->line() < b->line();
+	}
+};
+
+/*!
+* Gets the lines in ascending text order (the order of the former map based container).
+*
+* \param view lines in sorted order
+*/
+void srcLineVector::sorted(sortedView &view)
+{
+	view.clear();
+	view.reserve(live);
+	for (iterator it = begin(); it != end(); it++)
+		view.push_back(it);
+	sort(view.begin(), view.end(), srcLineLess());
+}
+
+/*!
+* Hashes the logical lines once the file is counted.
+* The hash of a line (from its text, as IDs change when lines are spilled) times its number of copies
+* is summed, so the hash does not depend on the order of the lines.
+* Two files with the same file_hash, sloc_hash and sloc_total are not compared (all lines unmodified).
+*/
+void results::hashSLOC()
+{
+	unsigned long long h;
+
+	sloc_hash = 0;
+	sloc_total = 0;
+	for (srcLineVector::iterator it = mySLOCLines.begin(); it != mySLOCLines.end(); it++)
+	{
+		// SplitMix64 finalizer of the line hash
+		h = HashSLOC(it->line()) + 0x9E3779B97F4A7C15ULL;
+		h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+		h ^= h >> 31;
+		sloc_hash += h * it->count;
+		sloc_total += it->count;
+	}
+}
+
+/*!
+* Computes the hash of the physical lines of a file.
+*
+* \param fmap physical lines of the file
+*
+* \return hash value
+*/
+static unsigned long long HashFileLines(const filemap &fmap)
+{
+	unsigned long long hash = 0;
+	for (filemap::const_iterator it = fmap.begin(); it != fmap.end(); it++)
+		hash = hash * 1099511628211ULL + CUtil::HashBuffer(it->line.data(), it->line.size());
+	return hash;
+}
+
+/*!
+* Hashes the physical lines once the file is counted, so the lines can be freed (-maxmem).
+* Files whose lines were freed are compared by lines_count and lines_hash (see SameFileLines).
+*
+* \param fmap physical lines of the file
+*/
+void results::hashLines(const filemap &fmap)
+{
+	lines_hash = HashFileLines(fmap);
+	lines_count = (unsigned int)fmap.size();
+}
+
+/*!
+* Returns the number of physical lines of a file, including lines freed once it was counted.
+*
+* \param file source file element
+*
+* \return number of lines
+*/
+unsigned int FileLineCount(const SourceFileElement &file)
+{
+	if (file.first.empty())
+		return file.second.lines_count;
+	return (unsigned int)file.first.size();
+}
+
+/*!
+* Checks whether two files have the same physical lines.
+* The lines are compared one by one, unless the lines of a file were freed once it was counted (-maxmem):
+* the hash of the lines is then compared instead.
+*
+* \param fileA first file
+* \param fileB second file
+*
+* \return true if the files have the same lines
+*/
+bool SameFileLines(const SourceFileElement &fileA, const SourceFileElement &fileB)
+{
+	unsigned int countA = FileLineCount(fileA);
+	if (countA != FileLineCount(fileB))
+		return false;
+
+	if (fileA.first.size() == countA && fileB.first.size() == countA)
+	{
+		for (filemap::const_iterator baseLine = fileA.first.begin(), compareLine = fileB.first.begin();
+			baseLine != fileA.first.end(); baseLine++, compareLine++)
+		{
+			if ((*baseLine).line.compare((*compareLine).line) != 0)
+				return false;
+		}
+		return true;
+	}
+
+	unsigned long long hashA = (fileA.first.empty()) ? fileA.second.lines_hash : HashFileLines(fileA.first);
+	unsigned long long hashB = (fileB.first.empty()) ? fileB.second.lines_hash : HashFileLines(fileB.first);
+	return hashA == hashB;
+}
+
+/*!
+* Moves the non zero keyword counts to the sparse list and frees the counting vectors.
+* Most keywords of a language do not occur in a given file, so this keeps
+* the per file results small when many files are counted.
+* Calling it again is harmless (counts are added to the sparse list).
+*/
+void results::compactCounts()
+{
+	size_t num_counts = sparse_counts.size();
+	for (int k = 0; k < KW_LIST_COUNT; k++)
+	{
+		UIntVector *counts = KeywordListCounts<UIntVector>(*this, (KeywordListType)k);
+		for (size_t i = 0; i < counts->size(); i++)
+		{
+			if ((*counts)[i] != 0)
+				num_counts++;
+		}
+	}
+
+	KeywordCountVector compact;
+	compact.reserve(num_counts);
+	KeywordCountVector::const_iterator its = sparse_counts.begin();
+	for (int k = 0; k < KW_LIST_COUNT; k++)
+	{
+		UIntVector *counts = KeywordListCounts<UIntVector>(*this, (KeywordListType)k);
+		for (size_t i = 0; i < counts->size(); i++)
+		{
+			if ((*counts)[i] == 0)
+				continue;
+			keywordCount kc;
+			kc.list = k;
+			kc.index = (unsigned int)i;
+			kc.count = (*counts)[i];
+			compact.push_back(kc);
+		}
+		UIntVector().swap(*counts);		// release the memory
+
+		// keep counts from an earlier compaction in list order
+		while (its != sparse_counts.end() && (int)its->list == k)
+			compact.push_back(*its++);
+	}
+	sparse_counts.swap(compact);
+}
+
+/*!
+* Returns the ID of the element at the iterator position.
+*
+* \return element ID
+*/
+SourceFileId SourceFileList::iterator::id() const
+{
+	SourceFileId topId = owner->topLevel[top];
+	if (child == 0)
+		return topId;
+	return owner->slots[topId].firstChild + child - 1;
+}
+
+/*!
+* Moves to the next element in document order.
+*
+* \return this iterator
+*/
+SourceFileList::iterator& SourceFileList::iterator::operator++()
+{
+	if (child < owner->slots[owner->topLevel[top]].numChildren)
+		child++;
+	else
+	{
+		top++;
+		child = 0;
+	}
+	return *this;
+}
+
+/*!
+* Moves to the previous element in document order.
+*
+* \return this iterator
+*/
+SourceFileList::iterator& SourceFileList::iterator::operator--()
+{
+	if (child > 0)
+		child--;
+	else
+	{
+		top--;
+		child = owner->slots[owner->topLevel[top]].numChildren;
+	}
+	return *this;
+}
+
+/*!
+* Removes all elements.
+*/
+void SourceFileList::clear()
+{
+	store.clear();
+	slots.clear();
+	topLevel.clear();
+}
+
+/*!
+* Adds an element to the store with the given parent.
+*
+* \param element source file element
+* \param parentId parent file ID (or NO_SOURCE_FILE)
+*
+* \return new element ID
+*/
+SourceFileId SourceFileList::store_element(const SourceFileElement &element, SourceFileId parentId)
+{
+	SourceFileSlot slot;
+	slot.parent = parentId;
+	slot.firstChild = NO_SOURCE_FILE;
+	slot.numChildren = 0;
+
+	store.push_back(element);
+	slots.push_back(slot);
+	return (SourceFileId)(store.size() - 1);
+}
+
+/*!
+* Appends a top level file.
+*
+* \param element source file element
+*
+* \return new element ID
+*/
+SourceFileId SourceFileList::push_back(const SourceFileElement &element)
+{
+	SourceFileId id = store_element(element, NO_SOURCE_FILE);
+	topLevel.push_back(id);
+	return id;
+}
+
+/*!
+* Adds an embedded file after the existing embedded files of a parent.
+* An embedded file of an embedded file is kept with the top level parent.
+* All embedded files of a parent must be added before another element is added.
+*
+* \param parentPos position of the parent file
+* \param element embedded source file element
+*
+* \return new element ID
+*/
+SourceFileId SourceFileList::insert_embedded(const iterator &parentPos, const SourceFileElement &element)
+{
+	SourceFileId parentId = topLevel[parentPos.top];
+	SourceFileId id = store_element(element, parentId);
+	add_embedded(parentId, id);
+	return id;
+}
+
+/*!
+* Adds an element to the store with the given parent, taking its contents.
+*
+* \param element source file element (left empty)
+* \param parentId parent file ID (or NO_SOURCE_FILE)
+*
+* \return new element ID
+*/
+SourceFileId SourceFileList::take_element(SourceFileElement &element, SourceFileId parentId)
+{
+	SourceFileSlot slot;
+	slot.parent = parentId;
+	slot.firstChild = NO_SOURCE_FILE;
+	slot.numChildren = 0;
+
+	store.resize(store.size() + 1);
+	store.back().first.swap(element.first);
+	store.back().second.swap(element.second);
+	slots.push_back(slot);
+	return (SourceFileId)(store.size() - 1);
+}
+
+/*!
+* Records an element as the last embedded file of a parent.
+*
+* \param parentId parent file ID
+* \param id embedded file ID
+*/
+void SourceFileList::add_embedded(SourceFileId parentId, SourceFileId id)
+{
+	SourceFileSlot &slot = slots[parentId];
+	if (slot.numChildren == 0)
+		slot.firstChild = id;
+	slot.numChildren++;
+}
+
+/*!
+* Appends a top level file, taking the contents of the element instead of copying them.
+*
+* \param element source file element (left empty)
+*
+* \return new element ID
+*/
+SourceFileId SourceFileList::take_back(SourceFileElement &element)
+{
+	SourceFileId id = take_element(element, NO_SOURCE_FILE);
+	topLevel.push_back(id);
+	return id;
+}
+
+/*!
+* Adds an embedded file like insert_embedded, taking the contents of the element instead of copying them.
+*
+* \param parentPos position of the parent file
+* \param element embedded source file element (left empty)
+*
+* \return new element ID
+*/
+SourceFileId SourceFileList::take_embedded(const iterator &parentPos, SourceFileElement &element)
+{
+	SourceFileId parentId = topLevel[parentPos.top];
+	SourceFileId id = take_element(element, parentId);
+	add_embedded(parentId, id);
+	return id;
+}
+
+/*!
+* Moves all elements of another list to the end of this list, keeping embedded files with their parents.
+* The elements are swapped rather than copied and the other list is left empty.
+*
+* \param other list to take elements from
+*/
+void SourceFileList::append(SourceFileList &other)
+{
+	iterator parentPos;
+	for (iterator it = other.begin(); it != other.end(); it++)
+	{
+		if (it.child == 0)
+		{
+			take_back(*it);
+			parentPos = iterator(this, topLevel.size() - 1, 0);
+		}
+		else
+			take_embedded(parentPos, *it);
+	}
+	other.clear();
+}
@@ -19,15 +19,22 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <deque>
+#include <iterator>
 #include <utility>
 #include <map>
 #include <stack>
 #include <algorithm>
+#include <new>
 using namespace std;
 
 // Product revision shows that this is NOT the official version from USC
 #define PRODUCT_REVISION "2013.04_Threads"
 
+// Uncomment this to get 2 or more worker threads supported.  Requires Boost libarary.
+// Defined here so the locks of the shared tables (cc_main.cpp) are compiled with the threads (UCCThread.cpp).
+// #define		ENABLE_THREADS
+
 #define PHY		0
 #define LOG		1
 #define CODE	0
@@ -93,7 +100,8 @@ enum ClassType {
 	VBS_CFM,				// VBScript in ColdFusion
 	VERILOG,				// Verilog
 	VHDL,					// VHDL
-	XML						// XML
+	XML,						// XML
+	USER_LANGUAGE			// First language of a specification file (-langfile), each further language adds 1
 };
 
 #define EMBEDDED_FILE_PREFIX  "*.*" // the text prepended to the temp file created for embedded code
@@ -137,6 +145,24 @@ enum WebTag {
 // General Data Structures
 ///////////////////////////////////////////////////////
 
+#ifdef	_DEBUG
+//! Kinds of deep copies counted in Debug builds.
+/*!
+* \enum DeepCopyType
+*
+* Enumeration of the objects whose copies are counted to make unintended copies visible.
+*/
+enum DeepCopyType
+{
+	DEEP_COPY_LINE = 0,		// line of a filemap (lineElement holding text)
+	DEEP_COPY_RESULTS,		// results of a file
+	DEEP_COPY_TYPE_COUNT
+};
+
+void CountDeepCopy(DeepCopyType type);
+unsigned long DeepCopyCount(DeepCopyType type);
+#endif
+
 //! Structure to contain a physical line of code.
 /*!
 * \struct lineElement
@@ -145,16 +171,30 @@ enum WebTag {
 */
 struct lineElement
 {
-	lineElement(unsigned int num, string str)
+	lineElement(unsigned int num, const string &str)
+		: lineNumber(num), line(str)
 	{
-		lineNumber = num;
-		line = str;
 	}
 	lineElement()
+		: lineNumber(0)
+	{
+	}
+#ifdef	_DEBUG
+	lineElement(const lineElement &obj)
+		: lineNumber(obj.lineNumber), line(obj.line)
+	{
+		if (!line.empty())
+			CountDeepCopy(DEEP_COPY_LINE);
+	}
+	lineElement& operator=(const lineElement &obj)
 	{
-		lineNumber = 0;
-		line = "";
+		lineNumber = obj.lineNumber;
+		line = obj.line;
+		if (!line.empty())
+			CountDeepCopy(DEEP_COPY_LINE);
+		return *this;
 	}
+#endif
 	unsigned int lineNumber;	//!< Line number
 	string line;				//!< Line text
 };
@@ -167,13 +207,253 @@ struct lineElement
 */
 typedef vector<lineElement> filemap;
 
-//! Map containing all logical lines in a file.
+lineElement& AppendLineElement(filemap &fmap, unsigned int lineNumber, string &line);
+
+//! Extents of a physical line within a file buffer.
+/*!
+* \struct lineExtent
+*
+* Defines where a physical line and its trimmed text lie within a file buffer.
+* A blank line has trimStart == trimEnd == end.
+*/
+struct lineExtent
+{
+	size_t start;		//!< Offset of the first char of the line
+	size_t end;			//!< Offset of the line break (or the end of the buffer)
+	size_t trimStart;	//!< Offset of the first char that is not a trim space
+	size_t trimEnd;		//!< Offset just past the last char that is not a trim space
+	bool smartQuotes;	//!< Does the line contain smart quotes (chars 145 to 148)?
+};
+
+//! Vector containing the extents of all physical lines in a file buffer.
+/*!
+* \typedef LineExtentVector
+*
+* Defines a vector containing the extents of all physical lines in a file buffer.
+*/
+typedef vector<lineExtent> LineExtentVector;
+
+//! Copy-on-write working copy of a filemap.
+/*!
+* \class filemapOverlay
+*
+* Defines a working copy of a filemap used by the counting passes.
+* Unmodified lines are read through to the original filemap and only the lines
+* a pass rewrites (or appends) are copied into the overlay.
+* Lines are read with the iterators or at() and are modified with edit().
+*/
+class filemapOverlay
+{
+public:
+	//! Random access iterator over the working lines (read only).
+	class iterator
+	{
+	public:
+		typedef random_access_iterator_tag iterator_category;
+		typedef lineElement value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const lineElement* pointer;
+		typedef const lineElement& reference;
+
+		iterator() {}
+		explicit iterator(vector<const lineElement*>::const_iterator pos) : it(pos) {}
+
+		reference operator*() const { return **it; }
+		pointer operator->() const { return *it; }
+		iterator& operator++() { ++it; return *this; }
+		iterator operator++(int) { iterator tmp = *this; ++it; return tmp; }
+		iterator& operator--() { --it; return *this; }
+		iterator operator--(int) { iterator tmp = *this; --it; return tmp; }
+		iterator& operator+=(difference_type n) { it += n; return *this; }
+		iterator& operator-=(difference_type n) { it -= n; return *this; }
+		iterator operator+(difference_type n) const { return iterator(it + n); }
+		iterator operator-(difference_type n) const { return iterator(it - n); }
+		difference_type operator-(const iterator &rhs) const { return it - rhs.it; }
+		bool operator==(const iterator &rhs) const { return it == rhs.it; }
+		bool operator!=(const iterator &rhs) const { return it != rhs.it; }
+		bool operator<(const iterator &rhs) const { return it < rhs.it; }
+		bool operator>(const iterator &rhs) const { return it > rhs.it; }
+		bool operator<=(const iterator &rhs) const { return it <= rhs.it; }
+		bool operator>=(const iterator &rhs) const { return it >= rhs.it; }
+
+	private:
+		friend class filemapOverlay;
+		vector<const lineElement*>::const_iterator it;
+	};
+
+	explicit filemapOverlay(const filemap *fmap);
+
+	iterator begin() const { return iterator(lines.begin()); }
+	iterator end() const { return iterator(lines.end()); }
+	size_t size() const { return lines.size(); }
+	bool empty() const { return lines.empty(); }
+	const lineElement& at(size_t idx) const { return *lines.at(idx); }
+	const lineElement& back() const { return *lines.back(); }
+
+	string& edit(size_t idx);
+	string& edit(const iterator &pos) { return edit((size_t)(pos.it - lines.begin())); }
+	void push_back(const lineElement &element);
+	size_t rewritten_lines() const { return store.size(); }	//!< # of lines copied into the overlay
+
+private:
+	filemapOverlay(const filemapOverlay &);				// not copyable
+	filemapOverlay& operator=(const filemapOverlay &);
+
+	vector<const lineElement*> lines;	//!< Current version of each line (original or rewritten)
+	vector<bool> rewritten;				//!< Is the line stored in the overlay?
+	deque<lineElement> store;			//!< Rewritten and appended lines (stable addresses)
+};
+
+//! Identifier of an interned logical line.
+/*!
+* \typedef SLOCId
+*
+* Defines the identifier of a logical line in the slocInternTable.
+*/
+typedef unsigned int SLOCId;
+
+#define NO_SLOC_ID	((SLOCId)-1)	//!< Logical line not interned
+
+//! Table of distinct logical lines.
+/*!
+* \class slocInternTable
+*
+* Defines the process wide table of normalized logical lines (LSLOC).
+* Each distinct line is stored once and identified by an SLOCId, so equal lines
+* from any files share storage and compare equal by ID.
+* The table is split into shards with their own lock so counting threads rarely wait.
+* Each srcLineVector holding a line holds a reference to it. The text of a line is freed
+* when its last reference is released, and its ID may then be given to another line.
+* The address of an interned text does not change while it is referenced.
+*/
+class slocInternTable
+{
+public:
+	static SLOCId Intern(const string &line, const string **text = NULL);
+	static SLOCId Find(const string &line);
+	static void AddRef(SLOCId id);
+	static void Release(SLOCId id);
+	static size_t Count();
+	static unsigned long long MemoryUsed();
+
+private:
+	slocInternTable();
+};
+
+//! Temporary file holding spilled logical line sets.
+/*!
+* \class slocSpillFile
+*
+* Defines the process wide spill file used when a memory budget is set (-maxmem).
+* Data is appended and read back by offset; the amount of I/O is tracked for the timing report.
+* Counting threads may spill at the same time, so the file has its own lock.
+*/
+class slocSpillFile
+{
+public:
+	static bool Open(const string &path);
+	static void Close();
+	static bool IsOpen();
+	static long long Write(const void *data, size_t len);
+	static bool Read(long long offset, void *data, size_t len);
+	static unsigned long long BytesWritten();
+	static unsigned long long BytesRead();
+
+private:
+	slocSpillFile();
+};
+
+//! Logical line held in a srcLineVector.
 /*!
-* \typedef srcLineVector
+* \struct srcLineEntry
 *
-* Defines a map containing all logical lines in a file for differencing.
+* Defines an interned logical line and its number of occurrences in a file.
 */
-typedef map<string, unsigned int> srcLineVector;
+struct srcLineEntry
+{
+	SLOCId id;					//!< Interned line ID
+	unsigned int count;			//!< Number of occurrences (0 once erased)
+	const string *text;			//!< Interned line text
+
+	const string& line() const { return *text; }	//!< Logical line
+};
+
+//! Multiset containing all logical lines in a file.
+/*!
+* \class srcLineVector
+*
+* Defines an open addressing hash multiset of the logical lines in a file for differencing.
+* Lines are keyed by their interned ID, so lookups compare integers only.
+* Iteration is in insertion order; use sorted() when line order matters.
+* The lines may be spilled to the slocSpillFile with their text (the interned lines are released);
+* size() stays valid and page_in() reads them back.
+* The memory used by all the multisets is tracked for the memory budget (-maxmem).
+*/
+class srcLineVector
+{
+public:
+	//! Forward iterator over the lines (erased lines are skipped).
+	class iterator
+	{
+	public:
+		iterator() : owner(NULL), pos(0) {}
+
+		srcLineEntry& operator*() const { return owner->entries[pos]; }
+		srcLineEntry* operator->() const { return &owner->entries[pos]; }
+		iterator& operator++() { pos++; skip_erased(); return *this; }
+		iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+
+		bool operator==(const iterator &rhs) const { return pos == rhs.pos; }
+		bool operator!=(const iterator &rhs) const { return pos != rhs.pos; }
+
+	private:
+		friend class srcLineVector;
+		iterator(srcLineVector *set, size_t idx) : owner(set), pos(idx) { skip_erased(); }
+		void skip_erased() { while (pos < owner->entries.size() && owner->entries[pos].count == 0) pos++; }
+
+		srcLineVector *owner;	//!< Multiset iterated over
+		size_t pos;				//!< Index of the entry
+	};
+
+	//! Lines in ascending text order.
+	typedef vector<iterator> sortedView;
+
+	srcLineVector() : live(0), spillOffset(-1), spillLength(0) {}
+	srcLineVector(const srcLineVector &other);
+	srcLineVector& operator=(const srcLineVector &other);
+	~srcLineVector() { clear(); }
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, entries.size()); }
+	size_t size() const { return live; }
+	bool empty() const { return live == 0; }
+	void clear();
+	void swap(srcLineVector &other);
+
+	iterator find(SLOCId id);
+	iterator find(const string &line);
+	bool insert(const string &line, unsigned int count = 1);
+	void erase(const iterator &pos);
+	void sorted(sortedView &view);
+
+	bool spilled() const { return spillOffset >= 0; }
+	size_t memory_used() const;
+	bool spill();
+	bool page_in();
+
+	static unsigned long long ResidentMemory();
+
+private:
+	size_t FindSlot(SLOCId id) const;
+	void Rehash(size_t numSlots);
+	void UpdateResident(size_t oldMemory);
+
+	vector<srcLineEntry> entries;	//!< Distinct lines in insertion order
+	vector<unsigned int> slots;		//!< Open addressing table of entry index + 1 (0 is empty)
+	size_t live;					//!< Number of lines not erased
+	long long spillOffset;			//!< Offset of the lines in the spill file (-1 if resident)
+	size_t spillLength;				//!< Size of the lines in the spill file
+};
 
 //! Vector containing a list of strings.
 /*!
@@ -207,6 +487,214 @@ typedef pair<unsigned int, unsigned int> UIntPair;
 */
 typedef vector<UIntPair> UIntPairVector;
 
+//! Monotonic arena for the transient allocations made while counting one file.
+/*!
+* \class fileArena
+*
+* Defines a bump pointer arena. Memory is carved out of large blocks and is only
+* released all at once by reset(), which keeps the first block for the next file.
+* Each counting thread has its own language counters, so an arena owned by a counter
+* is only used by one thread and needs no lock.
+*/
+class fileArena
+{
+public:
+	explicit fileArena(size_t blockSize = 64 * 1024);
+	fileArena(const fileArena &other);
+	~fileArena();
+
+	void* allocate(size_t size);
+	void reset();
+	size_t bytes_used() const { return used; }		//!< Bytes handed out since the last reset
+
+private:
+	fileArena& operator=(const fileArena &);		// not assignable
+
+	struct block
+	{
+		block *next;		//!< Previously allocated block
+		size_t size;		//!< Usable size of the block
+	};
+
+	block* NewBlock(size_t size);
+
+	block *head;			//!< Current block (blocks are linked newest first)
+	char *pos;				//!< Next free byte in the current block
+	char *end;				//!< End of the current block
+	size_t blockSize;		//!< Default block size
+	size_t used;			//!< Bytes handed out since the last reset
+};
+
+//! Guard resetting a fileArena when the count of a file ends.
+/*!
+* \class fileArenaReset
+*
+* Defines a guard that resets an arena when it goes out of scope, so the next file
+* starts with an empty arena even if counting this one threw an exception.
+* Declare it before any container using the arena.
+*/
+class fileArenaReset
+{
+public:
+	explicit fileArenaReset(fileArena &a) : arena(a) {}
+	~fileArenaReset() { arena.reset(); }
+
+private:
+	fileArenaReset(const fileArenaReset &);				// not copyable
+	fileArenaReset& operator=(const fileArenaReset &);	// not assignable
+
+	fileArena &arena;		//!< Arena to reset
+};
+
+//! Allocator drawing from a fileArena.
+/*!
+* \class arenaAllocator
+*
+* Defines a standard allocator for containers that only live while one file is counted.
+* deallocate() is a no-op; the memory is reclaimed when the arena is reset.
+*/
+template <class T>
+class arenaAllocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template <class U>
+	struct rebind
+	{
+		typedef arenaAllocator<U> other;
+	};
+
+	arenaAllocator(fileArena &a) : arena(&a) {}
+	template <class U>
+	arenaAllocator(const arenaAllocator<U> &other) : arena(other.arena) {}
+
+	pointer address(reference x) const { return &x; }
+	const_pointer address(const_reference x) const { return &x; }
+	pointer allocate(size_type n, const void * = 0) { return (pointer)arena->allocate(n * sizeof(T)); }
+	void deallocate(pointer, size_type) {}
+	size_type max_size() const { return (size_type)-1 / sizeof(T); }
+	void construct(pointer p, const T &val) { new ((void *)p) T(val); }
+	void destroy(pointer p) { p->~T(); }
+
+	bool operator==(const arenaAllocator &rhs) const { return arena == rhs.arena; }
+	bool operator!=(const arenaAllocator &rhs) const { return arena != rhs.arena; }
+
+	fileArena *arena;		//!< Arena providing the memory
+};
+
+//! Vector of strings allocated from a fileArena.
+/*!
+* \typedef ArenaStringVector
+*
+* Defines a per file list of strings (such as a stack of open loops).
+*/
+typedef vector<string, arenaAllocator<string> > ArenaStringVector;
+
+//! Vector of unsigned integers allocated from a fileArena.
+/*!
+* \typedef ArenaUIntVector
+*
+* Defines a per file list of unsigned integers.
+*/
+typedef vector<unsigned int, arenaAllocator<unsigned int> > ArenaUIntVector;
+
+//! Stack of unsigned integers allocated from a fileArena.
+/*!
+* \typedef ArenaUIntStack
+*
+* Defines a per file stack of unsigned integers (construct from an ArenaUIntVector).
+*/
+typedef stack<unsigned int, ArenaUIntVector> ArenaUIntStack;
+
+//! Vector of line elements allocated from a fileArena.
+/*!
+* \typedef ArenaFilemap
+*
+* Defines a per file list of line elements (such as a stack of open functions).
+*/
+typedef vector<lineElement, arenaAllocator<lineElement> > ArenaFilemap;
+
+//! Keyword count lists kept for each file.
+/*!
+* \enum KeywordListType
+*
+* Enumeration of the keyword count lists of a file (same order as the language counter lists).
+*/
+enum KeywordListType
+{
+	KW_DIRECTIVE = 0,
+	KW_DATA_NAME,
+	KW_EXEC_NAME,
+	KW_MATH_FUNC,
+	KW_TRIG_FUNC,
+	KW_LOG_FUNC,
+	KW_CMPLX_CALC,
+	KW_CMPLX_COND,
+	KW_CMPLX_LOGIC,
+	KW_CMPLX_PREPROC,
+	KW_CMPLX_ASSIGN,
+	KW_CMPLX_POINTER,
+	KW_LIST_COUNT
+};
+
+//! Non zero count of one keyword.
+/*!
+* \struct keywordCount
+*
+* Defines a sparse keyword count entry (8 bytes).
+*/
+struct keywordCount
+{
+	unsigned int list : 8;		//!< Keyword list (KeywordListType)
+	unsigned int index : 24;	//!< Index of the keyword within the list
+	unsigned int count;			//!< Number of occurrences
+};
+
+//! Vector of sparse keyword counts.
+/*!
+* \typedef KeywordCountVector
+*
+* Defines a vector of non zero keyword counts grouped by list.
+*/
+typedef vector<keywordCount> KeywordCountVector;
+
+/*!
+* Returns the counts of a keyword list of a file (results) or of a language counter (CCodeCounter).
+* Both name their count lists the same way.
+*
+* \param owner file results or language counter
+* \param list keyword list
+*
+* \return keyword counts (NULL if not a keyword list)
+*/
+template <class Counts, class Owner>
+Counts* KeywordListCounts(Owner &owner, KeywordListType list)
+{
+	switch (list)
+	{
+	case KW_DIRECTIVE:		return &owner.directive_count;
+	case KW_DATA_NAME:		return &owner.data_name_count;
+	case KW_EXEC_NAME:		return &owner.exec_name_count;
+	case KW_MATH_FUNC:		return &owner.math_func_count;
+	case KW_TRIG_FUNC:		return &owner.trig_func_count;
+	case KW_LOG_FUNC:		return &owner.log_func_count;
+	case KW_CMPLX_CALC:		return &owner.cmplx_calc_count;
+	case KW_CMPLX_COND:		return &owner.cmplx_cond_count;
+	case KW_CMPLX_LOGIC:	return &owner.cmplx_logic_count;
+	case KW_CMPLX_PREPROC:	return &owner.cmplx_preproc_count;
+	case KW_CMPLX_ASSIGN:	return &owner.cmplx_assign_count;
+	case KW_CMPLX_POINTER:	return &owner.cmplx_pointer_count;
+	default:				return NULL;
+	}
+}
+
 //! Class to hold results for each file.
 /*!
 * \class results
@@ -217,10 +705,16 @@ class results
 {
 public:
 	results() { reset(); }				//!< Constructor
+	results(const results&);			//!< Copy constructor
 	results& operator= (const results&);//!< Assignment operator
+	void swap(results&);				//!< Method that exchanges the contents of two results without copying
 	void reset();						//!< Method that zeroes out all counters
 	void clearSLOC();					//!< Method that frees memory used to store logical SLOC
 	bool addSLOC(const string &line, bool &trunc_flag);	//!< Method to store a logical source line of code
+	void compactCounts();				//!< Method that moves the keyword counts to the sparse list
+	void hashSLOC();					//!< Method that hashes the logical lines (identical files are not compared)
+	void hashLines(const filemap &fmap);	//!< Method that hashes the physical lines (before they are freed, -maxmem)
+	const KeywordCountVector& keyword_counts() const { return sparse_counts; }	//!< Non zero keyword counts (after compactCounts)
 
 	string error_code;					//!< Error string
 	unsigned int blank_lines;			//!< # of blank lines
@@ -241,13 +735,20 @@ public:
 	unsigned int cmplx_assign_lines;	//!< # of assignments
 	unsigned int cmplx_pointer_lines;	//!< # of pointers
 	unsigned int trunc_lines;			//!< # of truncated logical lines
-	bool      e_flag;					//!< Set to true if error occurs during processing
-	bool      file_name_isEmbedded;		//!< true if an Embedded file with *.* as part of the name
+	bool      e_flag : 1;				//!< Set to true if error occurs during processing
+	bool      file_name_isEmbedded : 1;	//!< true if an Embedded file with *.* as part of the name
+
+	// differencing (packed with the flags above)
+	bool firstDuplicate : 1;			//!< Is this file the first (source) duplicate? (printed in main counting file)
+	bool duplicate : 1;					//!< Is this file a duplicate? (printed in Duplicates counting file)
+	bool matched : 1;					//!< Has matching file been found for differencing?
+
 	string    file_name;				//!< File path and name
 	string		file_name_only;			//!< File name only, used by Duplicate (a lot) & Differencing 
 	int       file_type;				//!< File type (DATA, CODE)
 	ClassType class_type;				//!< File class type
 
+	// keyword counts while the file is counted (emptied by compactCounts)
 	UIntVector directive_count;			//!< Count of each directive statement keyword
 	UIntVector data_name_count;			//!< Count of each data statement keyword
 	UIntVector exec_name_count;			//!< Count of each executable statement keyword
@@ -264,11 +765,15 @@ public:
 	UIntVector cmplx_nestloop_count;	//!< Count of nested loop levels
 	filemap cmplx_cycfunct_count;		//!< Cyclomatic complexity by function
 
-	// differencing
-	bool firstDuplicate;				//!< Is this file the first (source) duplicate? (printed in main counting file)
-	bool duplicate;						//!< Is this file a duplicate? (printed in Duplicates counting file)
-	bool matched;						//!< Has matching file been found for differencing?
 	srcLineVector mySLOCLines;			//!< Contains the actual logical lines of code for differencing
+	unsigned long long file_hash;		//!< Hash of the file contents (set when the file is read)
+	unsigned long long sloc_hash;		//!< Hash of the logical lines (set by hashSLOC)
+	unsigned int sloc_total;			//!< Number of logical lines counting the copies (set by hashSLOC)
+	unsigned long long lines_hash;		//!< Hash of the physical lines freed with -maxmem (set by hashLines)
+	unsigned int lines_count;			//!< Number of physical lines freed with -maxmem (set by hashLines)
+
+private:
+	KeywordCountVector sparse_counts;	//!< Non zero keyword counts
 };
 
 //! Pair containing a filemap and a results set.
@@ -279,12 +784,102 @@ public:
 */
 typedef pair<filemap, results> SourceFileElement;
 
+unsigned int FileLineCount(const SourceFileElement &file);
+bool SameFileLines(const SourceFileElement &fileA, const SourceFileElement &fileB);
+
+//! Identifier of a source file element within a SourceFileList.
+/*!
+* \typedef SourceFileId
+*
+* Defines the stable index of a source file element (assigned in insertion order).
+*/
+typedef unsigned int SourceFileId;
+
+#define NO_SOURCE_FILE	((SourceFileId)-1)	//!< No source file (unmatched or no parent)
+
 //! List of source file elements.
 /*!
-* \typedef SourceFileList
+* \class SourceFileList
 *
-* Defines a list of source file elements.
+* Defines an index-addressable store of source file elements.
+* Each element keeps the ID it was given when added, and its address does not change.
+* WEB embedded (separation) files are stored as a child range of their parent file,
+* so inserting them does not move any other element.
+* Iteration is in document order: each top level file followed by its embedded files.
 */
-typedef list<SourceFileElement> SourceFileList;
+class SourceFileList
+{
+public:
+	//! Bidirectional iterator over the elements in document order.
+	class iterator
+	{
+	public:
+		typedef bidirectional_iterator_tag iterator_category;
+		typedef SourceFileElement value_type;
+		typedef ptrdiff_t difference_type;
+		typedef SourceFileElement* pointer;
+		typedef SourceFileElement& reference;
+
+		iterator() : owner(NULL), top(0), child(0) {}
+
+		reference operator*() const { return (*owner)[id()]; }
+		pointer operator->() const { return &(*owner)[id()]; }
+		iterator& operator++();
+		iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+		iterator& operator--();
+		iterator operator--(int) { iterator tmp = *this; --(*this); return tmp; }
+
+		bool operator==(const iterator &rhs) const { return top == rhs.top && child == rhs.child; }
+		bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+
+		SourceFileId id() const;
+
+	private:
+		friend class SourceFileList;
+		iterator(SourceFileList *list, size_t topIdx, unsigned int childIdx) : owner(list), top(topIdx), child(childIdx) {}
+
+		SourceFileList *owner;	//!< List iterated over
+		size_t top;				//!< Position within the top level files
+		unsigned int child;		//!< 0 for the top level file, else 1 based position of an embedded file
+	};
+
+	SourceFileList() {}
+
+	iterator begin() { return iterator(this, 0, 0); }
+	iterator end() { return iterator(this, topLevel.size(), 0); }
+	size_t size() const { return store.size(); }
+	bool empty() const { return store.empty(); }
+	void clear();
+
+	SourceFileElement& operator[](SourceFileId id) { return store[id]; }
+	const SourceFileElement& operator[](SourceFileId id) const { return store[id]; }
+
+	SourceFileId push_back(const SourceFileElement &element);
+	SourceFileId insert_embedded(const iterator &parentPos, const SourceFileElement &element);
+	SourceFileId take_back(SourceFileElement &element);
+	SourceFileId take_embedded(const iterator &parentPos, SourceFileElement &element);
+	void append(SourceFileList &other);
+
+	SourceFileId parent(SourceFileId id) const { return slots[id].parent; }
+	SourceFileId first_child(SourceFileId id) const { return slots[id].firstChild; }
+	unsigned int child_count(SourceFileId id) const { return slots[id].numChildren; }
+
+private:
+	//! Placement of an element within the list.
+	struct SourceFileSlot
+	{
+		SourceFileId parent;		//!< Parent file (NO_SOURCE_FILE for a top level file)
+		SourceFileId firstChild;	//!< First embedded file (NO_SOURCE_FILE if none)
+		unsigned int numChildren;	//!< Number of embedded files
+	};
+
+	SourceFileId store_element(const SourceFileElement &element, SourceFileId parentId);
+	SourceFileId take_element(SourceFileElement &element, SourceFileId parentId);
+	void add_embedded(SourceFileId parentId, SourceFileId id);
+
+	deque<SourceFileElement> store;		//!< Elements indexed by ID
+	vector<SourceFileSlot> slots;		//!< Placement indexed by ID
+	vector<SourceFileId> topLevel;		//!< Top level file IDs in document order
+};
 
 #endif
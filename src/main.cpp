@@ -192,6 +192,36 @@ void	ShowTiming( string & time_str,
 	else
 		TimeMsg( buf, time_str, "               Total time : %5d seconds\n", diffSeconds );
 
+	// Differencing statistics that are not times, shown apart from the table above
+	if ( g_identical_pairs || slocSpillFile::BytesWritten() || g_modified_candidates )
+	{
+		TimeMsg( buf, time_str, "\n", -1 );
+
+		// Matched pairs of identical files (credited as unmodified without comparing their lines)
+		if ( g_identical_pairs )
+			TimeMsg( buf, time_str, "     Identical file pairs : %5d\n", (int)g_identical_pairs );
+
+		// Logical lines spilled to disk to stay within -maxmem
+		if ( slocSpillFile::BytesWritten() )
+		{
+			TimeMsg( buf, time_str, "  Spill file written (KB) : %5d\n", (int)( ( slocSpillFile::BytesWritten() + 1023 ) / 1024 ) );
+			TimeMsg( buf, time_str, "     Spill file read (KB) : %5d\n", (int)( ( slocSpillFile::BytesRead() + 1023 ) / 1024 ) );
+		}
+
+		// Modified line candidates rejected by each filter before their LCS is completed (for tuning)
+		if ( g_modified_candidates )
+		{
+			sprintf_s( buf, STR_BUF_SIZE * sizeof(char), " Modified line candidates : %5llu\n", g_modified_candidates );
+			time_str += buf;
+			sprintf_s( buf, STR_BUF_SIZE * sizeof(char), "        Histogram rejects : %5llu\n", g_histogram_rejects );
+			time_str += buf;
+			sprintf_s( buf, STR_BUF_SIZE * sizeof(char), "           Bigram rejects : %5llu\n", g_bigram_rejects );
+			time_str += buf;
+			sprintf_s( buf, STR_BUF_SIZE * sizeof(char), "          LCS early exits : %5llu\n", g_lcs_exits );
+			time_str += buf;
+		}
+	}
+
 }
 
 
@@ -284,7 +314,8 @@ int main(int argc, char *argv[])
 			MainObject mainObject;
 			mainObject.MainProcess(argc, argv);
 			duplicate_threshold_used = mainObject.GetDuplicateThreshold();
-			files_A_count = SourceFileA.size();
+			// with -stream the files are not kept in the list once printed
+			files_A_count = ( g_stream_results ) ? g_stream_file_count : SourceFileA.size();
 		}
 	}
 	// Handle any Exceptions to get as much context info as possible
@@ -446,6 +477,10 @@ int main(int argc, char *argv[])
 //	extern unsigned int calls_FindModifiedLines;
 
 //	printf( "\nFindModifiedLines was called %d times.\n", calls_FindModifiedLines );
+
+	// Copies of file lines and results should stay low; a jump points to a new copy by value
+	printf( "\nDeep copies: %lu filemap lines, %lu results.\n",
+			DeepCopyCount( DEEP_COPY_LINE ), DeepCopyCount( DEEP_COPY_RESULTS ) );
 #endif
 
 #ifdef	_DEBUG